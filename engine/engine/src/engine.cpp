@@ -101,6 +101,12 @@ extern "C" {
 DM_PROPERTY_EXTERN(rmtp_Script);
 DM_PROPERTY_U32(rmtp_LuaMem, 0, FrameReset, "kb", &rmtp_Script); // kilo bytes
 DM_PROPERTY_U32(rmtp_LuaRefs, 0, FrameReset, "# Lua references", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaGCTimeGO, 0, FrameReset, "us", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaGCTimeGui, 0, FrameReset, "us", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaGCTimeRender, 0, FrameReset, "us", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaMemGO, 0, FrameReset, "kb", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaMemGui, 0, FrameReset, "kb", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaMemRender, 0, FrameReset, "kb", &rmtp_Script);
 
 namespace dmEngine
 {
@@ -215,6 +221,10 @@ namespace dmEngine
     Stats::Stats()
     : m_FrameCount(0)
     , m_TotalTime(0.0f)
+    , m_UpdateTime(0)
+    , m_RenderListTime(0)
+    , m_RenderScriptTime(0)
+    , m_FrameTime(0)
     {
 
     }
@@ -245,6 +255,7 @@ namespace dmEngine
     , m_QuitOnEsc(false)
     , m_ConnectionAppMode(false)
     , m_RunWhileIconified(0)
+    , m_LuaGCStepBudget(0)
     , m_Width(960)
     , m_Height(640)
     , m_InvPhysicalWidth(1.0f/960)
@@ -1006,6 +1017,17 @@ namespace dmEngine
             module_script_contexts.Push(engine->m_GuiScriptContext);
         }
 
+        // When set, the engine drives the Lua garbage collectors within a time budget at the end of each frame,
+        // instead of letting allocations trigger collection steps at arbitrary points during the frame
+        engine->m_LuaGCStepBudget = dmConfigFile::GetInt(engine->m_Config, "script.gc_step_budget", 0);
+        if (engine->m_LuaGCStepBudget)
+        {
+            for (uint32_t i = 0; i < module_script_contexts.Size(); ++i)
+            {
+                dmScript::SetManualGC(module_script_contexts[i], true);
+            }
+        }
+
         dmSound::InitializeParams sound_params;
         sound_params.m_OutputDevice = "default";
 #if defined(__EMSCRIPTEN__)
@@ -1416,7 +1438,7 @@ namespace dmEngine
 
         if (engine->m_EngineService)
         {
-            dmEngineService::InitProfiler(engine->m_EngineService, engine->m_Factory, engine->m_Register);
+            dmEngineService::InitProfiler(engine->m_EngineService, engine->m_Factory, engine->m_Register, engine->m_RenderContext);
         }
 
         {
@@ -1536,6 +1558,44 @@ bail:
         return memcount;
     }
 
+    static uint32_t StepLuaGC(dmScript::HContext context, uint64_t time_budget)
+    {
+        uint64_t start_time = dmTime::GetTime();
+        dmScript::StepGC(context, time_budget);
+        return (uint32_t)(dmTime::GetTime() - start_time);
+    }
+
+    static void StepLuaGC(HEngine engine)
+    {
+        DM_PROFILE("LuaGC");
+        if (engine->m_SharedScriptContext)
+        {
+            DM_PROPERTY_SET_U32(rmtp_LuaGCTimeGO, StepLuaGC(engine->m_SharedScriptContext, engine->m_LuaGCStepBudget));
+        }
+        else
+        {
+            // The budget is split evenly between the script contexts
+            uint64_t time_budget = engine->m_LuaGCStepBudget / 3;
+            DM_PROPERTY_SET_U32(rmtp_LuaGCTimeGO, StepLuaGC(engine->m_GOScriptContext, time_budget));
+            DM_PROPERTY_SET_U32(rmtp_LuaGCTimeGui, StepLuaGC(engine->m_GuiScriptContext, time_budget));
+            DM_PROPERTY_SET_U32(rmtp_LuaGCTimeRender, StepLuaGC(engine->m_RenderScriptContext, time_budget));
+        }
+    }
+
+    static void SetLuaMemProperties(HEngine engine)
+    {
+        if (engine->m_SharedScriptContext)
+        {
+            DM_PROPERTY_SET_U32(rmtp_LuaMemGO, dmScript::GetLuaGCCount(dmScript::GetLuaState(engine->m_SharedScriptContext)));
+        }
+        else
+        {
+            DM_PROPERTY_SET_U32(rmtp_LuaMemGO, dmScript::GetLuaGCCount(dmScript::GetLuaState(engine->m_GOScriptContext)));
+            DM_PROPERTY_SET_U32(rmtp_LuaMemGui, dmScript::GetLuaGCCount(dmScript::GetLuaState(engine->m_GuiScriptContext)));
+            DM_PROPERTY_SET_U32(rmtp_LuaMemRender, dmScript::GetLuaGCCount(dmScript::GetLuaState(engine->m_RenderScriptContext)));
+        }
+    }
+
     static void StepFrame(HEngine engine, float dt)
     {
         dmProfiler::SetUpdateFrequency((uint32_t)(1.0f / dt));
@@ -1570,6 +1630,7 @@ bail:
             }
         }
 
+        uint64_t frame_start = dmTime::GetTime();
         dmProfile::HProfile profile = dmProfile::BeginFrame();
         {
             DM_PROFILE("Frame");
@@ -1677,7 +1738,9 @@ bail:
                 update_context.m_DT = dt;
                 update_context.m_FixedUpdateFrequency = engine->m_FixedUpdateFrequency;
                 update_context.m_AccumFrameTime = engine->m_AccumFrameTime;
+                uint64_t update_start = dmTime::GetTime();
                 dmGameObject::Update(engine->m_MainCollection, &update_context);
+                engine->m_Stats.m_UpdateTime = (uint32_t)(dmTime::GetTime() - update_start);
 
                 // Don't render while iconified
                 if (!dmGraphics::GetWindowStateParam(engine->m_GraphicsContext, dmPlatform::WINDOW_STATE_ICONIFIED))
@@ -1696,6 +1759,7 @@ bail:
                     dmExtension::PreRender(&ext_params);
 
                     // Make the render list that will be used later.
+                    uint64_t render_list_start = dmTime::GetTime();
                     dmRender::RenderListBegin(engine->m_RenderContext);
                     dmGameObject::Render(engine->m_MainCollection);
 
@@ -1707,6 +1771,8 @@ bail:
                     }
 
                     dmRender::RenderListEnd(engine->m_RenderContext);
+                    uint64_t render_script_start = dmTime::GetTime();
+                    engine->m_Stats.m_RenderListTime = (uint32_t)(render_script_start - render_list_start);
 
                     dmGraphics::BeginFrame(engine->m_GraphicsContext);
 
@@ -1725,6 +1791,7 @@ bail:
                                             1.0f, 0);
                         dmRender::DrawRenderList(engine->m_RenderContext, 0x0, 0x0, 0x0);
                     }
+                    engine->m_Stats.m_RenderScriptTime = (uint32_t)(dmTime::GetTime() - render_script_start);
                 }
 
                 dmGameObject::PostUpdate(engine->m_MainCollection);
@@ -1736,8 +1803,14 @@ bail:
                 dmMessage::Dispatch(engine->m_SystemSocket, Dispatch, engine);
             } // Sim
 
+            if (engine->m_LuaGCStepBudget)
+            {
+                StepLuaGC(engine);
+            }
+
             DM_PROPERTY_SET_U32(rmtp_LuaRefs, dmScript::GetLuaRefCount());
             DM_PROPERTY_SET_U32(rmtp_LuaMem, GetLuaMemCount(engine));
+            SetLuaMemProperties(engine);
 
             if (dLib::IsDebugMode())
             {
@@ -1772,6 +1845,7 @@ bail:
                 dmExtension::PostRender(&ext_params);
             }
 
+            dmRender::NextStatsFrame(engine->m_RenderContext);
             dmGraphics::Flip(engine->m_GraphicsContext);
 
             RecordData* record_data = &engine->m_RecordData;
@@ -1798,6 +1872,7 @@ bail:
 
         ++engine->m_Stats.m_FrameCount;
         engine->m_Stats.m_TotalTime += dt;
+        engine->m_Stats.m_FrameTime = (uint32_t)(dmTime::GetTime() - frame_start);
     }
 
     static void CalcTimeStep(HEngine engine, float& step_dt, uint32_t& num_steps)
@@ -1866,6 +1941,17 @@ bail:
 
     }
 
+    void StepFixed(HEngine engine, float dt)
+    {
+        engine->m_Alive = true;
+        engine->m_RunResult.m_ExitCode = 0;
+        engine->m_RunResult.m_Action = dmEngine::RunResult::NONE;
+        engine->m_PreviousFrameTime = dmTime::GetTime();
+
+        DM_PROFILE("Step");
+        StepFrame(engine, dt);
+    }
+
     static int IsRunning(void* context)
     {
         HEngine engine = (HEngine)context;
@@ -85,6 +85,12 @@ namespace dmEngine
 
         uint32_t m_FrameCount;
         float    m_TotalTime;   // Total running time of the game
+
+        // Wall clock time (us) spent in the stages of the last frame
+        uint32_t m_UpdateTime;          // dmGameObject::Update
+        uint32_t m_RenderListTime;      // dmGameObject::Render, where the components build the render list
+        uint32_t m_RenderScriptTime;    // The render script update, including drawing the render list
+        uint32_t m_FrameTime;
     };
 
     struct RecordData
@@ -161,6 +167,7 @@ namespace dmEngine
         float                                       m_AccumFrameTime;           // Used to trigger frame updates when using m_UpdateFrequency != 0
         uint32_t                                    m_UpdateFrequency;
         uint32_t                                    m_FixedUpdateFrequency;
+        uint32_t                                    m_LuaGCStepBudget;          // Per frame Lua gc budget (us). 0 means the Lua states collect garbage automatically
         uint32_t                                    m_Width;
         uint32_t                                    m_Height;
         uint32_t                                    m_ClearColor;
@@ -175,6 +182,8 @@ namespace dmEngine
     void Delete(HEngine engine);
     bool Init(HEngine engine, int argc, char *argv[]);
     void Step(HEngine engine);
+    // Steps one frame with the given dt, regardless of the elapsed time (for benchmarking)
+    void StepFixed(HEngine engine, float dt);
 
     void ReloadResources(HEngine engine, const char* extension);
     bool LoadBootstrapContent(HEngine engine, dmConfigFile::HConfig config);
@@ -28,6 +28,7 @@
 #include <resource/resource.h>
 #include <gameobject/gameobject.h>
 #include <gamesys/components/comp_gui.h> 
+#include <render/render.h>
 #include "engine_service.h"
 #include "engine_version.h"
 
@@ -877,6 +878,49 @@ namespace dmEngineService
         OutputJsonSceneGraph(&root, request, 0);
     }
 
+    //
+    // Render stats
+    //
+
+    static void HttpRenderStatsRequestCallback(void* context, dmWebServer::Request* request)
+    {
+        dmRender::HRenderContext render_context = (dmRender::HRenderContext)context;
+
+        dmRender::Stats stats;
+        dmRender::GetStats(render_context, &stats);
+
+        char buffer[1024];
+        dmSnPrintf(buffer, sizeof(buffer),
+            "{\n"
+            "    \"draw_calls\": %u,\n"
+            "    \"vertices\": %u,\n"
+            "    \"buffer_bytes_uploaded\": %u,\n"
+            "    \"texture_uploads\": %u,\n"
+            "    \"texture_bytes_uploaded\": %u,\n"
+            "    \"program_switches\": %u,\n"
+            "    \"texture_binds\": %u,\n"
+            "    \"state_changes\": %u,\n"
+            "    \"render_objects\": %u,\n"
+            "    \"transient_render_targets\": %u,\n"
+            "    \"transient_render_target_bytes\": %u,\n"
+            "    \"sort_time\": %u,\n"
+            "    \"cull_time\": %u,\n"
+            "    \"dispatch_time\": %u,\n"
+            "    \"draw_time\": %u\n"
+            "}",
+            stats.m_DrawCalls, stats.m_Vertices, stats.m_BufferBytesUploaded, stats.m_TextureUploads, stats.m_TextureBytesUploaded,
+            stats.m_ProgramSwitches, stats.m_TextureBinds, stats.m_StateChanges, stats.m_RenderObjects,
+            stats.m_TransientRenderTargets, stats.m_TransientRenderTargetBytes,
+            stats.m_SortTime, stats.m_CullTime, stats.m_DispatchTime, stats.m_DrawTime);
+
+        dmWebServer::SetStatusCode(request, 200);
+        dmWebServer::SendAttribute(request, "Content-Type", "application/json");
+        dmWebServer::SendAttribute(request, "Access-Control-Allow-Origin", "*");
+        dmWebServer::SendAttribute(request, "Cache-Control", "no-store");
+
+        SendText(request, buffer);
+    }
+
 #undef CHECK_RESULT_BOOL
 
     //
@@ -891,7 +935,7 @@ namespace dmEngineService
         dmWebServer::Send(request, PROFILER_HTML, PROFILER_HTML_SIZE);
     }
 
-    void InitProfiler(HEngineService engine_service, dmResource::HFactory factory, dmGameObject::HRegister regist)
+    void InitProfiler(HEngineService engine_service, dmResource::HFactory factory, dmGameObject::HRegister regist, dmRender::HRenderContext render_context)
     {
         dmWebServer::HandlerParams resource_params;
         resource_params.m_Handler = HttpResourceRequestCallback;
@@ -911,6 +955,11 @@ namespace dmEngineService
         scenegraph_params.m_Userdata = regist;
         dmWebServer::AddHandler(engine_service->m_WebServer, "/scene_graph", &scenegraph_params);
 
+        dmWebServer::HandlerParams render_stats_params;
+        render_stats_params.m_Handler = HttpRenderStatsRequestCallback;
+        render_stats_params.m_Userdata = render_context;
+        dmWebServer::AddHandler(engine_service->m_WebServer, "/render_stats", &render_stats_params);
+
         // The entry point to the engine service profiler
         dmWebServer::HandlerParams profile_params;
         profile_params.m_Handler = ProfileHandler;
@@ -28,6 +28,11 @@ namespace dmGameObject
     typedef struct Register* HRegister;
 }
 
+namespace dmRender
+{
+    typedef struct RenderContext* HRenderContext;
+}
+
 namespace dmProfile
 {
     typedef void* HProfile;
@@ -51,7 +56,7 @@ namespace dmEngineService
     uint16_t GetPort(HEngineService engine_service);
     dmWebServer::HServer GetWebServer(HEngineService engine_service);
 
-    void InitProfiler(HEngineService engine_service, dmResource::HFactory factory, dmGameObject::HRegister regist);
+    void InitProfiler(HEngineService engine_service, dmResource::HFactory factory, dmGameObject::HRegister regist, dmRender::HRenderContext render_context);
 
     struct ResourceHandlerParams
     {
@@ -0,0 +1,255 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Headless render benchmark
+//
+// Runs each benchmark scene (see test/benchmark/) for a fixed number of frames at a fixed dt,
+// using the null graphics adapter, and writes the average time per frame spent in each stage as JSON.
+// The throughput ("objects_per_ms", e.g sprites/ms for the sprite scene) is the object count over the average frame time.
+//
+// Usage: bench_engine [--count=N] [--frames=N] [--warmup=N] [--scene=NAME] [--output=PATH] [game.projectc]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dlib/dstrings.h>
+#include <dlib/log.h>
+#include <dlib/testutil.h>
+#include <render/render.h>
+
+#include "../engine.h"
+#include "../engine_private.h"
+
+extern "C" void dmExportedSymbols();
+
+#define CONTENT_ROOT "src/test/build/default"
+
+static const char* SCENES[] = { "sprite", "model", "gui", "particle", "text" };
+
+struct BenchmarkParams
+{
+    const char* m_ProjectPath;
+    const char* m_OutputPath;
+    const char* m_Scene;    // 0 means all scenes
+    uint32_t    m_Count;
+    uint32_t    m_Frames;
+    uint32_t    m_WarmupFrames;
+};
+
+// Accumulated time (us) for each stage over all benchmarked frames
+struct BenchmarkResult
+{
+    uint64_t m_Frame;
+    uint64_t m_Update;
+    uint64_t m_RenderList;
+    uint64_t m_RenderScript;
+    uint64_t m_Cull;
+    uint64_t m_Sort;
+    uint64_t m_Dispatch;
+    uint64_t m_Draw;
+    uint64_t m_DrawCalls;
+    uint64_t m_RenderObjects;
+    uint64_t m_Vertices;
+};
+
+static bool RunScene(const BenchmarkParams& params, const char* scene, BenchmarkResult* result)
+{
+    char scene_config[128];
+    char count_config[128];
+    char sprite_config[128];
+    char model_config[128];
+    char label_config[128];
+    char particle_config[128];
+    char particle_count_config[128];
+    char instances_config[128];
+    char draw_calls_config[128];
+    dmSnPrintf(scene_config, sizeof(scene_config), "--config=benchmark.scene=%s", scene);
+    dmSnPrintf(count_config, sizeof(count_config), "--config=benchmark.count=%u", params.m_Count);
+    dmSnPrintf(sprite_config, sizeof(sprite_config), "--config=sprite.max_count=%u", params.m_Count);
+    dmSnPrintf(model_config, sizeof(model_config), "--config=model.max_count=%u", params.m_Count);
+    dmSnPrintf(label_config, sizeof(label_config), "--config=label.max_count=%u", params.m_Count);
+    dmSnPrintf(particle_config, sizeof(particle_config), "--config=particle_fx.max_count=%u", params.m_Count);
+    dmSnPrintf(particle_count_config, sizeof(particle_count_config), "--config=particle_fx.max_particle_count=%u", params.m_Count * 64);
+    dmSnPrintf(instances_config, sizeof(instances_config), "--config=collection.max_instances=%u", params.m_Count + 16);
+    dmSnPrintf(draw_calls_config, sizeof(draw_calls_config), "--config=graphics.max_draw_calls=%u", params.m_Count * 2 + 1024);
+
+    const char* argv[] = {"bench_engine",
+        "--config=script.shared_state=1",
+        "--config=dmengine.unload_builtins=0",
+        "--config=display.update_frequency=0",
+        "--config=bootstrap.main_collection=/benchmark/benchmark.collectionc",
+        scene_config, count_config, sprite_config, model_config, label_config,
+        particle_config, particle_count_config, instances_config, draw_calls_config,
+        params.m_ProjectPath};
+
+    dmEngine::HEngine engine = dmEngine::New(0);
+    if (!dmEngine::Init(engine, DM_ARRAY_SIZE(argv), (char**)argv))
+    {
+        dmLogError("Failed to initialize the engine for scene '%s'", scene);
+        dmEngine::Delete(engine);
+        return false;
+    }
+
+    const float dt = 1.0f / 60.0f;
+    for (uint32_t i = 0; i < params.m_WarmupFrames; ++i)
+    {
+        dmEngine::StepFixed(engine, dt);
+    }
+
+    memset(result, 0, sizeof(*result));
+    for (uint32_t i = 0; i < params.m_Frames; ++i)
+    {
+        dmEngine::StepFixed(engine, dt);
+
+        dmEngine::Stats engine_stats;
+        dmEngine::GetStats(engine, engine_stats);
+        // The render stats of the frame that was just stepped
+        dmRender::Stats render_stats;
+        dmRender::GetStats(engine->m_RenderContext, &render_stats);
+
+        result->m_Frame         += engine_stats.m_FrameTime;
+        result->m_Update        += engine_stats.m_UpdateTime;
+        result->m_RenderList    += engine_stats.m_RenderListTime;
+        result->m_RenderScript  += engine_stats.m_RenderScriptTime;
+        result->m_Cull          += render_stats.m_CullTime;
+        result->m_Sort          += render_stats.m_SortTime;
+        result->m_Dispatch      += render_stats.m_DispatchTime;
+        result->m_Draw          += render_stats.m_DrawTime;
+        result->m_DrawCalls     += render_stats.m_DrawCalls;
+        result->m_RenderObjects += render_stats.m_RenderObjects;
+        result->m_Vertices      += render_stats.m_Vertices;
+    }
+
+    dmEngine::Delete(engine);
+    return true;
+}
+
+static void WriteSceneResult(FILE* f, const char* scene, const BenchmarkResult& r, uint32_t count, uint32_t frames, bool last)
+{
+    double n = (double)(frames > 0 ? frames : 1);
+    double frame_ms = r.m_Frame / n / 1000.0;
+    fprintf(f, "    \"%s\": {\n", scene);
+    fprintf(f, "      \"frame\": %.2f,\n",          r.m_Frame / n);
+    fprintf(f, "      \"update\": %.2f,\n",         r.m_Update / n);
+    fprintf(f, "      \"render_list\": %.2f,\n",    r.m_RenderList / n);
+    fprintf(f, "      \"render_script\": %.2f,\n",  r.m_RenderScript / n);
+    fprintf(f, "      \"cull\": %.2f,\n",           r.m_Cull / n);
+    fprintf(f, "      \"sort\": %.2f,\n",           r.m_Sort / n);
+    fprintf(f, "      \"dispatch\": %.2f,\n",       r.m_Dispatch / n);
+    fprintf(f, "      \"draw\": %.2f,\n",           r.m_Draw / n);
+    fprintf(f, "      \"draw_calls\": %.2f,\n",     r.m_DrawCalls / n);
+    fprintf(f, "      \"render_objects\": %.2f,\n", r.m_RenderObjects / n);
+    fprintf(f, "      \"vertices\": %.2f,\n",       r.m_Vertices / n);
+    fprintf(f, "      \"objects_per_ms\": %.2f\n",  frame_ms > 0.0 ? count / frame_ms : 0.0);
+    fprintf(f, "    }%s\n", last ? "" : ",");
+}
+
+static const char* GetArgValue(const char* arg, const char* name)
+{
+    size_t len = strlen(name);
+    if (strncmp(arg, name, len) == 0 && arg[len] == '=')
+        return arg + len + 1;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    dmExportedSymbols();
+
+    char project_path[512];
+    dmTestUtil::MakeHostPathf(project_path, sizeof(project_path), "%s%s", CONTENT_ROOT, "/game.projectc");
+
+    BenchmarkParams params;
+    params.m_ProjectPath  = project_path;
+    params.m_OutputPath   = 0;
+    params.m_Scene        = 0;
+    params.m_Count        = 1000;
+    params.m_Frames       = 300;
+    params.m_WarmupFrames = 10;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* value;
+        if ((value = GetArgValue(argv[i], "--count")))
+            params.m_Count = (uint32_t)strtoul(value, 0, 10);
+        else if ((value = GetArgValue(argv[i], "--frames")))
+            params.m_Frames = (uint32_t)strtoul(value, 0, 10);
+        else if ((value = GetArgValue(argv[i], "--warmup")))
+            params.m_WarmupFrames = (uint32_t)strtoul(value, 0, 10);
+        else if ((value = GetArgValue(argv[i], "--scene")))
+            params.m_Scene = value;
+        else if ((value = GetArgValue(argv[i], "--output")))
+            params.m_OutputPath = value;
+        else if (argv[i][0] != '-')
+            params.m_ProjectPath = argv[i];
+        else
+        {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--count=N] [--frames=N] [--warmup=N] [--scene=NAME] [--output=PATH] [game.projectc]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE* f = stdout;
+    if (params.m_OutputPath)
+    {
+        f = fopen(params.m_OutputPath, "wb");
+        if (!f)
+        {
+            dmLogError("Failed to open '%s' for writing", params.m_OutputPath);
+            return 1;
+        }
+    }
+
+    const char* scenes[DM_ARRAY_SIZE(SCENES)];
+    uint32_t num_scenes = 0;
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(SCENES); ++i)
+    {
+        if (params.m_Scene == 0 || strcmp(params.m_Scene, SCENES[i]) == 0)
+            scenes[num_scenes++] = SCENES[i];
+    }
+    if (num_scenes == 0)
+    {
+        dmLogError("Unknown scene '%s'", params.m_Scene);
+        return 1;
+    }
+
+    dmEngineInitialize();
+
+    int exit_code = 0;
+    fprintf(f, "{\n");
+    fprintf(f, "  \"count\": %u,\n", params.m_Count);
+    fprintf(f, "  \"frames\": %u,\n", params.m_Frames);
+    fprintf(f, "  \"unit\": \"us\",\n");
+    fprintf(f, "  \"scenes\": {\n");
+    for (uint32_t i = 0; i < num_scenes; ++i)
+    {
+        BenchmarkResult result;
+        if (!RunScene(params, scenes[i], &result))
+        {
+            memset(&result, 0, sizeof(result));
+            exit_code = 1;
+        }
+        WriteSceneResult(f, scenes[i], result, params.m_Count, params.m_Frames, i + 1 == num_scenes);
+    }
+    fprintf(f, "  }\n");
+    fprintf(f, "}\n");
+
+    dmEngineFinalize();
+
+    if (f != stdout)
+        fclose(f);
+    return exit_code;
+}
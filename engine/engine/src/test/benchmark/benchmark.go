@@ -0,0 +1,28 @@
+components {
+  id: "script"
+  component: "/benchmark/benchmark.script"
+}
+components {
+  id: "gui"
+  component: "/benchmark/benchmark.gui"
+}
+embedded_components {
+  id: "sprite_factory"
+  type: "factory"
+  data: "prototype: \"/benchmark/sprite.go\""
+}
+embedded_components {
+  id: "model_factory"
+  type: "factory"
+  data: "prototype: \"/benchmark/model.go\""
+}
+embedded_components {
+  id: "particle_factory"
+  type: "factory"
+  data: "prototype: \"/benchmark/particle.go\""
+}
+embedded_components {
+  id: "label_factory"
+  type: "factory"
+  data: "prototype: \"/benchmark/label.go\""
+}
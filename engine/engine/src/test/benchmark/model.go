@@ -0,0 +1,4 @@
+components {
+  id: "model"
+  component: "/model/cube.model"
+}
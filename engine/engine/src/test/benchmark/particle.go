@@ -0,0 +1,8 @@
+components {
+  id: "particlefx"
+  component: "/particlefx/test_particlefx.particlefx"
+}
+components {
+  id: "script"
+  component: "/benchmark/particle.script"
+}
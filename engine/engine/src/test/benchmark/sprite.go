@@ -0,0 +1,4 @@
+components {
+  id: "sprite"
+  component: "/sprite/coll.sprite"
+}
@@ -26,6 +26,7 @@
 #include <dlib/math.h>
 #include <dlib/vmath.h>
 #include <dlib/mutex.h>
+#include <dlib/time.h>
 #include <dmsdk/dlib/vmath.h>
 #include <ddf/ddf.h>
 #include "gameobject.h"
@@ -227,6 +228,10 @@ namespace dmGameObject
         m_ScaleAlongZ = 0;
         m_DirtyTransforms = 1;
         m_Initialized = 0;
+        m_Initializing = 0;
+        m_InitFailed = 0;
+        m_InitCursor = 0;
+        m_InitCount = 0;
         m_FixedAccumTime = 0.0f;
         m_FirstUpdate = 1;
 
@@ -1299,322 +1304,544 @@ namespace dmGameObject
     }
 
 
-    // Returns if successful or not
-    static bool CollectionSpawnFromDescInternal(Collection* collection, dmGameObjectDDF::CollectionDesc* collection_desc, InstancePropertyBuffers *property_buffers, InstanceIdMap *id_mapping, dmTransform::Transform const &transform)
+    enum CollectionSpawnPhase
     {
-        // Path prefix for collection objects
-        char root_path[32];
-        HashState64 prefixHashState;
-        dmHashInit64(&prefixHashState, true);
-        GenerateUniqueCollectionInstanceId(collection, root_path, sizeof(root_path));
-        dmHashUpdateBuffer64(&prefixHashState, root_path, strlen(root_path));
+        COLLECTION_SPAWN_PHASE_CREATE,
+        COLLECTION_SPAWN_PHASE_INIT,
+        COLLECTION_SPAWN_PHASE_ADD_TO_UPDATE,
+        COLLECTION_SPAWN_PHASE_DONE,
+        COLLECTION_SPAWN_PHASE_FAILED,
+    };
 
-        // table for output ids
-        id_mapping->SetCapacity(32, collection_desc->m_Instances.m_Count);
+    static const uint32_t INVALID_SPAWN_INDEX = 0xffffffff;
+
+    // State of a collection being spawned, possibly over several frames.
+    // Instances are created, initialized and added to update in the order of the collection description.
+    // Instances are only referenced by identifier between frames, since they might be deleted by other scripts.
+    struct CollectionSpawn
+    {
+        Collection*                         m_Collection;
+        dmGameObjectDDF::CollectionDesc*    m_CollectionDesc;
+        InstancePropertyBuffers*            m_PropertyBuffers;
+        InstanceIdMap*                      m_IdMapping;
+        dmTransform::Transform              m_Transform;
+        HashState64                         m_PrefixHashState;
+        char                                m_RootPath[32];
+        // Per instance description: the new identifier, the parent description index and whether the instance was created
+        dmArray<dmhash_t>                   m_InstanceIds;
+        dmArray<uint32_t>                   m_ParentIndices;
+        dmArray<uint8_t>                    m_Created;
+        // Child description indices, m_ChildOffsets[i]..m_ChildOffsets[i+1] are the children of description i
+        dmArray<uint32_t>                   m_ChildOffsets;
+        dmArray<uint32_t>                   m_ChildIndices;
+        uint32_t                            m_Cursor;
+        uint8_t                             m_Phase;
+    };
 
-        dmArray<HInstance> new_instances;
-        new_instances.SetCapacity(collection_desc->m_Instances.m_Count);
+    // Limits the work of an incremental operation by time and/or by the number of processed instances
+    struct IncrementalBudget
+    {
+        IncrementalBudget(uint64_t time_budget, uint32_t max_steps)
+        : m_StartTime(dmTime::GetTime())
+        , m_TimeBudget(time_budget)
+        , m_MaxSteps(max_steps)
+        , m_Steps(0)
+        {
+        }
 
-        bool success = true;
+        uint64_t m_StartTime;
+        uint64_t m_TimeBudget;
+        uint32_t m_MaxSteps;
+        uint32_t m_Steps;
+    };
 
-        for (uint32_t i = 0; i < collection_desc->m_Instances.m_Count; ++i)
-        {
-            const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[i];
-            Prototype* proto = 0x0;
-            dmResource::HFactory factory = collection->m_Factory;
-            dmGameObject::HInstance instance = 0x0;
+    // Called once per processed instance
+    static inline bool IsBudgetSpent(IncrementalBudget& budget)
+    {
+        ++budget.m_Steps;
+        if (budget.m_MaxSteps != 0 && budget.m_Steps >= budget.m_MaxSteps)
+            return true;
+        return budget.m_TimeBudget != 0 && (dmTime::GetTime() - budget.m_StartTime) >= budget.m_TimeBudget;
+    }
 
-            if (instance_desc.m_Prototype)
+    static HInstance GetSpawnedInstance(CollectionSpawn* spawn, uint32_t index)
+    {
+        if (!spawn->m_Created[index])
+            return 0;
+        HInstance instance = GetInstanceFromIdentifier(spawn->m_Collection, spawn->m_InstanceIds[index]);
+        if (instance == 0 || instance->m_ToBeDeleted)
+            return 0;
+        return instance;
+    }
+
+    static bool SetSpawnedInstanceProperties(Collection* collection, dmGameObjectDDF::CollectionDesc* collection_desc, const dmGameObjectDDF::InstanceDesc& instance_desc,
+                                             HInstance instance, InstancePropertyBuffers* property_buffers)
+    {
+        // First set properties from the collection definition
+        // Then look if there are any properties in the supplied property_buffers for the instance
+        uint32_t component_instance_data_index = 0;
+        Prototype::Component* components = instance->m_Prototype->m_Components;
+        uint32_t comp_count = instance->m_Prototype->m_ComponentCount;
+        for (uint32_t comp_i = 0; comp_i < comp_count; ++comp_i)
+        {
+            Prototype::Component& component = components[comp_i];
+            ComponentType* type = component.m_Type;
+            if (type->m_SetPropertiesFunction != 0x0)
             {
-                dmResource::Result error = dmResource::Get(factory, instance_desc.m_Prototype, (void**)&proto);
-                if (error == dmResource::RESULT_OK) {
-                    instance = dmGameObject::NewInstance(collection, proto, instance_desc.m_Prototype);
-                    if (instance == 0) {
-                        dmResource::Release(factory, proto);
-                        success = false;
+                if (!type->m_InstanceHasUserData)
+                {
+                    DM_HASH_REVERSE_MEM(hash_ctx, 256);
+                    dmLogError("Unable to set properties for the component '%s' in game object '%s' in collection '%s' since it has no ability to store them.", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
+                    return false;
+                }
+
+                bool success = true;
+                HPropertyContainer ddf_properties = 0x0;
+                uint32_t comp_prop_count = instance_desc.m_ComponentProperties.m_Count;
+                for (uint32_t prop_i = 0; prop_i < comp_prop_count; ++prop_i)
+                {
+                    const dmGameObjectDDF::ComponentPropertyDesc& comp_prop = instance_desc.m_ComponentProperties[prop_i];
+                    if (dmHashString64(comp_prop.m_Id) == component.m_Id)
+                    {
+                        ddf_properties = PropertyContainerCreateFromDDF(&comp_prop.m_PropertyDecls);
+                        if (ddf_properties == 0x0)
+                        {
+                            DM_HASH_REVERSE_MEM(hash_ctx, 256);
+                            dmLogError("Could not read properties parameters for the component '%s' in game object '%s' in collection '%s'.", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
+                            success = false;
+                        }
                         break;
                     }
                 }
-            }
 
-            if (!instance)
-                continue;
+                HPropertyContainer lua_properties = 0x0;
+                dmhash_t instance_id = dmHashString64(instance_desc.m_Id);
+                HPropertyContainer* instance_properties = property_buffers->Get(instance_id);
+                if (instance_properties != 0x0)
+                {
+                    if (strcmp(type->m_Name, "scriptc") == 0)
+                    {
+                        // The container is owned by the instance from here on, the remaining ones are destroyed by the caller
+                        lua_properties = *instance_properties;
+                        property_buffers->Erase(instance_id);
+                    }
+                }
 
-            instance->m_ScaleAlongZ = collection_desc->m_ScaleAlongZ;
-            instance->m_Generated = 1;
+                if (!success)
+                {
+                    PropertyContainerDestroy(lua_properties);
+                    PropertyContainerDestroy(ddf_properties);
+                    return false;
+                }
 
-            // support legacy pipeline which outputs 0 for Scale3 and scale in Scale
-            Vector3 scale = instance_desc.m_Scale3;
-            if (scale.getX() == 0 && scale.getY() == 0 && scale.getZ() == 0)
-                    scale = Vector3(instance_desc.m_Scale, instance_desc.m_Scale, instance_desc.m_Scale);
+                HPropertyContainer properties = 0x0;
+                if (ddf_properties != 0x0 && lua_properties !=0x0)
+                {
+                    properties = PropertyContainerMerge(ddf_properties, lua_properties);
+                    PropertyContainerDestroy(lua_properties);
+                    PropertyContainerDestroy(ddf_properties);
+                    if (properties == 0x0)
+                    {
+                        DM_HASH_REVERSE_MEM(hash_ctx, 256);
+                        dmLogError("Could not merge properties parameters for the component '%s' in game object '%s' in collection '%s'", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
+                        return false;
+                    }
+                }
+                else
+                {
+                    properties = ddf_properties ? ddf_properties : lua_properties;
+                }
 
-            instance->m_Transform = dmTransform::Transform(Vector3(instance_desc.m_Position), instance_desc.m_Rotation, scale);
-            dmHashClone64(&instance->m_CollectionPathHashState, &prefixHashState, true);
+                ComponentSetPropertiesParams params;
+                params.m_Instance = instance;
 
-            const char* path_end = strrchr(instance_desc.m_Id, *ID_SEPARATOR);
-            if (path_end == 0x0) {
-                dmLogError("The id of %s has an incorrect format, missing path specifier.", instance_desc.m_Id);
-                success = false;
-            } else {
-                dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, instance_desc.m_Id, path_end - instance_desc.m_Id + 1);
-            }
+                if (properties != 0x0)
+                {
+                    params.m_PropertySet.m_GetPropertyCallback = PropertyContainerGetPropertyCallback;
+                    params.m_PropertySet.m_FreeUserDataCallback = PropertyContainerDestroyCallback;
+                    params.m_PropertySet.m_UserData = (uintptr_t)properties;
+                }
 
-            // Construct the full new path id and store in the id mapping table (mapping from prefixless
-            // to with the root_path added)
-            HashState64 new_id_hs;
-            dmHashClone64(&new_id_hs, &prefixHashState, true);
-            dmHashUpdateBuffer64(&new_id_hs, instance_desc.m_Id, strlen(instance_desc.m_Id));
-            dmhash_t new_id = dmHashFinal64(&new_id_hs);
-            dmhash_t id = dmHashBuffer64(instance_desc.m_Id, strlen(instance_desc.m_Id));
-            id_mapping->Put(id, new_id);
-            new_instances.Push(instance);
+                uintptr_t* component_instance_data = &instance->m_ComponentInstanceUserData[component_instance_data_index];
+                params.m_UserData = component_instance_data;
 
-            if (dmGameObject::SetIdentifier(collection, instance, new_id) != dmGameObject::RESULT_OK)
-            {
-                dmLogError("Unable to set identifier for %s%s. Name clash?", root_path, instance_desc.m_Id);
-                success = false;
+                PropertyResult result = type->m_SetPropertiesFunction(params);
+                if (result != PROPERTY_RESULT_OK)
+                {
+                    DM_HASH_REVERSE_MEM(hash_ctx, 256);
+                    dmLogError("Could not load properties for component '%s' when spawning '%s' in collection '%s'.", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
+                    PropertyContainerDestroy(properties);
+                    return false;
+                }
             }
+            if (component.m_Type->m_InstanceHasUserData)
+                ++component_instance_data_index;
         }
-        dmHashRelease64(&prefixHashState);
+        return true;
+    }
+
+    // Creates the instance, its components and links it to its already created parent and children
+    static bool CreateSpawnedInstance(CollectionSpawn* spawn, uint32_t index)
+    {
+        Collection* collection = spawn->m_Collection;
+        dmGameObjectDDF::CollectionDesc* collection_desc = spawn->m_CollectionDesc;
+        const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[index];
+
+        if (!instance_desc.m_Prototype)
+            return true;
 
-        if (success)
+        Prototype* proto = 0x0;
+        dmResource::HFactory factory = collection->m_Factory;
+        if (dmResource::Get(factory, instance_desc.m_Prototype, (void**)&proto) != dmResource::RESULT_OK)
+            return true;
+
+        HInstance instance = dmGameObject::NewInstance(collection, proto, instance_desc.m_Prototype);
+        if (instance == 0)
         {
-            // Setup hierarchy
-            for (uint32_t i = 0; i < collection_desc->m_Instances.m_Count; ++i)
-            {
-                const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[i];
+            dmResource::Release(factory, proto);
+            return false;
+        }
 
-                dmhash_t *parent_id = id_mapping->Get(dmHashString64(instance_desc.m_Id));
-                assert(parent_id);
+        instance->m_ScaleAlongZ = collection_desc->m_ScaleAlongZ;
+        instance->m_Generated = 1;
 
-                dmGameObject::HInstance parent = dmGameObject::GetInstanceFromIdentifier(collection, *parent_id);
-                assert(parent);
+        // support legacy pipeline which outputs 0 for Scale3 and scale in Scale
+        Vector3 scale = instance_desc.m_Scale3;
+        if (scale.getX() == 0 && scale.getY() == 0 && scale.getZ() == 0)
+                scale = Vector3(instance_desc.m_Scale, instance_desc.m_Scale, instance_desc.m_Scale);
 
-                for (uint32_t j = 0; j < instance_desc.m_Children.m_Count; ++j)
-                {
-                    dmhash_t child_id = dmGameObject::GetAbsoluteIdentifier(parent, instance_desc.m_Children[j], strlen(instance_desc.m_Children[j]));
+        instance->m_Transform = dmTransform::Transform(Vector3(instance_desc.m_Position), instance_desc.m_Rotation, scale);
+        dmHashClone64(&instance->m_CollectionPathHashState, &spawn->m_PrefixHashState, true);
 
-                    // It is not always the case that 'parent' has had the path prefix prepended to its id, so it is necessary
-                    // to see if a remapping exists.
-                    dmhash_t *new_id = id_mapping->Get(child_id);
-                    if (new_id)
-                    {
-                        child_id = *new_id;
-                    }
+        const char* path_end = strrchr(instance_desc.m_Id, *ID_SEPARATOR);
+        dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, instance_desc.m_Id, path_end - instance_desc.m_Id + 1);
 
-                    dmGameObject::HInstance child = dmGameObject::GetInstanceFromIdentifier(collection, child_id);
-                    if (child)
-                    {
-                        dmGameObject::Result r = dmGameObject::SetParent(child, parent);
-                        if (r != dmGameObject::RESULT_OK)
-                        {
-                            dmLogError("Unable to set %s as parent to %s (%d)", instance_desc.m_Id, instance_desc.m_Children[j], r);
-                            success = false;
-                        }
-                    }
-                    else
-                    {
-                        dmLogError("Child not found: %s", instance_desc.m_Children[j]);
-                        success = false;
-                    }
-                }
-            }
+        if (dmGameObject::SetIdentifier(collection, instance, spawn->m_InstanceIds[index]) != dmGameObject::RESULT_OK)
+        {
+            dmLogError("Unable to set identifier for %s%s. Name clash?", spawn->m_RootPath, instance_desc.m_Id);
+            UndoNewInstance(collection, instance);
+            return false;
         }
 
-        // Exit point 1: Before components are created.
-        if (!success)
+        // Update the transform for all parent-less objects
+        uint32_t parent_index = spawn->m_ParentIndices[index];
+        if (parent_index == INVALID_SPAWN_INDEX || collection_desc->m_Instances[parent_index].m_Prototype == 0x0)
         {
-            for (uint32_t i=0;i!=new_instances.Size();i++)
-            {
-                ReleaseIdentifier(collection, new_instances[i]);
-                UndoNewInstance(collection, new_instances[i]);
-            }
-            id_mapping->Clear();
+            instance->m_Transform = dmTransform::Mul(spawn->m_Transform, instance->m_Transform);
+        }
+
+        // world transforms need to be up to date in time for the script init calls
+        collection->m_WorldTransforms[instance->m_Index] = dmTransform::ToMatrix4(instance->m_Transform);
+
+        if (!dmGameObject::CreateComponents(collection, instance))
+        {
+            ReleaseIdentifier(collection, instance);
+            UndoNewInstance(collection, instance);
             return false;
         }
 
-        // Update the transform for all parent-less objects
-        for (uint32_t i=0;i!=new_instances.Size();i++)
+        // From here on, the instance is deleted as part of the spawn on error
+        spawn->m_Created[index] = 1;
+
+        if (!SetSpawnedInstanceProperties(collection, collection_desc, instance_desc, instance, spawn->m_PropertyBuffers))
+            return false;
+
+        // Setup hierarchy
+        HInstance parent = parent_index != INVALID_SPAWN_INDEX ? GetSpawnedInstance(spawn, parent_index) : 0;
+        if (parent)
         {
-            if (!GetParent(new_instances[i]))
+            dmGameObject::Result r = dmGameObject::SetParent(instance, parent);
+            if (r != dmGameObject::RESULT_OK)
             {
-                new_instances[i]->m_Transform = dmTransform::Mul(transform, new_instances[i]->m_Transform);
+                dmLogError("Unable to set %s as parent to %s (%d)", collection_desc->m_Instances[parent_index].m_Id, instance_desc.m_Id, r);
+                return false;
             }
+        }
 
-            // world transforms need to be up to date in time for the script init calls
-            collection->m_WorldTransforms[new_instances[i]->m_Index] = dmTransform::ToMatrix4(new_instances[i]->m_Transform);
+        for (uint32_t i = spawn->m_ChildOffsets[index]; i < spawn->m_ChildOffsets[index+1]; ++i)
+        {
+            uint32_t child_index = spawn->m_ChildIndices[i];
+            HInstance child = GetSpawnedInstance(spawn, child_index);
+            if (child)
+            {
+                dmGameObject::Result r = dmGameObject::SetParent(child, instance);
+                if (r != dmGameObject::RESULT_OK)
+                {
+                    dmLogError("Unable to set %s as parent to %s (%d)", instance_desc.m_Id, collection_desc->m_Instances[child_index].m_Id, r);
+                    return false;
+                }
+            }
         }
+        return true;
+    }
 
-        // Create components and set properties
-        //
-        // First set properties from the collection definition
-        // Then look if there are any properties in the supplied property_buffers for the instance
+    // Children might have been created before their parents, so the world transforms are resolved
+    // parent first before the instances are initialized
+    static void UpdateSpawnedWorldTransform(CollectionSpawn* spawn, uint32_t index, dmArray<uint8_t>& updated)
+    {
+        if (updated[index])
+            return;
+        updated[index] = 1;
 
-        // After this point, instances are either removed (through undo) on error, or added
-        // to the 'created' array from which they can be deleted on error.
-        dmArray<HInstance> created;
-        created.SetCapacity(collection_desc->m_Instances.m_Count);
+        HInstance instance = GetSpawnedInstance(spawn, index);
+        if (!instance)
+            return;
 
-        for (uint32_t i = 0; i < collection_desc->m_Instances.m_Count; ++i)
+        Collection* collection = spawn->m_Collection;
+        Matrix4* trans = &collection->m_WorldTransforms[instance->m_Index];
+        uint32_t parent_index = spawn->m_ParentIndices[index];
+        if (parent_index == INVALID_SPAWN_INDEX || instance->m_Parent == INVALID_INSTANCE_INDEX)
         {
-            const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[i];
+            *trans = dmTransform::ToMatrix4(instance->m_Transform);
+            return;
+        }
 
-            dmhash_t *instance_id = id_mapping->Get(dmHashString64(instance_desc.m_Id));
-            assert(instance_id);
+        UpdateSpawnedWorldTransform(spawn, parent_index, updated);
+        const Matrix4* parent_trans = &collection->m_WorldTransforms[instance->m_Parent];
+        if (instance->m_ScaleAlongZ)
+        {
+            *trans = (*parent_trans) * dmTransform::ToMatrix4(instance->m_Transform);
+        }
+        else
+        {
+            *trans = dmTransform::MulNoScaleZ(*parent_trans, dmTransform::ToMatrix4(instance->m_Transform));
+        }
+    }
 
-            dmGameObject::HInstance instance = dmGameObject::GetInstanceFromIdentifier(collection, *instance_id);
-            bool result = dmGameObject::CreateComponents(collection, instance);
-            if (result) {
-                created.Push(instance);
-                // Set properties
-                uint32_t component_instance_data_index = 0;
-                Prototype::Component* components = instance->m_Prototype->m_Components;
-                uint32_t comp_count = instance->m_Prototype->m_ComponentCount;
-                for (uint32_t comp_i = 0; comp_i < comp_count; ++comp_i)
-                {
-                    Prototype::Component& component = components[comp_i];
-                    ComponentType* type = component.m_Type;
-                    if (type->m_SetPropertiesFunction != 0x0)
-                    {
-                        if (!type->m_InstanceHasUserData)
-                        {
-                            DM_HASH_REVERSE_MEM(hash_ctx, 256);
-                            dmLogError("Unable to set properties for the component '%s' in game object '%s' in collection '%s' since it has no ability to store them.", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
-                            success = false;
-                            break;
-                        }
+    static void FailCollectionSpawn(CollectionSpawn* spawn)
+    {
+        // Fail cleanup
+        for (uint32_t i = 0; i < spawn->m_Created.Size(); ++i)
+        {
+            HInstance instance = GetSpawnedInstance(spawn, i);
+            if (instance)
+                dmGameObject::Delete(spawn->m_Collection, instance, false);
+            spawn->m_Created[i] = 0;
+        }
+        spawn->m_IdMapping->Clear();
+        spawn->m_Phase = COLLECTION_SPAWN_PHASE_FAILED;
+    }
 
-                        HPropertyContainer ddf_properties = 0x0;
-                        uint32_t comp_prop_count = instance_desc.m_ComponentProperties.m_Count;
-                        for (uint32_t prop_i = 0; prop_i < comp_prop_count; ++prop_i)
-                        {
-                            const dmGameObjectDDF::ComponentPropertyDesc& comp_prop = instance_desc.m_ComponentProperties[prop_i];
-                            if (dmHashString64(comp_prop.m_Id) == component.m_Id)
-                            {
-                                ddf_properties = PropertyContainerCreateFromDDF(&comp_prop.m_PropertyDecls);
-                                if (ddf_properties == 0x0)
-                                {
-                                    DM_HASH_REVERSE_MEM(hash_ctx, 256);
-                                    dmLogError("Could not read properties parameters for the component '%s' in game object '%s' in collection '%s'.", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
-                                    success = false;
-                                }
-                                break;
-                            }
-                        }
+    HCollectionSpawn NewCollectionSpawn(HCollection hcollection, HCollectionDesc hcollection_desc, InstancePropertyBuffers *property_buffers,
+                                        const Point3& position, const Quat& rotation, const Vector3& scale,
+                                        InstanceIdMap *id_mapping)
+    {
+        Collection* collection = hcollection->m_Collection;
+        dmGameObjectDDF::CollectionDesc* collection_desc = (dmGameObjectDDF::CollectionDesc*)hcollection_desc;
+        uint32_t instance_count = collection_desc->m_Instances.m_Count;
+
+        CollectionSpawn* spawn = new CollectionSpawn;
+        spawn->m_Collection = collection;
+        spawn->m_CollectionDesc = collection_desc;
+        spawn->m_PropertyBuffers = property_buffers;
+        spawn->m_IdMapping = id_mapping;
+        spawn->m_Transform.SetTranslation(Vector3(position));
+        spawn->m_Transform.SetRotation(rotation);
+        spawn->m_Transform.SetScale(scale);
+        spawn->m_Cursor = 0;
+        spawn->m_Phase = COLLECTION_SPAWN_PHASE_CREATE;
 
-                        HPropertyContainer lua_properties = 0x0;
-                        HPropertyContainer* instance_properties = property_buffers->Get(dmHashString64(instance_desc.m_Id));
-                        if (instance_properties != 0x0)
-                        {
-                            if (strcmp(type->m_Name, "scriptc") == 0)
-                            {
-                                lua_properties = *instance_properties;
-                            }
-                        }
+        // Path prefix for collection objects
+        dmHashInit64(&spawn->m_PrefixHashState, true);
+        GenerateUniqueCollectionInstanceId(collection, spawn->m_RootPath, sizeof(spawn->m_RootPath));
+        dmHashUpdateBuffer64(&spawn->m_PrefixHashState, spawn->m_RootPath, strlen(spawn->m_RootPath));
 
-                        if (!success)
-                        {
-                            PropertyContainerDestroy(lua_properties);
-                            PropertyContainerDestroy(ddf_properties);
-                            break;
-                        }
+        // table for output ids
+        id_mapping->SetCapacity(32, instance_count);
 
-                        HPropertyContainer properties = 0x0;
-                        if (ddf_properties != 0x0 && lua_properties !=0x0)
-                        {
-                            properties = PropertyContainerMerge(ddf_properties, lua_properties);
-                            PropertyContainerDestroy(lua_properties);
-                            PropertyContainerDestroy(ddf_properties);
-                            if (properties == 0x0)
-                            {
-                                DM_HASH_REVERSE_MEM(hash_ctx, 256);
-                                dmLogError("Could not merge properties parameters for the component '%s' in game object '%s' in collection '%s'", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
-                                success = false;
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            properties = ddf_properties ? ddf_properties : lua_properties;
-                        }
+        spawn->m_InstanceIds.SetCapacity(instance_count);
+        spawn->m_InstanceIds.SetSize(instance_count);
+        spawn->m_ParentIndices.SetCapacity(instance_count);
+        spawn->m_ParentIndices.SetSize(instance_count);
+        spawn->m_Created.SetCapacity(instance_count);
+        spawn->m_Created.SetSize(instance_count);
+        spawn->m_ChildOffsets.SetCapacity(instance_count + 1);
 
-                        ComponentSetPropertiesParams params;
-                        params.m_Instance = instance;
+        // Maps the new identifiers to description indices, for resolving the hierarchy
+        dmHashTable64<uint32_t> id_to_index;
+        id_to_index.SetCapacity(32, instance_count);
 
-                        if (properties != 0x0)
-                        {
-                            params.m_PropertySet.m_GetPropertyCallback = PropertyContainerGetPropertyCallback;
-                            params.m_PropertySet.m_FreeUserDataCallback = PropertyContainerDestroyCallback;
-                            params.m_PropertySet.m_UserData = (uintptr_t)properties;
-                        }
+        bool success = true;
+        uint32_t child_count = 0;
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[i];
+            spawn->m_ParentIndices[i] = INVALID_SPAWN_INDEX;
+            spawn->m_Created[i] = 0;
+            child_count += instance_desc.m_Children.m_Count;
 
-                        uintptr_t* component_instance_data = &instance->m_ComponentInstanceUserData[component_instance_data_index];
-                        params.m_UserData = component_instance_data;
+            if (strrchr(instance_desc.m_Id, *ID_SEPARATOR) == 0x0)
+            {
+                dmLogError("The id of %s has an incorrect format, missing path specifier.", instance_desc.m_Id);
+                success = false;
+            }
 
-                        PropertyResult result = type->m_SetPropertiesFunction(params);
-                        if (result != PROPERTY_RESULT_OK)
-                        {
-                            DM_HASH_REVERSE_MEM(hash_ctx, 256);
-                            dmLogError("Could not load properties for component '%s' when spawning '%s' in collection '%s'.", dmHashReverseSafe64Alloc(&hash_ctx, component.m_Id), instance_desc.m_Id, collection_desc->m_Name);
-                            PropertyContainerDestroy(properties);
-                            success = false;
-                            break;
-                        }
-                    }
-                    if (component.m_Type->m_InstanceHasUserData)
-                        ++component_instance_data_index;
-                }
-            } else {
-                ReparentChildNodes(collection, instance);
-                Unlink(collection, instance);
-                MoveAllUp(collection, instance);
+            // Construct the full new path id and store in the id mapping table (mapping from prefixless
+            // to with the root_path added)
+            HashState64 new_id_hs;
+            dmHashClone64(&new_id_hs, &spawn->m_PrefixHashState, true);
+            dmHashUpdateBuffer64(&new_id_hs, instance_desc.m_Id, strlen(instance_desc.m_Id));
+            dmhash_t new_id = dmHashFinal64(&new_id_hs);
+            dmhash_t id = dmHashBuffer64(instance_desc.m_Id, strlen(instance_desc.m_Id));
+            spawn->m_InstanceIds[i] = new_id;
+            id_to_index.Put(new_id, i);
 
-                ReleaseIdentifier(collection, instance);
-                UndoNewInstance(collection, instance);
-                success = false;
+            if (instance_desc.m_Prototype)
+            {
+                id_mapping->Put(id, new_id);
+                if (GetInstanceFromIdentifier(collection, new_id) != 0)
+                {
+                    dmLogError("Unable to set identifier for %s%s. Name clash?", spawn->m_RootPath, instance_desc.m_Id);
+                    success = false;
+                }
             }
         }
 
-        if (success)
+        spawn->m_ChildIndices.SetCapacity(child_count);
+        for (uint32_t i = 0; i < instance_count && success; ++i)
         {
-            for (uint32_t i=0;i!=created.Size();i++)
+            const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[i];
+            spawn->m_ChildOffsets.Push(spawn->m_ChildIndices.Size());
+
+            // The child identifiers are relative to the collection path of the parent
+            const char* path_end = strrchr(instance_desc.m_Id, *ID_SEPARATOR);
+            HashState64 path_hs;
+            dmHashClone64(&path_hs, &spawn->m_PrefixHashState, false);
+            dmHashUpdateBuffer64(&path_hs, instance_desc.m_Id, path_end - instance_desc.m_Id + 1);
+
+            for (uint32_t j = 0; j < instance_desc.m_Children.m_Count; ++j)
             {
-                if (!InitInstance(collection, created[i]))
+                const char* child_name = instance_desc.m_Children[j];
+                dmhash_t child_id;
+                if (*child_name == *ID_SEPARATOR)
+                {
+                    child_id = dmHashBuffer64(child_name, strlen(child_name));
+                }
+                else
+                {
+                    HashState64 tmp_state;
+                    dmHashClone64(&tmp_state, &path_hs, false);
+                    dmHashUpdateBuffer64(&tmp_state, child_name, strlen(child_name));
+                    child_id = dmHashFinal64(&tmp_state);
+                }
+
+                // It is not always the case that the parent has had the path prefix prepended to its id, so it is necessary
+                // to see if a remapping exists.
+                dmhash_t* new_id = id_mapping->Get(child_id);
+                if (new_id)
+                {
+                    child_id = *new_id;
+                }
+
+                uint32_t* child_index = id_to_index.Get(child_id);
+                if (child_index && collection_desc->m_Instances[*child_index].m_Prototype)
                 {
+                    spawn->m_ParentIndices[*child_index] = i;
+                    spawn->m_ChildIndices.Push(*child_index);
+                }
+                else
+                {
+                    dmLogError("Child not found: %s", child_name);
                     success = false;
-                    break;
                 }
             }
         }
+        spawn->m_ChildOffsets.Push(spawn->m_ChildIndices.Size());
 
         if (!success)
         {
-            // Fail cleanup
-            for (uint32_t i=0;i!=created.Size();i++)
-                dmGameObject::Delete(collection, created[i], false);
             id_mapping->Clear();
-            return false;
+            DeleteCollectionSpawn(spawn);
+            return 0;
+        }
+        return spawn;
+    }
+
+    IncrementalResult UpdateCollectionSpawn(HCollectionSpawn spawn, uint64_t time_budget, uint32_t max_steps)
+    {
+        DM_PROFILE("UpdateCollectionSpawn");
+        IncrementalBudget budget(time_budget, max_steps);
+        Collection* collection = spawn->m_Collection;
+        uint32_t instance_count = spawn->m_CollectionDesc->m_Instances.m_Count;
+
+        if (spawn->m_Phase == COLLECTION_SPAWN_PHASE_CREATE)
+        {
+            while (spawn->m_Cursor < instance_count)
+            {
+                if (!CreateSpawnedInstance(spawn, spawn->m_Cursor++))
+                {
+                    FailCollectionSpawn(spawn);
+                    return INCREMENTAL_RESULT_ERROR;
+                }
+                if (IsBudgetSpent(budget))
+                    return INCREMENTAL_RESULT_PENDING;
+            }
+            spawn->m_Cursor = 0;
+            spawn->m_Phase = COLLECTION_SPAWN_PHASE_INIT;
         }
 
-        for (uint32_t i=0;i!=created.Size();i++)
+        if (spawn->m_Phase == COLLECTION_SPAWN_PHASE_INIT)
         {
-            AddToUpdate(collection, created[i]);
+            if (spawn->m_Cursor == 0)
+            {
+                dmArray<uint8_t> updated;
+                updated.SetCapacity(instance_count);
+                updated.SetSize(instance_count);
+                memset(updated.Begin(), 0, instance_count);
+                for (uint32_t i = 0; i < instance_count; ++i)
+                {
+                    UpdateSpawnedWorldTransform(spawn, i, updated);
+                }
+            }
+
+            while (spawn->m_Cursor < instance_count)
+            {
+                HInstance instance = GetSpawnedInstance(spawn, spawn->m_Cursor++);
+                if (instance && !InitInstance(collection, instance))
+                {
+                    FailCollectionSpawn(spawn);
+                    return INCREMENTAL_RESULT_ERROR;
+                }
+                if (IsBudgetSpent(budget))
+                    return INCREMENTAL_RESULT_PENDING;
+            }
+            spawn->m_Phase = COLLECTION_SPAWN_PHASE_ADD_TO_UPDATE;
         }
 
-        return true;
+        if (spawn->m_Phase == COLLECTION_SPAWN_PHASE_ADD_TO_UPDATE)
+        {
+            for (uint32_t i = 0; i < instance_count; ++i)
+            {
+                HInstance instance = GetSpawnedInstance(spawn, i);
+                if (instance)
+                    AddToUpdate(collection, instance);
+            }
+            spawn->m_Phase = COLLECTION_SPAWN_PHASE_DONE;
+        }
+
+        return spawn->m_Phase == COLLECTION_SPAWN_PHASE_DONE ? INCREMENTAL_RESULT_DONE : INCREMENTAL_RESULT_ERROR;
+    }
+
+    void DeleteCollectionSpawn(HCollectionSpawn spawn)
+    {
+        if (spawn->m_Phase != COLLECTION_SPAWN_PHASE_DONE && spawn->m_Phase != COLLECTION_SPAWN_PHASE_FAILED)
+        {
+            FailCollectionSpawn(spawn);
+        }
+        dmHashRelease64(&spawn->m_PrefixHashState);
+        delete spawn;
     }
 
     bool SpawnFromCollection(HCollection hcollection, HCollectionDesc collection_desc, InstancePropertyBuffers *property_buffers,
                              const Point3& position, const Quat& rotation, const Vector3& scale,
                              InstanceIdMap *instances)
     {
-        dmTransform::Transform transform;
-        transform.SetTranslation(Vector3(position));
-        transform.SetRotation(rotation);
-        transform.SetScale(scale);
-
-        bool success = CollectionSpawnFromDescInternal(hcollection->m_Collection, (dmGameObjectDDF::CollectionDesc*)collection_desc, property_buffers, instances, transform);
+        HCollectionSpawn spawn = NewCollectionSpawn(hcollection, collection_desc, property_buffers, position, rotation, scale, instances);
+        if (spawn == 0)
+            return false;
 
+        bool success = UpdateCollectionSpawn(spawn, 0, 0) == INCREMENTAL_RESULT_DONE;
+        DeleteCollectionSpawn(spawn);
         return success;
     }
 
@@ -1784,6 +2011,56 @@ namespace dmGameObject
         return InitCollection(hcollection->m_Collection);
     }
 
+    IncrementalResult InitIncremental(HCollection hcollection, uint64_t time_budget, uint32_t max_steps)
+    {
+        DM_PROFILE("InitIncremental");
+        Collection* collection = hcollection->m_Collection;
+        assert(collection->m_InUpdate == 0 && "Initializing instances during Update(.) is not permitted");
+
+        if (collection->m_Initialized)
+            return INCREMENTAL_RESULT_DONE;
+
+        IncrementalBudget budget(time_budget, max_steps);
+        if (!collection->m_Initializing)
+        {
+            // Update transform cache
+            UpdateTransforms(collection);
+            collection->m_Initializing = 1;
+            collection->m_InitFailed = 0;
+            collection->m_InitCursor = 0;
+            collection->m_InitCount = collection->m_InstanceIndices.Size();
+        }
+
+        uint32_t count = collection->m_InitCount;
+        while (collection->m_InitCursor < count)
+        {
+            Instance* instance = collection->m_Instances[collection->m_InitCursor++];
+            // Instances spawned by already initialized instances are initialized when spawned
+            if (instance && !instance->m_Initialized && !InitInstance(collection, instance))
+            {
+                collection->m_InitFailed = 1;
+            }
+            if (IsBudgetSpent(budget))
+                return INCREMENTAL_RESULT_PENDING;
+        }
+
+        bool result = !collection->m_InitFailed;
+        for (uint32_t i = 0; i < count; ++i) {
+            Instance* instance = collection->m_Instances[i];
+            // Spawned instances are already scheduled to be added to update
+            if (instance && !instance->m_ToBeAdded && !DoAddToUpdate(collection, instance)) {
+                result = false;
+            }
+        }
+        dmMessage::HSocket sockets[] = {collection->m_ComponentSocket, collection->m_FrameSocket};
+        if (!DispatchMessages(collection, sockets, 2))
+            result = false;
+
+        collection->m_Initializing = 0;
+        collection->m_Initialized = 1;
+        return result ? INCREMENTAL_RESULT_DONE : INCREMENTAL_RESULT_ERROR;
+    }
+
     static bool FinalComponents(Collection* collection, HInstance instance)
     {
         uint32_t next_component_instance_data = 0;
@@ -1852,6 +2129,7 @@ namespace dmGameObject
         }
 
         collection->m_Initialized = 0;
+        collection->m_Initializing = 0;
         return result;
     }
 
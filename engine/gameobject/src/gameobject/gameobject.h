@@ -138,7 +138,8 @@ namespace dmGameObject
      *
      * @param collection Gameobject collection to spawn into
      * @param collection_desc Description data of collections
-     * @param property_buffers Serialized property buffers hashtable (key: game object identifier, value: property buffer)
+     * @param property_buffers Serialized property buffers hashtable (key: game object identifier, value: property buffer).
+     *                         The buffers taken over by the created instances are removed, the remaining ones are owned by the caller
      * @param position Position for the root object
      * @param rotation Rotation for the root object
      * @param scale Scale of the root object
@@ -149,6 +150,63 @@ namespace dmGameObject
                              const Point3& position, const Quat& rotation, const Vector3& scale,
                              InstanceIdMap *instances);
 
+    /**
+     * Result of an operation that is spread over several frames
+     */
+    enum IncrementalResult
+    {
+        INCREMENTAL_RESULT_DONE    = 0,  //!< INCREMENTAL_RESULT_DONE
+        INCREMENTAL_RESULT_PENDING = 1,  //!< INCREMENTAL_RESULT_PENDING
+        INCREMENTAL_RESULT_ERROR   = -1, //!< INCREMENTAL_RESULT_ERROR
+    };
+
+    /**
+     * Handle to a collection that is being spawned over several frames
+     */
+    typedef struct CollectionSpawn* HCollectionSpawn;
+
+    /**
+     * Starts spawning a collection into an existing one, see SpawnFromCollection. No instances are
+     * created by this call, use UpdateCollectionSpawn to create them within a time budget.
+     * The instance identifier mapping is filled in up front, but the instances are not
+     * available until the spawn has completed.
+     *
+     * @note The collection_desc, property_buffers and instances must be kept alive until the spawn has been deleted.
+     *       The buffers taken over by the created instances are removed, the remaining ones are owned by the caller
+     *
+     * @param collection Gameobject collection to spawn into
+     * @param collection_desc Description data of collections
+     * @param property_buffers Serialized property buffers hashtable (key: game object identifier, value: property buffer)
+     * @param position Position for the root object
+     * @param rotation Rotation for the root object
+     * @param scale Scale of the root object
+     * @param instances Hash table to be filled with instance identifier mapping.
+     * @return handle to the spawn, or 0 if the collection could not be spawned
+     */
+    HCollectionSpawn NewCollectionSpawn(HCollection collection, HCollectionDesc collection_desc, InstancePropertyBuffers *property_buffers,
+                                        const Point3& position, const Quat& rotation, const Vector3& scale,
+                                        InstanceIdMap *instances);
+
+    /**
+     * Creates, initializes and adds to update the instances of a spawned collection, in the order of the
+     * collection description, until the time budget or the step limit is spent. At least one instance is
+     * processed per call.
+     * The instances are added to update in the same frame, once all of them have been initialized.
+     * On error, all instances created by the spawn are deleted and the instance mapping is cleared.
+     *
+     * @param spawn Collection spawn
+     * @param time_budget Time budget in microseconds. 0 means no budget
+     * @param max_steps Maximum number of instances to create or initialize. 0 means no limit
+     * @return INCREMENTAL_RESULT_PENDING if there is more work left
+     */
+    IncrementalResult UpdateCollectionSpawn(HCollectionSpawn spawn, uint64_t time_budget, uint32_t max_steps);
+
+    /**
+     * Deletes a collection spawn. If the spawn has not completed, the instances created so far are deleted.
+     * @param spawn Collection spawn
+     */
+    void DeleteCollectionSpawn(HCollectionSpawn spawn);
+
     /**
      * Delete all gameobject instances in the collection
      * @param collection Gameobject collection
@@ -197,6 +255,18 @@ namespace dmGameObject
      */
     bool Init(HCollection collection);
 
+    /**
+     * Initializes the game object instances in the supplied collection, in instance order, until the
+     * time budget or the step limit is spent. The instances are added to update once all of them have been initialized.
+     * Call repeatedly (once per frame) until it no longer returns INCREMENTAL_RESULT_PENDING.
+     * The collection must not be updated while being initialized.
+     * @param collection Game object collection
+     * @param time_budget Time budget in microseconds. 0 means no budget
+     * @param max_steps Maximum number of instances to initialize. 0 means no limit
+     * @return INCREMENTAL_RESULT_PENDING if there are instances left to initialize
+     */
+    IncrementalResult InitIncremental(HCollection collection, uint64_t time_budget, uint32_t max_steps);
+
     /**
      * Finalizes all game object instances in the supplied collection.
      * @param collection Game object collection
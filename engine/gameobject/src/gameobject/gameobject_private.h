@@ -289,6 +289,10 @@ namespace dmGameObject
 
         float                    m_FixedAccumTime;  // Accumulated time between fixed updates. Scaled time.
 
+        // Next instance index and instance count for InitIncremental
+        uint32_t                 m_InitCursor;
+        uint32_t                 m_InitCount;
+
         // Set to 1 if in update-loop
         uint32_t                 m_InUpdate : 1;
         // Used for deferred deletion
@@ -298,6 +302,9 @@ namespace dmGameObject
         uint32_t                 m_DirtyTransforms : 1;
         uint32_t                 m_Initialized : 1;
         uint32_t                 m_FirstUpdate : 1;
+        // Set to 1 while being initialized by InitIncremental
+        uint32_t                 m_Initializing : 1;
+        uint32_t                 m_InitFailed : 1;
     };
 
     struct CollectionHandle
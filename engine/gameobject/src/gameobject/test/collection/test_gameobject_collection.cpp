@@ -303,6 +303,122 @@ TEST_F(CollectionTest, CollectionSpawningToFail)
     ASSERT_TRUE(true);
 }
 
+TEST_F(CollectionTest, CollectionSpawningIncremental)
+{
+    // NOTE: Coll is local and not m_Collection in CollectionTest
+    dmGameObject::HCollection coll;
+
+    dmResource::Result r = dmResource::Get(m_Factory, "/empty.collectionc", (void**) &coll);
+    ASSERT_EQ(dmResource::RESULT_OK, r);
+    ASSERT_NE((void*) 0, coll);
+
+    dmGameObject::Init(coll);
+
+    void *msg;
+    uint32_t msg_size;
+    r = dmResource::GetRaw(m_Factory, "/root1.collectionc", &msg, &msg_size);
+    ASSERT_EQ(dmResource::RESULT_OK, r);
+
+    dmGameObjectDDF::CollectionDesc* desc;
+    dmDDF::Result e = dmDDF::LoadMessage<dmGameObjectDDF::CollectionDesc>(msg, msg_size, &desc);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+
+    dmVMath::Point3 pos(0,0,0);
+    dmVMath::Quat rot(0,0,0,1);
+    dmVMath::Vector3 scale(1,1,1);
+
+    for (int i=0;i!=4;i++)
+    {
+        dmGameObject::InstanceIdMap output;
+        dmGameObject::InstancePropertyBuffers props;
+
+        dmGameObject::HCollectionSpawn spawn = dmGameObject::NewCollectionSpawn(coll, desc, &props, pos, rot, scale, &output);
+        ASSERT_NE((dmGameObject::HCollectionSpawn) 0, spawn);
+        ASSERT_EQ(desc->m_Instances.m_Count, output.Size());
+
+        // The ids are reserved up front, but the instances are created over several steps
+        dmhash_t* go1_id = output.Get(dmHashString64("/go1"));
+        ASSERT_NE((dmhash_t*) 0, go1_id);
+
+        // One instance per step, each instance is first created and then initialized
+        uint32_t steps = 0;
+        dmGameObject::IncrementalResult result;
+        while ((result = dmGameObject::UpdateCollectionSpawn(spawn, 0, 1)) == dmGameObject::INCREMENTAL_RESULT_PENDING)
+        {
+            ++steps;
+            ASSERT_TRUE(dmGameObject::Update(coll, &m_UpdateContext));
+            ASSERT_LT(steps, 1000u);
+        }
+        ASSERT_EQ(dmGameObject::INCREMENTAL_RESULT_DONE, result);
+        ASSERT_EQ(2 * desc->m_Instances.m_Count, steps);
+        dmGameObject::DeleteCollectionSpawn(spawn);
+
+        ASSERT_NE((void*) 0, dmGameObject::GetInstanceFromIdentifier(coll, *go1_id));
+
+        ASSERT_TRUE(dmGameObject::Update(coll, &m_UpdateContext));
+    }
+
+    // Deleting a spawn before it is done removes the instances created so far
+    {
+        dmGameObject::InstanceIdMap output;
+        dmGameObject::InstancePropertyBuffers props;
+
+        dmGameObject::HCollectionSpawn spawn = dmGameObject::NewCollectionSpawn(coll, desc, &props, pos, rot, scale, &output);
+        ASSERT_NE((dmGameObject::HCollectionSpawn) 0, spawn);
+        ASSERT_EQ(dmGameObject::INCREMENTAL_RESULT_PENDING, dmGameObject::UpdateCollectionSpawn(spawn, 0, 1));
+        dmGameObject::DeleteCollectionSpawn(spawn);
+        ASSERT_EQ(0u, output.Size());
+
+        ASSERT_TRUE(dmGameObject::Update(coll, &m_UpdateContext));
+    }
+
+    dmDDF::FreeMessage(desc);
+    free(msg);
+
+    dmResource::Release(m_Factory, (void*) coll);
+    dmGameObject::PostUpdate(m_Register);
+}
+
+TEST_F(CollectionTest, CollectionInitIncremental)
+{
+    // NOTE: Coll is local and not m_Collection in CollectionTest
+    dmGameObject::HCollection coll;
+    dmResource::Result r = dmResource::Get(m_Factory, "/root1.collectionc", (void**) &coll);
+    ASSERT_EQ(dmResource::RESULT_OK, r);
+    ASSERT_NE((void*) 0, coll);
+
+    void *msg;
+    uint32_t msg_size;
+    r = dmResource::GetRaw(m_Factory, "/root1.collectionc", &msg, &msg_size);
+    ASSERT_EQ(dmResource::RESULT_OK, r);
+
+    dmGameObjectDDF::CollectionDesc* desc;
+    dmDDF::Result e = dmDDF::LoadMessage<dmGameObjectDDF::CollectionDesc>(msg, msg_size, &desc);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+    uint32_t instance_count = desc->m_Instances.m_Count;
+    dmDDF::FreeMessage(desc);
+    free(msg);
+
+    // One instance is initialized per step
+    uint32_t steps = 0;
+    dmGameObject::IncrementalResult result;
+    while ((result = dmGameObject::InitIncremental(coll, 0, 1)) == dmGameObject::INCREMENTAL_RESULT_PENDING)
+    {
+        ++steps;
+        ASSERT_LT(steps, 1000u);
+    }
+    ASSERT_EQ(dmGameObject::INCREMENTAL_RESULT_DONE, result);
+    ASSERT_EQ(instance_count, steps);
+
+    // Already initialized
+    ASSERT_EQ(dmGameObject::INCREMENTAL_RESULT_DONE, dmGameObject::InitIncremental(coll, 0, 1));
+
+    ASSERT_TRUE(dmGameObject::Update(coll, &m_UpdateContext));
+
+    dmResource::Release(m_Factory, (void*) coll);
+    dmGameObject::PostUpdate(m_Register);
+}
+
 TEST_F(CollectionTest, PostCollection)
 {
     for (int i = 0; i < 10; ++i)
@@ -31,6 +31,10 @@ namespace dmGameSystem
 
     // The same effect as sending the "init" message to the proxy
     dmGameObject::Result CompCollectionProxyInitialize(HCollectionProxyWorld world, HCollectionProxyComponent proxy);
+    // The same effect as sending the "async_init" message to the proxy
+    // time_budget: time in microseconds spent initializing instances each frame
+    // The callback is invoked when all instances have been initialized
+    dmGameObject::Result CompCollectionProxyInitializeAsync(HCollectionProxyWorld world, HCollectionProxyComponent proxy, uint32_t time_budget, ProxyLoadCallback cbk, void* cbk_ctx);
     // The same effect as sending the "finalize" message to the proxy
     dmGameObject::Result CompCollectionProxyFinalize(HCollectionProxyWorld world, HCollectionProxyComponent proxy);
     // The same effect as sending the "enable" message to the proxy
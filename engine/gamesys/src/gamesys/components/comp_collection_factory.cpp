@@ -25,6 +25,7 @@
 #include <dlib/profile.h>
 #include <gameobject/gameobject.h>
 #include <gameobject/gameobject_ddf.h>
+#include <dmsdk/gameobject/gameobject_props.h>
 #include <dmsdk/dlib/vmath.h>
 
 #include "../gamesys.h"
@@ -60,13 +61,67 @@ namespace dmGameSystem
         uint8_t                     m_AddedToUpdate : 1;
     };
 
+    // A collection being spawned over several frames, see collectionfactory.create_async
+    struct CollectionFactorySpawn
+    {
+        dmGameObject::HCollectionSpawn         m_Spawn;
+        CollectionFactoryComponent*            m_Component;
+        dmGameObject::InstanceIdMap            m_Instances;
+        dmGameObject::InstancePropertyBuffers  m_PropertyBuffers;
+        uint32_t                               m_TimeBudget;
+        int                                    m_CallbackRef;
+        int                                    m_SelfRef;
+        int                                    m_URLRef;
+        int                                    m_IdsRef;
+    };
+
     struct CollectionFactoryWorld
     {
         dmArray<CollectionFactoryComponent> m_Components;
         dmIndexPool32                       m_IndexPool;
         dmResource::HFactory                m_Factory;
+        // Pending spawns, in the order they were created
+        dmArray<CollectionFactorySpawn*>    m_Spawns;
     };
 
+    static void DestroyPropertyBuffer(void*, const dmhash_t*, dmGameObject::HPropertyContainer* value)
+    {
+        dmGameObject::PropertyContainerDestroy(*value);
+    }
+
+    // The containers are removed from the buffers as the instances take them over, the rest belong to the spawn
+    static void DestroyPropertyBuffers(dmGameObject::InstancePropertyBuffers* buffers)
+    {
+        buffers->Iterate(DestroyPropertyBuffer, (void*) 0);
+        buffers->Clear();
+    }
+
+    static void DeleteSpawn(lua_State* L, CollectionFactorySpawn* spawn)
+    {
+        dmGameObject::DeleteCollectionSpawn(spawn->m_Spawn);
+        DestroyPropertyBuffers(&spawn->m_PropertyBuffers);
+        dmScript::Unref(L, LUA_REGISTRYINDEX, spawn->m_CallbackRef);
+        dmScript::Unref(L, LUA_REGISTRYINDEX, spawn->m_SelfRef);
+        dmScript::Unref(L, LUA_REGISTRYINDEX, spawn->m_URLRef);
+        dmScript::Unref(L, LUA_REGISTRYINDEX, spawn->m_IdsRef);
+        delete spawn;
+    }
+
+    // Removes the spawns belonging to the component (or all if 0), keeping the order of the remaining ones
+    static void DeleteSpawns(lua_State* L, CollectionFactoryWorld* world, CollectionFactoryComponent* component)
+    {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < world->m_Spawns.Size(); ++i)
+        {
+            CollectionFactorySpawn* spawn = world->m_Spawns[i];
+            if (component == 0 || spawn->m_Component == component)
+                DeleteSpawn(L, spawn);
+            else
+                world->m_Spawns[count++] = spawn;
+        }
+        world->m_Spawns.SetSize(count);
+    }
+
     void CollectionFactoryComponent::Init()
     {
         memset(this, 0x0, sizeof(CollectionFactoryComponent));
@@ -84,6 +139,7 @@ namespace dmGameSystem
         world->m_Components.SetSize(max_component_count);
         world->m_IndexPool.SetCapacity(max_component_count);
         world->m_Factory = context->m_Factory;
+        world->m_Spawns.SetCapacity(4);
         for(uint32_t i = 0; i < max_component_count; ++i)
         {
             world->m_Components[i].Init();
@@ -94,7 +150,9 @@ namespace dmGameSystem
 
     dmGameObject::CreateResult CompCollectionFactoryDeleteWorld(const dmGameObject::ComponentDeleteWorldParams& params)
     {
-        delete (CollectionFactoryWorld*)params.m_World;
+        CollectionFactoryWorld* world = (CollectionFactoryWorld*)params.m_World;
+        DeleteSpawns(dmScript::GetLuaState(((CollectionFactoryContext*)params.m_Context)->m_ScriptContext), world, 0);
+        delete world;
         return dmGameObject::CREATE_RESULT_OK;
     }
 
@@ -122,7 +180,9 @@ namespace dmGameSystem
     {
         CollectionFactoryWorld* fw = (CollectionFactoryWorld*)params.m_World;
         CollectionFactoryComponent* fc = (CollectionFactoryComponent*)*params.m_UserData;
-        CleanupAsyncLoading(dmScript::GetLuaState(((CollectionFactoryContext*)params.m_Context)->m_ScriptContext), fc);
+        lua_State* L = dmScript::GetLuaState(((CollectionFactoryContext*)params.m_Context)->m_ScriptContext);
+        CleanupAsyncLoading(L, fc);
+        DeleteSpawns(L, fw, fc);
         uint32_t index = fc - &fw->m_Components[0];
         fc->m_Resource = 0x0;
         if (fc->m_CustomResource)
@@ -140,10 +200,66 @@ namespace dmGameSystem
         return dmGameObject::CREATE_RESULT_OK;
     }
 
+    static void SpawnComplete(lua_State* L, CollectionFactorySpawn* spawn, dmGameObject::IncrementalResult result)
+    {
+        // The complete function is optional
+        if (spawn->m_CallbackRef == LUA_NOREF)
+            return;
+
+        int top = lua_gettop(L);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, spawn->m_CallbackRef);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, spawn->m_SelfRef);
+        lua_pushvalue(L, -1);
+        dmScript::SetInstance(L);
+        if (!dmScript::IsInstanceValid(L))
+        {
+            lua_pop(L, 2);
+            dmLogError("Could not run collectionfactory.create_async complete callback because the instance has been deleted.");
+            assert(top == lua_gettop(L));
+            return;
+        }
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, spawn->m_URLRef);
+        if (result == dmGameObject::INCREMENTAL_RESULT_DONE)
+            lua_rawgeti(L, LUA_REGISTRYINDEX, spawn->m_IdsRef);
+        else
+            lua_newtable(L);
+        dmScript::PCall(L, 3, 0);
+        assert(top == lua_gettop(L));
+    }
+
+    static void UpdateSpawns(lua_State* L, CollectionFactoryWorld* world)
+    {
+        DM_PROFILE("UpdateSpawns");
+        // Callbacks might start new spawns, which are then also updated this frame
+        uint32_t i = 0;
+        while (i < world->m_Spawns.Size())
+        {
+            CollectionFactorySpawn* spawn = world->m_Spawns[i];
+            dmGameObject::IncrementalResult r = dmGameObject::UpdateCollectionSpawn(spawn->m_Spawn, spawn->m_TimeBudget, 0);
+            if (r == dmGameObject::INCREMENTAL_RESULT_PENDING)
+            {
+                ++i;
+                continue;
+            }
+
+            uint32_t count = world->m_Spawns.Size();
+            memmove(&world->m_Spawns[i], &world->m_Spawns[i+1], sizeof(CollectionFactorySpawn*) * (count - i - 1));
+            world->m_Spawns.SetSize(count - 1);
+
+            SpawnComplete(L, spawn, r);
+            DeleteSpawn(L, spawn);
+        }
+    }
+
     dmGameObject::UpdateResult CompCollectionFactoryUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
     {
         CollectionFactoryWorld* world = (CollectionFactoryWorld*)params.m_World;
         dmGameObject::UpdateResult result = dmGameObject::UPDATE_RESULT_OK;
+        if (!world->m_Spawns.Empty())
+        {
+            UpdateSpawns(dmScript::GetLuaState(((CollectionFactoryContext*)params.m_Context)->m_ScriptContext), world);
+        }
         for (uint32_t i = 0; i < world->m_Components.Size(); ++i)
         {
             CollectionFactoryComponent* component = &world->m_Components[i];
@@ -226,6 +342,52 @@ namespace dmGameSystem
         return true;
     }
 
+    static void CopyPropertyBuffer(dmGameObject::InstancePropertyBuffers* buffers, const dmhash_t* key, dmGameObject::HPropertyContainer* value)
+    {
+        buffers->Put(*key, *value);
+    }
+
+    const dmGameObject::InstanceIdMap* CompCollectionFactorySpawnAsync(CollectionFactoryWorld* world, CollectionFactoryComponent* component, dmGameObject::HCollection collection,
+                                         dmGameObject::InstancePropertyBuffers* property_buffers,
+                                         const dmVMath::Point3& position, const dmVMath::Quat& rotation, const dmVMath::Vector3& scale,
+                                         uint32_t time_budget, int callback_ref, int self_ref, int url_ref, int ids_ref)
+    {
+        CollectionFactorySpawn* spawn = new CollectionFactorySpawn;
+        spawn->m_Component = component;
+        spawn->m_PropertyBuffers.SetCapacity(8, dmMath::Max(property_buffers->Size(), 1U));
+        property_buffers->Iterate(CopyPropertyBuffer, &spawn->m_PropertyBuffers);
+        spawn->m_Spawn = dmGameObject::NewCollectionSpawn(collection, GetResource(component)->m_CollectionDesc, &spawn->m_PropertyBuffers,
+                                                          position, rotation, scale, &spawn->m_Instances);
+        if (spawn->m_Spawn == 0)
+        {
+            DestroyPropertyBuffers(&spawn->m_PropertyBuffers);
+            delete spawn;
+            return 0;
+        }
+
+        // At least one instance is created each frame
+        spawn->m_TimeBudget = dmMath::Max(time_budget, 1U);
+        spawn->m_CallbackRef = callback_ref;
+        spawn->m_SelfRef = self_ref;
+        spawn->m_URLRef = url_ref;
+        spawn->m_IdsRef = ids_ref;
+
+        if (world->m_Spawns.Full())
+            world->m_Spawns.OffsetCapacity(4);
+        world->m_Spawns.Push(spawn);
+        return &spawn->m_Instances;
+    }
+
+    bool CompCollectionFactoryIsSpawning(CollectionFactoryWorld* world, CollectionFactoryComponent* component)
+    {
+        for (uint32_t i = 0; i < world->m_Spawns.Size(); ++i)
+        {
+            if (world->m_Spawns[i]->m_Component == component)
+                return true;
+        }
+        return false;
+    }
+
     bool CompCollectionFactoryUnload(CollectionFactoryWorld* world, CollectionFactoryComponent* component)
     {
         if(!GetResource(component)->m_LoadDynamically)
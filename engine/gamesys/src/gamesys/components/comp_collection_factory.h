@@ -43,6 +43,18 @@ namespace dmGameSystem
     bool CompCollectionFactoryLoad(CollectionFactoryWorld* world, CollectionFactoryComponent* component, int callback_ref, int self_ref, int url_ref);
     bool CompCollectionFactoryUnload(CollectionFactoryWorld* world, CollectionFactoryComponent* component);
 
+    /**
+     * Starts spawning the collection of the factory over several frames. The callback is invoked with the
+     * instance id table (ids_ref) when done. Ownership of the property containers is always transferred,
+     * and ownership of the Lua references on success.
+     * @return the instance id mapping, valid until the next update, or 0 on failure
+     */
+    const dmGameObject::InstanceIdMap* CompCollectionFactorySpawnAsync(CollectionFactoryWorld* world, CollectionFactoryComponent* component, dmGameObject::HCollection collection,
+                                         dmGameObject::InstancePropertyBuffers* property_buffers,
+                                         const dmVMath::Point3& position, const dmVMath::Quat& rotation, const dmVMath::Vector3& scale,
+                                         uint32_t time_budget, int callback_ref, int self_ref, int url_ref, int ids_ref);
+    bool CompCollectionFactoryIsSpawning(CollectionFactoryWorld* world, CollectionFactoryComponent* component);
+
     /**
      * CompCollectionFactoryStatus
      */
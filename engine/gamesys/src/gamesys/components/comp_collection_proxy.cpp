@@ -62,6 +62,7 @@ namespace dmGameSystem
     static const dmhash_t COLLECTION_PROXY_FINAL_HASH = dmHashString64("final");
     static const dmhash_t COLLECTION_PROXY_LOADED_HASH = dmHashString64("proxy_loaded");
     static const dmhash_t COLLECTION_PROXY_UNLOADED_HASH = dmHashString64("proxy_unloaded");
+    static const dmhash_t COLLECTION_PROXY_INITIALIZED_HASH = dmHashString64("proxy_initialized");
 
     struct CollectionProxyComponent
     {
@@ -78,10 +79,15 @@ namespace dmGameSystem
         uint32_t                        m_DelayedEnable : 1;
         uint32_t                        m_Unloaded : 1;
         uint32_t                        m_AddedToUpdate : 1;
+        uint32_t                        m_Initializing : 1;
 
         dmResource::HPreloader          m_Preloader;
         dmMessage::URL                  m_LoadSender, m_LoadReceiver;
 
+        // Time budget (microseconds) per frame when initializing asynchronously
+        uint32_t                        m_InitBudget;
+        dmMessage::URL                  m_InitSender, m_InitReceiver;
+
         ProxyLoadCallback               m_Callback;
         void*                           m_CallbackCtx;
     };
@@ -124,6 +130,22 @@ namespace dmGameSystem
         }
     }
 
+    static void InitComplete(CollectionProxyComponent* proxy, dmGameObject::Result result)
+    {
+        if (proxy->m_Callback)
+        {
+            proxy->m_Callback(proxy->m_Resource->m_DDF->m_Collection, result, proxy->m_CallbackCtx);
+        }
+        else if (dmMessage::IsSocketValid(proxy->m_InitSender.m_Socket))
+        {
+            dmMessage::Result msg_result = dmMessage::Post(&proxy->m_InitReceiver, &proxy->m_InitSender, COLLECTION_PROXY_INITIALIZED_HASH, 0, 0, 0, 0, 0);
+            if (msg_result != dmMessage::RESULT_OK)
+            {
+                dmLogWarning("proxy_initialized could not be posted: %d", msg_result);
+            }
+        }
+    }
+
     void UnloadComplete(CollectionProxyComponent* proxy, dmGameObject::Result result)
     {
         proxy->m_Unloaded = 0;
@@ -251,9 +273,10 @@ namespace dmGameSystem
     dmGameObject::CreateResult CompCollectionProxyFinal(const dmGameObject::ComponentFinalParams& params)
     {
         CollectionProxyComponent* proxy = (CollectionProxyComponent*)*params.m_UserData;
-        if (proxy->m_Initialized)
+        if (proxy->m_Initialized || proxy->m_Initializing)
         {
             proxy->m_Initialized = 0;
+            proxy->m_Initializing = 0;
             dmGameObject::Final(proxy->m_Collection);
         }
         return dmGameObject::CREATE_RESULT_OK;
@@ -294,12 +317,24 @@ namespace dmGameSystem
             if (proxy->m_Collection != 0)
             {
                 DM_PROPERTY_ADD_U32(rmtp_CollectionProxyLoaded, 1);
+                if (proxy->m_Initializing)
+                {
+                    dmGameObject::IncrementalResult r = dmGameObject::InitIncremental(proxy->m_Collection, proxy->m_InitBudget, 0);
+                    if (r != dmGameObject::INCREMENTAL_RESULT_PENDING)
+                    {
+                        proxy->m_Initializing = 0;
+                        proxy->m_Initialized = 1;
+                        InitComplete(proxy, r == dmGameObject::INCREMENTAL_RESULT_DONE ? dmGameObject::RESULT_OK : dmGameObject::RESULT_UNKNOWN_ERROR);
+                    }
+                }
+
                 if (proxy->m_DelayedEnable != proxy->m_Enabled)
                 {
                     proxy->m_Enabled = proxy->m_DelayedEnable;
                 }
 
-                if (proxy->m_Enabled)
+                // The collection isn't updated until it has been completely initialized
+                if (proxy->m_Enabled && !proxy->m_Initializing)
                 {
                     DM_PROPERTY_ADD_U32(rmtp_CollectionProxyEnabled, 1);
                     dmGameObject::UpdateContext uc = *params.m_UpdateContext;
@@ -352,7 +387,7 @@ namespace dmGameSystem
         for (uint32_t i = 0; i < proxy_world->m_Components.Size(); ++i)
         {
             CollectionProxyComponent* proxy = &proxy_world->m_Components[i];
-            if (proxy->m_Collection != 0 && proxy->m_Enabled)
+            if (proxy->m_Collection != 0 && proxy->m_Enabled && !proxy->m_Initializing)
             {
                 if (!dmGameObject::Render(proxy->m_Collection))
                     result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
@@ -513,6 +548,7 @@ namespace dmGameSystem
         dmResource::Release(context->m_Factory, proxy->m_Collection);
         proxy->m_Collection = 0;
         proxy->m_Initialized = 0;
+        proxy->m_Initializing = 0;
         proxy->m_Enabled = 0;
         proxy->m_DelayedEnable = 0;
         proxy->m_Unloaded = 1;
@@ -540,7 +576,14 @@ namespace dmGameSystem
     {
         if (proxy->m_Collection != 0)
         {
-            if (proxy->m_Initialized == 0)
+            if (proxy->m_Initializing)
+            {
+                LogMessageError(message, "The collection %s could not be initialized since it is already being initialized.", proxy->m_Resource->m_DDF->m_Collection);
+                if (message)
+                    return dmGameObject::RESULT_OK; // The message code path doesn't catch errors
+                return dmGameObject::RESULT_UNKNOWN_ERROR;
+            }
+            else if (proxy->m_Initialized == 0)
             {
                 dmGameObject::Init(proxy->m_Collection);
                 proxy->m_Initialized = 1;
@@ -569,12 +612,57 @@ namespace dmGameSystem
         return CompCollectionProxyInitializeInternal(proxy, 0);
     }
 
+    static dmGameObject::Result CompCollectionProxyInitializeAsyncInternal(HCollectionProxyComponent proxy, uint32_t time_budget,
+                                                            ProxyLoadCallback cbk, void* cbk_ctx,
+                                                            dmMessage::URL* sender, dmMessage::URL* receiver,
+                                                            dmMessage::Message* message)
+    {
+        if (proxy->m_Collection == 0)
+        {
+            LogMessageError(message, "The collection %s could not be initialized since it has not been loaded.", proxy->m_Resource->m_DDF->m_Collection);
+            if (message)
+                return dmGameObject::RESULT_OK; // The message code path doesn't catch errors
+            return dmGameObject::RESULT_UNKNOWN_ERROR;
+        }
+        if (proxy->m_Initialized || proxy->m_Initializing)
+        {
+            LogMessageError(message, "The collection %s could not be initialized since it has been already.", proxy->m_Resource->m_DDF->m_Collection);
+            if (message)
+                return dmGameObject::RESULT_OK; // The message code path doesn't catch errors
+            return dmGameObject::RESULT_UNKNOWN_ERROR;
+        }
+
+        if (sender)
+            proxy->m_InitSender = *sender;
+        else
+            dmMessage::ResetURL(&proxy->m_InitSender);
+
+        if (receiver)
+            proxy->m_InitReceiver = *receiver;
+        else
+            dmMessage::ResetURL(&proxy->m_InitReceiver);
+
+        proxy->m_Callback = cbk;
+        proxy->m_CallbackCtx = cbk_ctx;
+        // At least one instance is initialized each frame
+        proxy->m_InitBudget = dmMath::Max(time_budget, 1U);
+        proxy->m_Initializing = 1;
+        return dmGameObject::RESULT_OK;
+    }
+
+    dmGameObject::Result CompCollectionProxyInitializeAsync(HCollectionProxyWorld world, HCollectionProxyComponent proxy, uint32_t time_budget, ProxyLoadCallback cbk, void* cbk_ctx)
+    {
+        (void)world;
+        return CompCollectionProxyInitializeAsyncInternal(proxy, time_budget, cbk, cbk_ctx, 0, 0, 0);
+    }
+
     static dmGameObject::Result CompCollectionProxyFinalizeInternal(HCollectionProxyComponent proxy, dmMessage::Message* message)
     {
-        if (proxy->m_Initialized == 1 && proxy->m_Collection != 0x0)
+        if ((proxy->m_Initialized == 1 || proxy->m_Initializing == 1) && proxy->m_Collection != 0x0)
         {
             dmGameObject::Final(proxy->m_Collection);
             proxy->m_Initialized = 0;
+            proxy->m_Initializing = 0;
         }
         else
         {
@@ -600,7 +688,8 @@ namespace dmGameSystem
             {
                 proxy->m_DelayedEnable = 1;
 
-                if (proxy->m_Initialized == 0)
+                // An asynchronous initialization is left to complete before the collection is updated
+                if (proxy->m_Initialized == 0 && proxy->m_Initializing == 0)
                 {
                     dmGameObject::Init(proxy->m_Collection);
                     proxy->m_Initialized = 1;
@@ -683,6 +772,14 @@ namespace dmGameSystem
             dmGameObject::Result r = CompCollectionProxyInitializeInternal(proxy, params.m_Message);
             return dmGameObject::RESULT_OK == r ? dmGameObject::UPDATE_RESULT_OK : dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
         }
+        else if ((dmDDF::Descriptor*)params.m_Message->m_Descriptor == dmGameSystemDDF::AsyncInit::m_DDFDescriptor)
+        {
+            dmGameSystemDDF::AsyncInit* ddf = (dmGameSystemDDF::AsyncInit*)params.m_Message->m_Data;
+            uint32_t time_budget = (uint32_t)(dmMath::Max(ddf->m_Budget, 0.0f) * 1000.0f);
+            dmGameObject::Result r = CompCollectionProxyInitializeAsyncInternal(proxy, time_budget, 0, 0,
+                                            &params.m_Message->m_Sender, &params.m_Message->m_Receiver, params.m_Message);
+            return dmGameObject::RESULT_OK == r ? dmGameObject::UPDATE_RESULT_OK : dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+        }
         else if (params.m_Message->m_Id == COLLECTION_PROXY_FINAL_HASH)
         {
             dmGameObject::Result r = CompCollectionProxyFinalizeInternal(proxy, params.m_Message);
@@ -847,6 +944,45 @@ namespace dmGameSystem
      * ```
      */
 
+    /*# tells a collection proxy to initialize the loaded collection over several frames
+     * Post this message to a collection-proxy-component to initialize the game objects and components in the referenced
+     * collection, spending at most `budget` milliseconds each frame. At least one game object is initialized each frame.
+     * When all game objects have been initialized, the message [ref:proxy_initialized] will be sent back to the script.
+     *
+     * The collection is not updated or drawn until it has been completely initialized, even if it has been enabled.
+     *
+     * @message
+     * @name async_init
+     * @param budget [type:number] the time, in milliseconds, to spend initializing game objects each frame (default 2)
+     * @examples
+     *
+     * In this example we use a collection proxy to load a large level without a frame hitch.
+     *
+     * The example assume the script belongs to an instance with collection-proxy-component with id "proxy".
+     *
+     * ```lua
+     * function on_message(self, message_id, message, sender)
+     *     if message_id == hash("load_level") then
+     *         msg.post("#proxy", "async_load")
+     *     elseif message_id == hash("proxy_loaded") then
+     *         -- spend at most 4 milliseconds per frame initializing the level
+     *         msg.post(sender, "async_init", { budget = 4 })
+     *     elseif message_id == hash("proxy_initialized") then
+     *         msg.post(sender, "enable")
+     *     end
+     * end
+     * ```
+     */
+
+    /*# reports that a collection proxy has initialized its referenced collection
+     *
+     * This message is sent back to the script that posted [ref:async_init] to a collection proxy when all
+     * game objects in the referenced collection have been initialized. See documentation for [ref:async_init] for examples how to use.
+     *
+     * @message
+     * @name proxy_initialized
+     */
+
     /*# tells a collection proxy to enable the referenced collection
      * Post this message to a collection-proxy-component to enable the referenced collection, which in turn enables the contained game objects and components.
      * If the referenced collection was not initialized prior to this call, it will automatically be initialized.
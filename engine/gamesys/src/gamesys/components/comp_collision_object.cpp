@@ -34,6 +34,7 @@
 #include "../resources/res_collision_object.h"
 #include "../resources/res_textureset.h"
 #include "../resources/res_tilegrid.h"
+#include "comp_tilegrid.h" // TileTransformMask
 
 #include <gamesys/atlas_ddf.h>
 #include <gamesys/texture_set_ddf.h>
@@ -1171,6 +1172,41 @@ namespace dmGameSystem
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
+    // Sets the hull of a tile grid cell, and the collision filter of its child shape
+    static bool SetGridShapeCellHull(CollisionWorld* world, CollisionComponent* component, uint32_t shape, uint32_t row, uint32_t column, uint32_t hull, const dmPhysics::HullFlags& flags)
+    {
+        TileGridResource* tile_grid_resource = component->m_Resource->m_TileGridResource;
+
+        if (row >= tile_grid_resource->m_RowCount || column >= tile_grid_resource->m_ColumnCount)
+        {
+            dmLogError("SetGridShapeHull: <row,column> out of bounds");
+            return false;
+        }
+        if (hull != ~0u && hull >= tile_grid_resource->m_TextureSet->m_HullCollisionGroups.Size())
+        {
+            dmLogError("SetGridShapHull: specified hull index is out of bounds.");
+            return false;
+        }
+
+        bool success = dmPhysics::SetGridShapeHull(component->m_Object2D, shape, row, column, hull, flags);
+        if (!success)
+        {
+            dmLogError("SetGridShapeHull: unable to set hull %d for shape %d", hull, shape);
+            return false;
+        }
+        uint16_t child = column + tile_grid_resource->m_ColumnCount * row;
+        uint16_t group = 0;
+        uint16_t mask = 0;
+        // Hull-index of 0xffffffff is empty cell
+        if (hull != ~0u)
+        {
+            group = GetGroupBitIndex(world, tile_grid_resource->m_TextureSet->m_HullCollisionGroups[hull], false);
+            mask = component->m_Mask;
+        }
+        dmPhysics::SetCollisionObjectFilter(component->m_Object2D, shape, child, group, mask);
+        return true;
+    }
+
     dmGameObject::UpdateResult CompCollisionObjectOnMessage(const dmGameObject::ComponentOnMessageParams& params)
     {
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
@@ -1252,43 +1288,52 @@ namespace dmGameSystem
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
             dmPhysicsDDF::SetGridShapeHull* ddf = (dmPhysicsDDF::SetGridShapeHull*) params.m_Message->m_Data;
-            uint32_t column = ddf->m_Column;
-            uint32_t row = ddf->m_Row;
-            uint32_t hull = ddf->m_Hull;
-
-            TileGridResource* tile_grid_resource = component->m_Resource->m_TileGridResource;
-
-            if (row >= tile_grid_resource->m_RowCount || column >= tile_grid_resource->m_ColumnCount)
+            dmPhysics::HullFlags flags;
+            flags.m_FlipHorizontal = ddf->m_FlipHorizontal;
+            flags.m_FlipVertical = ddf->m_FlipVertical;
+            flags.m_Rotate90 = ddf->m_Rotate90;
+            if (!SetGridShapeCellHull((CollisionWorld*)params.m_World, component, ddf->m_Shape, ddf->m_Row, ddf->m_Column, ddf->m_Hull, flags))
+            {
+                return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+            }
+        }
+        else if (params.m_Message->m_Id == dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_NameHash)
+        {
+            if (physics_context->m_3D)
             {
-                dmLogError("SetGridShapeHull: <row,column> out of bounds");
+                dmLogError("Grid shape hulls can only be set for 2D physics.");
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-            if (hull != ~0u && hull >= tile_grid_resource->m_TextureSet->m_HullCollisionGroups.Size())
+            if (component->m_Resource->m_TileGrid == 0)
             {
-                dmLogError("SetGridShapHull: specified hull index is out of bounds.");
+                dmLogError("Hulls can only be set for collision objects with tile grids as shape.");
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-
-            dmPhysics::HullFlags flags;
-            flags.m_FlipHorizontal = ddf->m_FlipHorizontal;
-            flags.m_FlipVertical = ddf->m_FlipVertical;
-            flags.m_Rotate90 = ddf->m_Rotate90;
-            bool success = dmPhysics::SetGridShapeHull(component->m_Object2D, ddf->m_Shape, row, column, hull, flags);
-            if (!success)
+            dmPhysicsDDF::SetGridShapeHulls* ddf = (dmPhysicsDDF::SetGridShapeHulls*) params.m_Message->m_Data;
+            TileGridResource* tile_grid_resource = component->m_Resource->m_TileGridResource;
+            if (ddf->m_Row + ddf->m_Height > tile_grid_resource->m_RowCount || ddf->m_Column + ddf->m_Width > tile_grid_resource->m_ColumnCount)
             {
-                dmLogError("SetGridShapeHull: unable to set hull %d for shape %d", hull, ddf->m_Shape);
+                dmLogError("SetGridShapeHulls: <row,column> out of bounds");
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-            uint16_t child = column + tile_grid_resource->m_ColumnCount * row;
-            uint16_t group = 0;
-            uint16_t mask = 0;
-            // Hull-index of 0xffffffff is empty cell
-            if (hull != ~0u)
+
+            const uint32_t* hulls = (const uint32_t*) ddf->m_Hulls;
+            const uint8_t* transforms = (const uint8_t*) ddf->m_Transforms;
+            for (uint32_t y = 0; y < ddf->m_Height; ++y)
             {
-                group = GetGroupBitIndex((CollisionWorld*)params.m_World, tile_grid_resource->m_TextureSet->m_HullCollisionGroups[hull], false);
-                mask = component->m_Mask;
+                for (uint32_t x = 0; x < ddf->m_Width; ++x)
+                {
+                    uint32_t i = x + y * ddf->m_Width;
+                    dmPhysics::HullFlags flags;
+                    flags.m_FlipHorizontal = (transforms[i] & FLIP_HORIZONTAL) != 0;
+                    flags.m_FlipVertical = (transforms[i] & FLIP_VERTICAL) != 0;
+                    flags.m_Rotate90 = (transforms[i] & ROTATE_90) != 0;
+                    if (!SetGridShapeCellHull((CollisionWorld*)params.m_World, component, ddf->m_Shape, ddf->m_Row + y, ddf->m_Column + x, hulls[i], flags))
+                    {
+                        return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+                    }
+                }
             }
-            dmPhysics::SetCollisionObjectFilter(component->m_Object2D, ddf->m_Shape, child, group, mask);
         }
         else if(params.m_Message->m_Id == dmPhysicsDDF::EnableGridShapeLayer::m_DDFDescriptor->m_NameHash)
         {
@@ -1481,6 +1526,19 @@ namespace dmGameSystem
         }
     }
 
+    void RayCastBatch(void* _world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses, dmJobThread::HContext job_thread)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::RayCastBatch3D(world->m_World3D, requests, count, responses, job_thread);
+        }
+        else
+        {
+            dmPhysics::RayCastBatch2D(world->m_World2D, requests, count, responses, job_thread);
+        }
+    }
+
     // Find a JointEntry in the linked list of a collision component based on the joint id.
     static JointEntry* FindJointEntry(CollisionWorld* world, CollisionComponent* component, dmhash_t id)
     {
@@ -53,6 +53,7 @@
 
 DM_PROPERTY_EXTERN(rmtp_Gui);
 DM_PROPERTY_U32(rmtp_GuiVertexCount, 0, FrameReset, "#", &rmtp_Gui);
+DM_PROPERTY_U32(rmtp_GuiBatchesReused, 0, FrameReset, "# box/pie batches not regenerated", &rmtp_Gui);
 
 namespace dmGameSystem
 {
@@ -61,6 +62,8 @@ namespace dmGameSystem
     static CompGuiNodeTypeDescriptor g_CompGuiNodeTypeSentinel = {0};
     static bool g_CompGuiNodeTypesInitialized = false;
 
+    static const dmhash_t GUI_TRANSIENT_CATEGORY = dmHashString64("gui");
+
     static dmGui::FetchTextureSetAnimResult FetchTextureSetAnimCallback(dmGui::HTextureSource, dmhash_t, dmGui::TextureSetAnimDesc*);
 
     // implemention in comp_particlefx.cpp
@@ -193,7 +196,9 @@ namespace dmGameSystem
 
         // Grows automatically
         gui_world->m_ClientVertexBuffer.SetCapacity(512);
-        gui_world->m_VertexBuffer = dmGraphics::NewVertexBuffer(graphics_context, 0, 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        gui_world->m_ClientVerticesUploaded = 0;
+        gui_world->m_RenderObjectsUploaded = 0;
+        gui_world->m_BatchesReused = 0;
 
         uint8_t white_texture[] = { 0xff, 0xff, 0xff, 0xff,
                                     0xff, 0xff, 0xff, 0xff,
@@ -277,7 +282,6 @@ namespace dmGameSystem
         }
 
         dmGraphics::DeleteVertexDeclaration(gui_world->m_VertexDeclaration);
-        dmGraphics::DeleteVertexBuffer(gui_world->m_VertexBuffer);
         dmGraphics::DeleteTexture(gui_world->m_WhiteTexture);
 
         dmScript::DeleteScriptWorld(gui_world->m_ScriptWorld);
@@ -878,6 +882,12 @@ namespace dmGameSystem
 
         // true if the stencil is the first rendered (per scene)
         bool                        m_FirstStencil;
+
+        // The component being rendered, the index of its next box or pie batch, and if any batch
+        // was generated instead of reused
+        GuiComponent*               m_Component;
+        uint32_t                    m_BatchIndex;
+        bool                        m_BatchCacheChanged;
     };
 
     inline uint32_t MakeFinalRenderOrder(uint32_t scene_order, uint32_t sub_order)
@@ -1134,7 +1144,6 @@ namespace dmGameSystem
 
         ro.Init();
         ro.m_VertexDeclaration = gui_world->m_VertexDeclaration;
-        ro.m_VertexBuffer      = gui_world->m_VertexBuffer;
         ro.m_PrimitiveType     = dmGraphics::PRIMITIVE_TRIANGLES;
         ro.m_VertexStart       = gui_world->m_ClientVertexBuffer.Size();
         ro.m_Material          = GetNodeMaterial(gui_context, scene, first_node);
@@ -1322,7 +1331,6 @@ namespace dmGameSystem
 
         ro.Init();
         ro.m_VertexDeclaration = gui_world->m_VertexDeclaration;
-        ro.m_VertexBuffer      = gui_world->m_VertexBuffer;
         ro.m_PrimitiveType     = dmGraphics::PRIMITIVE_TRIANGLES;
         ro.m_VertexStart       = vertex_start;
         ro.m_VertexCount       = vertex_count;
@@ -1343,6 +1351,142 @@ namespace dmGameSystem
         }
     }
 
+    // Hashes the node state that box and pie vertices are generated from
+    static void HashNodeVertexState(HashState64* state, dmGui::HScene scene, dmGui::HNode node, const Matrix4& transform, float opacity)
+    {
+        dmHashUpdateBuffer64(state, &node, sizeof(node));
+        dmHashUpdateBuffer64(state, &transform, sizeof(transform));
+        dmHashUpdateBuffer64(state, &opacity, sizeof(opacity));
+
+        Vector4 color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
+        Vector4 size = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_SIZE);
+        Vector4 slice9 = dmGui::GetNodeSlice9(scene, node);
+        dmHashUpdateBuffer64(state, &color, sizeof(color));
+        dmHashUpdateBuffer64(state, &size, sizeof(size));
+        dmHashUpdateBuffer64(state, &slice9, sizeof(slice9));
+
+        const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
+        if (tc)
+        {
+            bool flip[2];
+            dmGui::GetNodeFlipbookAnimUVFlip(scene, node, flip[0], flip[1]);
+            dmHashUpdateBuffer64(state, tc, sizeof(float) * 6);
+            dmHashUpdateBuffer64(state, flip, sizeof(flip));
+        }
+
+        dmGameSystemDDF::TextureSet* texture_set_ddf = GetNodeTextureSetDDF(scene, node);
+        if (texture_set_ddf)
+        {
+            int32_t frame = dmGui::GetNodeAnimationFrame(scene, node);
+            dmHashUpdateBuffer64(state, &texture_set_ddf, sizeof(texture_set_ddf));
+            dmHashUpdateBuffer64(state, &frame, sizeof(frame));
+        }
+    }
+
+    static uint64_t HashBatch(dmGui::HScene scene,
+                        dmGui::NodeType node_type,
+                        const dmGui::RenderEntry* entries,
+                        const Matrix4* node_transforms,
+                        const float* node_opacities,
+                        uint32_t node_count,
+                        dmGraphics::HTexture texture)
+    {
+        HashState64 state;
+        dmHashInit64(&state, false);
+        uint32_t texture_size[2] = { dmGraphics::GetOriginalTextureWidth(texture), dmGraphics::GetOriginalTextureHeight(texture) };
+        dmHashUpdateBuffer64(&state, &node_type, sizeof(node_type));
+        dmHashUpdateBuffer64(&state, &texture, sizeof(texture));
+        dmHashUpdateBuffer64(&state, texture_size, sizeof(texture_size));
+        for (uint32_t i = 0; i < node_count; ++i)
+        {
+            dmGui::HNode node = entries[i].m_Node;
+            HashNodeVertexState(&state, scene, node, node_transforms[i], node_opacities[i]);
+            if (node_type == dmGui::NODE_TYPE_PIE)
+            {
+                float pie[2] = { dmGui::GetNodeInnerRadius(scene, node), dmGui::GetNodePieFillAngle(scene, node) };
+                uint32_t pie_config[2] = { dmGui::GetNodePerimeterVertices(scene, node), (uint32_t)dmGui::GetNodeOuterBounds(scene, node) };
+                dmHashUpdateBuffer64(&state, pie, sizeof(pie));
+                dmHashUpdateBuffer64(&state, pie_config, sizeof(pie_config));
+            }
+        }
+        return dmHashFinal64(&state);
+    }
+
+    // If the batch at the current index rendered the same state last frame, copies its vertices
+    // to the vertex buffer and returns true
+    static bool ReuseBatch(RenderGuiContext* gui_context, uint64_t hash, dmRender::RenderObject& ro)
+    {
+        GuiWorld* gui_world = gui_context->m_GuiWorld;
+        GuiComponent* component = gui_context->m_Component;
+        uint32_t index = gui_context->m_BatchIndex;
+        if (index >= component->m_BatchCache.Size() || component->m_BatchCache[index].m_Hash != hash)
+            return false;
+
+        GuiBatchCache& batch = component->m_BatchCache[index];
+        const BoxVertex* vertices = component->m_BatchVertices.Begin() + batch.m_VertexStart;
+        if (gui_world->m_ClientVertexBuffer.Remaining() < batch.m_VertexCount) {
+            gui_world->m_ClientVertexBuffer.OffsetCapacity(dmMath::Max(128U, batch.m_VertexCount));
+        }
+        gui_world->m_ClientVertexBuffer.PushArray(vertices, batch.m_VertexCount);
+
+        batch.m_ClientVertexStart = ro.m_VertexStart;
+        ro.m_VertexCount = batch.m_VertexCount;
+        gui_context->m_BatchIndex++;
+        gui_world->m_BatchesReused++;
+        return true;
+    }
+
+    // Records the vertices generated for the batch at the current index, to be reused next frame
+    // (see UpdateBatchCache())
+    static void CacheBatch(RenderGuiContext* gui_context, uint64_t hash, const dmRender::RenderObject& ro)
+    {
+        GuiComponent* component = gui_context->m_Component;
+        uint32_t index = gui_context->m_BatchIndex++;
+        if (index >= component->m_BatchCache.Size())
+        {
+            if (component->m_BatchCache.Full()) {
+                component->m_BatchCache.OffsetCapacity(16);
+            }
+            component->m_BatchCache.SetSize(index + 1);
+        }
+
+        GuiBatchCache& batch = component->m_BatchCache[index];
+        batch.m_Hash              = hash;
+        batch.m_VertexCount       = ro.m_VertexCount;
+        batch.m_ClientVertexStart = ro.m_VertexStart;
+        gui_context->m_BatchCacheChanged = true;
+    }
+
+    // Makes the batches rendered this frame the ones to reuse next frame. When every batch was reused,
+    // the cached vertices are already up to date and nothing is copied.
+    static void UpdateBatchCache(GuiWorld* gui_world, GuiComponent* component, uint32_t batch_count, bool changed)
+    {
+        if (!changed && batch_count == component->m_BatchCache.Size())
+            return;
+
+        component->m_BatchCache.SetSize(batch_count);
+
+        uint32_t vertex_count = 0;
+        for (uint32_t i = 0; i < batch_count; ++i)
+        {
+            vertex_count += component->m_BatchCache[i].m_VertexCount;
+        }
+        if (component->m_BatchVertices.Capacity() < vertex_count) {
+            component->m_BatchVertices.SetCapacity(vertex_count);
+        }
+        component->m_BatchVertices.SetSize(vertex_count);
+
+        // The vertices of all batches are still in the client vertex buffer
+        uint32_t vertex_start = 0;
+        for (uint32_t i = 0; i < batch_count; ++i)
+        {
+            GuiBatchCache& batch = component->m_BatchCache[i];
+            memcpy(component->m_BatchVertices.Begin() + vertex_start, gui_world->m_ClientVertexBuffer.Begin() + batch.m_ClientVertexStart, batch.m_VertexCount * sizeof(BoxVertex));
+            batch.m_VertexStart = vertex_start;
+            vertex_start += batch.m_VertexCount;
+        }
+    }
+
     static void RenderBoxNodes(dmGui::HScene scene,
                         const dmGui::RenderEntry* entries,
                         const Matrix4* node_transforms,
@@ -1377,7 +1521,6 @@ namespace dmGameSystem
         SetBlendMode(ro, blend_mode);
         ro.m_SetBlendFactors   = 1;
         ro.m_VertexDeclaration = gui_world->m_VertexDeclaration;
-        ro.m_VertexBuffer      = gui_world->m_VertexBuffer;
         ro.m_PrimitiveType     = dmGraphics::PRIMITIVE_TRIANGLES;
         ro.m_VertexStart       = gui_world->m_ClientVertexBuffer.Size();
         ro.m_Material          = GetNodeMaterial(gui_context, scene, first_node);
@@ -1389,6 +1532,10 @@ namespace dmGameSystem
         else
             ro.m_Textures[0] = gui_world->m_WhiteTexture;
 
+        uint64_t batch_hash = HashBatch(scene, node_type, entries, node_transforms, node_opacities, node_count, ro.m_Textures[0]);
+        if (ReuseBatch(gui_context, batch_hash, ro))
+            return;
+
         if (gui_world->m_ClientVertexBuffer.Remaining() < (max_total_vertices)) {
             gui_world->m_ClientVertexBuffer.OffsetCapacity(dmMath::Max(128U, max_total_vertices));
         }
@@ -1644,6 +1791,7 @@ namespace dmGameSystem
         }
 
         ro.m_VertexCount = rendered_vert_count;
+        CacheBatch(gui_context, batch_hash, ro);
     }
 
     // Computes max vertices required in the vertex buffer to draw a pie node with a
@@ -1693,7 +1841,6 @@ namespace dmGameSystem
         SetBlendMode(ro, blend_mode);
         ro.m_SetBlendFactors   = 1;
         ro.m_VertexDeclaration = gui_world->m_VertexDeclaration;
-        ro.m_VertexBuffer      = gui_world->m_VertexBuffer;
         ro.m_PrimitiveType     = dmGraphics::PRIMITIVE_TRIANGLE_STRIP;
         ro.m_VertexStart       = gui_world->m_ClientVertexBuffer.Size();
         ro.m_VertexCount       = 0;
@@ -1706,6 +1853,10 @@ namespace dmGameSystem
         else
             ro.m_Textures[0] = gui_world->m_WhiteTexture;
 
+        uint64_t batch_hash = HashBatch(scene, node_type, entries, node_transforms, node_opacities, node_count, ro.m_Textures[0]);
+        if (ReuseBatch(gui_context, batch_hash, ro))
+            return;
+
         uint32_t max_total_vertices = 0;
         for (uint32_t i = 0; i < node_count; ++i)
         {
@@ -1870,6 +2021,7 @@ namespace dmGameSystem
         }
 
         ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
+        CacheBatch(gui_context, batch_hash, ro);
     }
 
     static uint64_t GetCombinedNodeType(uint32_t node_type, uint32_t custom_type)
@@ -1893,6 +2045,33 @@ namespace dmGameSystem
         return *type;
     }
 
+    // Copies the vertices generated since the last upload into the shared transient vertex buffer,
+    // and points the render objects to their new location
+    static void UploadVertices(GuiWorld* gui_world, dmRender::HRenderContext render_context)
+    {
+        uint32_t vertex_count = gui_world->m_ClientVertexBuffer.Size() - gui_world->m_ClientVerticesUploaded;
+        if (gui_world->m_RenderObjectsUploaded < gui_world->m_GuiRenderObjects.Size())
+        {
+            dmRender::HRenderBuffer vertex_buffer;
+            uint32_t vertex_buffer_offset;
+            void* dst = dmRender::AllocTransientBuffer(render_context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, vertex_count * sizeof(BoxVertex), sizeof(BoxVertex), GUI_TRANSIENT_CATEGORY, &vertex_buffer, &vertex_buffer_offset);
+            memcpy(dst, gui_world->m_ClientVertexBuffer.Begin() + gui_world->m_ClientVerticesUploaded, vertex_count * sizeof(BoxVertex));
+
+            uint32_t vertex_start = vertex_buffer_offset / sizeof(BoxVertex);
+            for (uint32_t i = gui_world->m_RenderObjectsUploaded; i < gui_world->m_GuiRenderObjects.Size(); ++i)
+            {
+                dmRender::RenderObject& ro = gui_world->m_GuiRenderObjects[i].m_RenderObject;
+                ro.m_VertexBuffer = (dmGraphics::HVertexBuffer) vertex_buffer;
+                ro.m_VertexStart  = ro.m_VertexStart - gui_world->m_ClientVerticesUploaded + vertex_start;
+            }
+        }
+
+        DM_PROPERTY_ADD_U32(rmtp_GuiVertexCount, vertex_count);
+
+        gui_world->m_ClientVerticesUploaded = gui_world->m_ClientVertexBuffer.Size();
+        gui_world->m_RenderObjectsUploaded  = gui_world->m_GuiRenderObjects.Size();
+    }
+
     // Called from gui.cpp
     static void RenderNodes(dmGui::HScene scene,
                     const dmGui::RenderEntry* entries,
@@ -2044,12 +2223,7 @@ namespace dmGameSystem
             }
         }
 
-        dmGraphics::SetVertexBufferData(gui_world->m_VertexBuffer,
-                                        gui_world->m_ClientVertexBuffer.Size() * sizeof(BoxVertex),
-                                        gui_world->m_ClientVertexBuffer.Begin(),
-                                        dmGraphics::BUFFER_USAGE_STREAM_DRAW);
-
-        DM_PROPERTY_ADD_U32(rmtp_GuiVertexCount, gui_world->m_ClientVertexBuffer.Size());
+        UploadVertices(gui_world, gui_context->m_RenderContext);
     }
 
     static dmGraphics::TextureFormat ToGraphicsFormat(dmImage::Type type) {
@@ -2312,6 +2486,9 @@ namespace dmGameSystem
 
         gui_world->m_GuiRenderObjects.SetSize(0);
         gui_world->m_ClientVertexBuffer.SetSize(0);
+        gui_world->m_ClientVerticesUploaded = 0;
+        gui_world->m_RenderObjectsUploaded = 0;
+        gui_world->m_BatchesReused = 0;
 
         uint32_t lastEnd = 0;
 
@@ -2323,7 +2500,11 @@ namespace dmGameSystem
 
             // Render scene and see how many render objects it added, then we add those individually.
             render_gui_context.m_Material = GetMaterial(c, c->m_Resource);
+            render_gui_context.m_Component = c;
+            render_gui_context.m_BatchIndex = 0;
+            render_gui_context.m_BatchCacheChanged = false;
             dmGui::RenderScene(c->m_Scene, rp, &render_gui_context);
+            UpdateBatchCache(gui_world, c, render_gui_context.m_BatchIndex, render_gui_context.m_BatchCacheChanged);
             const uint32_t count = gui_world->m_GuiRenderObjects.Size() - lastEnd;
 
             dmRender::RenderListEntry* render_list = dmRender::RenderListAlloc(gui_context->m_RenderContext, count);
@@ -2348,6 +2529,8 @@ namespace dmGameSystem
             dmRender::RenderListSubmit(gui_context->m_RenderContext, render_list, write_ptr);
         }
 
+        DM_PROPERTY_ADD_U32(rmtp_GuiBatchesReused, gui_world->m_BatchesReused);
+
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
@@ -31,21 +31,6 @@ namespace dmGameSystem
     struct GuiSceneResource;
     struct MaterialResource;
 
-    struct GuiComponent
-    {
-        struct GuiWorld*        m_World;
-        GuiSceneResource*       m_Resource;
-        dmGui::HScene           m_Scene;
-        dmGameObject::HInstance m_Instance;
-        MaterialResource*       m_Material;
-        uint16_t                m_ComponentIndex;
-        uint8_t                 m_Enabled       : 1;
-        uint8_t                 m_AddedToUpdate : 1;
-        uint8_t                 m_Initialized   : 1;
-        uint8_t                 m_Padding       : 5;
-        dmArray<void*>          m_ResourcePropertyPointers;
-    };
-
     struct BoxVertex
     {
         inline BoxVertex() {}
@@ -89,6 +74,33 @@ namespace dmGameSystem
         float m_PageIndex;
     };
 
+    // A box or pie batch rendered in the previous frame. While the hash of the batch state is
+    // unchanged, its vertices are copied from the component's retained vertices instead of being regenerated.
+    struct GuiBatchCache
+    {
+        uint64_t m_Hash;
+        uint32_t m_VertexStart;         // Offset into GuiComponent::m_BatchVertices
+        uint32_t m_VertexCount;
+        uint32_t m_ClientVertexStart;   // Offset into GuiWorld::m_ClientVertexBuffer this frame
+    };
+
+    struct GuiComponent
+    {
+        struct GuiWorld*        m_World;
+        GuiSceneResource*       m_Resource;
+        dmGui::HScene           m_Scene;
+        dmGameObject::HInstance m_Instance;
+        MaterialResource*       m_Material;
+        uint16_t                m_ComponentIndex;
+        uint8_t                 m_Enabled       : 1;
+        uint8_t                 m_AddedToUpdate : 1;
+        uint8_t                 m_Initialized   : 1;
+        uint8_t                 m_Padding       : 5;
+        dmArray<void*>          m_ResourcePropertyPointers;
+        dmArray<GuiBatchCache>  m_BatchCache;           // Box and pie batches, in render order
+        dmArray<BoxVertex>      m_BatchVertices;        // Vertices of the cached batches
+    };
+
     struct GuiRenderObject
     {
         dmRender::RenderObject m_RenderObject;
@@ -134,11 +146,13 @@ namespace dmGameSystem
         dmArray<HComponentRenderConstants>       m_RenderConstants;
         dmArray<GuiComponent*>                   m_Components;
         dmGraphics::HVertexDeclaration           m_VertexDeclaration;
-        dmGraphics::HVertexBuffer                m_VertexBuffer;
         dmBuffer::StreamDeclaration*             m_BoxVertexStreamDeclaration;
         uint32_t                                 m_BoxVertexStreamDeclarationCount;
         uint32_t                                 m_BoxVertexStructSize;
         dmArray<BoxVertex>                       m_ClientVertexBuffer;
+        uint32_t                                 m_ClientVerticesUploaded;  // Vertices copied to the transient vertex buffer this frame
+        uint32_t                                 m_RenderObjectsUploaded;   // Render objects pointing to the transient vertex buffer
+        uint32_t                                 m_BatchesReused;           // Box and pie batches reusing last frame's vertices this frame
         dmGraphics::HTexture                     m_WhiteTexture;
         dmParticle::HParticleContext             m_ParticleContext;
         dmGraphics::VertexAttributeInfos         m_ParticleAttributeInfos;
@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include <float.h>
+#include <algorithm> // std::sort
 
 #include <dlib/array.h>
 #include <dlib/hash.h>
@@ -120,6 +121,12 @@ namespace dmGameSystem
         // Temporary scratch array for instances, only used during the creation phase of components
         dmArray<dmGameObject::HInstance> m_ScratchInstances;
         dmRig::HRigContext               m_RigContext;
+        // Instanced rendering of local space meshes. The declaration is only created if the context supports instancing.
+        dmGraphics::HVertexDeclaration   m_InstanceVertexDeclaration;
+        dmArray<dmGraphics::HVertexBuffer> m_InstanceBuffers;
+        dmArray<const MeshRenderItem*>   m_InstanceItems;
+        dmArray<Matrix4>                 m_InstanceTransforms;
+        uint32_t                         m_InstanceBufferCount;
         uint32_t                         m_MaxElementsVertices;
         uint32_t                         m_MaxBatchIndex;
     };
@@ -131,6 +138,8 @@ namespace dmGameSystem
     static const dmhash_t PROP_CURSOR = dmHashString64("cursor");
     static const dmhash_t PROP_PLAYBACK_RATE = dmHashString64("playback_rate");
 
+    static const dmhash_t INSTANCE_WORLD_MATRIX = dmHashString64("mtx_world");
+
     static const uint32_t MAX_TEXTURE_COUNT = dmRender::RenderObject::MAX_TEXTURE_COUNT;
 
     static void ResourceReloadedCallback(const dmResource::ResourceReloadedParams& params);
@@ -167,6 +176,17 @@ namespace dmGameSystem
 
         world->m_MaxBatchIndex = 0;
         world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, stream_declaration);
+        world->m_InstanceVertexDeclaration = 0;
+        world->m_InstanceBufferCount = 0;
+
+        if (dmGraphics::IsContextFeatureSupported(graphics_context, dmGraphics::CONTEXT_FEATURE_INSTANCING))
+        {
+            dmGraphics::HVertexStreamDeclaration instance_stream_declaration = dmGraphics::NewVertexStreamDeclaration(graphics_context);
+            dmGraphics::AddVertexStream(instance_stream_declaration, INSTANCE_WORLD_MATRIX, 16, dmGraphics::TYPE_FLOAT, false);
+            world->m_InstanceVertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, instance_stream_declaration);
+            dmGraphics::SetVertexDeclarationStepFunction(graphics_context, world->m_InstanceVertexDeclaration, dmGraphics::VERTEX_STEP_FUNCTION_INSTANCE);
+            dmGraphics::DeleteVertexStreamDeclaration(instance_stream_declaration);
+        }
         world->m_MaxElementsVertices = dmGraphics::GetMaxElementsVertices(graphics_context);
         world->m_VertexBuffers = new dmRender::HBufferedRenderBuffer[VERTEX_BUFFER_MAX_BATCHES];
         world->m_VertexBufferData = new dmArray<uint8_t>[VERTEX_BUFFER_MAX_BATCHES];
@@ -193,6 +213,14 @@ namespace dmGameSystem
         ModelContext* context = (ModelContext*)params.m_Context;
         ModelWorld* world = (ModelWorld*)params.m_World;
         dmGraphics::DeleteVertexDeclaration(world->m_VertexDeclaration);
+        if (world->m_InstanceVertexDeclaration)
+        {
+            dmGraphics::DeleteVertexDeclaration(world->m_InstanceVertexDeclaration);
+        }
+        for (uint32_t i = 0; i < world->m_InstanceBuffers.Size(); ++i)
+        {
+            dmGraphics::DeleteVertexBuffer(world->m_InstanceBuffers[i]);
+        }
         for(uint32_t i = 0; i < VERTEX_BUFFER_MAX_BATCHES; ++i)
         {
             dmRender::DeleteBufferedRenderBuffer(context->m_RenderContext, world->m_VertexBuffers[i]);
@@ -498,7 +526,8 @@ namespace dmGameSystem
         for (int i = 0; i < attribute_count; ++i)
         {
             const dmGraphics::VertexAttribute& attr = attributes[i];
-            if (!IsDefaultStream(attr.m_NameHash, attr.m_SemanticType))
+            // The per-instance world matrix is read from the instance stream, not the custom attribute stream
+            if (!IsDefaultStream(attr.m_NameHash, attr.m_SemanticType) && attr.m_NameHash != INSTANCE_WORLD_MATRIX)
             {
                 return true;
             }
@@ -763,67 +792,170 @@ namespace dmGameSystem
         return dmGameObject::CREATE_RESULT_OK;
     }
 
-    static inline void RenderBatchLocalVS(ModelWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
+    static inline bool IsInstancingSupported(ModelWorld* world, const MeshRenderItem* render_item, dmRender::HMaterial material)
     {
-        DM_PROFILE("RenderBatchLocal");
+        // The custom attribute stream would occupy the vertex buffer binding used for the instance data
+        if (!world->m_InstanceVertexDeclaration || render_item->m_AttributeRenderDataIndex != ATTRIBUTE_RENDER_DATA_INDEX_UNUSED)
+            return false;
+        dmRender::MaterialProgramAttributeInfo info;
+        return dmRender::GetMaterialProgramAttributeInfo(material, INSTANCE_WORLD_MATRIX, info);
+    }
 
-        for (uint32_t *i=begin;i!=end;i++)
+    static dmRender::RenderObject& AddLocalVSRenderObject(ModelWorld* world, dmRender::HRenderContext render_context, const MeshRenderItem* render_item, dmRender::HMaterial material, uint32_t instance_count)
+    {
+        const ModelResourceBuffers* buffers = render_item->m_Buffers;
+        ModelComponent* component = render_item->m_Component;
+        uint32_t material_index = render_item->m_MaterialIndex;
+
+        world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
+        dmRender::RenderObject& ro = world->m_RenderObjects.Back();
+
+        ro.Init();
+        ro.m_Material              = material;
+        ro.m_PrimitiveType         = dmGraphics::PRIMITIVE_TRIANGLES;
+        ro.m_VertexDeclarations[0] = world->m_VertexDeclaration;
+        ro.m_VertexBuffers[0]      = buffers->m_VertexBuffer;
+
+        if (render_item->m_AttributeRenderDataIndex != ATTRIBUTE_RENDER_DATA_INDEX_UNUSED)
         {
-            const MeshRenderItem* render_item = (MeshRenderItem*) buf[*i].m_UserData;
-            const ModelResourceBuffers* buffers = render_item->m_Buffers;
-            ModelComponent* component = render_item->m_Component;
-            uint32_t material_index = render_item->m_MaterialIndex;
+            MeshAttributeRenderData* attribute_rd = &component->m_MeshAttributeRenderDatas[render_item->m_AttributeRenderDataIndex];
+
+            if (!attribute_rd->m_VertexDeclaration)
+            {
+                SetupMeshAttributeRenderData(render_context,
+                    ro.m_Material,
+                    render_item,
+                    component->m_Resource->m_Materials[material_index].m_Attributes,
+                    component->m_Resource->m_Materials[material_index].m_AttributeCount,
+                    attribute_rd);
+            }
+
+            ro.m_VertexDeclarations[1] = attribute_rd->m_VertexDeclaration;
+            ro.m_VertexBuffers[1]      = attribute_rd->m_VertexBuffer;
+        }
+
+        // These should be named "element" or "index" (as opposed to vertex)
+        ro.m_VertexStart = 0;
+        ro.m_VertexCount = buffers->m_IndexCount;
+
+        ro.m_WorldTransform = render_item->m_World;
 
-            // We currently have no support for instancing, so we generate a separate draw call for each render item
-            world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
-            dmRender::RenderObject& ro = world->m_RenderObjects.Back();
+        ro.m_IndexBuffer = buffers->m_IndexBuffer;              // May be 0
+        ro.m_IndexType = buffers->m_IndexBufferElementType;
 
-            ro.Init();
-            ro.m_Material              = GetMaterial(component, component->m_Resource, material_index);
-            ro.m_PrimitiveType         = dmGraphics::PRIMITIVE_TRIANGLES;
-            ro.m_VertexDeclarations[0] = world->m_VertexDeclaration;
-            ro.m_VertexBuffers[0]      = buffers->m_VertexBuffer;
+        DM_PROPERTY_ADD_U32(rmtp_ModelIndexCount, buffers->m_IndexCount * dmMath::Max(instance_count, 1u));
+        DM_PROPERTY_ADD_U32(rmtp_ModelVertexCount, buffers->m_VertexCount * dmMath::Max(instance_count, 1u));
+        DM_PROPERTY_ADD_U32(rmtp_ModelVertexSize, buffers->m_VertexCount * sizeof(dmRig::RigModelVertex));
+
+        FillTextures(&ro, component, material_index);
+
+        if (component->m_RenderConstants)
+        {
+            dmGameSystem::EnableRenderObjectConstants(&ro, component->m_RenderConstants);
+        }
+
+        return ro;
+    }
 
-            if (render_item->m_AttributeRenderDataIndex != ATTRIBUTE_RENDER_DATA_INDEX_UNUSED)
+    static dmGraphics::HVertexBuffer NextInstanceBuffer(ModelWorld* world, dmRender::HRenderContext render_context)
+    {
+        // The instance buffers are handed out once per frame, so that no buffer is rewritten
+        // before the draw calls from an earlier dispatch have consumed it.
+        if (world->m_InstanceBufferCount == world->m_InstanceBuffers.Size())
+        {
+            if (world->m_InstanceBuffers.Full())
+                world->m_InstanceBuffers.OffsetCapacity(8);
+            dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(render_context);
+            world->m_InstanceBuffers.Push(dmGraphics::NewVertexBuffer(graphics_context, 0, 0x0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW));
+        }
+        return world->m_InstanceBuffers[world->m_InstanceBufferCount++];
+    }
+
+    static bool InstanceOrderPred(const MeshRenderItem* a, const MeshRenderItem* b)
+    {
+        if (a->m_Buffers != b->m_Buffers)
+            return a->m_Buffers < b->m_Buffers;
+        return a->m_MaterialIndex < b->m_MaterialIndex;
+    }
+
+    static void RenderInstancedLocalVS(ModelWorld* world, dmRender::HRenderContext render_context)
+    {
+        DM_PROFILE("RenderInstancedLocal");
+
+        dmArray<const MeshRenderItem*>& items = world->m_InstanceItems;
+        std::sort(items.Begin(), items.End(), InstanceOrderPred);
+
+        uint32_t item_count = items.Size();
+        uint32_t run_begin = 0;
+        while (run_begin < item_count)
+        {
+            const MeshRenderItem* first = items[run_begin];
+            const ModelComponent* component = first->m_Component;
+            dmRender::HMaterial material = GetMaterial(component, component->m_Resource, first->m_MaterialIndex);
+
+            // Items sharing both mesh buffers and material become one draw call
+            uint32_t run_end = run_begin + 1;
+            while (run_end < item_count && items[run_end]->m_Buffers == first->m_Buffers &&
+                   GetMaterial(items[run_end]->m_Component, items[run_end]->m_Component->m_Resource, items[run_end]->m_MaterialIndex) == material)
             {
-                MeshAttributeRenderData* attribute_rd = &component->m_MeshAttributeRenderDatas[render_item->m_AttributeRenderDataIndex];
+                ++run_end;
+            }
 
-                if (!attribute_rd->m_VertexDeclaration)
-                {
-                    SetupMeshAttributeRenderData(render_context,
-                        ro.m_Material,
-                        render_item,
-                        component->m_Resource->m_Materials[material_index].m_Attributes,
-                        component->m_Resource->m_Materials[material_index].m_AttributeCount,
-                        attribute_rd);
-                }
+            uint32_t instance_count = run_end - run_begin;
 
-                ro.m_VertexDeclarations[1] = attribute_rd->m_VertexDeclaration;
-                ro.m_VertexBuffers[1]      = attribute_rd->m_VertexBuffer;
+            dmArray<Matrix4>& transforms = world->m_InstanceTransforms;
+            transforms.SetSize(0);
+            if (transforms.Capacity() < instance_count)
+                transforms.SetCapacity(instance_count);
+            for (uint32_t i = run_begin; i < run_end; ++i)
+            {
+                transforms.Push(items[i]->m_World);
             }
 
-            // These should be named "element" or "index" (as opposed to vertex)
-            ro.m_VertexStart = 0;
-            ro.m_VertexCount = buffers->m_IndexCount;
+            dmGraphics::HVertexBuffer instance_buffer = NextInstanceBuffer(world, render_context);
+            dmGraphics::SetVertexBufferData(instance_buffer, instance_count * sizeof(Matrix4), transforms.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+
+            dmRender::RenderObject& ro = AddLocalVSRenderObject(world, render_context, first, material, instance_count);
+            ro.m_VertexDeclarations[1] = world->m_InstanceVertexDeclaration;
+            ro.m_VertexBuffers[1]      = instance_buffer;
+            ro.m_InstanceCount         = instance_count;
+            ro.m_WorldTransform        = Matrix4::identity(); // The world transforms are read per instance
+
+            dmRender::AddToRender(render_context, &ro);
 
-            ro.m_WorldTransform = render_item->m_World;
+            run_begin = run_end;
+        }
+    }
 
-            ro.m_IndexBuffer = buffers->m_IndexBuffer;              // May be 0
-            ro.m_IndexType = buffers->m_IndexBufferElementType;
+    static inline void RenderBatchLocalVS(ModelWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
+    {
+        DM_PROFILE("RenderBatchLocal");
 
-            DM_PROPERTY_ADD_U32(rmtp_ModelIndexCount, buffers->m_IndexCount);
-            DM_PROPERTY_ADD_U32(rmtp_ModelVertexCount, buffers->m_VertexCount);
-            DM_PROPERTY_ADD_U32(rmtp_ModelVertexSize, buffers->m_VertexCount * sizeof(dmRig::RigModelVertex));
+        world->m_InstanceItems.SetSize(0);
 
-            FillTextures(&ro, component, material_index);
+        for (uint32_t *i=begin;i!=end;i++)
+        {
+            const MeshRenderItem* render_item = (MeshRenderItem*) buf[*i].m_UserData;
+            ModelComponent* component = render_item->m_Component;
+            dmRender::HMaterial material = GetMaterial(component, component->m_Resource, render_item->m_MaterialIndex);
 
-            if (component->m_RenderConstants)
+            // Materials reading a per-instance world matrix are drawn with one instanced draw call per mesh
+            if (IsInstancingSupported(world, render_item, material) && render_item->m_Buffers->m_IndexBuffer)
             {
-                dmGameSystem::EnableRenderObjectConstants(&ro, component->m_RenderConstants);
+                if (world->m_InstanceItems.Full())
+                    world->m_InstanceItems.OffsetCapacity(dmMath::Max(64u, (uint32_t) (end - begin)));
+                world->m_InstanceItems.Push(render_item);
+                continue;
             }
 
+            dmRender::RenderObject& ro = AddLocalVSRenderObject(world, render_context, render_item, material, 0);
             dmRender::AddToRender(render_context, &ro);
         }
+
+        if (!world->m_InstanceItems.Empty())
+        {
+            RenderInstancedLocalVS(world, render_context);
+        }
     }
 
     #if 0
@@ -1125,6 +1257,7 @@ namespace dmGameSystem
         }
 
         world->m_MaxBatchIndex = 0;
+        world->m_InstanceBufferCount = 0;
 
         update_result.m_TransformsUpdated = rig_res == dmRig::RESULT_UPDATED_POSE;
         return dmGameObject::UPDATE_RESULT_OK;
@@ -1645,4 +1778,12 @@ namespace dmGameSystem
         *vx_buffers       = world->m_VertexBuffers;
         *vx_buffers_count = VERTEX_BUFFER_MAX_BATCHES;
     }
+
+    // For tests
+    void GetModelWorldRenderObjects(void* model_world, dmRender::RenderObject** render_objects, uint32_t* render_objects_count)
+    {
+        ModelWorld* world     = (ModelWorld*) model_world;
+        *render_objects       = world->m_RenderObjects.Begin();
+        *render_objects_count = world->m_RenderObjects.Size();
+    }
 }
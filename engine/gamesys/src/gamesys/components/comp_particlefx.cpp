@@ -47,6 +47,8 @@ namespace dmGameSystem
 
     struct ParticleFXWorld;
 
+    static const dmhash_t PARTICLEFX_TRANSIENT_CATEGORY = dmHashString64("particlefx");
+
     struct ParticleFXComponentPrototype
     {
         Vector3 m_Translation;
@@ -77,11 +79,10 @@ namespace dmGameSystem
         dmIndexPool32                           m_PrototypeIndices;
         ParticleFXContext*                      m_Context;
         dmParticle::HParticleContext            m_ParticleContext;
-        dmRender::HBufferedRenderBuffer         m_VertexBuffer;
+        // The vertices of a dispatch are generated here, and each batch is then copied to the transient vertex buffer of the render context
         dmArray<uint8_t>                        m_VertexBufferData;
         uint32_t                                m_VerticesWritten;
         uint32_t                                m_EmitterCount;
-        uint32_t                                m_DispatchCount;
         float                                   m_DT;
         uint32_t                                m_WarnOutOfROs : 1;
     };
@@ -113,7 +114,6 @@ namespace dmGameSystem
         const uint32_t default_vx_size = sizeof(float) * (3 + 4 + 2 + 1);
         const uint32_t buffer_size     = ctx->m_MaxParticleCount * 6 * default_vx_size;
         world->m_VertexBufferData.SetCapacity(buffer_size);
-        world->m_VertexBuffer = dmRender::NewBufferedRenderBuffer(ctx->m_RenderContext, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER);
 
         world->m_WarnOutOfROs = 0;
         world->m_EmitterCount = 0;
@@ -124,7 +124,6 @@ namespace dmGameSystem
 
     dmGameObject::CreateResult CompParticleFXDeleteWorld(const dmGameObject::ComponentDeleteWorldParams& params)
     {
-        ParticleFXContext* ctx = (ParticleFXContext*)params.m_Context;
         ParticleFXWorld* pfx_world = (ParticleFXWorld*)params.m_World;
         for (uint32_t i = 0; i < pfx_world->m_Components.Size(); ++i)
         {
@@ -142,7 +141,6 @@ namespace dmGameSystem
         }
 
         dmParticle::DestroyContext(pfx_world->m_ParticleContext);
-        dmRender::DeleteBufferedRenderBuffer(ctx->m_RenderContext, pfx_world->m_VertexBuffer);
 
         delete pfx_world;
         return dmGameObject::CREATE_RESULT_OK;
@@ -200,7 +198,6 @@ namespace dmGameSystem
         ParticleFXWorld* w   = (ParticleFXWorld*)params.m_World;
         w->m_DT              = params.m_UpdateContext->m_DT;
         w->m_VerticesWritten = 0;
-        w->m_DispatchCount   = 0;
 
         dmArray<ParticleFXComponent>& components = w->m_Components;
         if (components.Empty())
@@ -252,9 +249,6 @@ namespace dmGameSystem
             }
         }
 
-        dmRender::TrimBuffer(ctx->m_RenderContext, w->m_VertexBuffer);
-        dmRender::RewindBuffer(ctx->m_RenderContext, w->m_VertexBuffer);
-
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
@@ -276,20 +270,9 @@ namespace dmGameSystem
         }
 
         dmArray<uint8_t> &vertex_buffer = pfx_world->m_VertexBufferData;
-        uint8_t* vb_begin = vertex_buffer.End();
-
-        // We need to pad the buffer if the vertex stride doesn't start at an even byte offset from the start
-        const uint32_t vb_buffer_offset = vertex_buffer.Size();
-        uint32_t vertex_offset = vb_buffer_offset / vx_stride;
-
-        if (vb_buffer_offset % vx_stride != 0)
-        {
-            vb_begin += vx_stride - vb_buffer_offset % vx_stride;
-            vertex_offset++;
-            pfx_world->m_VerticesWritten++;
-        }
 
-        uint32_t vb_size_init = vb_begin - vertex_buffer.Begin();
+        // No padding is needed between batches of different vertex strides, the transient buffer aligns each batch
+        uint32_t vb_size_init = vertex_buffer.Size();
         uint32_t vb_size      = vb_size_init;
         uint32_t vb_max_size  = pfx_world->m_VertexBufferData.Capacity();
 
@@ -329,15 +312,19 @@ namespace dmGameSystem
 
         vertex_buffer.SetSize(vb_size);
 
+        dmRender::HRenderBuffer gfx_vertex_buffer = 0;
+        uint32_t gfx_vertex_buffer_offset = 0;
+        if (ro_vertex_count > 0)
+        {
+            uint32_t size = ro_vertex_count * vx_stride;
+            void* dst = dmRender::AllocTransientBuffer(render_context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, size, vx_stride, PARTICLEFX_TRANSIENT_CATEGORY, &gfx_vertex_buffer, &gfx_vertex_buffer_offset);
+            memcpy(dst, vertex_buffer.Begin() + vb_size_init, size);
+        }
+
         // In place writing of render object
         uint32_t ro_index = pfx_world->m_RenderObjects.Size();
         pfx_world->m_RenderObjects.SetSize(ro_index+1);
 
-        if (dmRender::GetBufferIndex(render_context, pfx_world->m_VertexBuffer) < pfx_world->m_DispatchCount)
-        {
-            dmRender::AddRenderBuffer(render_context, pfx_world->m_VertexBuffer);
-        }
-
         TextureResource* texture_res = (TextureResource*) first->m_Texture;
         dmGraphics::HTexture texture = texture_res ? texture_res->m_Texture : 0;
 
@@ -346,9 +333,9 @@ namespace dmGameSystem
         ro.m_Material          = material_res->m_Material;
         ro.m_VertexDeclaration = dmRender::GetVertexDeclaration(material_res->m_Material);
         ro.m_Textures[0]       = texture;
-        ro.m_VertexStart       = vertex_offset;
+        ro.m_VertexStart       = gfx_vertex_buffer_offset / vx_stride;
         ro.m_VertexCount       = ro_vertex_count;
-        ro.m_VertexBuffer      = (dmGraphics::HVertexBuffer) dmRender::GetBuffer(render_context, pfx_world->m_VertexBuffer);
+        ro.m_VertexBuffer      = (dmGraphics::HVertexBuffer) gfx_vertex_buffer;
         ro.m_PrimitiveType     = dmGraphics::PRIMITIVE_TRIANGLES;
         ro.m_SetBlendFactors   = 1;
 
@@ -381,12 +368,11 @@ namespace dmGameSystem
                 RenderBatch(pfx_world, params.m_Context, params.m_Buf, params.m_Begin, params.m_End);
                 break;
             case dmRender::RENDER_LIST_OPERATION_END:
+                // The batches have already been copied to the transient vertex buffer, which the renderer uploads before drawing
                 if (pfx_world->m_VertexBufferData.Size() > 0)
                 {
-                    dmRender::SetBufferData(params.m_Context, pfx_world->m_VertexBuffer, pfx_world->m_VertexBufferData.Size(), pfx_world->m_VertexBufferData.Begin(), dmGraphics::BUFFER_USAGE_STREAM_DRAW);
                     DM_PROPERTY_ADD_U32(rmtp_ParticleVertexCount, pfx_world->m_VerticesWritten);
                     DM_PROPERTY_ADD_U32(rmtp_ParticleVertexSize, pfx_world->m_VertexBufferData.Size());
-                    pfx_world->m_DispatchCount++;
                 }
                 break;
             default:break;
@@ -697,9 +683,11 @@ namespace dmGameSystem
         }
     }
 
-    void GetParticleFXWorldRenderBuffers(void* pfx_world, dmRender::HBufferedRenderBuffer* vx_buffer)
+    // For tests
+    void GetParticleFXWorldRenderObjects(void* pfx_world, dmRender::RenderObject** render_objects, uint32_t* render_objects_count)
     {
         ParticleFXWorld* world = (ParticleFXWorld*) pfx_world;
-        *vx_buffer = world->m_VertexBuffer;
+        *render_objects       = world->m_RenderObjects.Begin();
+        *render_objects_count = world->m_RenderObjects.Size();
     }
 }
@@ -51,6 +51,7 @@ DM_PROPERTY_U32(rmtp_Sprite, 0, FrameReset, "# components", &rmtp_Components);
 DM_PROPERTY_U32(rmtp_SpriteVertexCount, 0, FrameReset, "# vertices", &rmtp_Sprite);
 DM_PROPERTY_U32(rmtp_SpriteVertexSize, 0, FrameReset, "size of vertices in bytes", &rmtp_Sprite);
 DM_PROPERTY_U32(rmtp_SpriteIndexSize, 0, FrameReset, "size of indices in bytes", &rmtp_Sprite);
+DM_PROPERTY_U32(rmtp_SpriteVerticesReused, 0, FrameReset, "# vertices reused from the vertex cache", &rmtp_Sprite);
 
 namespace dmGameSystem
 {
@@ -74,6 +75,7 @@ namespace dmGameSystem
         Vector3                     m_Size;     // The current size of the animation frame (in texels)
         Vector4                     m_Slice9;
         Matrix4                     m_World;
+        Matrix4                     m_GameObjectWorld; // The game object transform m_World was last calculated from
         dmMessage::URL              m_Listener;
         int                         m_FunctionRef; // Animation callback function
         // Hash of the m_Resource-pointer etc. Hash is used to be compatible with 64-bit arch as a 32-bit value is used for sorting
@@ -94,6 +96,13 @@ namespace dmGameSystem
         /// Timer in local space: [0,1]
         float                       m_AnimTimer;
         float                       m_PlaybackRate;
+        // Where the vertices generated for this sprite are kept in SpriteWorld::m_VertexCache/m_IndexCache
+        uint32_t                    m_VertexCacheKey;   // Hash of the vertex format and texture sets they were generated with
+        uint32_t                    m_VertexCacheFrame; // The frame they were generated, selects the cache
+        uint32_t                    m_VertexCacheOffset;
+        uint32_t                    m_IndexCacheOffset;
+        uint16_t                    m_VertexCacheCount;
+        uint16_t                    m_IndexCacheCount;
         uint16_t                    m_ComponentIndex;
         uint16_t                    m_AnimPingPong : 1;
         uint16_t                    m_AnimBackwards : 1;
@@ -105,7 +114,9 @@ namespace dmGameSystem
         uint16_t                    m_AddedToUpdate : 1;
         uint16_t                    m_ReHash : 1;
         uint16_t                    m_UseSlice9 : 1;
-        uint16_t                    m_Padding : 6;
+        uint16_t                    m_TransformDirty : 1; // m_World needs to be recalculated, even if the game object didn't move
+        uint16_t                    m_VerticesDirty : 1;  // The cached vertices can't be reused
+        uint16_t                    m_Padding : 4;
     };
 
     struct SpriteWorld
@@ -115,17 +126,21 @@ namespace dmGameSystem
         dmArray<dmRender::RenderObject*>    m_RenderObjects;
         dmArray<float>                      m_BoundingVolumes;
         uint32_t                            m_RenderObjectsInUse;
-        dmRender::HBufferedRenderBuffer     m_VertexBuffer;
+        // The vertices and indices of a dispatch are written here, and each batch is then copied to the transient buffers of the render context
         uint8_t*                            m_VertexBufferData;
         uint8_t*                            m_VertexBufferWritePtr;
-        dmRender::HBufferedRenderBuffer     m_IndexBuffer;
         uint32_t                            m_VerticesWritten;
         uint32_t                            m_VertexMemorySize;
         uint32_t                            m_VertexCount;
         uint32_t                            m_IndexCount;
-        uint32_t                            m_DispatchCount;
         uint8_t*                            m_IndexBufferData;
         uint8_t*                            m_IndexBufferWritePtr;
+        // The vertices of each sprite rendered the previous and the current frame (indexed by frame parity),
+        // and their indices relative to the first vertex of each sprite
+        dmArray<uint8_t>                    m_VertexCache[2];
+        dmArray<uint32_t>                   m_IndexCache[2];
+        uint32_t                            m_Frame;
+        uint32_t                            m_VerticesReused;
         uint8_t                             m_Is16BitIndex : 1;
         uint8_t                             m_ReallocBuffers : 1;
     };
@@ -157,6 +172,8 @@ namespace dmGameSystem
     static const dmhash_t SPRITE_PROP_ANIMATION     = dmHashString64("animation");
     static const dmhash_t SPRITE_PROP_FRAME_COUNT   = dmHashString64("frame_count");
 
+    static const dmhash_t SPRITE_TRANSIENT_CATEGORY = dmHashString64("sprite");
+
     // The 9 slice function produces 16 vertices (4 rows 4 columns)
     // and since there's 2 triangles per quad and 9 quads in total,
     // the amount of indices is 6 per quad and 9 quads = 54 indices in total
@@ -172,14 +189,7 @@ namespace dmGameSystem
     static float GetPlaybackRate(SpriteComponent* component);
     static void SetPlaybackRate(SpriteComponent* component, float playback_rate);
 
-    static void ReAllocateBuffers(SpriteWorld* sprite_world, dmRender::HRenderContext render_context) {
-        if (sprite_world->m_VertexBuffer)
-        {
-            dmRender::DeleteBufferedRenderBuffer(render_context, sprite_world->m_VertexBuffer);
-            sprite_world->m_VertexBuffer = 0;
-        }
-
-        sprite_world->m_VertexBuffer     = dmRender::NewBufferedRenderBuffer(render_context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER);
+    static void ReAllocateBuffers(SpriteWorld* sprite_world) {
         uint32_t vertex_memsize          = sprite_world->m_VertexMemorySize;
         sprite_world->m_VertexBufferData = (uint8_t*) realloc(sprite_world->m_VertexBufferData, vertex_memsize);
 
@@ -187,15 +197,7 @@ namespace dmGameSystem
         size_t indices_memsize          = sprite_world->m_IndexCount * index_data_type_size;
         sprite_world->m_Is16BitIndex    = index_data_type_size == sizeof(uint16_t) ? 1 : 0;
         sprite_world->m_IndexBufferData = (uint8_t*)realloc(sprite_world->m_IndexBufferData, indices_memsize);
-
-        if (sprite_world->m_IndexBuffer)
-        {
-            dmRender::DeleteBufferedRenderBuffer(render_context, sprite_world->m_IndexBuffer);
-            sprite_world->m_IndexBuffer = 0;
-        }
-
-        sprite_world->m_IndexBuffer    = dmRender::NewBufferedRenderBuffer(render_context, dmRender::RENDER_BUFFER_TYPE_INDEX_BUFFER);
-        sprite_world->m_ReallocBuffers = 0;
+        sprite_world->m_ReallocBuffers  = 0;
     }
 
     dmGameObject::CreateResult CompSpriteNewWorld(const dmGameObject::ComponentNewWorldParams& params)
@@ -208,9 +210,7 @@ namespace dmGameSystem
         sprite_world->m_BoundingVolumes.SetSize(comp_count);
         memset(sprite_world->m_Components.GetRawObjects().Begin(), 0, sizeof(SpriteComponent) * comp_count);
         sprite_world->m_RenderObjectsInUse = 0;
-        sprite_world->m_VertexBuffer     = 0;
         sprite_world->m_VertexBufferData = 0;
-        sprite_world->m_IndexBuffer      = 0;
         sprite_world->m_IndexBufferData  = 0;
 
         InitializeMaterialAttributeInfos(sprite_world->m_DynamicVertexAttributePool, 8);
@@ -230,10 +230,7 @@ namespace dmGameSystem
             delete sprite_world->m_RenderObjects[i];
         }
 
-        SpriteContext* sprite_context = (SpriteContext*)params.m_Context;
-        dmRender::DeleteBufferedRenderBuffer(sprite_context->m_RenderContext, sprite_world->m_VertexBuffer);
         free(sprite_world->m_VertexBufferData);
-        dmRender::DeleteBufferedRenderBuffer(sprite_context->m_RenderContext, sprite_world->m_IndexBuffer);
         free(sprite_world->m_IndexBufferData);
 
         delete sprite_world;
@@ -473,9 +470,15 @@ namespace dmGameSystem
         uint32_t frame_current = component->m_CurrentAnimationFrame;
         component->m_CurrentAnimationFrame = frame;
 
+        if (frame != frame_current)
+        {
+            component->m_VerticesDirty = 1;
+        }
+
         if (component->m_Resource->m_DDF->m_SizeMode == dmGameSystemDDF::SpriteDesc::SIZE_MODE_AUTO && frame != frame_current)
         {
             component->m_Size = GetSizeFromAnimation(component, texture_set_ddf, component->m_AnimationID);
+            component->m_TransformDirty = 1;
         }
     }
 
@@ -483,6 +486,9 @@ namespace dmGameSystem
     {
         TextureSetResource* texture_set = GetFirstTextureSet(component);
         uint32_t* anim_id = texture_set ? texture_set->m_AnimationIds.Get(animation) : 0;
+        // Both the size and the frame may change
+        component->m_TransformDirty = 1;
+        component->m_VerticesDirty = 1;
         if (anim_id)
         {
             component->m_AnimationID = *anim_id;
@@ -576,6 +582,8 @@ namespace dmGameSystem
         component->m_Enabled = 1;
         component->m_FunctionRef = 0;
         component->m_ReHash = 1;
+        component->m_TransformDirty = 1;
+        component->m_VerticesDirty = 1;
         component->m_Slice9 = component->m_Resource->m_DDF->m_Slice9;
         component->m_UseSlice9 = sum(component->m_Slice9) != 0 &&
                 component->m_Resource->m_DDF->m_SizeMode == dmGameSystemDDF::SpriteDesc::SIZE_MODE_MANUAL;
@@ -615,7 +623,14 @@ namespace dmGameSystem
 
         DeleteOverrides(factory, component);
 
+        // The last sprite is moved into the freed slot, and the bounding volumes are indexed by slot
+        dmArray<SpriteComponent>& components = sprite_world->m_Components.GetRawObjects();
+        uint32_t physical_index = component - components.Begin();
         sprite_world->m_Components.Free(index, true);
+        if (physical_index < components.Size())
+        {
+            components[physical_index].m_TransformDirty = 1;
+        }
         return dmGameObject::CREATE_RESULT_OK;
     }
 
@@ -647,6 +662,12 @@ namespace dmGameSystem
         }
     }
 
+    // All sprite vertices lie in the z=0 plane, so transforming them only needs two columns of the world transform
+    static inline Vector4 TransformSpritePoint(const Matrix4& transform, float x, float y)
+    {
+        return transform.getCol0() * x + transform.getCol1() * y + transform.getCol3();
+    }
+
     static void CreateVertexDataSlice9(uint8_t* vertices, uint8_t* indices, bool is_indices_16_bit, bool has_local_position_attribute,
         const Matrix4& transform, Vector3 sprite_size, Vector4 slice9, uint32_t vertex_offset, uint32_t vertex_stride,
         TexturesData* textures, dmArray<float>* scratch_uvs, float* scratch_uv_ptrs[MAX_TEXTURE_COUNT],
@@ -769,14 +790,16 @@ namespace dmGameSystem
         {
             for (int x=0; x<4; x++)
             {
-                Point3 p_world = Point3(xs[x] - 0.5, ys[y] - 0.5, 0);
+                float px = xs[x] - 0.5f;
+                float py = ys[y] - 0.5f;
+                Vector4 p_world = TransformSpritePoint(transform, px, py);
                 Point3 p_local;
                 if (has_local_position_attribute)
                 {
-                    p_local = Point3(p_world.getX() * sprite_size.getX(), p_world.getY() * sprite_size.getY(), 0.0f);
+                    p_local = Point3(px * sprite_size.getX(), py * sprite_size.getY(), 0.0f);
                 }
 
-                dmGraphics::WriteAttribute(sprite_infos, vertices + vertex_stride * vx_index, vx_index, &transform, p_world, p_local, 0, scratch_uv_ptrs, textures->m_PageIndices, textures->m_NumTextures);
+                dmGraphics::WriteAttribute(sprite_infos, vertices + vertex_stride * vx_index, vx_index, &p_world, p_local, 0, scratch_uv_ptrs, textures->m_PageIndices, textures->m_NumTextures);
                 vx_index++;
             }
         }
@@ -1038,6 +1061,98 @@ namespace dmGameSystem
         }
     }
 
+    template <typename T>
+    static void PushCacheData(dmArray<T>& cache, const T* data, uint32_t count)
+    {
+        if (cache.Remaining() < count) {
+            cache.OffsetCapacity(dmMath::Max(cache.Capacity(), count));
+        }
+        cache.PushArray(data, count);
+    }
+
+    // Stores the vertices and indices just generated for a sprite, so they can be reused while the sprite doesn't change
+    static void CacheVertices(SpriteWorld* sprite_world, SpriteComponent* component, uint32_t cache_key, uint32_t vertex_stride,
+                                const uint8_t* vertices, uint32_t vertex_count, const uint8_t* indices, uint32_t index_count, uint32_t vertex_offset)
+    {
+        if (vertex_count > 0xFFFF || index_count > 0xFFFF)
+        {
+            component->m_VertexCacheCount = 0;
+            return;
+        }
+
+        dmArray<uint8_t>& vertex_cache = sprite_world->m_VertexCache[sprite_world->m_Frame & 1];
+        dmArray<uint32_t>& index_cache = sprite_world->m_IndexCache[sprite_world->m_Frame & 1];
+
+        component->m_VertexCacheKey    = cache_key;
+        component->m_VertexCacheFrame  = sprite_world->m_Frame;
+        component->m_VertexCacheOffset = vertex_cache.Size();
+        component->m_IndexCacheOffset  = index_cache.Size();
+        component->m_VertexCacheCount  = vertex_count;
+        component->m_IndexCacheCount   = index_count;
+        component->m_VerticesDirty     = 0;
+
+        PushCacheData(vertex_cache, vertices, vertex_count * vertex_stride);
+
+        if (index_cache.Remaining() < index_count) {
+            index_cache.OffsetCapacity(dmMath::Max(index_cache.Capacity(), index_count));
+        }
+        for (uint32_t i = 0; i < index_count; ++i)
+        {
+            uint32_t index = sprite_world->m_Is16BitIndex ? ((const uint16_t*)indices)[i] : ((const uint32_t*)indices)[i];
+            index_cache.Push(index - vertex_offset);
+        }
+    }
+
+    // Writes the cached vertices and indices of a sprite, if it hasn't changed since they were generated
+    static bool ReuseVertices(SpriteWorld* sprite_world, SpriteComponent* component, uint32_t cache_key, uint32_t vertex_stride,
+                                uint8_t** vb_where, uint8_t** ib_where, uint32_t* vertex_offset)
+    {
+        // The caches only hold the vertices from the previous and the current frame
+        uint32_t age = sprite_world->m_Frame - component->m_VertexCacheFrame;
+        if (component->m_VerticesDirty || age > 1 || component->m_VertexCacheKey != cache_key || component->m_VertexCacheCount == 0)
+            return false;
+
+        uint32_t cache_index     = component->m_VertexCacheFrame & 1;
+        uint32_t vertex_count    = component->m_VertexCacheCount;
+        uint32_t index_count     = component->m_IndexCacheCount;
+        const uint8_t* vertices  = sprite_world->m_VertexCache[cache_index].Begin() + component->m_VertexCacheOffset;
+        const uint32_t* indices  = sprite_world->m_IndexCache[cache_index].Begin() + component->m_IndexCacheOffset;
+
+        memcpy(*vb_where, vertices, vertex_count * vertex_stride);
+
+        if (sprite_world->m_Is16BitIndex)
+        {
+            uint16_t* indices_16 = (uint16_t*) *ib_where;
+            for (uint32_t i = 0; i < index_count; ++i)
+                indices_16[i] = *vertex_offset + indices[i];
+        }
+        else
+        {
+            uint32_t* indices_32 = (uint32_t*) *ib_where;
+            for (uint32_t i = 0; i < index_count; ++i)
+                indices_32[i] = *vertex_offset + indices[i];
+        }
+
+        // Carry the vertices over to this frame's cache
+        if (age == 1)
+        {
+            dmArray<uint8_t>& vertex_cache = sprite_world->m_VertexCache[sprite_world->m_Frame & 1];
+            dmArray<uint32_t>& index_cache = sprite_world->m_IndexCache[sprite_world->m_Frame & 1];
+            component->m_VertexCacheFrame  = sprite_world->m_Frame;
+            component->m_VertexCacheOffset = vertex_cache.Size();
+            component->m_IndexCacheOffset  = index_cache.Size();
+            PushCacheData(vertex_cache, vertices, vertex_count * vertex_stride);
+            PushCacheData(index_cache, indices, index_count);
+        }
+
+        *vb_where      += vertex_count * vertex_stride;
+        *ib_where      += index_count * (sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t));
+        *vertex_offset += vertex_count;
+        sprite_world->m_VerticesReused += vertex_count;
+        DM_PROPERTY_ADD_U32(rmtp_SpriteVerticesReused, vertex_count);
+        return true;
+    }
+
     static void CreateVertexData(SpriteWorld* sprite_world, dmGraphics::VertexAttributeInfos* material_attribute_info, bool has_local_position_attribute, uint8_t** vb_where, uint8_t** ib_where, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
     {
         DM_PROFILE("CreateVertexData");
@@ -1046,7 +1161,7 @@ namespace dmGameSystem
         uint8_t* indices         = *ib_where;
         uint32_t index_type_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
 
-        const dmArray<SpriteComponent>& components = sprite_world->m_Components.GetRawObjects();
+        dmArray<SpriteComponent>& components = sprite_world->m_Components.GetRawObjects();
 
         // The offset for the indices
         uint32_t vertex_offset = sprite_world->m_VerticesWritten;
@@ -1070,12 +1185,41 @@ namespace dmGameSystem
             textures.m_TextureSets[i] = textures.m_Resources[i]->m_TextureSet;
         }
 
+        // All sprites in a batch share material and texture sets, which decide the layout and contents of the cached vertices
+        HashState32 cache_key_state;
+        dmHashInit32(&cache_key_state, false);
+        dmHashUpdateBuffer32(&cache_key_state, textures.m_TextureSets, sizeof(textures.m_TextureSets[0]) * textures.m_NumTextures);
+        dmHashUpdateBuffer32(&cache_key_state, &material_attribute_info->m_VertexStride, sizeof(material_attribute_info->m_VertexStride));
+        dmHashUpdateBuffer32(&cache_key_state, &has_local_position_attribute, sizeof(has_local_position_attribute));
+        dmRender::HMaterial material = GetMaterial(first);
+        dmHashUpdateBuffer32(&cache_key_state, &material, sizeof(material));
+        uint32_t cache_key = dmHashFinal32(&cache_key_state);
+
         dmGraphics::VertexAttributeInfos sprite_attribute_info = {};
 
         for (uint32_t* i = begin; i != end; ++i)
         {
-            uint32_t component_index         = (uint32_t)buf[*i].m_UserData;
-            const SpriteComponent* component = (const SpriteComponent*) &components[component_index];
+            uint32_t component_index   = (uint32_t)buf[*i].m_UserData;
+            SpriteComponent* component = &components[component_index];
+
+            // We need to pad the buffer if the vertex stride doesn't start at an even byte offset from the start
+            const uint32_t vb_buffer_offset = vertices - sprite_world->m_VertexBufferData;
+            vertex_offset = vb_buffer_offset / vertex_stride;
+
+            if (vb_buffer_offset % vertex_stride != 0)
+            {
+                vertices      += vertex_stride - vb_buffer_offset % vertex_stride;
+                vertex_offset += 1;
+            }
+
+            if (ReuseVertices(sprite_world, component, cache_key, vertex_stride, &vertices, &indices, &vertex_offset))
+            {
+                continue;
+            }
+
+            uint8_t* sprite_vertices           = vertices;
+            uint8_t* sprite_indices            = indices;
+            const uint32_t sprite_vertex_start = vertex_offset;
 
             float sp_width  = component->m_Size.getX();
             float sp_height = component->m_Size.getY();
@@ -1097,16 +1241,6 @@ namespace dmGameSystem
                 sprite_attribute_info_ptr = &sprite_attribute_info;
             }
 
-            // We need to pad the buffer if the vertex stride doesn't start at an even byte offset from the start
-            const uint32_t vb_buffer_offset = vertices - sprite_world->m_VertexBufferData;
-            vertex_offset = vb_buffer_offset / vertex_stride;
-
-            if (vb_buffer_offset % vertex_stride != 0)
-            {
-                vertices      += vertex_stride - vb_buffer_offset % vertex_stride;
-                vertex_offset += 1;
-            }
-
             // if num_texture == 0, then we don't have a texture set to get any vertex/uv coordinates from
             if (textures.m_NumTextures != 0 && !CanUseQuads(&textures))
             {
@@ -1132,7 +1266,7 @@ namespace dmGameSystem
                     float x = scratch_pos[vert*2+0];
                     float y = scratch_pos[vert*2+1];
 
-                    Point3 p_world = Point3(x, y, 0.0f);
+                    Vector4 p_world = TransformSpritePoint(w, x, y);
                     Point3 p_local;
 
                     if (has_local_position_attribute)
@@ -1140,7 +1274,7 @@ namespace dmGameSystem
                         p_local = Point3(x * sp_width, y * sp_height, 0.0f);
                     }
 
-                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vert * vertex_stride, vert, &w, p_world, p_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
+                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vert * vertex_stride, vert, &p_world, p_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
                 }
 
                 uint32_t index_count = geometry->m_Indices.m_Count;
@@ -1203,10 +1337,14 @@ namespace dmGameSystem
                     //    for any subsequent geometry would yield a wuad anyways.
                     ResolveUVDataFromQuads(&textures, scratch_uvs, scratch_uv_ptrs, component->m_FlipHorizontal, component->m_FlipVertical);
 
-                    Point3 p0 = Point3(-0.5f, -0.5f, 0.0f);
-                    Point3 p1 = Point3(-0.5f,  0.5f, 0.0f);
-                    Point3 p2 = Point3( 0.5f,  0.5f, 0.0f);
-                    Point3 p3 = Point3( 0.5f, -0.5f, 0.0f);
+                    // The corners are +-half of the x and y axes of the transform, around its translation
+                    const Vector4 half_x = w.getCol0() * 0.5f;
+                    const Vector4 half_y = w.getCol1() * 0.5f;
+                    const Vector4 center = w.getCol3();
+                    Vector4 p0 = -half_x - half_y + center;
+                    Vector4 p1 = -half_x + half_y + center;
+                    Vector4 p2 =  half_x + half_y + center;
+                    Vector4 p3 =  half_x - half_y + center;
 
                     Point3 p0_local;
                     Point3 p1_local;
@@ -1221,10 +1359,10 @@ namespace dmGameSystem
                         p3_local = Point3( 0.5f * sp_width, -0.5f * sp_height, 0.0f);
                     }
 
-                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices                    , 0, &w, p0, p0_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
-                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vertex_stride    , 1, &w, p1, p1_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
-                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vertex_stride * 2, 2, &w, p2, p2_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
-                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vertex_stride * 3, 3, &w, p3, p3_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
+                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices                    , 0, &p0, p0_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
+                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vertex_stride    , 1, &p1, p1_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
+                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vertex_stride * 2, 2, &p2, p2_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
+                    dmGraphics::WriteAttribute(sprite_attribute_info_ptr, vertices + vertex_stride * 3, 3, &p3, p3_local, 0, scratch_uv_ptrs, textures.m_PageIndices, textures.m_NumTextures);
 
                 #if 0
                     for (int f = 0; f < 4; ++f)
@@ -1257,6 +1395,10 @@ namespace dmGameSystem
                     indices       += SPRITE_INDEX_COUNT_LEGACY * index_type_size;
                 }
             }
+
+            CacheVertices(sprite_world, component, cache_key, vertex_stride,
+                sprite_vertices, vertex_offset - sprite_vertex_start,
+                sprite_indices, (indices - sprite_indices) / index_type_size, sprite_vertex_start);
         }
 
         sprite_world->m_VerticesWritten = vertex_offset;
@@ -1265,6 +1407,57 @@ namespace dmGameSystem
         *ib_where = indices;
     }
 
+    // Copies the vertices and indices of a batch from the staging buffers to the transient buffers of the render context.
+    // The indices are rebased to where the vertices ended up, and widened to 32 bits if they no longer fit in 16 bits.
+    static void UploadBatch(SpriteWorld* sprite_world, dmRender::HRenderContext render_context, uint32_t vertex_stride,
+                            const uint8_t* vb_begin, const uint8_t* vb_end, const uint8_t* ib_begin, const uint8_t* ib_end, dmRender::RenderObject& ro)
+    {
+        uint32_t staging_index_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
+        uint32_t index_count        = (ib_end - ib_begin) / staging_index_size;
+
+        // The first vertex of the batch is padded to a multiple of the vertex stride (see CreateVertexData)
+        uint32_t first_vertex = ((vb_begin - sprite_world->m_VertexBufferData) + vertex_stride - 1) / vertex_stride;
+        uint32_t end_vertex   = (vb_end - sprite_world->m_VertexBufferData) / vertex_stride;
+        if (index_count == 0 || end_vertex <= first_vertex)
+        {
+            ro.m_VertexCount = 0;
+            return;
+        }
+        uint32_t vertex_count = end_vertex - first_vertex;
+
+        dmRender::HRenderBuffer vertex_buffer;
+        uint32_t vertex_buffer_offset;
+        void* vertices = dmRender::AllocTransientBuffer(render_context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, vertex_count * vertex_stride, vertex_stride, SPRITE_TRANSIENT_CATEGORY, &vertex_buffer, &vertex_buffer_offset);
+        memcpy(vertices, sprite_world->m_VertexBufferData + first_vertex * vertex_stride, vertex_count * vertex_stride);
+
+        uint32_t vertex_start = vertex_buffer_offset / vertex_stride;
+        bool is_16_bit_index  = vertex_start + vertex_count <= 65536;
+        uint32_t index_size   = is_16_bit_index ? sizeof(uint16_t) : sizeof(uint32_t);
+
+        dmRender::HRenderBuffer index_buffer;
+        uint32_t index_buffer_offset;
+        void* indices = dmRender::AllocTransientBuffer(render_context, dmRender::RENDER_BUFFER_TYPE_INDEX_BUFFER, index_count * index_size, index_size, SPRITE_TRANSIENT_CATEGORY, &index_buffer, &index_buffer_offset);
+
+        // The staging indices count from the start of the staging buffer
+        for (uint32_t i = 0; i < index_count; ++i)
+        {
+            uint32_t index = sprite_world->m_Is16BitIndex ? ((const uint16_t*) ib_begin)[i] : ((const uint32_t*) ib_begin)[i];
+            index = index - first_vertex + vertex_start;
+            if (is_16_bit_index)
+                ((uint16_t*) indices)[i] = (uint16_t) index;
+            else
+                ((uint32_t*) indices)[i] = index;
+        }
+
+        ro.m_VertexBuffer = (dmGraphics::HVertexBuffer) vertex_buffer;
+        ro.m_IndexBuffer  = (dmGraphics::HIndexBuffer) index_buffer;
+        ro.m_IndexType    = is_16_bit_index ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
+
+        // These should be named "element" or "index" (as opposed to vertex)
+        ro.m_VertexStart = index_buffer_offset; // offset in bytes into element buffer
+        ro.m_VertexCount = index_count;
+    }
+
     static void RenderBatch(SpriteWorld* sprite_world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
     {
         DM_PROFILE("SpriteRenderBatch");
@@ -1304,19 +1497,8 @@ namespace dmGameSystem
         sprite_world->m_VertexBufferWritePtr = vb_iter;
         sprite_world->m_IndexBufferWritePtr = ib_iter;
 
-        if (dmRender::GetBufferIndex(render_context, sprite_world->m_VertexBuffer) < sprite_world->m_DispatchCount)
-        {
-            dmRender::AddRenderBuffer(render_context, sprite_world->m_VertexBuffer);
-        }
-        if (dmRender::GetBufferIndex(render_context, sprite_world->m_IndexBuffer) < sprite_world->m_DispatchCount)
-        {
-            dmRender::AddRenderBuffer(render_context, sprite_world->m_IndexBuffer);
-        }
-
         ro.Init();
         ro.m_VertexDeclaration = vx_decl;
-        ro.m_VertexBuffer = (dmGraphics::HVertexBuffer) dmRender::GetBuffer(render_context, sprite_world->m_VertexBuffer);
-        ro.m_IndexBuffer = (dmGraphics::HIndexBuffer) dmRender::GetBuffer(render_context, sprite_world->m_IndexBuffer);
         ro.m_Material = material;
         for(uint32_t i = 0; i < resource->m_NumTextures; ++i)
         {
@@ -1324,18 +1506,8 @@ namespace dmGameSystem
         }
 
         ro.m_PrimitiveType = dmGraphics::PRIMITIVE_TRIANGLES;
-        ro.m_IndexType = sprite_world->m_Is16BitIndex ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
-
-        // offset in bytes into element buffer
-        uint32_t index_offset = ib_begin - sprite_world->m_IndexBufferData;
 
-        // num elements = Number of bytes / sizeof(index_type)
-        uint32_t index_type_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
-        uint32_t num_elements = ((uint8_t*)sprite_world->m_IndexBufferWritePtr - (uint8_t*)ib_begin) / index_type_size;
-
-        // These should be named "element" or "index" (as opposed to vertex)
-        ro.m_VertexStart = index_offset;
-        ro.m_VertexCount = num_elements;
+        UploadBatch(sprite_world, render_context, material_attribute_info.m_VertexStride, vb_begin, vb_iter, ib_begin, ib_iter, ro);
 
         HComponentRenderConstants constants = GetRenderConstants(first);
         if (constants) {
@@ -1389,42 +1561,31 @@ namespace dmGameSystem
             SpriteComponent* c = &components[0];
             scale_along_z = dmGameObject::ScaleAlongZ(dmGameObject::GetCollection(c->m_Instance));
         }
-        // Note: We update all sprites, even though they might be disabled, or not added to update
+        // Note: We update all sprites, even though they might be disabled, or not added to update.
+        //       Sprites whose game object didn't move, and whose own transform didn't change, are skipped.
 
-        if (scale_along_z) {
-            for (uint32_t i = 0; i < n; ++i)
-            {
-                SpriteComponent* c = &components[i];
-                Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
-                Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
-                Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
-                c->m_World = dmVMath::AppendScale(world * local, size);
-                // we need to consider the full scale here
-                // I.e. we want the length of the diagonal C, where C = X + Y
-                float radius_sq = dmVMath::LengthSqr((c->m_World.getCol(0).getXYZ() + c->m_World.getCol(1).getXYZ()) * 0.5f);
-                sprite_world->m_BoundingVolumes[i] = radius_sq;
-            }
-        } else
+        for (uint32_t i = 0; i < n; ++i)
         {
-            for (uint32_t i = 0; i < n; ++i)
-            {
-                SpriteComponent* c = &components[i];
-                Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
-                Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
-                Matrix4 w = dmTransform::MulNoScaleZ(world, local);
-                Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
-                c->m_World = dmVMath::AppendScale(w, size);
-                // we need to consider the full scale here
-                // I.e. we want the length of the diagonal C, where C = X + Y
-                float radius_sq = dmVMath::LengthSqr((c->m_World.getCol(0).getXYZ() + c->m_World.getCol(1).getXYZ()) * 0.5f);
-                sprite_world->m_BoundingVolumes[i] = radius_sq;
-            }
-        }
+            SpriteComponent* c = &components[i];
+            const Matrix4& world = dmGameObject::GetWorldMatrix(c->m_Instance);
+            if (!c->m_TransformDirty && memcmp(&world, &c->m_GameObjectWorld, sizeof(Matrix4)) == 0)
+                continue;
 
-        // The "sub_pixels" is set by default
-        if (!sub_pixels) {
-            for (uint32_t i = 0; i < n; ++i) {
-                SpriteComponent* c = &components[i];
+            c->m_GameObjectWorld = world;
+            c->m_TransformDirty = 0;
+            c->m_VerticesDirty = 1;
+
+            Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
+            Matrix4 w = scale_along_z ? world * local : dmTransform::MulNoScaleZ(world, local);
+            Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
+            c->m_World = dmVMath::AppendScale(w, size);
+            // we need to consider the full scale here
+            // I.e. we want the length of the diagonal C, where C = X + Y
+            float radius_sq = dmVMath::LengthSqr((c->m_World.getCol(0).getXYZ() + c->m_World.getCol(1).getXYZ()) * 0.5f);
+            sprite_world->m_BoundingVolumes[i] = radius_sq;
+
+            // The "sub_pixels" is set by default
+            if (!sub_pixels) {
                 Vector4 position = c->m_World.getCol3();
                 position.setX((int) position.getX());
                 position.setY((int) position.getY());
@@ -1666,15 +1827,6 @@ namespace dmGameSystem
 
         PostMessages(world);
 
-        SpriteContext* sprite_context = (SpriteContext*)params.m_Context;
-        dmRender::TrimBuffer(sprite_context->m_RenderContext, world->m_VertexBuffer);
-        dmRender::RewindBuffer(sprite_context->m_RenderContext, world->m_VertexBuffer);
-
-        dmRender::TrimBuffer(sprite_context->m_RenderContext, world->m_IndexBuffer);
-        dmRender::RewindBuffer(sprite_context->m_RenderContext, world->m_IndexBuffer);
-
-        world->m_DispatchCount = 0;
-
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
@@ -1714,19 +1866,12 @@ namespace dmGameSystem
                     uint32_t vertex_data_size = world->m_VertexBufferWritePtr - world->m_VertexBufferData;
                     uint32_t index_data_size  = world->m_IndexBufferWritePtr - world->m_IndexBufferData;
 
-                    // JG: The renderer executes the dispatch function for begin/end regardless if something is actually batched or not
-                    //     This behaviour can cause side-effects on certain platforms and non-opengl graphics adapters.
-                    //     We might want to change how that process is setup, but for now this is a safer change.
+                    // The batches have already been copied to the transient buffers, which the renderer uploads before drawing
                     if (vertex_data_size && index_data_size)
                     {
-                        dmRender::SetBufferData(params.m_Context, world->m_VertexBuffer, vertex_data_size, world->m_VertexBufferData, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
-                        dmRender::SetBufferData(params.m_Context, world->m_IndexBuffer, index_data_size, world->m_IndexBufferData, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
-
                         DM_PROPERTY_ADD_U32(rmtp_SpriteVertexCount, world->m_VertexCount);
                         DM_PROPERTY_ADD_U32(rmtp_SpriteVertexSize, vertex_data_size);
                         DM_PROPERTY_ADD_U32(rmtp_SpriteIndexSize, index_data_size);
-
-                        world->m_DispatchCount++;
                     }
                 }
                 break;
@@ -1743,6 +1888,12 @@ namespace dmGameSystem
 
         sprite_world->m_VerticesWritten = 0;
 
+        // Start a new frame in the vertex cache, dropping the vertices from two frames ago
+        uint32_t cache_index = ++sprite_world->m_Frame & 1;
+        sprite_world->m_VertexCache[cache_index].SetSize(0);
+        sprite_world->m_IndexCache[cache_index].SetSize(0);
+        sprite_world->m_VerticesReused = 0;
+
         UpdateTransforms(sprite_world, sprite_context->m_Subpixels); // TODO: Why is this not in the update function?
 
         UpdateVertexAndIndexCount(sprite_world);
@@ -1757,7 +1908,7 @@ namespace dmGameSystem
 
         if (sprite_world->m_ReallocBuffers)
         {
-            ReAllocateBuffers(sprite_world, render_context);
+            ReAllocateBuffers(sprite_world);
         }
 
         // Submit all sprites as entries in the render list for sorting.
@@ -1905,11 +2056,13 @@ namespace dmGameSystem
             {
                 dmGameSystemDDF::SetFlipHorizontal* ddf = (dmGameSystemDDF::SetFlipHorizontal*)params.m_Message->m_Data;
                 component->m_FlipHorizontal = ddf->m_Flip != 0 ? 1 : 0;
+                component->m_VerticesDirty = 1;
             }
             else if (params.m_Message->m_Id == dmGameSystemDDF::SetFlipVertical::m_DDFDescriptor->m_NameHash)
             {
                 dmGameSystemDDF::SetFlipVertical* ddf = (dmGameSystemDDF::SetFlipVertical*)params.m_Message->m_Data;
                 component->m_FlipVertical = ddf->m_Flip != 0 ? 1 : 0;
+                component->m_VerticesDirty = 1;
             }
             else if (params.m_Message->m_Id == dmGameSystemDDF::SetConstant::m_DDFDescriptor->m_NameHash)
             {
@@ -1938,6 +2091,7 @@ namespace dmGameSystem
             {
                 dmGameSystemDDF::SetScale* ddf = (dmGameSystemDDF::SetScale*)params.m_Message->m_Data;
                 component->m_Scale = ddf->m_Scale;
+                component->m_TransformDirty = 1;
             }
         }
 
@@ -1948,6 +2102,8 @@ namespace dmGameSystem
     {
         SpriteWorld* sprite_world = (SpriteWorld*)params.m_World;
         SpriteComponent* component = &sprite_world->m_Components.Get(*params.m_UserData);
+        component->m_TransformDirty = 1;
+        component->m_VerticesDirty = 1;
         if (component->m_Playing)
             PlayAnimation(component, component->m_CurrentAnimation, component->m_AnimTimer, component->m_PlaybackRate);
     }
@@ -2026,6 +2182,7 @@ namespace dmGameSystem
 
         if (IsReferencingProperty(SPRITE_PROP_SCALE, set_property))
         {
+            component->m_TransformDirty = 1;
             return SetProperty(set_property, params.m_Value, component->m_Scale, SPRITE_PROP_SCALE);
         }
         else if (IsReferencingProperty(SPRITE_PROP_SIZE, set_property))
@@ -2034,6 +2191,7 @@ namespace dmGameSystem
             {
                 return dmGameObject::PROPERTY_RESULT_UNSUPPORTED_OPERATION;
             }
+            component->m_TransformDirty = 1;
             return SetProperty(set_property, params.m_Value, component->m_Size, SPRITE_PROP_SIZE);
         }
         else if (IsReferencingProperty(SPRITE_PROP_SLICE, set_property))
@@ -2047,6 +2205,7 @@ namespace dmGameSystem
             if (dmGameObject::PROPERTY_RESULT_OK == result)
             {
                 component->m_UseSlice9 = sum(component->m_Slice9) != 0;
+                component->m_VerticesDirty = 1;
             }
             return result;
         }
@@ -2070,6 +2229,7 @@ namespace dmGameSystem
         {
             dmGameObject::PropertyResult res = AddOverrideMaterial(dmGameObject::GetFactory(params.m_Instance), component, params.m_Value.m_Hash);
             component->m_ReHash |= res == dmGameObject::PROPERTY_RESULT_OK;
+            component->m_VerticesDirty |= res == dmGameObject::PROPERTY_RESULT_OK;
             return res;
         }
         else if (set_property == PROP_IMAGE)
@@ -2079,6 +2239,7 @@ namespace dmGameSystem
             dmhash_t sampler_name_hash = 0;
             dmGameObject::PropertyResult res = AddOverrideTextureSet(dmGameObject::GetFactory(params.m_Instance), component, sampler_name_hash, params.m_Value.m_Hash);
             component->m_ReHash |= res == dmGameObject::PROPERTY_RESULT_OK;
+            component->m_VerticesDirty |= res == dmGameObject::PROPERTY_RESULT_OK;
 
             // Since the animation referred to the old texture, we need to update it
             if (res == dmGameObject::PROPERTY_RESULT_OK)
@@ -2112,7 +2273,9 @@ namespace dmGameSystem
         {
             return dmGameObject::PROPERTY_RESULT_OK;
         }
-        return SetMaterialAttribute(sprite_world->m_DynamicVertexAttributePool, &component->m_DynamicVertexAttributeIndex, material, set_property, params.m_Value, CompSpriteGetMaterialAttributeCallback, component);
+        dmGameObject::PropertyResult res = SetMaterialAttribute(sprite_world->m_DynamicVertexAttributePool, &component->m_DynamicVertexAttributeIndex, material, set_property, params.m_Value, CompSpriteGetMaterialAttributeCallback, component);
+        component->m_VerticesDirty |= res == dmGameObject::PROPERTY_RESULT_OK;
+        return res;
     }
 
     static bool CompSpriteIterPropertiesGetNext(dmGameObject::SceneNodePropertyIterator* pit)
@@ -2227,10 +2390,29 @@ namespace dmGameSystem
     }
 
     // For tests
-    void GetSpriteWorldRenderBuffers(void* sprite_world, dmRender::HBufferedRenderBuffer* vx_buffer, dmRender::HBufferedRenderBuffer* ix_buffer)
+    // The render objects of the last dispatch
+    void GetSpriteWorldRenderObjects(void* sprite_world, dmRender::RenderObject*** render_objects, uint32_t* render_objects_count)
+    {
+        SpriteWorld* world = (SpriteWorld*) sprite_world;
+        *render_objects       = world->m_RenderObjects.Begin();
+        *render_objects_count = world->m_RenderObjectsInUse;
+    }
+
+    uint32_t GetSpriteWorldVerticesReused(void* sprite_world)
+    {
+        SpriteWorld* world = (SpriteWorld*) sprite_world;
+        return world->m_VerticesReused;
+    }
+
+    // Forces all sprites to recalculate their transforms and vertices on the next render
+    void InvalidateSpriteWorldVertexCache(void* sprite_world)
     {
         SpriteWorld* world = (SpriteWorld*) sprite_world;
-        *vx_buffer = world->m_VertexBuffer;
-        *ix_buffer = world->m_IndexBuffer;
+        dmArray<SpriteComponent>& components = world->m_Components.GetRawObjects();
+        for (uint32_t i = 0; i < components.Size(); ++i)
+        {
+            components[i].m_TransformDirty = 1;
+            components[i].m_VerticesDirty = 1;
+        }
     }
 }
@@ -29,6 +29,7 @@
 #include <gameobject/gameobject.h>
 #include <gameobject/gameobject_ddf.h>
 #include <dmsdk/dlib/vmath.h>
+#include <dmsdk/dlib/intersection.h>
 
 #include "../gamesys_private.h"
 #include "../gamesys.h"
@@ -47,25 +48,23 @@ DM_PROPERTY_U32(rmtp_TilemapVertexSize, 0, FrameReset, "size of vertices in byte
 
 namespace dmGameSystem
 {
-    const uint32_t TILEGRID_REGION_SIZE = 32;
+    const uint32_t TILEGRID_CHUNK_CELL_COUNT = TILEGRID_REGION_SIZE * TILEGRID_REGION_SIZE;
+    const uint16_t TILEGRID_EMPTY_CELL = 0xffff;
 
     using namespace dmVMath;
 
-    // A "region" spans all layers (in Z) for a bounding box [(x1,y1), (x2,y2)]
-    // where the the box spans TILEGRID_REGION_SIZE tiles in each direction
-    struct TileGridRegion
-    {
-        uint8_t m_Dirty:1;
-        uint8_t m_Occupied:1;
-        uint8_t :6;
-    };
-
     struct TileGridLayer
     {
+        uint32_t m_ChunkCount; // Number of allocated chunks in this layer
         uint8_t m_IsVisible:1;
         uint8_t :7;
     };
 
+    struct TileGridChunk;
+
+    // A "region" is a bounding box [(x1,y1), (x2,y2)] spanning TILEGRID_REGION_SIZE tiles in each direction.
+    // The cells of one layer within a region are stored in a chunk, which is only allocated while it
+    // holds at least one tile. Empty parts of the map take no memory and produce no render entries.
     struct TileGridComponent
     {
         struct Flags
@@ -76,12 +75,13 @@ namespace dmGameSystem
 
         TileGridComponent()
         : m_Instance(0)
-        , m_Cells(0)
-        , m_CellFlags(0)
         , m_RenderConstants(0)
         , m_Material(0)
         , m_TextureSet(0)
         , m_Resource(0)
+        , m_RegionsX(0)
+        , m_RegionsY(0)
+        , m_Occupied(0)
         {
         }
 
@@ -89,23 +89,29 @@ namespace dmGameSystem
         dmVMath::Quat               m_Rotation;
         dmVMath::Matrix4            m_World;
         dmGameObject::HInstance     m_Instance;
-        uint16_t*                   m_Cells;
-        Flags*                      m_CellFlags;
-        dmArray<TileGridRegion>     m_Regions;
+        dmArray<TileGridChunk*>     m_Chunks; // (layer, region_y, region_x), 0 for empty chunks
         dmArray<TileGridLayer>      m_Layers;
         uint32_t                    m_MixedHash;
         HComponentRenderConstants   m_RenderConstants;
         MaterialResource*           m_Material;
         TextureSetResource*         m_TextureSet;
         TileGridResource*           m_Resource;
+        float                       m_RegionRadiusSq; // Squared world space bounding radius of a region
         uint16_t                    m_RegionsX; // number of regions in the x dimension
         uint16_t                    m_RegionsY; // number of regions in the y dimension
-        uint16_t                    m_Occupied; // Number of occupied regions (regions with visible tiles)
+        uint32_t                    m_Occupied; // Number of chunks in the visible layers
         uint8_t                     m_Enabled : 1;
         uint8_t                     m_AddedToUpdate : 1;
         uint8_t                     : 6;
     };
 
+    struct TileGridChunk
+    {
+        uint16_t                    m_Cells[TILEGRID_CHUNK_CELL_COUNT]; // Row by row from the lower left corner
+        TileGridComponent::Flags    m_CellFlags[TILEGRID_CHUNK_CELL_COUNT];
+        uint16_t                    m_TileCount; // Number of non empty cells
+    };
+
     struct TileGridVertex
     {
         float x, y, z, u, v;
@@ -194,9 +200,83 @@ namespace dmGameSystem
         return component->m_TextureSet ? component->m_TextureSet : component->m_Resource->m_TextureSet;
     }
 
-    uint32_t CalculateCellIndex(uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t column_count, uint32_t row_count)
+    static inline uint32_t GetChunkIndex(const TileGridComponent* component, uint32_t layer, uint32_t region_x, uint32_t region_y)
+    {
+        return (layer * component->m_RegionsY + region_y) * component->m_RegionsX + region_x;
+    }
+
+    static inline uint32_t GetChunkCellIndex(int32_t cell_x, int32_t cell_y)
+    {
+        return (cell_y % TILEGRID_REGION_SIZE) * TILEGRID_REGION_SIZE + (cell_x % TILEGRID_REGION_SIZE);
+    }
+
+    static TileGridChunk* NewChunk()
+    {
+        TileGridChunk* chunk = new TileGridChunk;
+        memset(chunk->m_Cells, 0xff, sizeof(chunk->m_Cells));
+        memset(chunk->m_CellFlags, 0, sizeof(chunk->m_CellFlags));
+        chunk->m_TileCount = 0;
+        return chunk;
+    }
+
+    static inline void SetChunkCell(TileGridChunk* chunk, uint32_t cell_index, uint16_t tile, uint8_t transform_mask)
     {
-        return layer * row_count * column_count + (cell_x + cell_y * column_count);
+        uint16_t prev_tile = chunk->m_Cells[cell_index];
+        chunk->m_Cells[cell_index] = tile;
+        chunk->m_CellFlags[cell_index].m_TransformMask = transform_mask;
+        if (prev_tile == TILEGRID_EMPTY_CELL && tile != TILEGRID_EMPTY_CELL)
+        {
+            chunk->m_TileCount++;
+        }
+        else if (prev_tile != TILEGRID_EMPTY_CELL && tile == TILEGRID_EMPTY_CELL)
+        {
+            chunk->m_TileCount--;
+        }
+    }
+
+    // Stores the chunk at the index, or frees it if it holds no tiles
+    static void SetChunk(TileGridComponent* component, uint32_t layer, uint32_t chunk_index, TileGridChunk* chunk)
+    {
+        TileGridChunk* prev = component->m_Chunks[chunk_index];
+        if (chunk && chunk->m_TileCount == 0)
+        {
+            if (chunk != prev)
+            {
+                delete chunk;
+            }
+            chunk = 0;
+        }
+        if (prev == chunk)
+        {
+            return;
+        }
+
+        if (prev)
+        {
+            delete prev;
+            component->m_Layers[layer].m_ChunkCount--;
+        }
+        if (chunk)
+        {
+            component->m_Layers[layer].m_ChunkCount++;
+        }
+        component->m_Chunks[chunk_index] = chunk;
+    }
+
+    static void DeleteChunks(TileGridComponent* component)
+    {
+        uint32_t chunk_count = component->m_Chunks.Size();
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            delete component->m_Chunks[i];
+        }
+        component->m_Chunks.SetSize(0);
+
+        uint32_t n_layers = component->m_Layers.Size();
+        for (uint32_t i = 0; i < n_layers; ++i)
+        {
+            component->m_Layers[i].m_ChunkCount = 0;
+        }
     }
 
     void GetTileGridBounds(const TileGridComponent* component, int32_t* x, int32_t* y, int32_t* w, int32_t* h)
@@ -216,9 +296,13 @@ namespace dmGameSystem
 
     uint16_t GetTileGridTile(const TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y)
     {
-        TileGridResource* resource = component->m_Resource;
-        uint32_t cell_index = CalculateCellIndex(layer, cell_x, cell_y, resource->m_ColumnCount, resource->m_RowCount);
-        uint16_t cell = (component->m_Cells[cell_index] + 1);
+        uint32_t chunk_index = GetChunkIndex(component, layer, cell_x / TILEGRID_REGION_SIZE, cell_y / TILEGRID_REGION_SIZE);
+        const TileGridChunk* chunk = component->m_Chunks[chunk_index];
+        if (!chunk)
+        {
+            return 0;
+        }
+        uint16_t cell = (chunk->m_Cells[GetChunkCellIndex(cell_x, cell_y)] + 1);
         return cell;
     }
 
@@ -228,25 +312,152 @@ namespace dmGameSystem
         layer->m_IsVisible = visible;
     }
 
-    static void SetRegionDirty(TileGridComponent* component, int32_t cell_x, int32_t cell_y)
+    void SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t transform_mask)
     {
-        uint32_t region_x = cell_x / TILEGRID_REGION_SIZE;
-        uint32_t region_y = cell_y / TILEGRID_REGION_SIZE;
-        uint32_t region_index = region_y * component->m_RegionsX + region_x;
-        TileGridRegion* region = &component->m_Regions[region_index];
-        region->m_Dirty = 1;
+        uint32_t chunk_index = GetChunkIndex(component, layer, cell_x / TILEGRID_REGION_SIZE, cell_y / TILEGRID_REGION_SIZE);
+        TileGridChunk* chunk = component->m_Chunks[chunk_index];
+        if (!chunk)
+        {
+            if ((uint16_t)tile == TILEGRID_EMPTY_CELL)
+            {
+                return;
+            }
+            chunk = NewChunk();
+        }
+
+        SetChunkCell(chunk, GetChunkCellIndex(cell_x, cell_y), (uint16_t)tile, transform_mask);
+        SetChunk(component, layer, chunk_index, chunk);
     }
 
-    void SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t transform_mask)
+    void SetTileGridTiles(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t width, uint32_t height,
+                            const uint16_t* tiles, uint32_t tiles_stride, const uint8_t* transform_masks, uint32_t transform_masks_stride)
+    {
+        if (width == 0 || height == 0)
+        {
+            return;
+        }
+
+        // Write the part of the rectangle that overlaps each region, so that each chunk is looked up,
+        // allocated or freed only once
+        const int32_t region_size = (int32_t)TILEGRID_REGION_SIZE;
+        int32_t end_x = cell_x + (int32_t)width;
+        int32_t end_y = cell_y + (int32_t)height;
+        for (int32_t region_y = cell_y / region_size; region_y * region_size < end_y; ++region_y)
+        {
+            int32_t min_y = dmMath::Max(cell_y, region_y * region_size);
+            int32_t max_y = dmMath::Min(end_y, (region_y + 1) * region_size);
+
+            for (int32_t region_x = cell_x / region_size; region_x * region_size < end_x; ++region_x)
+            {
+                int32_t min_x = dmMath::Max(cell_x, region_x * region_size);
+                int32_t max_x = dmMath::Min(end_x, (region_x + 1) * region_size);
+
+                uint32_t chunk_index = GetChunkIndex(component, layer, region_x, region_y);
+                TileGridChunk* chunk = component->m_Chunks[chunk_index];
+
+                for (int32_t y = min_y; y < max_y; ++y)
+                {
+                    for (int32_t x = min_x; x < max_x; ++x)
+                    {
+                        uint32_t i = (y - cell_y) * width + (x - cell_x);
+                        uint16_t tile = tiles[i * tiles_stride] - 1;
+                        if (!chunk)
+                        {
+                            if (tile == TILEGRID_EMPTY_CELL)
+                            {
+                                continue;
+                            }
+                            chunk = NewChunk();
+                        }
+                        uint8_t transform_mask = transform_masks ? transform_masks[i * transform_masks_stride] : 0;
+                        SetChunkCell(chunk, GetChunkCellIndex(x, y), tile, transform_mask);
+                    }
+                }
+
+                if (chunk)
+                {
+                    SetChunk(component, layer, chunk_index, chunk);
+                }
+            }
+        }
+    }
+
+    void GetTileGridTiles(const TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t width, uint32_t height,
+                            uint16_t* tiles, uint32_t tiles_stride, uint8_t* transform_masks, uint32_t transform_masks_stride)
+    {
+        const int32_t region_size = (int32_t)TILEGRID_REGION_SIZE;
+        int32_t end_x = cell_x + (int32_t)width;
+        int32_t end_y = cell_y + (int32_t)height;
+        for (int32_t region_y = cell_y / region_size; region_y * region_size < end_y; ++region_y)
+        {
+            int32_t min_y = dmMath::Max(cell_y, region_y * region_size);
+            int32_t max_y = dmMath::Min(end_y, (region_y + 1) * region_size);
+
+            for (int32_t region_x = cell_x / region_size; region_x * region_size < end_x; ++region_x)
+            {
+                int32_t min_x = dmMath::Max(cell_x, region_x * region_size);
+                int32_t max_x = dmMath::Min(end_x, (region_x + 1) * region_size);
+
+                const TileGridChunk* chunk = component->m_Chunks[GetChunkIndex(component, layer, region_x, region_y)];
+                for (int32_t y = min_y; y < max_y; ++y)
+                {
+                    for (int32_t x = min_x; x < max_x; ++x)
+                    {
+                        uint32_t i = (y - cell_y) * width + (x - cell_x);
+                        uint32_t cell_index = GetChunkCellIndex(x, y);
+                        tiles[i * tiles_stride] = chunk ? (uint16_t)(chunk->m_Cells[cell_index] + 1) : 0;
+                        if (transform_masks)
+                        {
+                            transform_masks[i * transform_masks_stride] = chunk ? chunk->m_CellFlags[cell_index].m_TransformMask : 0;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void GetTileGridChunkCount(const TileGridComponent* component, uint32_t* chunks_x, uint32_t* chunks_y)
+    {
+        *chunks_x = component->m_RegionsX;
+        *chunks_y = component->m_RegionsY;
+    }
+
+    void LoadTileGridChunk(TileGridComponent* component, uint32_t layer, uint32_t chunk_x, uint32_t chunk_y, const uint16_t* tiles, const uint8_t* transform_masks)
     {
+        uint32_t chunk_index = GetChunkIndex(component, layer, chunk_x, chunk_y);
+        TileGridChunk* chunk = component->m_Chunks[chunk_index];
+        if (!chunk)
+        {
+            chunk = NewChunk();
+        }
+
+        // The cells of the edge chunks that fall outside of the tile grid are left empty
         TileGridResource* resource = component->m_Resource;
-        uint32_t cell_index = CalculateCellIndex(layer, cell_x, cell_y, resource->m_ColumnCount, resource->m_RowCount);
-        component->m_Cells[cell_index] = tile;
+        uint32_t width = dmMath::Min(TILEGRID_REGION_SIZE, resource->m_ColumnCount - chunk_x * TILEGRID_REGION_SIZE);
+        uint32_t height = dmMath::Min(TILEGRID_REGION_SIZE, resource->m_RowCount - chunk_y * TILEGRID_REGION_SIZE);
+
+        memset(chunk->m_Cells, 0xff, sizeof(chunk->m_Cells));
+        memset(chunk->m_CellFlags, 0, sizeof(chunk->m_CellFlags));
+        uint32_t tile_count = 0;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint32_t i = y * TILEGRID_REGION_SIZE + x;
+                uint16_t tile = tiles[i] - 1;
+                chunk->m_Cells[i] = tile;
+                chunk->m_CellFlags[i].m_TransformMask = transform_masks ? transform_masks[i] : 0;
+                tile_count += tile != TILEGRID_EMPTY_CELL;
+            }
+        }
+        chunk->m_TileCount = tile_count;
 
-        TileGridComponent::Flags* flags = &component->m_CellFlags[cell_index];
-        flags->m_TransformMask = transform_mask;
+        SetChunk(component, layer, chunk_index, chunk);
+    }
 
-        SetRegionDirty(component, cell_x, cell_y);
+    void UnloadTileGridChunk(TileGridComponent* component, uint32_t layer, uint32_t chunk_x, uint32_t chunk_y)
+    {
+        SetChunk(component, layer, GetChunkIndex(component, layer, chunk_x, chunk_y), 0);
     }
 
     uint16_t GetTileCount(const TileGridComponent* component) {
@@ -270,74 +481,20 @@ namespace dmGameSystem
         component->m_MixedHash = dmHashFinal32(&state);
     }
 
-    static void CreateRegions(TileGridComponent* component, TileGridResource* resource)
+    // Number of chunks that will be rendered
+    static uint32_t CalcNumVisibleChunks(const TileGridComponent* component)
     {
-        // Round up to closest multiple
-        component->m_RegionsX = ((resource->m_ColumnCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
-        component->m_RegionsY = ((resource->m_RowCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
-        uint32_t region_count = component->m_RegionsX * component->m_RegionsY;
-
-        component->m_Regions.SetCapacity(region_count);
-        component->m_Regions.SetSize(region_count);
-        memset(&component->m_Regions[0], 0xFF, region_count * sizeof(TileGridRegion)); // mark them all dirty
-    }
-
-    static uint32_t UpdateRegion(TileGridComponent* component, uint32_t region_x, uint32_t region_y)
-    {
-        uint32_t index = region_y * component->m_RegionsX + region_x;
-        TileGridRegion* region = &component->m_Regions[index];
-        if (!region->m_Dirty) {
-            return region->m_Occupied;
-        }
-        region->m_Dirty = 0;
-
-        TileGridResource* resource = component->m_Resource;
-        dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
-
-        uint32_t n_layers = tile_grid_ddf->m_Layers.m_Count;
-
-        uint32_t column_count = resource->m_ColumnCount;
-        uint32_t row_count = resource->m_RowCount;
-        int32_t min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
-        int32_t min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
-        int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)column_count);
-        int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)row_count);
-
-        region->m_Occupied = 0;
-
-        for (uint32_t j = 0; j < n_layers; ++j)
+        uint32_t num_chunks = 0;
+        uint32_t n_layers = component->m_Layers.Size();
+        for (uint32_t l = 0; l < n_layers; ++l)
         {
-            TileGridLayer* layer = &component->m_Layers[j];
-            if (!layer->m_IsVisible)
-                continue;
-
-            for (int32_t y = min_y; y < max_y; ++y)
+            const TileGridLayer* layer = &component->m_Layers[l];
+            if (layer->m_IsVisible)
             {
-                for (int32_t x = min_x; x < max_x; ++x)
-                {
-                    uint32_t cell = CalculateCellIndex(j, x - resource->m_MinCellX, y - resource->m_MinCellY, column_count, row_count);
-                    uint16_t tile = component->m_Cells[cell];
-                    if (tile != 0xffff)
-                    {
-                        region->m_Occupied = 1;
-                        return region->m_Occupied;
-                    }
-                }
+                num_chunks += layer->m_ChunkCount;
             }
         }
-
-        return region->m_Occupied;
-    }
-
-    static uint32_t UpdateRegions(TileGridComponent* component)
-    {
-        uint32_t occupied = 0;
-        for (uint32_t region_y = 0; region_y < component->m_RegionsY; ++region_y) {
-            for (uint32_t region_x = 0; region_x < component->m_RegionsX; ++region_x) {
-                occupied += UpdateRegion(component, region_x, region_y);
-            }
-        }
-        return occupied;
+        return num_chunks;
     }
 
     static uint32_t CreateTileGrid(TileGridComponent* component)
@@ -345,23 +502,21 @@ namespace dmGameSystem
         TileGridResource* resource = component->m_Resource;
         dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
         uint32_t n_layers = tile_grid_ddf->m_Layers.m_Count;
-        uint32_t cell_count = resource->m_ColumnCount * resource->m_RowCount * n_layers;
-        if (component->m_Cells != 0x0)
-        {
-            delete [] component->m_Cells;
-        }
-        component->m_Cells = new uint16_t[cell_count];
-        memset(component->m_Cells, 0xff, cell_count * sizeof(uint16_t));
-        if (component->m_CellFlags != 0x0)
+        DeleteChunks(component);
+
+        // Round up to closest multiple
+        component->m_RegionsX = ((resource->m_ColumnCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
+        component->m_RegionsY = ((resource->m_RowCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
+        uint32_t chunk_count = component->m_RegionsX * component->m_RegionsY * n_layers;
+        component->m_Chunks.SetCapacity(chunk_count);
+        component->m_Chunks.SetSize(chunk_count);
+        if (chunk_count > 0)
         {
-            delete [] component->m_CellFlags;
+            memset(component->m_Chunks.Begin(), 0, chunk_count * sizeof(TileGridChunk*));
         }
-        component->m_CellFlags = new TileGridComponent::Flags[cell_count];
-        memset(component->m_CellFlags, 0, cell_count * sizeof(TileGridComponent::Flags));
+
         int32_t min_x = resource->m_MinCellX;
         int32_t min_y = resource->m_MinCellY;
-        uint32_t column_count = resource->m_ColumnCount;
-        uint32_t row_count = resource->m_RowCount;
 
         component->m_Layers.SetCapacity(n_layers);
         component->m_Layers.SetSize(n_layers);
@@ -371,33 +526,31 @@ namespace dmGameSystem
             dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[i];
 
             component->m_Layers[i].m_IsVisible = layer_ddf->m_IsVisible;
+            component->m_Layers[i].m_ChunkCount = 0;
 
             uint32_t n_cells = layer_ddf->m_Cell.m_Count;
             for (uint32_t j = 0; j < n_cells; ++j)
             {
                 dmGameSystemDDF::TileCell* cell = &layer_ddf->m_Cell[j];
-                uint32_t cell_index = CalculateCellIndex(i, cell->m_X - min_x, cell->m_Y - min_y, column_count, row_count);
-                component->m_Cells[cell_index] = (uint16_t)cell->m_Tile;
 
-                TileGridComponent::Flags* flags = &component->m_CellFlags[cell_index];
-                flags->m_TransformMask = 0;
+                uint8_t transform_mask = 0;
                 if (cell->m_HFlip)
                 {
-                    flags->m_TransformMask = FLIP_HORIZONTAL;
+                    transform_mask = FLIP_HORIZONTAL;
                 }
                 if (cell->m_VFlip)
                 {
-                    flags->m_TransformMask |= FLIP_VERTICAL;
+                    transform_mask |= FLIP_VERTICAL;
                 }
                 if (cell->m_Rotate90)
                 {
-                    flags->m_TransformMask |= ROTATE_90;
+                    transform_mask |= ROTATE_90;
                 }
+                SetTileGridTile(component, i, cell->m_X - min_x, cell->m_Y - min_y, cell->m_Tile, transform_mask);
             }
         }
 
-        CreateRegions(component, resource);
-        component->m_Occupied = UpdateRegions(component);
+        component->m_Occupied = CalcNumVisibleChunks(component);
         return n_layers;
     }
 
@@ -450,8 +603,7 @@ namespace dmGameSystem
                     dmResource::Release(dmGameObject::GetFactory(params.m_Instance), tile_grid->m_TextureSet);
                 }
 
-                delete [] tile_grid->m_Cells;
-                delete [] tile_grid->m_CellFlags;
+                DeleteChunks(tile_grid);
 
                 if (tile_grid->m_RenderConstants)
                 {
@@ -494,7 +646,7 @@ namespace dmGameSystem
                 continue;
             }
 
-            component->m_Occupied = UpdateRegions(component);
+            component->m_Occupied = CalcNumVisibleChunks(component);
             if (!component->m_Occupied) {
                 continue;
             }
@@ -509,6 +661,12 @@ namespace dmGameSystem
             {
                 component->m_World = dmTransform::MulNoScaleZ(go_world, local);
             }
+
+            // The bounding sphere of a region, centered in the region. Both diagonals are tested in case of skew.
+            dmGameSystemDDF::TextureSet* texture_set_ddf = GetTextureSet(component)->m_TextureSet;
+            Vector3 half_x = component->m_World.getCol0().getXYZ() * (TILEGRID_REGION_SIZE * 0.5f * texture_set_ddf->m_TileWidth);
+            Vector3 half_y = component->m_World.getCol1().getXYZ() * (TILEGRID_REGION_SIZE * 0.5f * texture_set_ddf->m_TileHeight);
+            component->m_RegionRadiusSq = dmMath::Max(lengthSqr(half_x + half_y), lengthSqr(half_x - half_y));
         }
         DM_PROPERTY_ADD_U32(rmtp_Tilemap, world->m_Components.Size());
 
@@ -573,21 +731,24 @@ namespace dmGameSystem
             const Matrix4& w = component->m_World;
             const float z = layer_ddf->m_Z;
 
-            uint32_t column_count = resource->m_ColumnCount;
-            uint32_t row_count = resource->m_RowCount;
+            const TileGridChunk* chunk = component->m_Chunks[GetChunkIndex(component, layer, region_x, region_y)];
+            if (!chunk)
+            {
+                continue;
+            }
 
             int32_t min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
             int32_t min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
-            int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)column_count);
-            int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)row_count);
+            uint32_t width = dmMath::Min(TILEGRID_REGION_SIZE, resource->m_ColumnCount - region_x * TILEGRID_REGION_SIZE);
+            uint32_t height = dmMath::Min(TILEGRID_REGION_SIZE, resource->m_RowCount - region_y * TILEGRID_REGION_SIZE);
 
-            for (int32_t y = min_y; y < max_y; ++y)
+            for (uint32_t y = 0; y < height; ++y)
             {
-                for (int32_t x = min_x; x < max_x; ++x)
+                for (uint32_t x = 0; x < width; ++x)
                 {
-                    uint32_t cell = CalculateCellIndex(layer, x - resource->m_MinCellX, y - resource->m_MinCellY, column_count, row_count);
-                    uint16_t tile = component->m_Cells[cell];
-                    if (tile == 0xffff)
+                    uint32_t cell = y * TILEGRID_REGION_SIZE + x;
+                    uint16_t tile = chunk->m_Cells[cell];
+                    if (tile == TILEGRID_EMPTY_CELL)
                     {
                         continue;
                     }
@@ -599,10 +760,10 @@ namespace dmGameSystem
                     }
 
                     float p[4];
-                    CalculateCellBounds(x, y, 1, 1, p);
+                    CalculateCellBounds(min_x + x, min_y + y, 1, 1, p);
                     const float* puv = &tex_coords[tile * 8];
 
-                    TileGridComponent::Flags flags = component->m_CellFlags[cell];
+                    TileGridComponent::Flags flags = chunk->m_CellFlags[cell];
                     const int* tex_lookup = &tex_coord_order[flags.m_TransformMask * 6];
 
                     #define SET_VERTEX(_I, _X, _Y, _Z, _U, _V) \
@@ -733,7 +894,28 @@ namespace dmGameSystem
         }
     }
 
-    // Estimates the number of render entries needed
+    static void RenderListFrustumCulling(dmRender::RenderListVisibilityParams const &params)
+    {
+        DM_PROFILE("TileGrid");
+
+        TileGridWorld* world = (TileGridWorld*)params.m_UserData;
+
+        const dmIntersection::Frustum frustum = *params.m_Frustum;
+        uint32_t num_entries = params.m_NumEntries;
+        for (uint32_t i = 0; i < num_entries; ++i)
+        {
+            dmRender::RenderListEntry* entry = &params.m_Entries[i];
+
+            uint32_t index, layer, region_x, region_y;
+            DecodeGridAndLayer(entry->m_UserData, index, layer, region_x, region_y);
+            float radius_sq = world->m_Components[index]->m_RegionRadiusSq;
+
+            bool intersect = dmIntersection::TestFrustumSphereSq(frustum, entry->m_WorldPosition, radius_sq);
+            entry->m_Visibility = intersect ? dmRender::VISIBILITY_FULL : dmRender::VISIBILITY_NONE;
+        }
+    }
+
+    // Calculates the number of render entries needed
     static uint32_t CalcNumVisibleRegions(TileGridComponent** components, uint32_t num_components)
     {
         uint32_t num_render_entries = 0;
@@ -743,15 +925,7 @@ namespace dmGameSystem
             if (!component->m_Enabled || !component->m_AddedToUpdate || !component->m_Occupied) {
                 continue;
             }
-            uint32_t n_layers = component->m_Layers.Size();
-            for (uint32_t l = 0; l < n_layers; ++l)
-            {
-                const TileGridLayer* layer = &component->m_Layers[l];
-                if (!layer->m_IsVisible)
-                    continue;
-
-                num_render_entries += component->m_RegionsY * component->m_RegionsX;
-            }
+            num_render_entries += CalcNumVisibleChunks(component);
         }
         return num_render_entries;
     }
@@ -779,7 +953,7 @@ namespace dmGameSystem
 
         dmRender::HRenderContext render_context = context->m_RenderContext;
         dmRender::RenderListEntry* render_list = dmRender::RenderListAlloc(render_context, num_render_entries);
-        dmRender::HRenderListDispatch dispatch = dmRender::RenderListMakeDispatch(render_context, &RenderListDispatch, world);
+        dmRender::HRenderListDispatch dispatch = dmRender::RenderListMakeDispatch(render_context, &RenderListDispatch, &RenderListFrustumCulling, world);
         dmRender::RenderListEntry* write_ptr = render_list;
 
         for (uint32_t i = 0; i < n; ++i)
@@ -809,15 +983,18 @@ namespace dmGameSystem
                     continue;
 
                 dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[l];
+                TileGridChunk** chunks = &component->m_Chunks[GetChunkIndex(component, l, 0, 0)];
                 for (uint32_t y = 0, region_index = 0; y < component->m_RegionsY; ++y) {
                     for (uint32_t x = 0; x < component->m_RegionsX; ++x, ++region_index) {
 
-                        TileGridRegion* region = &component->m_Regions[region_index];
-                        if (!region->m_Occupied) {
+                        if (!chunks[region_index]) {
                             continue;
                         }
 
-                        Vector4 trans = component->m_World * Point3(x * tile_width, y * tile_height, layer_ddf->m_Z);
+                        // The center of the region, see RenderListFrustumCulling
+                        float center_x = (resource->m_MinCellX + (int32_t)(x * TILEGRID_REGION_SIZE) + TILEGRID_REGION_SIZE * 0.5f) * tile_width;
+                        float center_y = (resource->m_MinCellY + (int32_t)(y * TILEGRID_REGION_SIZE) + TILEGRID_REGION_SIZE * 0.5f) * tile_height;
+                        Vector4 trans = component->m_World * Point3(center_x, center_y, layer_ddf->m_Z);
 
                         write_ptr->m_WorldPosition = Point3(trans.getXYZ());
                         write_ptr->m_UserData = EncodeRegionInfo(i, l, x, y);
@@ -975,4 +1152,27 @@ namespace dmGameSystem
         TileGridWorld* world = (TileGridWorld*) tilegrid_world;
         *vx_buffer = world->m_VertexBuffer;
     }
+
+    // Number of vertices written by the last dispatch
+    uint32_t GetTileGridWorldVertexCount(void* tilegrid_world)
+    {
+        TileGridWorld* world = (TileGridWorld*) tilegrid_world;
+        return world->m_VertexBufferWritePtr - world->m_VertexBufferData;
+    }
+
+    // Number of allocated chunks in all layers of all components
+    uint32_t GetTileGridWorldChunkCount(void* tilegrid_world)
+    {
+        TileGridWorld* world = (TileGridWorld*) tilegrid_world;
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < world->m_Components.Size(); ++i)
+        {
+            const TileGridComponent* component = world->m_Components[i];
+            for (uint32_t l = 0; l < component->m_Layers.Size(); ++l)
+            {
+                count += component->m_Layers[l].m_ChunkCount;
+            }
+        }
+        return count;
+    }
 }
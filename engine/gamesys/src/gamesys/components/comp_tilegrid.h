@@ -49,7 +49,8 @@ namespace dmGameSystem
     // Script support
     struct TileGridComponent;
 
-    uint32_t CalculateCellIndex(uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t column_count, uint32_t row_count);
+    // The tiles are stored in chunks of TILEGRID_REGION_SIZE x TILEGRID_REGION_SIZE cells per layer
+    const uint32_t TILEGRID_REGION_SIZE = 32;
 
     uint32_t GetLayerIndex(const TileGridComponent* component, dmhash_t layer_id);
 
@@ -61,8 +62,25 @@ namespace dmGameSystem
 
     void SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t transform_mask);
 
+    // Sets the tiles of a rectangle of cells, given row by row from the lower left corner. The tiles use the same
+    // indexing as GetTileGridTile(), where 0 is an empty cell. The strides are in elements, and transform_masks may be 0.
+    void SetTileGridTiles(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t width, uint32_t height,
+                            const uint16_t* tiles, uint32_t tiles_stride, const uint8_t* transform_masks, uint32_t transform_masks_stride);
+
+    void GetTileGridTiles(const TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t width, uint32_t height,
+                            uint16_t* tiles, uint32_t tiles_stride, uint8_t* transform_masks, uint32_t transform_masks_stride);
+
     uint16_t GetTileCount(const TileGridComponent* component);
 
+    void GetTileGridChunkCount(const TileGridComponent* component, uint32_t* chunks_x, uint32_t* chunks_y);
+
+    // Replaces all cells of a layer within a chunk. The arrays hold TILEGRID_REGION_SIZE * TILEGRID_REGION_SIZE
+    // values row by row from the lower left corner, where a tile of 0 is an empty cell (see SetTileGridTiles()).
+    // transform_masks may be 0.
+    void LoadTileGridChunk(TileGridComponent* component, uint32_t layer, uint32_t chunk_x, uint32_t chunk_y, const uint16_t* tiles, const uint8_t* transform_masks);
+
+    void UnloadTileGridChunk(TileGridComponent* component, uint32_t layer, uint32_t chunk_x, uint32_t chunk_y);
+
     void SetLayerVisible(TileGridComponent* component, uint32_t layer, bool visible);
 
     enum TileTransformMask
@@ -168,6 +168,9 @@ namespace dmGameSystem
             {
                 dmLogWarning("Reloading the material failed, some shaders might not have been correctly linked.");
             }
+
+            // The relinked program has lost its uniform values
+            dmRender::InvalidateMaterialConstants(material);
         }
     }
 
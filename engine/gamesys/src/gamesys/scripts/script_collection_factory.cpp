@@ -284,42 +284,31 @@ namespace dmGameSystem
      * ```
      */
 
-    static int CollectionFactoryComp_Create(lua_State* L)
+    // Reads the optional position, rotation, properties and scale arguments of collectionfactory.create/create_async
+    static void CheckSpawnArguments(lua_State* L, dmGameObject::HInstance sender_instance, const char* function_name,
+                                    dmVMath::Point3* position, dmVMath::Quat* rotation,
+                                    dmGameObject::InstancePropertyBuffers* prop_bufs, dmVMath::Vector3* scale)
     {
         int top = lua_gettop(L);
-        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
-        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
-
-        CollectionFactoryWorld* world;
-        CollectionFactoryComponent* component;
-        dmScript::GetComponentFromLua(L, 1, COLLECTION_FACTORY_EXT, (void**)&world, (void**)&component, 0);
-
-        dmVMath::Point3 position;
         if (top >= 2 && !lua_isnil(L, 2))
         {
-            position = dmVMath::Point3(*dmScript::CheckVector3(L, 2));
+            *position = dmVMath::Point3(*dmScript::CheckVector3(L, 2));
         }
         else
         {
-            position = dmGameObject::GetWorldPosition(sender_instance);
+            *position = dmGameObject::GetWorldPosition(sender_instance);
         }
 
-        dmVMath::Quat rotation;
         if (top >= 3 && !lua_isnil(L, 3))
         {
-            rotation = *dmScript::CheckQuat(L, 3);
+            *rotation = *dmScript::CheckQuat(L, 3);
         }
         else
         {
-            rotation = dmGameObject::GetWorldRotation(sender_instance);
+            *rotation = dmGameObject::GetWorldRotation(sender_instance);
         }
 
-        const uint32_t buffer_size = 4096;
-        uint8_t DM_ALIGNED(16) buffer[buffer_size];
-        uint32_t buffer_pos = 0;
-
-        dmGameObject::InstancePropertyBuffers prop_bufs;
-        prop_bufs.SetCapacity(8, 32);
+        prop_bufs->SetCapacity(8, 32);
 
         if (top >= 4 && !lua_isnil(L, 4))
         {
@@ -332,40 +321,74 @@ namespace dmGameSystem
                 while (lua_next(L, -2))
                 {
                     dmhash_t instance_id = dmScript::CheckHash(L, -2);
-                    uint32_t left = buffer_size - buffer_pos;
 
                     dmGameObject::HPropertyContainer properties = dmGameObject::PropertyContainerCreateFromLua(L, -1);
 
-                    prop_bufs.Put(instance_id, properties);
+                    prop_bufs->Put(instance_id, properties);
                     lua_pop(L, 1);
                 }
                 lua_pop(L, 1);
             }
             else
             {
-                return luaL_error(L, "expected table at argument #4 to collectionfactory.create");
+                luaL_error(L, "expected table at argument #4 to %s", function_name);
             }
         }
 
-        dmVMath::Vector3 scale;
         if (top >= 5 && !lua_isnil(L, 5))
         {
             // We check for zero in the ToTransform/ResetScale in transform.h
             dmVMath::Vector3* v = dmScript::ToVector3(L, 5);
             if (v != 0)
             {
-                scale = *v;
+                *scale = *v;
             }
             else
             {
                 float val = luaL_checknumber(L, 5);
-                scale = dmVMath::Vector3(val, val, val);
+                *scale = dmVMath::Vector3(val, val, val);
             }
         }
         else
         {
-            scale = dmGameObject::GetWorldScale(sender_instance);
+            *scale = dmGameObject::GetWorldScale(sender_instance);
         }
+    }
+
+    // Pushes a table mapping the collection ids to the spawned instance ids
+    static void PushInstanceTable(lua_State* L, const dmGameObject::InstanceIdMap* instances)
+    {
+        lua_newtable(L);
+        lua_createtable(L, 0, 1);
+        lua_pushcfunction(L, HashTableIndex);
+        lua_setfield(L, -2, "__index");
+        lua_setmetatable(L, -2);
+        if (instances)
+        {
+            instances->Iterate(&InsertInstanceEntry, L);
+        }
+    }
+
+    static void DestroyPropertyBuffer(void*, const dmhash_t*, dmGameObject::HPropertyContainer* value)
+    {
+        dmGameObject::PropertyContainerDestroy(*value);
+    }
+
+    static int CollectionFactoryComp_Create(lua_State* L)
+    {
+        int top = lua_gettop(L);
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        CollectionFactoryWorld* world;
+        CollectionFactoryComponent* component;
+        dmScript::GetComponentFromLua(L, 1, COLLECTION_FACTORY_EXT, (void**)&world, (void**)&component, 0);
+
+        dmVMath::Point3 position;
+        dmVMath::Quat rotation;
+        dmVMath::Vector3 scale;
+        dmGameObject::InstancePropertyBuffers prop_bufs;
+        CheckSpawnArguments(L, sender_instance, "collectionfactory.create", &position, &rotation, &prop_bufs, &scale);
 
         dmScript::GetInstance(L);
         int ref = dmScript::Ref(L, LUA_REGISTRYINDEX);
@@ -374,6 +397,9 @@ namespace dmGameSystem
         bool success = dmGameObject::SpawnFromCollection(collection, CompCollectionFactoryGetResource(component)->m_CollectionDesc, &prop_bufs,
                                                          position, rotation, scale, &instances);
 
+        // The instances took over their property containers, the ones left weren't used
+        prop_bufs.Iterate(DestroyPropertyBuffer, (void*) 0);
+
         lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
         dmScript::SetInstance(L);
         dmScript::Unref(L, LUA_REGISTRYINDEX, ref);
@@ -381,12 +407,7 @@ namespace dmGameSystem
         // Construct return table
         if (success)
         {
-            lua_newtable(L);
-            lua_createtable(L, 0, 1);
-            lua_pushcfunction(L, HashTableIndex);
-            lua_setfield(L, -2, "__index");
-            lua_setmetatable(L, -2);
-            instances.Iterate(&InsertInstanceEntry, L);
+            PushInstanceTable(L, &instances);
         }
         else
         {
@@ -398,6 +419,107 @@ namespace dmGameSystem
         return 1;
     }
 
+    /*# Spawn a new instance of a collection into the existing collection over several frames.
+     * The URL identifies the collectionfactory component that should do the spawning.
+     *
+     * Works like [ref:collectionfactory.create], but instead of creating and initializing all game objects
+     * at once, at most `budget` milliseconds are spent each frame creating and initializing game objects,
+     * in the order they appear in the collection. At least one game object is created each frame.
+     * The game objects are added to the update once all of them have been initialized, after which the
+     * `complete_function` is called.
+     *
+     * The returned table maps the id:s from the collection to the new instance id:s, but the game objects
+     * don't exist until the spawn has completed.
+     *
+     * @name collectionfactory.create_async
+     * @param url [type:string|hash|url] the collection factory component to be used
+     * @param [position] [type:vector3] position to assign to the newly spawned collection
+     * @param [rotation] [type:quaternion] rotation to assign to the newly spawned collection
+     * @param [properties] [type:table] table of script properties to propagate to any new game object instances
+     * @param [scale] [type:number] uniform scaling to apply to the newly spawned collection (must be greater than 0).
+     * @param [budget] [type:number] the time, in milliseconds, to spend spawning each frame (default 2)
+     * @param [complete_function] [type:function(self, url, ids)] function to call when the collection has been spawned.
+     *
+     * `self`
+     * : [type:object] The current object.
+     *
+     * `url`
+     * : [type:url] url of the collection factory component
+     *
+     * `ids`
+     * : [type:table] a table mapping the id:s from the collection to the new instance id:s, empty if the spawn failed
+     *
+     * @return ids [type:table] a table mapping the id:s from the collection to the new instance id:s, empty if the spawn could not be started
+     * @examples
+     *
+     * How to spawn a large level without a frame hitch:
+     *
+     * ```lua
+     * function init(self)
+     *   collectionfactory.create_async("#levelfactory", nil, nil, nil, nil, 4, function(self, url, ids)
+     *     msg.post(ids[hash("/player")], "acquire_input_focus")
+     *   end)
+     * end
+     * ```
+     */
+    static int CollectionFactoryComp_CreateAsync(lua_State* L)
+    {
+        int top = lua_gettop(L);
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        CollectionFactoryWorld* world;
+        CollectionFactoryComponent* component;
+        dmMessage::URL receiver;
+        dmScript::GetComponentFromLua(L, 1, COLLECTION_FACTORY_EXT, (void**)&world, (void**)&component, &receiver);
+
+        dmVMath::Point3 position;
+        dmVMath::Quat rotation;
+        dmVMath::Vector3 scale;
+        dmGameObject::InstancePropertyBuffers prop_bufs;
+        CheckSpawnArguments(L, sender_instance, "collectionfactory.create_async", &position, &rotation, &prop_bufs, &scale);
+
+        float budget = 2.0f;
+        if (top >= 6 && !lua_isnil(L, 6))
+        {
+            budget = dmMath::Max((float)luaL_checknumber(L, 6), 0.0f);
+        }
+
+        int callback_ref = LUA_NOREF;
+        if (top >= 7 && !lua_isnil(L, 7))
+        {
+            luaL_checktype(L, 7, LUA_TFUNCTION);
+            lua_pushvalue(L, 7);
+            callback_ref = dmScript::Ref(L, LUA_REGISTRYINDEX);
+        }
+        dmScript::GetInstance(L);
+        int self_ref = dmScript::Ref(L, LUA_REGISTRYINDEX);
+        dmScript::PushURL(L, receiver);
+        int url_ref = dmScript::Ref(L, LUA_REGISTRYINDEX);
+
+        PushInstanceTable(L, 0);
+        lua_pushvalue(L, -1);
+        int ids_ref = dmScript::Ref(L, LUA_REGISTRYINDEX);
+
+        const dmGameObject::InstanceIdMap* instances = dmGameSystem::CompCollectionFactorySpawnAsync(world, component, collection, &prop_bufs,
+                                                            position, rotation, scale, (uint32_t)(budget * 1000.0f),
+                                                            callback_ref, self_ref, url_ref, ids_ref);
+        if (instances)
+        {
+            instances->Iterate(&InsertInstanceEntry, L);
+        }
+        else
+        {
+            dmScript::Unref(L, LUA_REGISTRYINDEX, callback_ref);
+            dmScript::Unref(L, LUA_REGISTRYINDEX, self_ref);
+            dmScript::Unref(L, LUA_REGISTRYINDEX, url_ref);
+            dmScript::Unref(L, LUA_REGISTRYINDEX, ids_ref);
+        }
+
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
     /*# changes the prototype for the collection factory
      *
      * Changes the prototype for the collection factory.
@@ -410,6 +532,7 @@ namespace dmGameSystem
      * @note
      *   - Requires the factory to have the "Dynamic Prototype" set
      *   - Cannot be set when the state is COMP_FACTORY_STATUS_LOADING
+     *   - Cannot be set while a [ref:collectionfactory.create_async] spawn is in progress
      *   - Setting the prototype to "nil" will revert back to the original prototype.
      *
      * @examples
@@ -444,6 +567,11 @@ namespace dmGameSystem
             return luaL_error(L, "Cannot set prototype while factory is loading");
         }
 
+        if (dmGameSystem::CompCollectionFactoryIsSpawning(world, component))
+        {
+            return luaL_error(L, "Cannot set prototype while factory is spawning");
+        }
+
         dmResource::HFactory factory = CompCollectionFactoryGetResourceFactory(world);
         CollectionFactoryResource* default_resource = CompCollectionFactoryGetDefaultResource(component);
         CollectionFactoryResource* custom_resource = CompCollectionFactoryGetCustomResource(component);
@@ -502,6 +630,7 @@ namespace dmGameSystem
     static const luaL_reg COLLECTION_FACTORY_COMP_FUNCTIONS[] =
     {
         {"create",            CollectionFactoryComp_Create},
+        {"create_async",      CollectionFactoryComp_CreateAsync},
         {"load",              CollectionFactoryComp_Load},
         {"unload",            CollectionFactoryComp_Unload},
         {"get_status",        CollectionFactoryComp_GetStatus},
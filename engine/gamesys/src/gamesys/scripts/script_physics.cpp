@@ -144,6 +144,7 @@ namespace dmGameSystem
     struct PhysicsScriptContext
     {
         dmMessage::HSocket m_Socket;
+        dmJobThread::HContext m_JobThread;
         uint32_t m_ComponentIndex;
     };
 
@@ -509,6 +510,135 @@ namespace dmGameSystem
         return 1;
     }
 
+    /*# performs a batch of ray casts
+     *
+     * Performs many ray casts at once, which is a lot cheaper than calling `physics.raycast` for each ray.
+     * The rays are tested against the physics world in parallel, on the engine worker threads when available.
+     * Like for `physics.raycast`, collision objects of types kinematic, dynamic and static are tested against,
+     * trigger objects do not intersect with ray casts and only the closest hit of each ray is reported.
+     *
+     * @name physics.raycast_many
+     * @param from [type:table] a lua list of world positions [type:vector3] where the rays start
+     * @param to [type:table] a lua list of world positions [type:vector3] where the rays end, one for each ray in `from`
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return results [type:table] a list with one entry per ray, in the same order as the rays. The entry is `false`
+     * if the ray missed, otherwise a table with the closest hit. See [ref:ray_cast_response] for details on the returned values.
+     * @examples
+     *
+     * How to cast a fan of rays from a game object:
+     *
+     * ```lua
+     * function update(self, dt)
+     *     local pos = go.get_position()
+     *     local from = {}
+     *     local to = {}
+     *     for i = 1, 64 do
+     *         local angle = i / 64 * 2 * math.pi
+     *         from[i] = pos
+     *         to[i] = pos + vmath.vector3(math.cos(angle), math.sin(angle), 0) * 500
+     *     end
+     *     local results = physics.raycast_many(from, to, {hash("world")})
+     *     for i, result in ipairs(results) do
+     *         if result then
+     *             -- act on the hit (see 'ray_cast_response')
+     *             handle_result(i, result)
+     *         end
+     *     end
+     * end
+     * ```
+     */
+    static int Physics_RayCastMany(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            return luaL_error(L, "could not find a requesting instance for physics.raycast_many");
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+        if (world == 0x0)
+        {
+            return DM_LUA_ERROR("Physics world doesn't exist. Make sure you have at least one physics component in collection.");
+        }
+
+        luaL_checktype(L, 1, LUA_TTABLE);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        uint32_t count = (uint32_t)lua_objlen(L, 1);
+        if ((uint32_t)lua_objlen(L, 2) != count)
+        {
+            return DM_LUA_ERROR("The 'from' and 'to' lists must have the same length (%u and %u)", count, (uint32_t)lua_objlen(L, 2));
+        }
+
+        // Validate all positions up front, so that no error is raised once the arrays are allocated
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            for (int list = 1; list <= 2; ++list)
+            {
+                lua_rawgeti(L, list, i + 1);
+                bool is_vector3 = dmScript::IsVector3(L, -1);
+                lua_pop(L, 1);
+                if (!is_vector3)
+                {
+                    return DM_LUA_ERROR("Expected a vector3 at index %u of the '%s' list", i + 1, list == 1 ? "from" : "to");
+                }
+            }
+        }
+
+        uint32_t mask = 0;
+        luaL_checktype(L, 3, LUA_TTABLE);
+        lua_pushnil(L);
+        while (lua_next(L, 3) != 0)
+        {
+            mask |= CompCollisionGetGroupBitIndex(world, dmScript::CheckHash(L, -1));
+            lua_pop(L, 1);
+        }
+
+        dmArray<dmPhysics::RayCastRequest> requests;
+        requests.SetCapacity(count);
+        requests.SetSize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmPhysics::RayCastRequest& request = requests[i];
+            request = dmPhysics::RayCastRequest();
+            lua_rawgeti(L, 1, i + 1);
+            request.m_From = dmVMath::Point3(*dmScript::ToVector3(L, -1));
+            lua_rawgeti(L, 2, i + 1);
+            request.m_To = dmVMath::Point3(*dmScript::ToVector3(L, -1));
+            lua_pop(L, 2);
+            request.m_Mask = mask;
+        }
+
+        dmArray<dmPhysics::RayCastResponse> responses;
+        responses.SetCapacity(count);
+        responses.SetSize(count);
+
+        dmGameSystem::RayCastBatch(world, requests.Begin(), count, responses.Begin(), context->m_JobThread);
+
+        lua_createtable(L, count, 0);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (responses[i].m_Hit)
+            {
+                lua_newtable(L);
+                PushRayCastResponse(L, world, responses[i]);
+            }
+            else
+            {
+                lua_pushboolean(L, 0);
+            }
+            lua_rawseti(L, -2, i + 1);
+        }
+
+        return 1;
+    }
+
     // Matches JointResult in physics.h
     static const char* PhysicsResultString[] = {
         "result ok",
@@ -1745,6 +1875,7 @@ namespace dmGameSystem
         {"ray_cast",        Physics_RayCastAsync}, // Deprecated
         {"raycast_async",   Physics_RayCastAsync},
         {"raycast",         Physics_RayCast},
+        {"raycast_many",    Physics_RayCastMany},
 
         {"create_joint",    Physics_CreateJoint},
         {"destroy_joint",   Physics_DestroyJoint},
@@ -1807,6 +1938,7 @@ namespace dmGameSystem
         bool result = true;
 
         PhysicsScriptContext* physics_context = new PhysicsScriptContext();
+        physics_context->m_JobThread = context.m_JobThread;
         dmMessage::Result socket_result = dmMessage::GetSocket(dmPhysics::PHYSICS_SOCKET_NAME, &physics_context->m_Socket);
         if (socket_result != dmMessage::RESULT_OK)
         {
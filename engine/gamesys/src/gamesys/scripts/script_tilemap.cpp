@@ -12,14 +12,20 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#include <stdlib.h> // malloc, free
 
+#include <dlib/array.h>
+#include <dlib/buffer.h>
 #include <dlib/configfile.h>
+#include <dlib/dstrings.h>
 #include <dlib/log.h>
+#include <dlib/math.h>
 #include <ddf/ddf.h>
 #include <gameobject/gameobject.h>
 #include <render/render.h>
 #include <script/script.h>
 #include <gameobject/script.h>
+#include <dmsdk/gamesys/script.h>
 #include "gamesys.h"
 #include <gamesys/tile_ddf.h>
 #include <gamesys/physics_ddf.h>
@@ -170,6 +176,79 @@ namespace dmGameSystem
         return 0;
     }
 
+    // Broadcasts the new hull of a cell to the collision object components of the tile map game object
+    static dmMessage::Result PostSetGridShapeHull(const dmMessage::URL* sender, const dmMessage::URL* tilemap_url, uint32_t layer_index,
+                                                    int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t bitmask)
+    {
+        // TODO Filter broadcast to only collision objects
+        dmPhysicsDDF::SetGridShapeHull set_hull_ddf;
+        set_hull_ddf.m_Shape = layer_index;
+        set_hull_ddf.m_Column = cell_x;
+        set_hull_ddf.m_Row = cell_y;
+        set_hull_ddf.m_Hull = tile;
+        set_hull_ddf.m_FlipHorizontal = (bitmask & FLIP_HORIZONTAL) > 0 ? 1 : 0;
+        set_hull_ddf.m_FlipVertical = (bitmask & FLIP_VERTICAL) > 0 ? 1 : 0;
+        set_hull_ddf.m_Rotate90 = (bitmask & ROTATE_90) > 0 ? 1 : 0;
+        dmhash_t message_id = dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor->m_NameHash;
+        uintptr_t descriptor = (uintptr_t)dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor;
+        uint32_t data_size = sizeof(dmPhysicsDDF::SetGridShapeHull);
+        dmMessage::URL receiver = *tilemap_url;
+        receiver.m_Fragment = 0;
+        return dmMessage::Post(sender, &receiver, message_id, 0, descriptor, &set_hull_ddf, data_size, 0);
+    }
+
+    static void SetGridShapeHullsDestroyCallback(dmMessage::Message* message)
+    {
+        dmPhysicsDDF::SetGridShapeHulls* ddf = (dmPhysicsDDF::SetGridShapeHulls*)message->m_Data;
+        free((void*)ddf->m_Hulls);
+        free((void*)ddf->m_Transforms);
+    }
+
+    // Broadcasts the new hulls of a rectangle of cells to the collision object components of the tile map game object.
+    // The tiles are 1-based (0 is an empty cell), and the transform masks are optional. Rows start every pitch elements
+    // of the arrays, and the strides are in elements.
+    static dmMessage::Result PostSetGridShapeHulls(const dmMessage::URL* sender, const dmMessage::URL* tilemap_url, uint32_t layer_index,
+                                                    int32_t cell_x, int32_t cell_y, uint32_t width, uint32_t height, uint32_t pitch,
+                                                    const uint16_t* tiles, uint32_t tiles_stride, const uint8_t* transform_masks, uint32_t transform_masks_stride)
+    {
+        const uint32_t count = width * height;
+        uint32_t* hulls = (uint32_t*)malloc(count * sizeof(uint32_t));
+        uint8_t* transforms = (uint8_t*)malloc(count * sizeof(uint8_t));
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint32_t src = y * pitch + x;
+                uint32_t dst = y * width + x;
+                // An empty cell is encoded as 0xffffffff, see TileMap_SetTile
+                hulls[dst] = (uint32_t)tiles[src * tiles_stride] - 1;
+                transforms[dst] = transform_masks ? transform_masks[src * transform_masks_stride] : 0;
+            }
+        }
+
+        // TODO Filter broadcast to only collision objects
+        dmPhysicsDDF::SetGridShapeHulls set_hulls_ddf;
+        set_hulls_ddf.m_Shape = layer_index;
+        set_hulls_ddf.m_Column = cell_x;
+        set_hulls_ddf.m_Row = cell_y;
+        set_hulls_ddf.m_Width = width;
+        set_hulls_ddf.m_Height = height;
+        set_hulls_ddf.m_Hulls = (uint64_t)(uintptr_t)hulls;
+        set_hulls_ddf.m_Transforms = (uint64_t)(uintptr_t)transforms;
+        dmhash_t message_id = dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_NameHash;
+        uintptr_t descriptor = (uintptr_t)dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor;
+        uint32_t data_size = sizeof(dmPhysicsDDF::SetGridShapeHulls);
+        dmMessage::URL receiver = *tilemap_url;
+        receiver.m_Fragment = 0;
+        dmMessage::Result result = dmMessage::Post(sender, &receiver, message_id, 0, descriptor, &set_hulls_ddf, data_size, SetGridShapeHullsDestroyCallback);
+        if (result != dmMessage::RESULT_OK)
+        {
+            free(hulls);
+            free(transforms);
+        }
+        return result;
+    }
+
     /*# set a tile in a tile map
      * Replace a tile in a tile map with a new tile.
      * The coordinates of the tiles are indexed so that the "first" tile just
@@ -304,20 +383,7 @@ namespace dmGameSystem
         if (dmScript::GetURL(L, &sender))
         {
             // Broadcast to any collision object components
-            // TODO Filter broadcast to only collision objects
-            dmPhysicsDDF::SetGridShapeHull set_hull_ddf;
-            set_hull_ddf.m_Shape = layer_index;
-            set_hull_ddf.m_Column = cell_x;
-            set_hull_ddf.m_Row = cell_y;
-            set_hull_ddf.m_Hull = tile;
-            set_hull_ddf.m_FlipHorizontal = (bitmask & FLIP_HORIZONTAL) > 0 ? 1 : 0;
-            set_hull_ddf.m_FlipVertical = (bitmask & FLIP_VERTICAL) > 0 ? 1 : 0;
-            set_hull_ddf.m_Rotate90 = (bitmask & ROTATE_90) > 0 ? 1 : 0;
-            dmhash_t message_id = dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor->m_NameHash;
-            uintptr_t descriptor = (uintptr_t)dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor;
-            uint32_t data_size = sizeof(dmPhysicsDDF::SetGridShapeHull);
-            receiver.m_Fragment = 0;
-            dmMessage::Result result = dmMessage::Post(&sender, &receiver, message_id, 0, descriptor, &set_hull_ddf, data_size, 0);
+            dmMessage::Result result = PostSetGridShapeHull(&sender, &receiver, layer_index, cell_x, cell_y, tile, bitmask);
             if (result != dmMessage::RESULT_OK)
             {
                 dmLogError("Could not send %s to components, result: %d.", dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor->m_Name, result);
@@ -501,6 +567,655 @@ namespace dmGameSystem
         return 0;
     }
 
+    static const dmhash_t TILE_STREAM = dmHashString64("tile");
+    static const dmhash_t TRANSFORM_STREAM = dmHashString64("transform");
+
+    // A buffer stream where the stride is in elements
+    struct TileStream
+    {
+        void*               m_Data;
+        uint32_t            m_Stride;
+        dmBuffer::ValueType m_Type;
+    };
+
+    // Gets a stream with at least 'count' elements
+    static dmBuffer::Result GetTileStream(dmBuffer::HBuffer buffer, dmhash_t stream_name, uint32_t count, TileStream* stream)
+    {
+        uint32_t components = 0;
+        dmBuffer::Result r = dmBuffer::GetStreamType(buffer, stream_name, &stream->m_Type, &components);
+        if (r != dmBuffer::RESULT_OK)
+        {
+            return r;
+        }
+
+        uint32_t stream_count = 0;
+        r = dmBuffer::GetStream(buffer, stream_name, &stream->m_Data, &stream_count, &components, &stream->m_Stride);
+        if (r != dmBuffer::RESULT_OK)
+        {
+            return r;
+        }
+        if (stream_count < count)
+        {
+            return dmBuffer::RESULT_STREAM_SIZE_ERROR;
+        }
+        return dmBuffer::RESULT_OK;
+    }
+
+    template <typename T>
+    static void ReadStreamValues(const T* data, uint32_t stride, uint32_t count, int32_t* out)
+    {
+        for (uint32_t i = 0; i < count; ++i, data += stride)
+        {
+            out[i] = (int32_t)data[0];
+        }
+    }
+
+    template <typename T, typename U>
+    static void WriteStreamValues(T* data, uint32_t stride, uint32_t count, const U* values)
+    {
+        for (uint32_t i = 0; i < count; ++i, data += stride)
+        {
+            data[0] = (T)values[i];
+        }
+    }
+
+    // Reads the first component of the first 'count' elements of the stream
+    static void ReadStream(const TileStream& stream, uint32_t count, int32_t* out)
+    {
+        void* data = stream.m_Data;
+        uint32_t stride = stream.m_Stride;
+        switch (stream.m_Type)
+        {
+            case dmBuffer::VALUE_TYPE_UINT8:   ReadStreamValues((const uint8_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_UINT16:  ReadStreamValues((const uint16_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_UINT32:  ReadStreamValues((const uint32_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_UINT64:  ReadStreamValues((const uint64_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_INT8:    ReadStreamValues((const int8_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_INT16:   ReadStreamValues((const int16_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_INT32:   ReadStreamValues((const int32_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_INT64:   ReadStreamValues((const int64_t*)data, stride, count, out); break;
+            case dmBuffer::VALUE_TYPE_FLOAT32: ReadStreamValues((const float*)data, stride, count, out); break;
+            default: memset(out, 0, count * sizeof(int32_t)); break;
+        }
+    }
+
+    // Writes the first component of the first 'count' elements of the stream
+    template <typename U>
+    static void WriteStream(const TileStream& stream, uint32_t count, const U* values)
+    {
+        void* data = stream.m_Data;
+        uint32_t stride = stream.m_Stride;
+        switch (stream.m_Type)
+        {
+            case dmBuffer::VALUE_TYPE_UINT8:   WriteStreamValues((uint8_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_UINT16:  WriteStreamValues((uint16_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_UINT32:  WriteStreamValues((uint32_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_UINT64:  WriteStreamValues((uint64_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_INT8:    WriteStreamValues((int8_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_INT16:   WriteStreamValues((int16_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_INT32:   WriteStreamValues((int32_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_INT64:   WriteStreamValues((int64_t*)data, stride, count, values); break;
+            case dmBuffer::VALUE_TYPE_FLOAT32: WriteStreamValues((float*)data, stride, count, values); break;
+            default: break;
+        }
+    }
+
+    static dmBuffer::Result ReadStreamAsIntegers(dmBuffer::HBuffer buffer, dmhash_t stream_name, uint32_t count, int32_t* out)
+    {
+        TileStream stream;
+        dmBuffer::Result r = GetTileStream(buffer, stream_name, count, &stream);
+        if (r == dmBuffer::RESULT_OK)
+        {
+            ReadStream(stream, count, out);
+        }
+        return r;
+    }
+
+    static TileGridComponent* CheckLayer(lua_State* L, const char* fn_name, uint32_t* layer_index, dmMessage::URL* receiver = 0)
+    {
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        TileGridComponent* component;
+        dmGameObject::GetComponentFromLua(L, 1, collection, TILE_MAP_EXT, (dmGameObject::HComponent*)&component, receiver, 0);
+
+        dmhash_t layer_id = dmScript::CheckHashOrString(L, 2);
+        *layer_index = GetLayerIndex(component, layer_id);
+        if (*layer_index == ~0u)
+        {
+            luaL_error(L, "%s: Could not find layer '%s'.", fn_name, dmHashReverseSafe64(layer_id));
+            return 0;
+        }
+        return component;
+    }
+
+    static TileGridComponent* CheckChunk(lua_State* L, const char* fn_name, uint32_t* layer_index, uint32_t* chunk_x, uint32_t* chunk_y,
+                                         dmMessage::URL* receiver)
+    {
+        TileGridComponent* component = CheckLayer(L, fn_name, layer_index, receiver);
+
+        int x = luaL_checkinteger(L, 3) - 1;
+        int y = luaL_checkinteger(L, 4) - 1;
+
+        uint32_t chunks_x, chunks_y;
+        GetTileGridChunkCount(component, &chunks_x, &chunks_y);
+        if (x < 0 || x >= (int)chunks_x || y < 0 || y >= (int)chunks_y)
+        {
+            luaL_error(L, "%s: Chunk (%d, %d) is outside of the tile map (%d x %d chunks).", fn_name, x + 1, y + 1, chunks_x, chunks_y);
+            return 0;
+        }
+        *chunk_x = x;
+        *chunk_y = y;
+        return component;
+    }
+
+    static TileGridComponent* CheckTileRect(lua_State* L, const char* fn_name, uint32_t* layer_index, int32_t* cell_x, int32_t* cell_y, uint32_t* width, uint32_t* height,
+                                            dmMessage::URL* receiver = 0)
+    {
+        TileGridComponent* component = CheckLayer(L, fn_name, layer_index, receiver);
+
+        int x = luaL_checkinteger(L, 3) - 1;
+        int y = luaL_checkinteger(L, 4) - 1;
+        int w = luaL_checkinteger(L, 5);
+        int h = luaL_checkinteger(L, 6);
+
+        int min_x, min_y, grid_w, grid_h;
+        GetTileGridBounds(component, &min_x, &min_y, &grid_w, &grid_h);
+        GetTileGridCellCoord(component, x, y, *cell_x, *cell_y);
+
+        if (w < 0 || h < 0 || *cell_x < 0 || *cell_x + w > grid_w || *cell_y < 0 || *cell_y + h > grid_h)
+        {
+            luaL_error(L, "%s: The rectangle (%d, %d, %d, %d) is outside of the tile map.", fn_name, x + 1, y + 1, w, h);
+            return 0;
+        }
+        *width = w;
+        *height = h;
+        return component;
+    }
+
+    // Validates and writes the tiles for tilemap.set_tiles(), from the table at the index or from the buffer,
+    // and posts the new hulls of the rectangle to the collision objects of the tile map game object, in one message.
+    // No Lua errors are raised from here, since that would leak the scratch arrays.
+    static bool SetTiles(lua_State* L, int index, dmBuffer::HBuffer buffer, TileGridComponent* component, uint32_t layer,
+                            int32_t cell_x, int32_t cell_y, uint32_t width, uint32_t height,
+                            const dmMessage::URL* sender, const dmMessage::URL* receiver, char* error, uint32_t error_size)
+    {
+        const uint32_t count = width * height;
+        const int32_t tile_count = GetTileCount(component);
+
+        dmArray<int32_t> values;
+        dmArray<uint16_t> tile_values;
+        dmArray<uint8_t> transform_values;
+        const uint16_t* tiles = 0;
+        uint32_t tiles_stride = 1;
+        const uint8_t* transform_masks = 0;
+        uint32_t transform_masks_stride = 1;
+        TileStream stream;
+
+        if (!buffer)
+        {
+            uint32_t table_size = lua_objlen(L, index);
+            if (table_size < count)
+            {
+                dmSnPrintf(error, error_size, "The table has %u tiles, expected %u.", table_size, count);
+                return false;
+            }
+            values.SetCapacity(count);
+            values.SetSize(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                lua_rawgeti(L, index, i + 1);
+                bool is_number = lua_isnumber(L, -1) != 0;
+                values[i] = (int32_t)lua_tointeger(L, -1);
+                lua_pop(L, 1);
+                if (!is_number)
+                {
+                    dmSnPrintf(error, error_size, "The tile at index %u is not a number.", i + 1);
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            dmBuffer::Result r = GetTileStream(buffer, TILE_STREAM, count, &stream);
+            if (r != dmBuffer::RESULT_OK)
+            {
+                dmSnPrintf(error, error_size, "Could not read %u tiles from the stream 'tile': %s", count, dmBuffer::GetResultString(r));
+                return false;
+            }
+            if (stream.m_Type == dmBuffer::VALUE_TYPE_UINT16)
+            {
+                // Use the stream as is
+                tiles = (const uint16_t*)stream.m_Data;
+                tiles_stride = stream.m_Stride;
+            }
+            else
+            {
+                values.SetCapacity(count);
+                values.SetSize(count);
+                ReadStream(stream, count, values.Begin());
+            }
+        }
+
+        if (tiles)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (tiles[i * tiles_stride] > tile_count)
+                {
+                    dmSnPrintf(error, error_size, "Out-of-range tile index (%d)", tiles[i * tiles_stride]);
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            tile_values.SetCapacity(count);
+            tile_values.SetSize(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (values[i] < 0 || values[i] > tile_count)
+                {
+                    dmSnPrintf(error, error_size, "Out-of-range tile index (%d)", values[i]);
+                    return false;
+                }
+                tile_values[i] = (uint16_t)values[i];
+            }
+            tiles = tile_values.Begin();
+        }
+
+        if (buffer)
+        {
+            dmBuffer::Result r = GetTileStream(buffer, TRANSFORM_STREAM, count, &stream);
+            if (r == dmBuffer::RESULT_OK)
+            {
+                if (stream.m_Type == dmBuffer::VALUE_TYPE_UINT8)
+                {
+                    transform_masks = (const uint8_t*)stream.m_Data;
+                    transform_masks_stride = stream.m_Stride;
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        if (transform_masks[i * transform_masks_stride] > MAX_TRANSFORM_FLAG)
+                        {
+                            dmSnPrintf(error, error_size, "Wrong transformation bitmask (%d)", transform_masks[i * transform_masks_stride]);
+                            return false;
+                        }
+                    }
+                }
+                else
+                {
+                    values.SetCapacity(count);
+                    values.SetSize(count);
+                    ReadStream(stream, count, values.Begin());
+
+                    transform_values.SetCapacity(count);
+                    transform_values.SetSize(count);
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        // See the ROTATE_180 and ROTATE_270 constants
+                        int32_t bitmask = dmMath::Abs(values[i]);
+                        if (bitmask > MAX_TRANSFORM_FLAG)
+                        {
+                            dmSnPrintf(error, error_size, "Wrong transformation bitmask (%d)", values[i]);
+                            return false;
+                        }
+                        transform_values[i] = (uint8_t)bitmask;
+                    }
+                    transform_masks = transform_values.Begin();
+                }
+            }
+            else if (r != dmBuffer::RESULT_STREAM_MISSING)
+            {
+                dmSnPrintf(error, error_size, "Could not read %u transforms from the stream 'transform': %s", count, dmBuffer::GetResultString(r));
+                return false;
+            }
+        }
+
+        SetTileGridTiles(component, layer, cell_x, cell_y, width, height, tiles, tiles_stride, transform_masks, transform_masks_stride);
+
+        // Broadcast the whole rectangle to any collision object components
+        dmMessage::Result result = PostSetGridShapeHulls(sender, receiver, layer, cell_x, cell_y, width, height, width, tiles, tiles_stride, transform_masks, transform_masks_stride);
+        if (result != dmMessage::RESULT_OK)
+        {
+            dmLogError("Could not send %s to components, result: %d.", dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_Name, result);
+        }
+        return true;
+    }
+
+    // Reads the tiles for tilemap.get_tiles() and pushes the buffer at the index, or a new table if there is no buffer.
+    // No Lua errors are raised from here, since that would leak the scratch arrays.
+    static bool GetTiles(lua_State* L, int index, dmBuffer::HBuffer buffer, const TileGridComponent* component, uint32_t layer,
+                            int32_t cell_x, int32_t cell_y, uint32_t width, uint32_t height, char* error, uint32_t error_size)
+    {
+        const uint32_t count = width * height;
+
+        dmArray<uint16_t> tile_values;
+        dmArray<uint8_t> transform_values;
+
+        if (!buffer)
+        {
+            tile_values.SetCapacity(count);
+            tile_values.SetSize(count);
+            GetTileGridTiles(component, layer, cell_x, cell_y, width, height, tile_values.Begin(), 1, 0, 1);
+
+            lua_createtable(L, count, 0);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                lua_pushinteger(L, tile_values[i]);
+                lua_rawseti(L, -2, i + 1);
+            }
+            return true;
+        }
+
+        TileStream tile_stream;
+        dmBuffer::Result r = GetTileStream(buffer, TILE_STREAM, count, &tile_stream);
+        if (r != dmBuffer::RESULT_OK)
+        {
+            dmSnPrintf(error, error_size, "Could not write %u tiles to the stream 'tile': %s", count, dmBuffer::GetResultString(r));
+            return false;
+        }
+
+        TileStream transform_stream;
+        r = GetTileStream(buffer, TRANSFORM_STREAM, count, &transform_stream);
+        bool has_transforms = r == dmBuffer::RESULT_OK;
+        if (!has_transforms && r != dmBuffer::RESULT_STREAM_MISSING)
+        {
+            dmSnPrintf(error, error_size, "Could not write %u transforms to the stream 'transform': %s", count, dmBuffer::GetResultString(r));
+            return false;
+        }
+
+        // Write directly to the streams that have the same type as the tile map cells
+        bool direct_tiles = tile_stream.m_Type == dmBuffer::VALUE_TYPE_UINT16;
+        uint16_t* tiles = (uint16_t*)tile_stream.m_Data;
+        uint32_t tiles_stride = tile_stream.m_Stride;
+        if (!direct_tiles)
+        {
+            tile_values.SetCapacity(count);
+            tile_values.SetSize(count);
+            tiles = tile_values.Begin();
+            tiles_stride = 1;
+        }
+
+        bool direct_transforms = has_transforms && transform_stream.m_Type == dmBuffer::VALUE_TYPE_UINT8;
+        uint8_t* transform_masks = 0;
+        uint32_t transform_masks_stride = 1;
+        if (direct_transforms)
+        {
+            transform_masks = (uint8_t*)transform_stream.m_Data;
+            transform_masks_stride = transform_stream.m_Stride;
+        }
+        else if (has_transforms)
+        {
+            transform_values.SetCapacity(count);
+            transform_values.SetSize(count);
+            transform_masks = transform_values.Begin();
+        }
+
+        GetTileGridTiles(component, layer, cell_x, cell_y, width, height, tiles, tiles_stride, transform_masks, transform_masks_stride);
+
+        if (!direct_tiles)
+        {
+            WriteStream(tile_stream, count, tiles);
+        }
+        if (has_transforms && !direct_transforms)
+        {
+            WriteStream(transform_stream, count, transform_masks);
+        }
+
+        lua_pushvalue(L, index);
+        return true;
+    }
+
+    /*# set a rectangle of tiles in a tile map
+     * Replaces the tiles of a layer within a rectangle of the tile map in a single call, which is much faster than
+     * calling [ref:tilemap.set_tile()] for each tile when changing large parts of a map.
+     *
+     * The tiles are given row by row, starting with the lower left tile of the rectangle, either in a table or in a buffer.
+     * A tile index of 0 resets the cell. A buffer must have a stream named "tile", and may have a stream named "transform"
+     * with the flip and rotation bitmask of each tile (see [ref:tilemap.set_tile()]). Only the first component of each stream element is used.
+     * A "tile" stream of type `buffer.VALUE_TYPE_UINT16` and a "transform" stream of type `buffer.VALUE_TYPE_UINT8` are read without being copied.
+     *
+     * Like [ref:tilemap.set_tile()], the collision shapes of the tile map game object are updated for the cells that change.
+     *
+     * @name tilemap.set_tiles
+     * @param url [type:string|hash|url] the tile map
+     * @param layer [type:string|hash] name of the layer for the tiles
+     * @param x [type:number] x-coordinate of the lower left tile of the rectangle
+     * @param y [type:number] y-coordinate of the lower left tile of the rectangle
+     * @param w [type:number] width of the rectangle
+     * @param h [type:number] height of the rectangle
+     * @param tiles [type:table|buffer] the w * h tile indices
+     * @examples
+     *
+     * ```lua
+     * -- Clear a 4x2 area
+     * tilemap.set_tiles("/level#tilemap", "foreground", 10, 10, 4, 2, { 0, 0, 0, 0, 0, 0, 0, 0 })
+     *
+     * -- Fill a layer from a buffer
+     * local x, y, w, h = tilemap.get_bounds("/level#tilemap")
+     * local tiles = buffer.create(w * h, { {name=hash("tile"), type=buffer.VALUE_TYPE_UINT16, count=1} })
+     * local stream = buffer.get_stream(tiles, hash("tile"))
+     * for i = 1, w * h do
+     *     stream[i] = math.random(0, 4)
+     * end
+     * tilemap.set_tiles("/level#tilemap", "background", x, y, w, h, tiles)
+     * ```
+     */
+    static int TileMap_SetTiles(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+
+        uint32_t layer_index, width, height;
+        int32_t cell_x, cell_y;
+        dmMessage::URL receiver;
+        TileGridComponent* component = CheckTileRect(L, "tilemap.set_tiles", &layer_index, &cell_x, &cell_y, &width, &height, &receiver);
+        dmBuffer::HBuffer buffer = lua_istable(L, 7) ? 0 : dmScript::CheckBufferUnpack(L, 7);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender))
+        {
+            return DM_LUA_ERROR("tilemap.set_tiles is not available from this script-type.");
+        }
+
+        char error[128];
+        if (!SetTiles(L, 7, buffer, component, layer_index, cell_x, cell_y, width, height, &sender, &receiver, error, sizeof(error)))
+        {
+            return DM_LUA_ERROR("tilemap.set_tiles: %s", error);
+        }
+        return 0;
+    }
+
+    /*# get a rectangle of tiles from a tile map
+     * Gets the tiles of a layer within a rectangle of the tile map, row by row starting with the lower left tile of the rectangle.
+     * The tile indices are the same as those returned by [ref:tilemap.get_tile()], where 0 is an empty cell.
+     *
+     * If a buffer is given, the tiles are written to its stream named "tile", and the flip and rotation bitmasks are written
+     * to its stream named "transform" if it has one. Only the first component of each stream element is written.
+     * A "tile" stream of type `buffer.VALUE_TYPE_UINT16` and a "transform" stream of type `buffer.VALUE_TYPE_UINT8` are written without intermediate copies.
+     * Without a buffer, a new table with the tile indices is returned.
+     *
+     * @name tilemap.get_tiles
+     * @param url [type:string|hash|url] the tile map
+     * @param layer [type:string|hash] name of the layer for the tiles
+     * @param x [type:number] x-coordinate of the lower left tile of the rectangle
+     * @param y [type:number] y-coordinate of the lower left tile of the rectangle
+     * @param w [type:number] width of the rectangle
+     * @param h [type:number] height of the rectangle
+     * @param [buffer] [type:buffer] buffer with at least w * h elements to write the tiles to
+     * @return tiles [type:table|buffer] the tile indices
+     * @examples
+     *
+     * ```lua
+     * -- Get the 3x3 tiles around the player
+     * local tiles = tilemap.get_tiles("/level#tilemap", "foreground", self.player_x - 1, self.player_y - 1, 3, 3)
+     * local tile_below = tiles[2]
+     * ```
+     */
+    static int TileMap_GetTiles(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        uint32_t layer_index, width, height;
+        int32_t cell_x, cell_y;
+        TileGridComponent* component = CheckTileRect(L, "tilemap.get_tiles", &layer_index, &cell_x, &cell_y, &width, &height);
+        dmBuffer::HBuffer buffer = lua_isnoneornil(L, 7) ? 0 : dmScript::CheckBufferUnpack(L, 7);
+
+        char error[128];
+        if (!GetTiles(L, 7, buffer, component, layer_index, cell_x, cell_y, width, height, error, sizeof(error)))
+        {
+            return DM_LUA_ERROR("tilemap.get_tiles: %s", error);
+        }
+        return 1;
+    }
+
+    // Broadcasts the new hulls of the cells of a chunk that are inside the tile map, see PostSetGridShapeHulls()
+    static void PostChunkHulls(const dmMessage::URL* sender, const dmMessage::URL* receiver, TileGridComponent* component, uint32_t layer_index,
+                                uint32_t chunk_x, uint32_t chunk_y, const uint16_t* tiles, uint32_t tiles_stride, const uint8_t* transform_masks)
+    {
+        int32_t min_x, min_y, grid_w, grid_h;
+        GetTileGridBounds(component, &min_x, &min_y, &grid_w, &grid_h);
+        int32_t cell_x = (int32_t)(chunk_x * TILEGRID_REGION_SIZE);
+        int32_t cell_y = (int32_t)(chunk_y * TILEGRID_REGION_SIZE);
+        uint32_t width = dmMath::Min((int32_t)TILEGRID_REGION_SIZE, grid_w - cell_x);
+        uint32_t height = dmMath::Min((int32_t)TILEGRID_REGION_SIZE, grid_h - cell_y);
+
+        dmMessage::Result result = PostSetGridShapeHulls(sender, receiver, layer_index, cell_x, cell_y, width, height, TILEGRID_REGION_SIZE,
+                                                            tiles, tiles_stride, transform_masks, 1);
+        if (result != dmMessage::RESULT_OK)
+        {
+            dmLogError("Could not send %s to components, result: %d.", dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_Name, result);
+        }
+    }
+
+    /*# load a chunk of tiles into a tile map
+     * Replaces all tiles of a layer within a chunk of the tile map with the tiles of a buffer.
+     * The tile map stores each layer in chunks of [ref:tilemap.CHUNK_SIZE] x [ref:tilemap.CHUNK_SIZE] tiles,
+     * starting at the lower left corner of the tile map bounds (see [ref:tilemap.get_bounds()]) with chunk 1, 1.
+     * Memory is only used by chunks that contain tiles, and only those chunks that are inside the view are rendered,
+     * which makes it possible to stream in the parts of a very large map as they are needed.
+     *
+     * The buffer must have a stream named "tile" with at least `tilemap.CHUNK_SIZE * tilemap.CHUNK_SIZE` elements, holding
+     * the tile index of each cell row by row from the lower left corner of the chunk. A tile index of 0 leaves the cell empty.
+     * An optional stream named "transform" holds the flip and rotation bitmask of each cell (see [ref:tilemap.set_tile()]).
+     * Only the first component of each stream element is used, and cells outside of the tile map bounds are ignored.
+     * The collision shapes of the tile map are updated for the cells of the chunk.
+     *
+     * @name tilemap.load_chunk
+     * @param url [type:string|hash|url] the tile map
+     * @param layer [type:string|hash] name of the layer
+     * @param x [type:number] x-coordinate of the chunk
+     * @param y [type:number] y-coordinate of the chunk
+     * @param buffer [type:buffer] the tiles of the chunk
+     * @examples
+     *
+     * ```lua
+     * local size = tilemap.CHUNK_SIZE
+     * local tiles = buffer.create(size * size, { {name=hash("tile"), type=buffer.VALUE_TYPE_UINT16, count=1} })
+     * local stream = buffer.get_stream(tiles, hash("tile"))
+     * for i = 1, size * size do
+     *     stream[i] = math.random(0, 4)
+     * end
+     * tilemap.load_chunk("/level#tilemap", "ground", 1, 1, tiles)
+     * ```
+     */
+    static int TileMap_LoadChunk(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+
+        uint32_t layer_index, chunk_x, chunk_y;
+        dmMessage::URL receiver;
+        TileGridComponent* component = CheckChunk(L, "tilemap.load_chunk", &layer_index, &chunk_x, &chunk_y, &receiver);
+        dmBuffer::HBuffer buffer = dmScript::CheckBufferUnpack(L, 5);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender))
+        {
+            return DM_LUA_ERROR("tilemap.load_chunk is not available from this script-type.");
+        }
+
+        const uint32_t cell_count = TILEGRID_REGION_SIZE * TILEGRID_REGION_SIZE;
+        int32_t values[cell_count];
+
+        dmBuffer::Result r = ReadStreamAsIntegers(buffer, TILE_STREAM, cell_count, values);
+        if (r != dmBuffer::RESULT_OK)
+        {
+            return DM_LUA_ERROR("tilemap.load_chunk: Could not read %u tiles from the stream 'tile': %s", cell_count, dmBuffer::GetResultString(r));
+        }
+
+        int32_t tile_count = GetTileCount(component);
+        uint16_t tiles[cell_count];
+        for (uint32_t i = 0; i < cell_count; ++i)
+        {
+            if (values[i] < 0 || values[i] > tile_count)
+            {
+                return DM_LUA_ERROR("tilemap.load_chunk called with out-of-range tile index (%d)", values[i]);
+            }
+            tiles[i] = (uint16_t)values[i];
+        }
+
+        uint8_t transform_masks[cell_count];
+        r = ReadStreamAsIntegers(buffer, TRANSFORM_STREAM, cell_count, values);
+        if (r == dmBuffer::RESULT_OK)
+        {
+            for (uint32_t i = 0; i < cell_count; ++i)
+            {
+                // See the ROTATE_180 and ROTATE_270 constants
+                int32_t bitmask = dmMath::Abs(values[i]);
+                if (bitmask > MAX_TRANSFORM_FLAG)
+                {
+                    return DM_LUA_ERROR("tilemap.load_chunk called with wrong tranformation bitmask (%d)", values[i]);
+                }
+                transform_masks[i] = (uint8_t)bitmask;
+            }
+        }
+        else if (r != dmBuffer::RESULT_STREAM_MISSING)
+        {
+            return DM_LUA_ERROR("tilemap.load_chunk: Could not read %u transforms from the stream 'transform': %s", cell_count, dmBuffer::GetResultString(r));
+        }
+
+        const uint8_t* chunk_transform_masks = r == dmBuffer::RESULT_OK ? transform_masks : 0;
+        LoadTileGridChunk(component, layer_index, chunk_x, chunk_y, tiles, chunk_transform_masks);
+        PostChunkHulls(&sender, &receiver, component, layer_index, chunk_x, chunk_y, tiles, 1, chunk_transform_masks);
+        return 0;
+    }
+
+    /*# unload a chunk of tiles from a tile map
+     * Clears all tiles of a layer within a chunk of the tile map and frees the memory used by the chunk
+     * (see [ref:tilemap.load_chunk()]). The collision shapes of the tile map are cleared for the cells of the chunk.
+     *
+     * @name tilemap.unload_chunk
+     * @param url [type:string|hash|url] the tile map
+     * @param layer [type:string|hash] name of the layer
+     * @param x [type:number] x-coordinate of the chunk
+     * @param y [type:number] y-coordinate of the chunk
+     * @examples
+     *
+     * ```lua
+     * tilemap.unload_chunk("/level#tilemap", "ground", 1, 1)
+     * ```
+     */
+    static int TileMap_UnloadChunk(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+
+        uint32_t layer_index, chunk_x, chunk_y;
+        dmMessage::URL receiver;
+        TileGridComponent* component = CheckChunk(L, "tilemap.unload_chunk", &layer_index, &chunk_x, &chunk_y, &receiver);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender))
+        {
+            return DM_LUA_ERROR("tilemap.unload_chunk is not available from this script-type.");
+        }
+
+        UnloadTileGridChunk(component, layer_index, chunk_x, chunk_y);
+
+        // All cells of the chunk are empty, which a zero stride reads from a single tile
+        const uint16_t empty_tile = 0;
+        PostChunkHulls(&sender, &receiver, component, layer_index, chunk_x, chunk_y, &empty_tile, 0, 0);
+        return 0;
+    }
+
     static const luaL_reg TILEMAP_FUNCTIONS[] =
     {
         {"set_constant",    TileMap_SetConstant},
@@ -509,6 +1224,10 @@ namespace dmGameSystem
         {"get_tile",        TileMap_GetTile},
         {"get_bounds",      TileMap_GetBounds},
         {"set_visible",     TileMap_SetVisible},
+        {"load_chunk",      TileMap_LoadChunk},
+        {"unload_chunk",    TileMap_UnloadChunk},
+        {"set_tiles",       TileMap_SetTiles},
+        {"get_tiles",       TileMap_GetTiles},
         {0, 0}
     };
 
@@ -537,6 +1256,12 @@ namespace dmGameSystem
      * @name tilemap.ROTATE_270
      * @variable
      */
+    /*# number of tiles along each side of a chunk
+     * The width and height of the chunks used by [ref:tilemap.load_chunk()]
+     *
+     * @name tilemap.CHUNK_SIZE
+     * @variable
+     */
 
     void ScriptTileMapRegister(const ScriptLibContext& context)
     {
@@ -553,6 +1278,7 @@ namespace dmGameSystem
         SETCONSTANT(ROTATE_90, ROTATE_90);
         SETCONSTANT(ROTATE_180, -(FLIP_HORIZONTAL + FLIP_VERTICAL));
         SETCONSTANT(ROTATE_270, -(FLIP_HORIZONTAL + FLIP_VERTICAL + ROTATE_90));
+        SETCONSTANT(CHUNK_SIZE, TILEGRID_REGION_SIZE);
 
         /* It's enough to have 3 flags to specify a quad transform. 1st bit for h_flip, 2nd for v_flip and 3rd for 90 degree rotation.
          * All the other rotations are possible to specify using these 3 bits.
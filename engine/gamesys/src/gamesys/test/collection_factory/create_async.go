@@ -0,0 +1,12 @@
+components {
+  id: "script"
+  component: "/collection_factory/create_async.script"
+}
+components {
+  id: "collectionfactory"
+  component: "/collection_factory/collectionfactory_test.collectionfactory"
+}
+components {
+  id: "dynamic"
+  component: "/collection_factory/dynamic_collectionfactory_test.collectionfactory"
+}
@@ -0,0 +1,4 @@
+components {
+  id: "script"
+  component: "/collection_factory/create_async_delete.script"
+}
@@ -0,0 +1,4 @@
+components {
+  id: "collectionfactory"
+  component: "/collection_factory/collectionfactory_test.collectionfactory"
+}
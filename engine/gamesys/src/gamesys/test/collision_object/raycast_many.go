@@ -0,0 +1,9 @@
+components {
+  id: "script"
+  component: "/collision_object/raycast_many.script"
+}
+
+components {
+  id: "co"
+  component: "/collision_object/raycast_many.collisionobject"
+}
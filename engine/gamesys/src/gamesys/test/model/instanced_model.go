@@ -0,0 +1,36 @@
+components {
+  id: "model0"
+  component: "/model/instanced.model"
+  position {
+    x: 0.0
+    y: 0.0
+    z: 0.0
+  }
+}
+components {
+  id: "model1"
+  component: "/model/instanced.model"
+  position {
+    x: 10.0
+    y: 0.0
+    z: 0.0
+  }
+}
+components {
+  id: "model2"
+  component: "/model/instanced.model"
+  position {
+    x: 20.0
+    y: 0.0
+    z: 0.0
+  }
+}
+components {
+  id: "model3"
+  component: "/model/instanced.model"
+  position {
+    x: 30.0
+    y: 0.0
+    z: 0.0
+  }
+}
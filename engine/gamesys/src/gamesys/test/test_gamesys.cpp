@@ -2016,6 +2016,88 @@ TEST_P(CollectionFactoryTest, Test)
     dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
 }
 
+TEST_F(CollectionFactoryTest, CreateAsync)
+{
+    /* Setup:
+    ** create_async
+    ** - [script] collection_factory/create_async.script
+    ** - [collectionfactory] collection_factory/collectionfactory_test.collectionfactory
+    ** - [dynamic] collection_factory/dynamic_collectionfactory_test.collectionfactory
+    **
+    ** The script spawns the collection with and without a complete function, and unloads
+    ** the dynamic factory while its spawn is in flight.
+    */
+
+    dmHashEnableReverseHash(true);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory         = m_Factory;
+    scriptlibcontext.m_Register        = m_Register;
+    scriptlibcontext.m_LuaState        = dmScript::GetLuaState(m_ScriptContext);
+    scriptlibcontext.m_GraphicsContext = m_GraphicsContext;
+    scriptlibcontext.m_ScriptContext   = m_ScriptContext;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/collection_factory/create_async.goc", dmHashString64("/go"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    bool tests_done = false;
+    WaitForTestsDone(100, false, &tests_done);
+    ASSERT_TRUE(tests_done);
+
+    // Execute the deferred deletes of the spawned game objects
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    dmGameObject::PostUpdate(m_Register);
+
+    // Only the static factory holds the prototype game objects, the unloaded dynamic factory and the spawns have released theirs
+    ASSERT_EQ(2, dmResource::GetRefCount(m_Factory, dmHashString64("/collection_factory/collectionfactory_resource.goc")));
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+}
+
+TEST_F(CollectionFactoryTest, CreateAsyncDeleted)
+{
+    /* Setup:
+    ** factory
+    ** - [collectionfactory] collection_factory/collectionfactory_test.collectionfactory
+    ** test
+    ** - [script] collection_factory/create_async_delete.script
+    **
+    ** The script spawns the collection with properties for each game object, and the factory
+    ** is deleted before the spawn has finished. The spawn is deleted with it, and the property
+    ** containers of the game objects that weren't created are destroyed.
+    */
+
+    dmHashEnableReverseHash(true);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory         = m_Factory;
+    scriptlibcontext.m_Register        = m_Register;
+    scriptlibcontext.m_LuaState        = dmScript::GetLuaState(m_ScriptContext);
+    scriptlibcontext.m_GraphicsContext = m_GraphicsContext;
+    scriptlibcontext.m_ScriptContext   = m_ScriptContext;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+    dmGameObject::HInstance factory_go = Spawn(m_Factory, m_Collection, "/collection_factory/create_async_factory.goc", dmHashString64("/factory"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, factory_go);
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/collection_factory/create_async_delete.goc", dmHashString64("/test"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    dmGameObject::Delete(m_Collection, factory_go, false);
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+    bool tests_done = false;
+    WaitForTestsDone(10, false, &tests_done);
+    ASSERT_TRUE(tests_done);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+}
+
 /* Draw Count */
 
 TEST_P(DrawCountTest, DrawCount)
@@ -2098,6 +2180,20 @@ TEST_P(BoxRenderTest, BoxRender)
 
     ASSERT_EQ(world->m_ClientVertexBuffer.Size(), (uint32_t)p.m_ExpectedVerticesCount);
 
+    for (int i = 0; i < p.m_ExpectedVerticesCount; i++)
+    {
+        AssertVertexEqual(world->m_ClientVertexBuffer[i], p.m_ExpectedVertices[p.m_ExpectedIndices[i]]);
+    }
+    ASSERT_EQ(0u, world->m_BatchesReused);
+
+    // Nothing changed, so the next frame should reuse the vertices of the previous one
+    dmRender::RenderListBegin(m_RenderContext);
+    dmGameObject::Render(m_Collection);
+    dmRender::RenderListEnd(m_RenderContext);
+    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, 0x0);
+
+    ASSERT_LT(0u, world->m_BatchesReused);
+    ASSERT_EQ(world->m_ClientVertexBuffer.Size(), (uint32_t)p.m_ExpectedVerticesCount);
     for (int i = 0; i < p.m_ExpectedVerticesCount; i++)
     {
         AssertVertexEqual(world->m_ClientVertexBuffer[i], p.m_ExpectedVertices[p.m_ExpectedIndices[i]]);
@@ -2265,6 +2361,52 @@ TEST_F(CollisionObject2DTest, PropertiesTest)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+// Test case for physics.raycast_many
+TEST_F(CollisionObject2DTest, RayCastManyTest)
+{
+    dmHashEnableReverseHash(true);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory         = m_Factory;
+    scriptlibcontext.m_Register        = m_Register;
+    scriptlibcontext.m_LuaState        = dmScript::GetLuaState(m_ScriptContext);
+    scriptlibcontext.m_GraphicsContext = m_GraphicsContext;
+    scriptlibcontext.m_ScriptContext   = m_ScriptContext;
+    scriptlibcontext.m_JobThread       = m_JobThread;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/collision_object/raycast_many.goc", dmHashString64("/go"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    bool tests_done = false;
+    WaitForTestsDone(10, false, &tests_done);
+    ASSERT_TRUE(tests_done);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+TEST_F(CollisionObject2DTest, TileMapSetTilesTest)
+{
+    dmHashEnableReverseHash(true);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory         = m_Factory;
+    scriptlibcontext.m_Register        = m_Register;
+    scriptlibcontext.m_LuaState        = dmScript::GetLuaState(m_ScriptContext);
+    scriptlibcontext.m_GraphicsContext = m_GraphicsContext;
+    scriptlibcontext.m_ScriptContext   = m_ScriptContext;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/tile/set_tiles.goc", dmHashString64("/go"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    bool tests_done = false;
+    WaitForTestsDone(20, false, &tests_done);
+    ASSERT_TRUE(tests_done);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
 TEST_P(GroupAndMask2DTest, GroupAndMaskTest )
 {
     const GroupAndMaskParams& params = GetParam();
@@ -2598,12 +2740,66 @@ TEST_F(ComponentTest, PhysicsUpdateMassTest)
 
 namespace dmGameSystem
 {
-    extern void GetSpriteWorldRenderBuffers(void* world, dmRender::HBufferedRenderBuffer* vx_buffer, dmRender::HBufferedRenderBuffer* ix_buffer);
+    extern void GetSpriteWorldRenderObjects(void* world, dmRender::RenderObject*** render_objects, uint32_t* render_objects_count);
+    extern uint32_t GetSpriteWorldVerticesReused(void* world);
+    extern void InvalidateSpriteWorldVertexCache(void* world);
     extern void GetModelWorldRenderBuffers(void* world, dmRender::HBufferedRenderBuffer** vx_buffers, uint32_t* vx_buffers_count);
-    extern void GetParticleFXWorldRenderBuffers(void* world, dmRender::HBufferedRenderBuffer* vx_buffer);
+    extern void GetModelWorldRenderObjects(void* world, dmRender::RenderObject** render_objects, uint32_t* render_objects_count);
+    extern void GetParticleFXWorldRenderObjects(void* world, dmRender::RenderObject** render_objects, uint32_t* render_objects_count);
     extern void GetTileGridWorldRenderBuffers(void* world, dmRender::HBufferedRenderBuffer* vx_buffer);
+    extern uint32_t GetTileGridWorldVertexCount(void* world);
+    extern uint32_t GetTileGridWorldChunkCount(void* world);
 };
 
+TEST_F(ComponentTest, ModelInstancingTest)
+{
+    void* model_world = dmGameObject::GetWorld(m_Collection, dmGameObject::GetComponentTypeIndex(m_Collection, dmHashString64("modelc")));
+    ASSERT_NE((void*) 0, model_world);
+
+    // The go has four local space models sharing a mesh and a material that reads a per-instance world matrix
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/model/instanced_model.goc", dmHashString64("/go"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+    dmGraphics::ResetDrawCount();
+    dmRender::RenderListBegin(m_RenderContext);
+    dmGameObject::Render(m_Collection);
+    dmRender::RenderListEnd(m_RenderContext);
+    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, 0x0);
+
+    dmRender::RenderObject* render_objects;
+    uint32_t render_objects_count;
+    dmGameSystem::GetModelWorldRenderObjects(model_world, &render_objects, &render_objects_count);
+    ASSERT_EQ(1u, render_objects_count);
+    ASSERT_EQ(4u, render_objects[0].m_InstanceCount);
+    ASSERT_NE(0u, render_objects[0].m_IndexBuffer);
+    ASSERT_NE(0u, render_objects[0].m_VertexBuffers[1]);
+
+    ASSERT_EQ(1u, dmGraphics::GetDrawCount());
+    ASSERT_EQ(4u, dmGraphics::GetDrawInstanceCount());
+
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    dmGraphics::Flip(m_GraphicsContext);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+// Returns the vertex a render object draws at the given element (null graphics adapter only)
+static const uint8_t* GetRenderObjectVertex(const dmRender::RenderObject* ro, uint32_t element)
+{
+    uint32_t vertex = ro->m_VertexStart + element;
+    if (ro->m_IndexBuffer)
+    {
+        // The vertex start of indexed render objects is a byte offset into the index buffer
+        const char* indices = ((dmGraphics::IndexBuffer*) ro->m_IndexBuffer)->m_Buffer + ro->m_VertexStart;
+        vertex = ro->m_IndexType == dmGraphics::TYPE_UNSIGNED_SHORT ? ((const uint16_t*) indices)[element] : ((const uint32_t*) indices)[element];
+    }
+    uint32_t vertex_stride = dmGraphics::GetVertexDeclarationStride(ro->m_VertexDeclaration);
+    return (const uint8_t*) ((dmGraphics::VertexBuffer*) ro->m_VertexBuffer)->m_Buffer + vertex * vertex_stride;
+}
+
 TEST_F(ComponentTest, DispatchBuffersTest)
 {
     dmHashEnableReverseHash(true);
@@ -2646,6 +2842,9 @@ TEST_F(ComponentTest, DispatchBuffersTest)
     // Furthermore, each component type is represented twice, with a different material per
     // instance. The two materials have different vertex formats, which we also account for
     // when producing our "expected" data for this test.
+    //
+    // Sprites and particles write to the transient buffers of the render context instead,
+    // so for those we check the vertices drawn by the render objects of the last dispatch.
     ////////////////////////////////////////////////////////////////////////////////////////////
 
     ASSERT_TRUE(dmGameObject::Init(m_Collection));
@@ -2736,23 +2935,14 @@ TEST_F(ComponentTest, DispatchBuffersTest)
     // Sprite
     ///////////////////////////////////////
     {
-        dmRender::BufferedRenderBuffer* vx_buffer;
-        dmRender::BufferedRenderBuffer* ix_buffer;
-        dmGameSystem::GetSpriteWorldRenderBuffers(sprite_world,  &vx_buffer, &ix_buffer);
-
-        ASSERT_EQ(num_draws, vx_buffer->m_Buffers.Size());
-        ASSERT_EQ(num_draws, ix_buffer->m_Buffers.Size());
+        dmRender::RenderObject** render_objects;
+        uint32_t render_objects_count;
+        dmGameSystem::GetSpriteWorldRenderObjects(sprite_world, &render_objects, &render_objects_count);
+        ASSERT_EQ(2u, render_objects_count);
 
-        ASSERT_EQ(dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, vx_buffer->m_Type);
-        ASSERT_EQ(dmRender::RENDER_BUFFER_TYPE_INDEX_BUFFER, ix_buffer->m_Type);
-
-        const uint32_t vertex_count   = 4;
-        const uint32_t vertex_padding = vertex_stride_b - (vertex_stride_a * vertex_count) % vertex_stride_b;
-        const uint32_t buffer_size    = (vertex_stride_a + vertex_stride_b) * vertex_count + vertex_padding;
-        uint8_t buffer[buffer_size];
-
-        vs_format_a* sprite_a = (vs_format_a*) &buffer[0];
-        vs_format_b* sprite_b = (vs_format_b*) &buffer[vertex_stride_a * vertex_count + vertex_padding];
+        const uint32_t vertex_count = 4;
+        vs_format_a sprite_a[vertex_count];
+        vs_format_b sprite_b[vertex_count];
 
         const float sprite_a_w = 32.0f;
         const float sprite_a_h = 32.0f;
@@ -2770,21 +2960,29 @@ TEST_F(ComponentTest, DispatchBuffersTest)
         SET_VTX_B(sprite_b[2],  sprite_b_w / 2.0f,  sprite_b_h / 2.0f, 0.0f, 4.0f, 3.0f, 2.0f, 1.0f);
         SET_VTX_B(sprite_b[3],  sprite_b_w / 2.0f, -sprite_b_h / 2.0f, 0.0f, 4.0f, 3.0f, 2.0f, 1.0f);
 
-        for (int i = 0; i < num_draws; ++i)
-        {
-            // TODO: Maybe validate index buffer here as well
-            dmGraphics::VertexBuffer* gfx_vx_buffer = (dmGraphics::VertexBuffer*) vx_buffer->m_Buffers[i];
-            ASSERT_EQ(buffer_size, gfx_vx_buffer->m_Size);
+        // The elements of the quad indices (0, 1, 2, 2, 3, 0) that refer to each vertex
+        const uint32_t quad_elements[vertex_count] = { 0, 1, 2, 4 };
 
-            vs_format_a* written_sprite_a = (vs_format_a*) &gfx_vx_buffer->m_Buffer[0];
-            vs_format_b* written_sprite_b = (vs_format_b*) &gfx_vx_buffer->m_Buffer[vertex_stride_a * vertex_count + vertex_padding];
+        // Sprite a is dispatched first (see the z values above)
+        ASSERT_EQ(vertex_stride_a, dmGraphics::GetVertexDeclarationStride(render_objects[0]->m_VertexDeclaration));
+        ASSERT_EQ(vertex_stride_b, dmGraphics::GetVertexDeclarationStride(render_objects[1]->m_VertexDeclaration));
 
-            for (int i = 0; i < vertex_count; ++i)
-            {
-                ASSERT_VTX_A_EQ(sprite_a[i], written_sprite_a[i]);
-                ASSERT_VTX_B_EQ(sprite_b[i], written_sprite_b[i]);
-            }
+        for (int i = 0; i < render_objects_count; ++i)
+        {
+            ASSERT_NE(0u, render_objects[i]->m_IndexBuffer);
+            ASSERT_EQ(6u, render_objects[i]->m_VertexCount);
         }
+
+        for (int i = 0; i < vertex_count; ++i)
+        {
+            const vs_format_a* written_sprite_a = (const vs_format_a*) GetRenderObjectVertex(render_objects[0], quad_elements[i]);
+            const vs_format_b* written_sprite_b = (const vs_format_b*) GetRenderObjectVertex(render_objects[1], quad_elements[i]);
+            ASSERT_VTX_A_EQ(sprite_a[i], (*written_sprite_a));
+            ASSERT_VTX_B_EQ(sprite_b[i], (*written_sprite_b));
+        }
+
+        // Only the first dispatch generates the sprite vertices, the others reuse them
+        ASSERT_EQ(2 * vertex_count * (num_draws - 1), dmGameSystem::GetSpriteWorldVerticesReused(sprite_world));
     }
 
     ///////////////////////////////////////
@@ -2852,18 +3050,14 @@ TEST_F(ComponentTest, DispatchBuffersTest)
     // Particle
     ///////////////////////////////////////
     {
-        dmRender::BufferedRenderBuffer* vx_buffer;
-        dmGameSystem::GetParticleFXWorldRenderBuffers(particlefx_world, &vx_buffer);
-        ASSERT_EQ(num_draws, vx_buffer->m_Buffers.Size());
-        ASSERT_EQ(dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, vx_buffer->m_Type);
-
-        const uint32_t vertex_count   = 6;
-        const uint32_t vertex_padding = vertex_stride_b - (vertex_stride_a * vertex_count) % vertex_stride_b;
-        const uint32_t buffer_size    = (vertex_stride_a + vertex_stride_b) * vertex_count + vertex_padding;
-        uint8_t buffer[buffer_size];
+        dmRender::RenderObject* render_objects;
+        uint32_t render_objects_count;
+        dmGameSystem::GetParticleFXWorldRenderObjects(particlefx_world, &render_objects, &render_objects_count);
+        ASSERT_EQ(2u, render_objects_count);
 
-        vs_format_a* pfx_a = (vs_format_a*) &buffer[0];
-        vs_format_b* pfx_b = (vs_format_b*) &buffer[vertex_stride_a * vertex_count + vertex_padding];
+        const uint32_t vertex_count = 6;
+        vs_format_a pfx_a[vertex_count];
+        vs_format_b pfx_b[vertex_count];
 
         const float pfx_s = 20.0f / 2.0f;
 
@@ -2886,19 +3080,21 @@ TEST_F(ComponentTest, DispatchBuffersTest)
         SET_VTX_B(pfx_b[4], p2[0], p2[1], 0.0f, 4.0f, 3.0f, 2.0f, 1.0f);
         SET_VTX_B(pfx_b[5], p0[0], p0[1], 0.0f, 4.0f, 3.0f, 2.0f, 1.0f);
 
-        for (int i = 0; i < num_draws; ++i)
-        {
-            dmGraphics::VertexBuffer* gfx_vx_buffer = (dmGraphics::VertexBuffer*) vx_buffer->m_Buffers[i];
-            ASSERT_EQ(buffer_size, gfx_vx_buffer->m_Size);
+        ASSERT_EQ(vertex_stride_a, dmGraphics::GetVertexDeclarationStride(render_objects[0].m_VertexDeclaration));
+        ASSERT_EQ(vertex_stride_b, dmGraphics::GetVertexDeclarationStride(render_objects[1].m_VertexDeclaration));
 
-            vs_format_a* written_pfx_a = (vs_format_a*) &gfx_vx_buffer->m_Buffer[0];
-            vs_format_b* written_pfx_b = (vs_format_b*) &gfx_vx_buffer->m_Buffer[vertex_stride_a * vertex_count + vertex_padding];
+        for (int i = 0; i < render_objects_count; ++i)
+        {
+            ASSERT_EQ(0u, render_objects[i].m_IndexBuffer);
+            ASSERT_EQ(vertex_count, render_objects[i].m_VertexCount);
+        }
 
-            for (int i = 0; i < vertex_count; ++i)
-            {
-                ASSERT_VTX_A_EQ(pfx_a[i], written_pfx_a[i]);
-                ASSERT_VTX_B_EQ(pfx_b[i], written_pfx_b[i]);
-            }
+        for (int i = 0; i < vertex_count; ++i)
+        {
+            const vs_format_a* written_pfx_a = (const vs_format_a*) GetRenderObjectVertex(&render_objects[0], i);
+            const vs_format_b* written_pfx_b = (const vs_format_b*) GetRenderObjectVertex(&render_objects[1], i);
+            ASSERT_VTX_A_EQ(pfx_a[i], (*written_pfx_a));
+            ASSERT_VTX_B_EQ(pfx_b[i], (*written_pfx_b));
         }
     }
 
@@ -2924,6 +3120,270 @@ TEST_F(ComponentTest, DispatchBuffersTest)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+// Renders a frame, and copies the vertices the sprite render objects draw, in draw order
+static void RenderSpriteFrame(dmRender::HRenderContext render_context, dmGraphics::HContext graphics_context, dmGameObject::HCollection collection, void* sprite_world, dmArray<uint8_t>& vertices)
+{
+    dmRender::RenderListBegin(render_context);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    dmRender::DrawRenderList(render_context, 0x0, 0x0, 0x0);
+
+    dmRender::RenderObject** render_objects;
+    uint32_t render_objects_count;
+    dmGameSystem::GetSpriteWorldRenderObjects(sprite_world, &render_objects, &render_objects_count);
+
+    vertices.SetSize(0);
+    for (uint32_t i = 0; i < render_objects_count; ++i)
+    {
+        const dmRender::RenderObject* ro = render_objects[i];
+        uint32_t vertex_stride = dmGraphics::GetVertexDeclarationStride(ro->m_VertexDeclaration);
+        for (uint32_t j = 0; j < ro->m_VertexCount; ++j)
+        {
+            if (vertices.Remaining() < vertex_stride)
+                vertices.OffsetCapacity(ro->m_VertexCount * vertex_stride);
+            vertices.PushArray(GetRenderObjectVertex(ro, j), vertex_stride);
+        }
+    }
+
+    dmRender::ClearRenderObjects(render_context);
+    dmGraphics::Flip(graphics_context);
+}
+
+static bool VerticesEqual(const dmArray<uint8_t>& a, const dmArray<uint8_t>& b)
+{
+    return a.Size() == b.Size() && memcmp(a.Begin(), b.Begin(), a.Size()) == 0;
+}
+
+TEST_F(ComponentTest, SpriteVertexCacheTest)
+{
+    void* sprite_world = dmGameObject::GetWorld(m_Collection, dmGameObject::GetComponentTypeIndex(m_Collection, dmHashString64("spritec")));
+    ASSERT_NE((void*) 0, sprite_world);
+
+    void* alt_material = 0;
+    void* alt_image = 0;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/resource/resource_alt.materialc", &alt_material));
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/tile/valid2.t.texturesetc", &alt_image));
+
+    // The sprites don't animate while the time stands still, so only the changes made below affect the vertices
+    m_UpdateContext.m_DT = 0.0f;
+
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+    dmGameObject::HInstance go_a = Spawn(m_Factory, m_Collection, "/sprite/vertex_cache.goc", dmHashString64("/go_a"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go_a);
+    dmGameObject::HInstance go_b = Spawn(m_Factory, m_Collection, "/sprite/vertex_cache.goc", dmHashString64("/go_b"), 0, Point3(64, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go_b);
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+    const uint32_t vertex_count = 4; // Per sprite
+    const dmhash_t sprite_id = dmHashString64("sprite");
+    dmGameObject::PropertyOptions opt;
+    opt.m_Index = 0;
+
+    dmArray<uint8_t> vertices;
+    dmArray<uint8_t> cached_vertices;
+
+    RenderSpriteFrame(m_RenderContext, m_GraphicsContext, m_Collection, sprite_world, vertices);
+    ASSERT_EQ(0u, dmGameSystem::GetSpriteWorldVerticesReused(sprite_world));
+
+    // Static sprites reuse their vertices in the following frames, also after they've been carried over to a new frame.
+    // The game objects don't move, so UpdateTransforms skips them, or the vertices would be regenerated.
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+        RenderSpriteFrame(m_RenderContext, m_GraphicsContext, m_Collection, sprite_world, cached_vertices);
+        ASSERT_EQ(2 * vertex_count, dmGameSystem::GetSpriteWorldVerticesReused(sprite_world));
+        ASSERT_TRUE(VerticesEqual(vertices, cached_vertices));
+    }
+
+    enum Change
+    {
+        CHANGE_POSITION,
+        CHANGE_FLIP,
+        CHANGE_FRAME,
+        CHANGE_SIZE,
+        CHANGE_SCALE,
+        CHANGE_MATERIAL,
+        CHANGE_IMAGE,
+        CHANGE_COUNT,
+    };
+
+    for (uint32_t change = 0; change < CHANGE_COUNT; ++change)
+    {
+        switch (change)
+        {
+            case CHANGE_POSITION:
+                dmGameObject::SetPosition(go_a, Point3(0, 32, 0));
+                break;
+            case CHANGE_FLIP:
+                {
+                    dmGameSystemDDF::SetFlipHorizontal ddf;
+                    ddf.m_Flip = 1;
+                    dmMessage::URL receiver;
+                    receiver.m_Socket   = dmGameObject::GetMessageSocket(m_Collection);
+                    receiver.m_Path     = dmGameObject::GetIdentifier(go_a);
+                    receiver.m_Fragment = sprite_id;
+                    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0, &receiver, dmGameSystemDDF::SetFlipHorizontal::m_DDFDescriptor->m_NameHash,
+                            (uintptr_t) go_a, (uintptr_t) dmGameSystemDDF::SetFlipHorizontal::m_DDFDescriptor, &ddf, sizeof(ddf), 0));
+                }
+                break;
+            case CHANGE_FRAME:
+                ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(go_a, sprite_id, dmHashString64("cursor"), opt, dmGameObject::PropertyVar(0.5f)));
+                break;
+            case CHANGE_SIZE:
+                ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(go_a, sprite_id, dmHashString64("size"), opt, dmGameObject::PropertyVar(Vector3(48, 48, 0))));
+                break;
+            case CHANGE_SCALE:
+                ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(go_a, sprite_id, dmHashString64("scale"), opt, dmGameObject::PropertyVar(Vector3(2, 2, 1))));
+                break;
+            case CHANGE_MATERIAL:
+                ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, SetResourceProperty(go_a, sprite_id, dmHashString64("material"), dmHashString64("/resource/resource_alt.materialc")));
+                break;
+            case CHANGE_IMAGE:
+                ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, SetResourceProperty(go_a, sprite_id, dmHashString64("image"), dmHashString64("/tile/valid2.t.texturesetc")));
+                break;
+        }
+
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+        // Only the unchanged sprite reuses its vertices
+        RenderSpriteFrame(m_RenderContext, m_GraphicsContext, m_Collection, sprite_world, cached_vertices);
+        ASSERT_EQ(vertex_count, dmGameSystem::GetSpriteWorldVerticesReused(sprite_world));
+
+        // The alternative material uses the same shaders, so only the batch changes
+        if (change != CHANGE_MATERIAL)
+        {
+            ASSERT_FALSE(VerticesEqual(vertices, cached_vertices));
+        }
+
+        // The vertices match the ones generated from scratch
+        dmGameSystem::InvalidateSpriteWorldVertexCache(sprite_world);
+        RenderSpriteFrame(m_RenderContext, m_GraphicsContext, m_Collection, sprite_world, vertices);
+        ASSERT_EQ(0u, dmGameSystem::GetSpriteWorldVerticesReused(sprite_world));
+        ASSERT_TRUE(VerticesEqual(vertices, cached_vertices));
+
+        // And are reused again in the following frames
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            RenderSpriteFrame(m_RenderContext, m_GraphicsContext, m_Collection, sprite_world, cached_vertices);
+            ASSERT_EQ(2 * vertex_count, dmGameSystem::GetSpriteWorldVerticesReused(sprite_world));
+            ASSERT_TRUE(VerticesEqual(vertices, cached_vertices));
+        }
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+
+    dmResource::Release(m_Factory, alt_material);
+    dmResource::Release(m_Factory, alt_image);
+}
+
+TEST_F(ComponentTest, TileGridChunksTest)
+{
+    /* Setup:
+    ** chunks
+    ** - [script] tile/chunks.script
+    ** - [tilemap] tile/chunks.tilegrid, 40x40 tiles in 2x2 chunks, with tiles in the lower left and upper right chunk
+    **
+    ** The script runs one step per frame
+    */
+
+    dmHashEnableReverseHash(true);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory         = m_Factory;
+    scriptlibcontext.m_Register        = m_Register;
+    scriptlibcontext.m_LuaState        = dmScript::GetLuaState(m_ScriptContext);
+    scriptlibcontext.m_GraphicsContext = m_GraphicsContext;
+    scriptlibcontext.m_ScriptContext   = m_ScriptContext;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    void* tilegrid_world = dmGameObject::GetWorld(m_Collection, dmGameObject::GetComponentTypeIndex(m_Collection, dmHashString64("tilemapc")));
+    ASSERT_NE((void*) 0, tilegrid_world);
+
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/tile/chunks.goc", dmHashString64("/go"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    // Only the chunks with tiles in the resource are allocated
+    ASSERT_EQ(2u, dmGameSystem::GetTileGridWorldChunkCount(tilegrid_world));
+
+    const uint32_t expected_chunk_counts[] = {
+        3, // set_tile in an empty chunk
+        1, // set_tile clearing the last tile of two chunks
+        1, // load_chunk of a new edge chunk, and of an empty buffer into the upper right chunk
+        0, // unload_chunk
+    };
+
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(expected_chunk_counts); ++i)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+        ASSERT_EQ(expected_chunk_counts[i], dmGameSystem::GetTileGridWorldChunkCount(tilegrid_world));
+    }
+
+    lua_getglobal(L, "tests_done");
+    bool tests_done = lua_toboolean(L, -1);
+    lua_pop(L, 1);
+    ASSERT_TRUE(tests_done);
+
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+TEST_F(ComponentTest, TileGridFrustumCullingTest)
+{
+    void* tilegrid_world = dmGameObject::GetWorld(m_Collection, dmGameObject::GetComponentTypeIndex(m_Collection, dmHashString64("tilemapc")));
+    ASSERT_NE((void*) 0, tilegrid_world);
+
+    // 40x40 tiles of 16x16 units, with one tile in the lower left chunk (centered at 256, 256) and one tile
+    // in the upper right chunk (centered at 768, 768)
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/tile/chunks_tilemap.goc", dmHashString64("/go"), 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+    const uint32_t vertices_per_tile = 6;
+
+    // No frustum, both chunks are rendered
+    dmRender::RenderListBegin(m_RenderContext);
+    dmGameObject::Render(m_Collection);
+    dmRender::RenderListEnd(m_RenderContext);
+    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, 0x0);
+    ASSERT_EQ(2 * vertices_per_tile, dmGameSystem::GetTileGridWorldVertexCount(tilegrid_world));
+    dmGraphics::Flip(m_GraphicsContext);
+
+    // A view of the lower left corner culls the upper right chunk
+    dmRender::FrustumOptions frustum_options;
+    frustum_options.m_NumPlanes = dmRender::FRUSTUM_PLANES_SIDES;
+    frustum_options.m_Matrix = dmVMath::Matrix4::orthographic(-100.0f, 100.0f, -100.0f, 100.0f, -1.0f, 1.0f);
+
+    dmRender::RenderListBegin(m_RenderContext);
+    dmGameObject::Render(m_Collection);
+    dmRender::RenderListEnd(m_RenderContext);
+    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, &frustum_options);
+    ASSERT_EQ(vertices_per_tile, dmGameSystem::GetTileGridWorldVertexCount(tilegrid_world));
+    dmGraphics::Flip(m_GraphicsContext);
+
+    // A view of the upper right corner culls the lower left chunk
+    frustum_options.m_Matrix = dmVMath::Matrix4::orthographic(600.0f, 700.0f, 600.0f, 700.0f, -1.0f, 1.0f);
+
+    dmRender::RenderListBegin(m_RenderContext);
+    dmGameObject::Render(m_Collection);
+    dmRender::RenderListEnd(m_RenderContext);
+    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, &frustum_options);
+    ASSERT_EQ(vertices_per_tile, dmGameSystem::GetTileGridWorldVertexCount(tilegrid_world));
+    dmGraphics::Flip(m_GraphicsContext);
+
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
 /* Camera */
 
 const char* valid_camera_resources[] = {"/camera/valid.camerac"};
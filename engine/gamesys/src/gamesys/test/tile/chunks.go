@@ -0,0 +1,8 @@
+components {
+  id: "script"
+  component: "/tile/chunks.script"
+}
+components {
+  id: "tilemap"
+  component: "/tile/chunks.tilegrid"
+}
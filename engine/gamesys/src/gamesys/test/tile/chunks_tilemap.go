@@ -0,0 +1,4 @@
+components {
+  id: "tilemap"
+  component: "/tile/chunks.tilegrid"
+}
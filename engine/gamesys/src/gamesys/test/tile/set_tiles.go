@@ -0,0 +1,12 @@
+components {
+  id: "script"
+  component: "/tile/set_tiles.script"
+}
+components {
+  id: "tilemap"
+  component: "/tile/chunks.tilegrid"
+}
+components {
+  id: "co"
+  component: "/tile/chunks.collisionobject"
+}
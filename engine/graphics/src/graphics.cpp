@@ -25,15 +25,55 @@
 
 DM_PROPERTY_GROUP(rmtp_Graphics, "Graphics");
 DM_PROPERTY_U32(rmtp_DrawCalls, 0, FrameReset, "# vertices", &rmtp_Graphics);
+DM_PROPERTY_U32(rmtp_BufferUploadSize, 0, FrameReset, "bytes uploaded to vertex and index buffers", &rmtp_Graphics);
+DM_PROPERTY_U32(rmtp_TextureUploads, 0, FrameReset, "# texture uploads", &rmtp_Graphics);
 
 #include <dlib/log.h>
 #include <dlib/dstrings.h>
+#include <dlib/math.h>
 
 namespace dmGraphics
 {
     static GraphicsAdapter*             g_adapter_list = 0;
     static GraphicsAdapter*             g_adapter = 0;
     static GraphicsAdapterFunctionTable g_functions;
+    // Collected here rather than in each adapter, so that all adapters report the same numbers
+    static Stats                        g_Stats;
+
+    static inline void AddBufferUpload(uint32_t size, const void* data)
+    {
+        if (data)
+        {
+            g_Stats.m_BufferBytesUploaded += size;
+            DM_PROPERTY_ADD_U32(rmtp_BufferUploadSize, size);
+        }
+    }
+
+    static inline void AddTextureUpload(const TextureParams& params)
+    {
+        if (params.m_Data)
+        {
+            g_Stats.m_TextureUploads++;
+            g_Stats.m_TextureBytesUploaded += params.m_DataSize;
+            DM_PROPERTY_ADD_U32(rmtp_TextureUploads, 1);
+        }
+    }
+
+    static inline void AddDrawCall(uint32_t count)
+    {
+        g_Stats.m_DrawCalls++;
+        g_Stats.m_Vertices += count;
+    }
+
+    void GetStats(HContext context, Stats* stats)
+    {
+        *stats = g_Stats;
+    }
+
+    void ResetStats(HContext context)
+    {
+        memset(&g_Stats, 0, sizeof(g_Stats));
+    }
 
     void RegisterGraphicsAdapter(GraphicsAdapter* adapter, GraphicsAdapterIsSupportedCb is_supported_cb, GraphicsAdapterRegisterFunctionsCb register_functions_cb, int8_t priority)
     {
@@ -417,7 +457,50 @@ namespace dmGraphics
         *data_size = attribute.m_Values.m_BinaryValues.m_Count;
     }
 
-    uint8_t* WriteAttribute(const VertexAttributeInfos* attribute_infos, uint8_t* write_ptr, uint32_t vertex_index, const dmVMath::Matrix4* world_transform, const dmVMath::Point3& p, const dmVMath::Point3& p_local, const dmVMath::Vector4* color, float** uvs, uint32_t* page_indices, uint32_t num_textures)
+    // Writes generated float values in the data type the attribute is declared with,
+    // which lets materials use e.g normalized unsigned shorts for texture coordinates and colors
+    static void WriteAttributeValues(const VertexAttributeInfo& info, uint8_t* write_ptr, const float* values)
+    {
+        if (info.m_DataType == VertexAttribute::TYPE_FLOAT)
+        {
+            memcpy(write_ptr, values, info.m_ValueByteSize);
+            return;
+        }
+
+        uint32_t count = dmMath::Min(info.m_ElementCount, 4U);
+        switch(info.m_DataType)
+        {
+            case VertexAttribute::TYPE_BYTE:
+                for (uint32_t i = 0; i < count; ++i)
+                    ((int8_t*) write_ptr)[i] = (int8_t) dmMath::Clamp(info.m_Normalize ? values[i] * 127.0f : values[i], -128.0f, 127.0f);
+                break;
+            case VertexAttribute::TYPE_UNSIGNED_BYTE:
+                for (uint32_t i = 0; i < count; ++i)
+                    ((uint8_t*) write_ptr)[i] = (uint8_t) dmMath::Clamp(info.m_Normalize ? values[i] * 255.0f + 0.5f : values[i], 0.0f, 255.0f);
+                break;
+            case VertexAttribute::TYPE_SHORT:
+                for (uint32_t i = 0; i < count; ++i)
+                    ((int16_t*) write_ptr)[i] = (int16_t) dmMath::Clamp(info.m_Normalize ? values[i] * 32767.0f : values[i], -32768.0f, 32767.0f);
+                break;
+            case VertexAttribute::TYPE_UNSIGNED_SHORT:
+                for (uint32_t i = 0; i < count; ++i)
+                    ((uint16_t*) write_ptr)[i] = (uint16_t) dmMath::Clamp(info.m_Normalize ? values[i] * 65535.0f + 0.5f : values[i], 0.0f, 65535.0f);
+                break;
+            case VertexAttribute::TYPE_INT:
+                for (uint32_t i = 0; i < count; ++i)
+                    ((int32_t*) write_ptr)[i] = (int32_t) values[i];
+                break;
+            case VertexAttribute::TYPE_UNSIGNED_INT:
+                for (uint32_t i = 0; i < count; ++i)
+                    ((uint32_t*) write_ptr)[i] = (uint32_t) dmMath::Max(values[i], 0.0f);
+                break;
+            default:
+                memcpy(write_ptr, values, info.m_ValueByteSize);
+                break;
+        }
+    }
+
+    uint8_t* WriteAttribute(const VertexAttributeInfos* attribute_infos, uint8_t* write_ptr, uint32_t vertex_index, const dmVMath::Vector4* world_position, const dmVMath::Point3& p_local, const dmVMath::Vector4* color, float** uvs, uint32_t* page_indices, uint32_t num_textures)
     {
         uint32_t num_texcoords = 0;
         uint32_t num_page_indices = 0;
@@ -430,14 +513,14 @@ namespace dmGraphics
             {
                 case dmGraphics::VertexAttribute::SEMANTIC_TYPE_POSITION:
                 {
-                    if (info.m_CoordinateSpace == dmGraphics::COORDINATE_SPACE_WORLD && world_transform)
+                    if (info.m_CoordinateSpace == dmGraphics::COORDINATE_SPACE_WORLD && world_position)
                     {
-                        dmVMath::Vector4 wp = *world_transform * p;
-                        memcpy(write_ptr, &wp, info.m_ValueByteSize);
+                        WriteAttributeValues(info, write_ptr, (const float*) world_position);
                     }
                     else
                     {
-                        memcpy(write_ptr, &p_local, info.m_ValueByteSize);
+                        dmVMath::Vector4 local(p_local);
+                        WriteAttributeValues(info, write_ptr, (const float*) &local);
                     }
                 } break;
                 case dmGraphics::VertexAttribute::SEMANTIC_TYPE_TEXCOORD:
@@ -445,20 +528,22 @@ namespace dmGraphics
                     uint32_t unit = num_texcoords++;
                     if (unit >= num_textures)
                         unit = 0;
-                    memcpy(write_ptr, uvs[unit] + vertex_index * 2, info.m_ValueByteSize);
+                    const float* uv = uvs[unit] + vertex_index * 2;
+                    float values[4] = { uv[0], uv[1], 0.0f, 0.0f };
+                    WriteAttributeValues(info, write_ptr, values);
                 } break;
                 case dmGraphics::VertexAttribute::SEMANTIC_TYPE_COLOR:
                 {
                     if (color)
-                        memcpy(write_ptr, color, info.m_ValueByteSize);
+                        WriteAttributeValues(info, write_ptr, (const float*) color);
                     else
                         memcpy(write_ptr, info.m_ValuePtr, info.m_ValueByteSize);
                 } break;
                 case dmGraphics::VertexAttribute::SEMANTIC_TYPE_PAGE_INDEX:
                 {
                     uint32_t unit = num_page_indices++;
-                    float page_index = (float) page_indices[unit];
-                    memcpy(write_ptr, &page_index, info.m_ValueByteSize);
+                    float values[4] = { (float) page_indices[unit], 0.0f, 0.0f, 0.0f };
+                    WriteAttributeValues(info, write_ptr, values);
                 } break;
                 default:
                 {
@@ -473,6 +558,16 @@ namespace dmGraphics
         return write_ptr;
     }
 
+    uint8_t* WriteAttribute(const VertexAttributeInfos* attribute_infos, uint8_t* write_ptr, uint32_t vertex_index, const dmVMath::Matrix4* world_transform, const dmVMath::Point3& p, const dmVMath::Point3& p_local, const dmVMath::Vector4* color, float** uvs, uint32_t* page_indices, uint32_t num_textures)
+    {
+        if (world_transform)
+        {
+            dmVMath::Vector4 wp = *world_transform * p;
+            return WriteAttribute(attribute_infos, write_ptr, vertex_index, &wp, p_local, color, uvs, page_indices, num_textures);
+        }
+        return WriteAttribute(attribute_infos, write_ptr, vertex_index, (const dmVMath::Vector4*) 0, p_local, color, uvs, page_indices, num_textures);
+    }
+
     dmGraphics::Type GetGraphicsType(dmGraphics::VertexAttribute::DataType data_type)
     {
         switch(data_type)
@@ -1233,6 +1328,7 @@ namespace dmGraphics
     }
     HVertexBuffer NewVertexBuffer(HContext context, uint32_t size, const void* data, BufferUsage buffer_usage)
     {
+        AddBufferUpload(size, data);
         return g_functions.m_NewVertexBuffer(context, size, data, buffer_usage);
     }
     void DeleteVertexBuffer(HVertexBuffer buffer)
@@ -1241,10 +1337,12 @@ namespace dmGraphics
     }
     void SetVertexBufferData(HVertexBuffer buffer, uint32_t size, const void* data, BufferUsage buffer_usage)
     {
+        AddBufferUpload(size, data);
         g_functions.m_SetVertexBufferData(buffer, size, data, buffer_usage);
     }
     void SetVertexBufferSubData(HVertexBuffer buffer, uint32_t offset, uint32_t size, const void* data)
     {
+        AddBufferUpload(size, data);
         g_functions.m_SetVertexBufferSubData(buffer, offset, size, data);
     }
     uint32_t GetMaxElementsVertices(HContext context)
@@ -1253,6 +1351,7 @@ namespace dmGraphics
     }
     HIndexBuffer NewIndexBuffer(HContext context, uint32_t size, const void* data, BufferUsage buffer_usage)
     {
+        AddBufferUpload(size, data);
         return g_functions.m_NewIndexBuffer(context, size, data, buffer_usage);
     }
     void DeleteIndexBuffer(HIndexBuffer buffer)
@@ -1261,10 +1360,12 @@ namespace dmGraphics
     }
     void SetIndexBufferData(HIndexBuffer buffer, uint32_t size, const void* data, BufferUsage buffer_usage)
     {
+        AddBufferUpload(size, data);
         g_functions.m_SetIndexBufferData(buffer, size, data, buffer_usage);
     }
     void SetIndexBufferSubData(HIndexBuffer buffer, uint32_t offset, uint32_t size, const void* data)
     {
+        AddBufferUpload(size, data);
         g_functions.m_SetIndexBufferSubData(buffer, offset, size, data);
     }
     bool IsIndexBufferFormatSupported(HContext context, IndexBufferFormat format)
@@ -1291,6 +1392,10 @@ namespace dmGraphics
     {
         g_functions.m_DisableVertexDeclaration(context, vertex_declaration);
     }
+    void SetVertexDeclarationStepFunction(HContext context, HVertexDeclaration vertex_declaration, VertexStepFunction step_function)
+    {
+        g_functions.m_SetVertexDeclarationStepFunction(context, vertex_declaration, step_function);
+    }
     void EnableVertexBuffer(HContext context, HVertexBuffer vertex_buffer, uint32_t binding_index)
     {
         return g_functions.m_EnableVertexBuffer(context, vertex_buffer, binding_index);
@@ -1301,10 +1406,17 @@ namespace dmGraphics
     }
     void DrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer)
     {
+        AddDrawCall(count);
         g_functions.m_DrawElements(context, prim_type, first, count, type, index_buffer);
     }
+    void DrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
+    {
+        AddDrawCall(count * instance_count);
+        g_functions.m_DrawElementsInstanced(context, prim_type, first, count, instance_count, type, index_buffer);
+    }
     void Draw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
     {
+        AddDrawCall(count);
         g_functions.m_Draw(context, prim_type, first, count);
     }
     HVertexProgram NewVertexProgram(HContext context, ShaderDesc::Shader* ddf)
@@ -1349,6 +1461,7 @@ namespace dmGraphics
     }
     void EnableProgram(HContext context, HProgram program)
     {
+        g_Stats.m_ProgramSwitches++;
         g_functions.m_EnableProgram(context, program);
     }
     void DisableProgram(HContext context)
@@ -1501,10 +1614,12 @@ namespace dmGraphics
     }
     void SetTexture(HTexture texture, const TextureParams& params)
     {
+        AddTextureUpload(params);
         g_functions.m_SetTexture(texture, params);
     }
     void SetTextureAsync(HTexture texture, const TextureParams& params, SetTextureAsyncCallback callback, void* user_data)
     {
+        AddTextureUpload(params);
         g_functions.m_SetTextureAsync(texture, params, callback, user_data);
     }
     void SetTextureParams(HTexture texture, TextureFilter minfilter, TextureFilter magfilter, TextureWrap uwrap, TextureWrap vwrap, float max_anisotropy)
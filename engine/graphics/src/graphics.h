@@ -169,6 +169,7 @@ namespace dmGraphics
         CONTEXT_FEATURE_TEXTURE_ARRAY          = 1,
         CONTEXT_FEATURE_COMPUTE_SHADER         = 2,
         CONTEXT_FEATURE_STORAGE_BUFFER         = 3,
+        CONTEXT_FEATURE_INSTANCING             = 4,
     };
 
     // Translation table to translate RenderTargetAttachment to BufferType
@@ -326,6 +327,17 @@ namespace dmGraphics
         uint64_t m_PolygonOffsetFillEnabled : 1;
     };
 
+    // Counters collected by the graphics layer, see GetStats()
+    struct Stats
+    {
+        uint32_t m_DrawCalls;
+        uint32_t m_Vertices;             // Vertices (or indices) submitted, including all instances
+        uint32_t m_BufferBytesUploaded;  // Bytes uploaded to vertex and index buffers
+        uint32_t m_TextureUploads;
+        uint32_t m_TextureBytesUploaded;
+        uint32_t m_ProgramSwitches;
+    };
+
     struct VertexAttributeInfo
     {
         dmhash_t                      m_NameHash;
@@ -501,6 +513,21 @@ namespace dmGraphics
      */
     void Flip(HContext context);
 
+    /**
+     * Get the counters collected since the last call to ResetStats()
+     *
+     * @param context Graphics context handle
+     * @param stats Out parameter for the counters
+     */
+    void GetStats(HContext context, Stats* stats);
+
+    /**
+     * Reset the counters returned by GetStats(), e.g. once per frame
+     *
+     * @param context Graphics context handle
+     */
+    void ResetStats(HContext context);
+
     /**
      * Set buffer swap interval.
      * 1 for base frequency, eg every frame (60hz)
@@ -530,11 +557,14 @@ namespace dmGraphics
     void     DisableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration);
     void     HashVertexDeclaration(HashState32 *state, HVertexDeclaration vertex_declaration);
     uint32_t GetVertexDeclarationStride(HVertexDeclaration vertex_declaration);
+    void     SetVertexDeclarationStepFunction(HContext context, HVertexDeclaration vertex_declaration, VertexStepFunction step_function);
 
     void     EnableVertexBuffer(HContext context, HVertexBuffer vertex_buffer, uint32_t binding_index);
     void     DisableVertexBuffer(HContext context, HVertexBuffer vertex_buffer);
 
     void DrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer);
+    // Requires CONTEXT_FEATURE_INSTANCING. Streams of declarations with VERTEX_STEP_FUNCTION_INSTANCE advance once per instance.
+    void DrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer);
     void Draw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count);
 
     // Shaders
@@ -568,6 +598,8 @@ namespace dmGraphics
     void             GetAttributeValues(const VertexAttribute& attribute, const uint8_t** data_ptr, uint32_t* data_size);
     Type             GetGraphicsType(VertexAttribute::DataType data_type);
     uint8_t*         WriteAttribute(const VertexAttributeInfos* attribute_infos, uint8_t* write_ptr, uint32_t vertex_index, const dmVMath::Matrix4* world_transform, const dmVMath::Point3& p, const dmVMath::Point3& p_local, const dmVMath::Vector4* color, float** uvs, uint32_t* page_indices, uint32_t num_textures);
+    // Same as above, but with the world space position already calculated (e.g when many vertices share a transform)
+    uint8_t*         WriteAttribute(const VertexAttributeInfos* attribute_infos, uint8_t* write_ptr, uint32_t vertex_index, const dmVMath::Vector4* world_position, const dmVMath::Point3& p_local, const dmVMath::Vector4* color, float** uvs, uint32_t* page_indices, uint32_t num_textures);
 
     uint32_t         GetUniformName(HProgram prog, uint32_t index, char* buffer, uint32_t buffer_size, Type* type, int32_t* size);
     uint32_t         GetUniformCount(HProgram prog);
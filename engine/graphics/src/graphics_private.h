@@ -236,6 +236,7 @@ namespace dmGraphics
     // Test only functions:
     void     ResetDrawCount();
     uint64_t GetDrawCount();
+    uint64_t GetDrawInstanceCount();
     void     GetTextureFilters(HContext context, uint32_t unit, TextureFilter& min_filter, TextureFilter& mag_filter);
     void     EnableVertexDeclaration(HContext _context, HVertexDeclaration vertex_declaration, uint32_t binding_index);
     void     SetOverrideShaderLanguage(HContext context, ShaderDesc::ShaderClass shader_class, ShaderDesc::Language language);
@@ -22,6 +22,7 @@
 #include <dlib/math.h>
 #include <dlib/thread.h>
 #include <dlib/hash.h>
+#include <dlib/profile.h>
 
 #include <platform/platform_window.h>
 
@@ -31,7 +32,10 @@
 #include "graphics_null_private.h"
 #include "glsl_uniform_parser.h"
 
+DM_PROPERTY_EXTERN(rmtp_DrawCalls);
+
 uint64_t g_DrawCount = 0;
+uint64_t g_DrawInstanceCount = 0;
 uint64_t g_Flipped = 0;
 
 // Used only for tests
@@ -185,6 +189,7 @@ namespace dmGraphics
         context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_MULTI_TARGET_RENDERING;
         context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_TEXTURE_ARRAY;
         context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_COMPUTE_SHADER;
+        context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_INSTANCING;
 
         if (context->m_AsyncProcessingSupport)
         {
@@ -514,16 +519,17 @@ namespace dmGraphics
         return vd;
     }
 
-    static void EnableVertexStream(HContext context, uint16_t stream, uint16_t size, Type type, uint16_t stride, const void* vertex_buffer)
+    static void EnableVertexStream(HContext context, uint16_t stream, uint16_t size, Type type, uint16_t stride, VertexStepFunction step_function, const void* vertex_buffer)
     {
         assert(context);
         assert(vertex_buffer);
         VertexStreamBuffer& s = ((NullContext*) context)->m_VertexStreams[stream];
         assert(s.m_Source == 0x0);
         assert(s.m_Buffer == 0x0);
-        s.m_Source = vertex_buffer;
-        s.m_Size   = size * TYPE_SIZE[type - dmGraphics::TYPE_BYTE];
-        s.m_Stride = stride;
+        s.m_Source       = vertex_buffer;
+        s.m_Size         = size * TYPE_SIZE[type - dmGraphics::TYPE_BYTE];
+        s.m_Stride       = stride;
+        s.m_StepFunction = step_function;
     }
 
     static void DisableVertexStream(HContext context, uint16_t stream)
@@ -536,29 +542,36 @@ namespace dmGraphics
             delete [] (char*)s.m_Buffer;
             s.m_Buffer = 0x0;
         }
-        s.m_Source = 0x0;
+        s.m_Source       = 0x0;
+        s.m_StepFunction = VERTEX_STEP_FUNCTION_VERTEX;
     }
 
     static void NullEnableVertexBuffer(HContext _context, HVertexBuffer vertex_buffer, uint32_t binding_index)
     {
         NullContext* context = (NullContext*) _context;
-        context->m_VertexBuffer = vertex_buffer;
+        assert(binding_index < MAX_VERTEX_BUFFERS);
+        context->m_VertexBuffers[binding_index] = vertex_buffer;
     }
 
     static void NullDisableVertexBuffer(HContext _context, HVertexBuffer vertex_buffer)
     {
         NullContext* context = (NullContext*) _context;
-        context->m_VertexBuffer = 0;
+        for (uint32_t i = 0; i < MAX_VERTEX_BUFFERS; ++i)
+        {
+            if (context->m_VertexBuffers[i] == vertex_buffer)
+                context->m_VertexBuffers[i] = 0;
+        }
     }
 
     void EnableVertexDeclaration(HContext _context, HVertexDeclaration vertex_declaration, uint32_t binding_index)
     {
         assert(_context);
         assert(vertex_declaration);
+        assert(binding_index < MAX_VERTEX_BUFFERS);
 
         NullContext* context = (NullContext*) _context;
 
-        VertexBuffer* vb = (VertexBuffer*) context->m_VertexBuffer;
+        VertexBuffer* vb = (VertexBuffer*) context->m_VertexBuffers[binding_index];
         assert(vb);
 
         uint16_t stride = 0;
@@ -568,14 +581,21 @@ namespace dmGraphics
             stride += vertex_declaration->m_Streams[i].m_Size * TYPE_SIZE[vertex_declaration->m_Streams[i].m_Type - dmGraphics::TYPE_BYTE];
         }
 
+        // Streams from all bound declarations share the same slots, so each declaration
+        // takes the first free slots and remembers them as its stream locations.
+        uint16_t slot   = 0;
         uint32_t offset = 0;
         for (uint16_t i = 0; i < vertex_declaration->m_StreamCount; ++i)
         {
             VertexDeclaration::Stream& stream = vertex_declaration->m_Streams[i];
             if (stream.m_Size > 0)
             {
-                stream.m_Location = i;
-                EnableVertexStream(context, i, stream.m_Size, stream.m_Type, stride, &vb->m_Buffer[offset]);
+                while (slot < MAX_VERTEX_STREAM_COUNT && context->m_VertexStreams[slot].m_Source != 0x0)
+                    ++slot;
+                assert(slot < MAX_VERTEX_STREAM_COUNT);
+
+                stream.m_Location = slot;
+                EnableVertexStream(context, slot, stream.m_Size, stream.m_Type, stride, vertex_declaration->m_StepFunction, &vb->m_Buffer[offset]);
                 offset += stream.m_Size * TYPE_SIZE[stream.m_Type - dmGraphics::TYPE_BYTE];
             }
         }
@@ -591,8 +611,17 @@ namespace dmGraphics
         assert(context);
         assert(vertex_declaration);
         for (uint32_t i = 0; i < vertex_declaration->m_StreamCount; ++i)
-            if (vertex_declaration->m_Streams[i].m_Size > 0)
-                DisableVertexStream(context, i);
+        {
+            const VertexDeclaration::Stream& stream = vertex_declaration->m_Streams[i];
+            if (stream.m_Size > 0 && stream.m_Location >= 0)
+                DisableVertexStream(context, stream.m_Location);
+        }
+    }
+
+    static void NullSetVertexDeclarationStepFunction(HContext context, HVertexDeclaration vertex_declaration, VertexStepFunction step_function)
+    {
+        assert(vertex_declaration);
+        vertex_declaration->m_StepFunction = step_function;
     }
 
     static uint32_t GetIndex(Type type, HIndexBuffer ib, uint32_t index)
@@ -612,7 +641,20 @@ namespace dmGraphics
         return ~0;
     }
 
-    static void NullDrawElements(HContext _context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer)
+    static void CountDraw(uint32_t instance_count)
+    {
+        if (g_Flipped)
+        {
+            g_Flipped = 0;
+            g_DrawCount = 0;
+            g_DrawInstanceCount = 0;
+        }
+        g_DrawCount++;
+        g_DrawInstanceCount += instance_count;
+        DM_PROPERTY_ADD_U32(rmtp_DrawCalls, 1);
+    }
+
+    static void NullDrawElementsInstanced(HContext _context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
     {
         assert(_context);
         assert(index_buffer);
@@ -622,7 +664,8 @@ namespace dmGraphics
             VertexStreamBuffer& vs = context->m_VertexStreams[i];
             if (vs.m_Size > 0)
             {
-                vs.m_Buffer = new char[vs.m_Size * count];
+                uint32_t element_count = vs.m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE ? instance_count : count;
+                vs.m_Buffer = new char[vs.m_Size * element_count];
             }
         }
         for (uint32_t i = 0; i < count; ++i)
@@ -631,35 +674,39 @@ namespace dmGraphics
             for (uint32_t j = 0; j < MAX_VERTEX_STREAM_COUNT; ++j)
             {
                 VertexStreamBuffer& vs = context->m_VertexStreams[j];
-                if (vs.m_Size > 0)
+                if (vs.m_Size > 0 && vs.m_StepFunction == VERTEX_STEP_FUNCTION_VERTEX)
                     memcpy(&((char*)vs.m_Buffer)[i * vs.m_Size], &((char*)vs.m_Source)[index * vs.m_Stride], vs.m_Size);
             }
         }
-
-        if (g_Flipped)
+        for (uint32_t i = 0; i < instance_count; ++i)
         {
-            g_Flipped = 0;
-            g_DrawCount = 0;
+            for (uint32_t j = 0; j < MAX_VERTEX_STREAM_COUNT; ++j)
+            {
+                VertexStreamBuffer& vs = context->m_VertexStreams[j];
+                if (vs.m_Size > 0 && vs.m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE)
+                    memcpy(&((char*)vs.m_Buffer)[i * vs.m_Size], &((char*)vs.m_Source)[i * vs.m_Stride], vs.m_Size);
+            }
         }
-        g_DrawCount++;
+
+        CountDraw(instance_count);
+    }
+
+    static void NullDrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer)
+    {
+        NullDrawElementsInstanced(context, prim_type, first, count, 1, type, index_buffer);
     }
 
     static void NullDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
     {
         assert(context);
-
-        if (g_Flipped)
-        {
-            g_Flipped = 0;
-            g_DrawCount = 0;
-        }
-        g_DrawCount++;
+        CountDraw(1);
     }
 
     // For tests
     void ResetDrawCount()
     {
         g_DrawCount = 0;
+        g_DrawInstanceCount = 0;
     }
 
     uint64_t GetDrawCount()
@@ -667,6 +714,11 @@ namespace dmGraphics
         return g_DrawCount;
     }
 
+    uint64_t GetDrawInstanceCount()
+    {
+        return g_DrawInstanceCount;
+    }
+
     static void ProgramShaderResourceCallback(dmGraphics::GLSLUniformParserBindingType binding_type, const char* name, uint32_t name_length, dmGraphics::Type type, uint32_t size, uintptr_t userdata);
 
     struct ShaderBinding
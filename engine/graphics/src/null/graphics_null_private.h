@@ -25,6 +25,7 @@ namespace dmGraphics
 {
     const static uint32_t MAX_REGISTER_COUNT = 16;
     const static uint32_t MAX_TEXTURE_COUNT  = 32;
+    const static uint32_t MAX_VERTEX_BUFFERS = 2;
 
     struct TextureSampler
     {
@@ -54,10 +55,11 @@ namespace dmGraphics
 
     struct VertexStreamBuffer
     {
-        const void* m_Source;
-        void* m_Buffer;
-        uint16_t m_Size;
-        uint16_t m_Stride;
+        const void*        m_Source;
+        void*              m_Buffer;
+        uint16_t           m_Size;
+        uint16_t           m_Stride;
+        VertexStepFunction m_StepFunction;
     };
 
     struct FrameBuffer
@@ -114,7 +116,7 @@ namespace dmGraphics
         dmVMath::Vector4                   m_ProgramRegisters[MAX_REGISTER_COUNT];
         TextureSampler                     m_Samplers[MAX_TEXTURE_COUNT];
         HTexture                           m_Textures[MAX_TEXTURE_COUNT];
-        HVertexBuffer                      m_VertexBuffer;
+        HVertexBuffer                      m_VertexBuffers[MAX_VERTEX_BUFFERS];
         FrameBuffer                        m_MainFrameBuffer;
         FrameBuffer*                       m_CurrentFrameBuffer;
         void*                              m_Program;
@@ -133,7 +135,7 @@ namespace dmGraphics
         uint32_t                           m_UseAsyncTextureLoad    : 1;
         uint32_t                           m_RequestWindowClose     : 1;
         uint32_t                           m_PrintDeviceInfo        : 1;
-        uint32_t                           m_ContextFeatures        : 3;
+        uint32_t                           m_ContextFeatures        : 8;
     };
 }
 
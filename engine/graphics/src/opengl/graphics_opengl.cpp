@@ -398,6 +398,12 @@ static void LogFrameBufferError(GLenum status)
     typedef void (* DM_PFNGLDRAWBUFFERSPROC) (GLsizei n, const GLenum *bufs);
     DM_PFNGLDRAWBUFFERSPROC PFN_glDrawBuffers = NULL;
 
+    typedef void (* DM_PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount);
+    DM_PFNGLDRAWELEMENTSINSTANCEDPROC PFN_glDrawElementsInstanced = NULL;
+
+    typedef void (* DM_PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+    DM_PFNGLVERTEXATTRIBDIVISORPROC PFN_glVertexAttribDivisor = NULL;
+
     // Note: This is necessary for webgl and android to work since we don't load core functions with emsc,
     //       however we might want to do this the other way around perhaps? i.e special case for webgl
     //       and load functions like this for all other platforms.
@@ -676,6 +682,7 @@ static void LogFrameBufferError(GLenum status)
             case CONTEXT_FEATURE_TEXTURE_ARRAY:          return context->m_TextureArraySupport;
             case CONTEXT_FEATURE_COMPUTE_SHADER:         return context->m_ComputeSupport;
             case CONTEXT_FEATURE_STORAGE_BUFFER:         return context->m_StorageBufferSupport;
+            case CONTEXT_FEATURE_INSTANCING:             return context->m_InstancingSupport;
         }
         return false;
     }
@@ -814,6 +821,7 @@ static void LogFrameBufferError(GLenum status)
         PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_MULTI_TARGET_RENDERING);
         PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_TEXTURE_ARRAY);
         PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_COMPUTE_SHADER);
+        PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_INSTANCING);
     #undef PRINT_FEATURE_IF_SUPPORTED
     }
 
@@ -1033,6 +1041,9 @@ static void LogFrameBufferError(GLenum status)
 
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glInvalidateFramebuffer,   "glDiscardFramebuffer", "discard_framebuffer", "glInvalidateFramebuffer", DM_PFNGLINVALIDATEFRAMEBUFFERPROC, context);
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawBuffers,             "glDrawBuffers",        "draw_buffers",        "glDrawBuffers",           DM_PFNGLDRAWBUFFERSPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced,   "glDrawElementsInstanced", "draw_instanced",   "glDrawElementsInstanced", DM_PFNGLDRAWELEMENTSINSTANCEDPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced,   "glDrawElementsInstanced", "instanced_arrays", "glDrawElementsInstanced", DM_PFNGLDRAWELEMENTSINSTANCEDPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glVertexAttribDivisor,     "glVertexAttribDivisor",   "instanced_arrays", "glVertexAttribDivisor",   DM_PFNGLVERTEXATTRIBDIVISORPROC, context);
     #ifdef ANDROID
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glTexSubImage3D,           "glTexSubImage3D",           "texture_array", "glTexSubImage3D",           DM_PFNGLTEXSUBIMAGE3DPROC, context);
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glTexImage3D,              "glTexImage3D",              "texture_array", "glTexImage3D",              DM_PFNGLTEXIMAGE3DPROC, context);
@@ -1041,6 +1052,8 @@ static void LogFrameBufferError(GLenum status)
     #endif
     #undef DMGRAPHICS_GET_PROC_ADDRESS_EXT
 
+        context->m_InstancingSupport = PFN_glDrawElementsInstanced != 0 && PFN_glVertexAttribDivisor != 0;
+
         if (OpenGLIsExtensionSupported(context, "GL_IMG_texture_compression_pvrtc") ||
             OpenGLIsExtensionSupported(context, "WEBGL_compressed_texture_pvrtc"))
         {
@@ -1636,6 +1649,22 @@ static void LogFrameBufferError(GLenum status)
         vertex_declaration->m_ModificationVersion = ((OpenGLContext*) context)->m_ModificationVersion;
     }
 
+    static inline uint32_t GetVertexStreamColumnCount(uint16_t stream_size)
+    {
+        switch (stream_size)
+        {
+            case 16: return 4; // mat4
+            case 9:  return 3; // mat3
+            default: return 1;
+        }
+    }
+
+    static void OpenGLSetVertexDeclarationStepFunction(HContext context, HVertexDeclaration vertex_declaration, VertexStepFunction step_function)
+    {
+        assert(vertex_declaration);
+        vertex_declaration->m_StepFunction = step_function;
+    }
+
     static void OpenGLEnableVertexBuffer(HContext context, HVertexBuffer vertex_buffer, uint32_t binding_index)
     {
         glBindBufferARB(GL_ARRAY_BUFFER, vertex_buffer);
@@ -1661,21 +1690,35 @@ static void LogFrameBufferError(GLenum status)
 
         #define BUFFER_OFFSET(i) ((char*)0x0 + (i))
 
+        const GLuint divisor = vertex_declaration->m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE ? 1 : 0;
+
         for (uint32_t i=0; i<vertex_declaration->m_StreamCount; i++)
         {
             if (vertex_declaration->m_Streams[i].m_Location != -1)
             {
-                glEnableVertexAttribArray(vertex_declaration->m_Streams[i].m_Location);
-                CHECK_GL_ERROR;
-                glVertexAttribPointer(
-                        vertex_declaration->m_Streams[i].m_Location,
-                        vertex_declaration->m_Streams[i].m_Size,
-                        GetOpenGLType(vertex_declaration->m_Streams[i].m_Type),
-                        vertex_declaration->m_Streams[i].m_Normalize,
-                        vertex_declaration->m_Stride,
-                BUFFER_OFFSET(vertex_declaration->m_Streams[i].m_Offset) );   //The starting point of the VBO, for the vertices
+                // Matrix attributes occupy one location per column
+                uint32_t column_count = GetVertexStreamColumnCount(vertex_declaration->m_Streams[i].m_Size);
+                uint32_t column_size  = vertex_declaration->m_Streams[i].m_Size / column_count;
+                for (uint32_t c = 0; c < column_count; ++c)
+                {
+                    GLuint location = vertex_declaration->m_Streams[i].m_Location + c;
+                    glEnableVertexAttribArray(location);
+                    CHECK_GL_ERROR;
+                    glVertexAttribPointer(
+                            location,
+                            column_size,
+                            GetOpenGLType(vertex_declaration->m_Streams[i].m_Type),
+                            vertex_declaration->m_Streams[i].m_Normalize,
+                            vertex_declaration->m_Stride,
+                    BUFFER_OFFSET(vertex_declaration->m_Streams[i].m_Offset + c * column_size * GetTypeSize(vertex_declaration->m_Streams[i].m_Type)) );   //The starting point of the VBO, for the vertices
+                    CHECK_GL_ERROR;
 
-                CHECK_GL_ERROR;
+                    if (context->m_InstancingSupport)
+                    {
+                        PFN_glVertexAttribDivisor(location, divisor);
+                        CHECK_GL_ERROR;
+                    }
+                }
             }
         }
 
@@ -1687,12 +1730,25 @@ static void LogFrameBufferError(GLenum status)
         assert(context);
         assert(vertex_declaration);
 
+        const bool reset_divisor = vertex_declaration->m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE && ((OpenGLContext*) context)->m_InstancingSupport;
+
         for (uint32_t i=0; i<vertex_declaration->m_StreamCount; i++)
         {
             if (vertex_declaration->m_Streams[i].m_Location != -1)
             {
-                glDisableVertexAttribArray(vertex_declaration->m_Streams[i].m_Location);
-                CHECK_GL_ERROR;
+                uint32_t column_count = GetVertexStreamColumnCount(vertex_declaration->m_Streams[i].m_Size);
+                for (uint32_t c = 0; c < column_count; ++c)
+                {
+                    GLuint location = vertex_declaration->m_Streams[i].m_Location + c;
+                    glDisableVertexAttribArray(location);
+                    CHECK_GL_ERROR;
+
+                    if (reset_divisor)
+                    {
+                        PFN_glVertexAttribDivisor(location, 0);
+                        CHECK_GL_ERROR;
+                    }
+                }
             }
         }
 
@@ -1716,6 +1772,20 @@ static void LogFrameBufferError(GLenum status)
         CHECK_GL_ERROR
     }
 
+    static void OpenGLDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
+    {
+        DM_PROFILE(__FUNCTION__);
+        DM_PROPERTY_ADD_U32(rmtp_DrawCalls, 1);
+        assert(context);
+        assert(index_buffer);
+        assert(((OpenGLContext*) context)->m_InstancingSupport);
+        glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+        CHECK_GL_ERROR;
+
+        PFN_glDrawElementsInstanced(GetOpenGLPrimitiveType(prim_type), count, GetOpenGLType(type), (GLvoid*)(uintptr_t) first, instance_count);
+        CHECK_GL_ERROR
+    }
+
     static void OpenGLDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
     {
         DM_PROFILE(__FUNCTION__);
@@ -351,6 +351,63 @@ TEST_F(dmGraphicsTest, VertexDeclaration)
     dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
 }
 
+TEST_F(dmGraphicsTest, WriteAttributeDataTypes)
+{
+    dmGraphics::VertexAttributeInfos infos;
+    infos.m_NumInfos = 3;
+
+    dmGraphics::VertexAttributeInfo& position = infos.m_Infos[0];
+    position.m_SemanticType    = dmGraphics::VertexAttribute::SEMANTIC_TYPE_POSITION;
+    position.m_DataType        = dmGraphics::VertexAttribute::TYPE_FLOAT;
+    position.m_CoordinateSpace = dmGraphics::COORDINATE_SPACE_WORLD;
+    position.m_ElementCount    = 3;
+    position.m_ValueByteSize   = 3 * sizeof(float);
+
+    dmGraphics::VertexAttributeInfo& texcoord = infos.m_Infos[1];
+    texcoord.m_SemanticType  = dmGraphics::VertexAttribute::SEMANTIC_TYPE_TEXCOORD;
+    texcoord.m_DataType      = dmGraphics::VertexAttribute::TYPE_UNSIGNED_SHORT;
+    texcoord.m_Normalize     = true;
+    texcoord.m_ElementCount  = 2;
+    texcoord.m_ValueByteSize = 2 * sizeof(uint16_t);
+
+    dmGraphics::VertexAttributeInfo& color = infos.m_Infos[2];
+    color.m_SemanticType  = dmGraphics::VertexAttribute::SEMANTIC_TYPE_COLOR;
+    color.m_DataType      = dmGraphics::VertexAttribute::TYPE_UNSIGNED_BYTE;
+    color.m_Normalize     = true;
+    color.m_ElementCount  = 4;
+    color.m_ValueByteSize = 4;
+
+    infos.m_VertexStride = position.m_ValueByteSize + texcoord.m_ValueByteSize + color.m_ValueByteSize;
+
+    float uv_data[] = { 0.0f, 1.0f, 0.5f, 2.0f };
+    float* uvs[] = { uv_data };
+    uint32_t page_indices[] = { 0 };
+    dmVMath::Vector4 world_position(1.0f, 2.0f, 3.0f, 1.0f);
+    dmVMath::Vector4 vertex_color(1.0f, 0.0f, 0.5f, -1.0f);
+
+    uint8_t vertex[3 * sizeof(float) + 2 * sizeof(uint16_t) + 4];
+    uint8_t* end = dmGraphics::WriteAttribute(&infos, vertex, 1, &world_position, dmVMath::Point3(0.0f, 0.0f, 0.0f), &vertex_color, uvs, page_indices, 1);
+    ASSERT_EQ(vertex + sizeof(vertex), end);
+
+    float p[3];
+    memcpy(p, vertex, sizeof(p));
+    ASSERT_EQ(1.0f, p[0]);
+    ASSERT_EQ(2.0f, p[1]);
+    ASSERT_EQ(3.0f, p[2]);
+
+    // The second vertex' uvs, normalized and clamped to [0,1]
+    uint16_t uv[2];
+    memcpy(uv, vertex + 3 * sizeof(float), sizeof(uv));
+    ASSERT_EQ(32768, uv[0]);
+    ASSERT_EQ(65535, uv[1]);
+
+    const uint8_t* c = vertex + 3 * sizeof(float) + sizeof(uv);
+    ASSERT_EQ(255, c[0]);
+    ASSERT_EQ(0,   c[1]);
+    ASSERT_EQ(128, c[2]);
+    ASSERT_EQ(0,   c[3]);
+}
+
 TEST_F(dmGraphicsTest, Drawing)
 {
     float v[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f };
@@ -386,6 +443,61 @@ TEST_F(dmGraphicsTest, Drawing)
     dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
 }
 
+TEST_F(dmGraphicsTest, DrawingInstanced)
+{
+    ASSERT_TRUE(dmGraphics::IsContextFeatureSupported(m_Context, dmGraphics::CONTEXT_FEATURE_INSTANCING));
+
+    float v[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+    float instance_data[] = { 10.0f, 11.0f, 20.0f, 21.0f, 30.0f, 31.0f };
+    uint16_t i[] = { 0, 1, 2 };
+
+    dmGraphics::HVertexStreamDeclaration stream_declaration = dmGraphics::NewVertexStreamDeclaration(m_Context);
+    dmGraphics::AddVertexStream(stream_declaration, "position", 3, dmGraphics::TYPE_FLOAT, false);
+    dmGraphics::HVertexDeclaration vd = dmGraphics::NewVertexDeclaration(m_Context, stream_declaration);
+
+    dmGraphics::HVertexStreamDeclaration instance_stream_declaration = dmGraphics::NewVertexStreamDeclaration(m_Context);
+    dmGraphics::AddVertexStream(instance_stream_declaration, "offset", 2, dmGraphics::TYPE_FLOAT, false);
+    dmGraphics::HVertexDeclaration instance_vd = dmGraphics::NewVertexDeclaration(m_Context, instance_stream_declaration);
+    dmGraphics::SetVertexDeclarationStepFunction(m_Context, instance_vd, dmGraphics::VERTEX_STEP_FUNCTION_INSTANCE);
+
+    dmGraphics::HVertexBuffer vb          = dmGraphics::NewVertexBuffer(m_Context, sizeof(v), v, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+    dmGraphics::HVertexBuffer instance_vb = dmGraphics::NewVertexBuffer(m_Context, sizeof(instance_data), instance_data, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+    dmGraphics::HIndexBuffer ib           = dmGraphics::NewIndexBuffer(m_Context, sizeof(i), i, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+
+    dmGraphics::EnableVertexBuffer(m_Context, vb, 0);
+    dmGraphics::EnableVertexBuffer(m_Context, instance_vb, 1);
+    dmGraphics::EnableVertexDeclaration(m_Context, vd, 0);
+    dmGraphics::EnableVertexDeclaration(m_Context, instance_vd, 1);
+
+    // The per-instance stream is placed after the per-vertex stream
+    ASSERT_EQ(dmGraphics::VERTEX_STEP_FUNCTION_VERTEX, m_NullContext->m_VertexStreams[0].m_StepFunction);
+    ASSERT_EQ(dmGraphics::VERTEX_STEP_FUNCTION_INSTANCE, m_NullContext->m_VertexStreams[1].m_StepFunction);
+
+    dmGraphics::ResetDrawCount();
+    dmGraphics::DrawElementsInstanced(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 3, 3, dmGraphics::TYPE_UNSIGNED_SHORT, ib);
+    ASSERT_EQ(1u, dmGraphics::GetDrawCount());
+    ASSERT_EQ(3u, dmGraphics::GetDrawInstanceCount());
+
+    // The instance stream advances once per instance rather than once per index
+    ASSERT_EQ(0, memcmp(instance_data, m_NullContext->m_VertexStreams[1].m_Buffer, sizeof(instance_data)));
+
+    dmGraphics::DisableVertexDeclaration(m_Context, instance_vd);
+    dmGraphics::DisableVertexDeclaration(m_Context, vd);
+    ASSERT_EQ(0u, m_NullContext->m_VertexStreams[0].m_Size);
+    ASSERT_EQ(0u, m_NullContext->m_VertexStreams[1].m_Size);
+
+    dmGraphics::DisableVertexBuffer(m_Context, instance_vb);
+    dmGraphics::DisableVertexBuffer(m_Context, vb);
+
+    dmGraphics::DeleteIndexBuffer(ib);
+    dmGraphics::DeleteVertexBuffer(instance_vb);
+    dmGraphics::DeleteVertexBuffer(vb);
+    dmGraphics::DeleteVertexDeclaration(instance_vd);
+    dmGraphics::DeleteVertexDeclaration(vd);
+    dmGraphics::DeleteVertexStreamDeclaration(instance_stream_declaration);
+    dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
+}
+
 static inline dmGraphics::ShaderDesc::Shader MakeDDFShader(dmGraphics::ShaderDesc::Language language, const char* data, uint32_t count)
 {
     dmGraphics::ShaderDesc::Shader ddf;
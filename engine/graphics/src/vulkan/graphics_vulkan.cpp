@@ -4547,6 +4547,11 @@ bail:
         vkCmdDraw(vk_command_buffer, count, instance_count, first, base_instance);
     }
 
+    static void VulkanDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
+    {
+        VulkanDrawElementsInstanced(context, prim_type, first, count, instance_count, 0, type, index_buffer);
+    }
+
     void VulkanSetVertexDeclarationStepFunction(HContext, HVertexDeclaration vertex_declaration, VertexStepFunction step_function)
     {
         vertex_declaration->m_StepFunction = step_function;
@@ -218,6 +218,7 @@ namespace dmGui
         scene->m_Width = width;
         scene->m_Height = height;
         scene->m_ResChanged = 1;
+        SetNodesChanged(scene);
     }
 
     void GetPhysicalResolution(HScene scene, uint32_t& width, uint32_t& height)
@@ -242,6 +243,7 @@ namespace dmGui
         {
             Scene* scene = scenes[i];
             scene->m_ResChanged = 1;
+            SetNodesChanged(scene);
             if(scene->m_OnWindowResizeCallback)
             {
                 scene->m_OnWindowResizeCallback(scene, width, height);
@@ -279,6 +281,7 @@ namespace dmGui
     void SetSceneAdjustReference(HScene scene, AdjustReference adjust_reference)
     {
         scene->m_AdjustReference = adjust_reference;
+        SetNodesChanged(scene);
     }
 
     void SetDefaultNewSceneParams(NewSceneParams* params)
@@ -352,6 +355,8 @@ namespace dmGui
         scene->m_RenderHead = INVALID_INDEX;
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NextVersionNumber = 0;
+        scene->m_WorldTransformVersion = 0;
+        scene->m_NodesChanged = 0;
         scene->m_RenderOrder = 0;
         scene->m_Width = context->m_DefaultProjectWidth;
         scene->m_Height = context->m_DefaultProjectHeight;
@@ -423,6 +428,7 @@ namespace dmGui
             }
         }
 
+        delete scene->m_PickGrid;
         scene->~Scene();
 
         ResetScene(scene);
@@ -454,6 +460,7 @@ namespace dmGui
                 nodes[i].m_Node.m_TextureType = texture_type;
             }
         }
+        SetNodesChanged(scene);
         return RESULT_OK;
     }
 
@@ -838,6 +845,7 @@ namespace dmGui
             if (nodes[i].m_Node.m_LayerHash == layer_hash)
                 nodes[i].m_Node.m_LayerIndex = index;
         }
+        SetNodesChanged(scene);
         return RESULT_OK;
     }
 
@@ -937,6 +945,7 @@ namespace dmGui
             set_node_callback(scene, GetNodeHandle(n), n->m_Node.m_NodeDescTable[index]);
             n->m_Node.m_DirtyLocal = 1;
         }
+        SetNodesChanged(scene);
         return RESULT_OK;
     }
 
@@ -1638,12 +1647,77 @@ namespace dmGui
         }
     }
 
+    // Advances the animations in [begin, end) of the gathered animations, and evaluates their new values.
+    // Only the animations in the range and their slots in the output arrays are written, so separate
+    // ranges can be evaluated in parallel. The values are applied in UpdateAnimations().
+    static void EvaluateAnimations(Animation* animations, const uint32_t* indices, float* values, uint8_t* completed, uint32_t begin, uint32_t end, float dt)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Animation* anim = &animations[indices[i]];
+            dmGui::Playback playback = anim->m_Playback;
+            bool looping = playback == PLAYBACK_LOOP_FORWARD || playback == PLAYBACK_LOOP_BACKWARD || playback == PLAYBACK_LOOP_PINGPONG;
+
+            // NOTE: We add dt to elapsed before we calculate t.
+            // Example: 60 updates with dt=1/60.0 should result in a complete animation
+            anim->m_Elapsed += dt*anim->m_PlaybackRate;
+
+            // Clamp elapsed to duration if we are closer than half a time step
+            anim->m_Elapsed = dmMath::Select(anim->m_Elapsed + dt * anim->m_PlaybackRate * 0.5f - anim->m_Duration, anim->m_Duration, anim->m_Elapsed);
+            // Calculate normalized time if elapsed has not yet reached duration, otherwise it's set to 1 (animation complete)
+            float t = 1.0f;
+            if (anim->m_Duration != 0)
+            {
+                t = dmMath::Select(anim->m_Duration - anim->m_Elapsed, anim->m_Elapsed / anim->m_Duration, 1.0f);
+            }
+            float t2 = t;
+            if (playback == PLAYBACK_ONCE_BACKWARD || playback == PLAYBACK_LOOP_BACKWARD || anim->m_Backwards) {
+                t2 = 1.0f - t;
+            }
+            if (playback == PLAYBACK_ONCE_PINGPONG || playback == PLAYBACK_LOOP_PINGPONG) {
+                t2 *= 2.0f;
+                if (t2 > 1.0f) {
+                    t2 = 2.0f - t2;
+                }
+            }
+
+            float x = dmEasing::GetValue(anim->m_Easing, t2);
+            values[i] = anim->m_From + (anim->m_To - anim->m_From) * x;
+            completed[i] = 0;
+
+            // Animation complete, see above
+            if (t >= 1.0f)
+            {
+                if (looping) {
+                    anim->m_Elapsed = anim->m_Elapsed - anim->m_Duration;
+                    if (playback == PLAYBACK_LOOP_PINGPONG) {
+                        anim->m_Backwards ^= 1;
+                    }
+                } else {
+                    completed[i] = 1;
+                }
+            }
+        }
+    }
+
     void UpdateAnimations(HScene scene, float dt)
     {
         dmArray<Animation>* animations = &scene->m_Animations;
+        Context* context = scene->m_Context;
 
         uint32_t active_animations = 0;
 
+        // Gather the animations to evaluate this frame
+        dmArray<uint32_t>& indices = context->m_AnimationIndices;
+        indices.SetSize(0);
+        if (indices.Capacity() < animations->Size())
+        {
+            indices.SetCapacity(animations->Size());
+            context->m_AnimationTargets.SetCapacity(animations->Size());
+            context->m_AnimationValues.SetCapacity(animations->Size());
+            context->m_AnimationCompleted.SetCapacity(animations->Size());
+        }
+
         for (uint32_t i = 0; i < animations->Size(); ++i)
         {
             Animation* anim = &(*animations)[i];
@@ -1673,52 +1747,53 @@ namespace dmGui
                     anim->m_Elapsed = -anim->m_Delay;
                     anim->m_Delay = 0;
                 }
+                indices.Push(i);
+            }
+            else
+            {
+                anim->m_Delay -= dt;
+            }
+        }
 
-                // NOTE: We add dt to elapsed before we calculate t.
-                // Example: 60 updates with dt=1/60.0 should result in a complete animation
-                anim->m_Elapsed += dt*anim->m_PlaybackRate;
+        uint32_t count = indices.Size();
+        dmArray<float*>& targets = context->m_AnimationTargets;
+        dmArray<float>& values = context->m_AnimationValues;
+        dmArray<uint8_t>& completed = context->m_AnimationCompleted;
+        targets.SetSize(count);
+        values.SetSize(count);
+        completed.SetSize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            targets[i] = (*animations)[indices[i]].m_Value;
+        }
 
-                // Clamp elapsed to duration if we are closer than half a time step
-                anim->m_Elapsed = dmMath::Select(anim->m_Elapsed + dt * anim->m_PlaybackRate * 0.5f - anim->m_Duration, anim->m_Duration, anim->m_Elapsed);
-                // Calculate normalized time if elapsed has not yet reached duration, otherwise it's set to 1 (animation complete)
-                float t = 1.0f;
-                if (anim->m_Duration != 0)
-                {
-                    t = dmMath::Select(anim->m_Duration - anim->m_Elapsed, anim->m_Elapsed / anim->m_Duration, 1.0f);
-                }
-                float t2 = t;
-                if (playback == PLAYBACK_ONCE_BACKWARD || playback == PLAYBACK_LOOP_BACKWARD || anim->m_Backwards) {
-                    t2 = 1.0f - t;
-                }
-                if (playback == PLAYBACK_ONCE_PINGPONG || playback == PLAYBACK_LOOP_PINGPONG) {
-                    t2 *= 2.0f;
-                    if (t2 > 1.0f) {
-                        t2 = 2.0f - t2;
-                    }
-                }
+        EvaluateAnimations(animations->Begin(), indices.Begin(), values.Begin(), completed.Begin(), 0, count, dt);
 
-                float x = dmEasing::GetValue(anim->m_Easing, t2);
+        // Apply the values and invoke the completion callbacks, in animation order.
+        // The callbacks may cancel, restart or add animations, which can move the animations in the array.
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t index = indices[i];
+            if (index >= animations->Size() || (*animations)[index].m_Value != targets[i])
+            {
+                index = FindAnimation(*animations, targets[i]);
+                if (index == 0xffffffff)
+                    continue;
+            }
 
-                *anim->m_Value = anim->m_From + (anim->m_To - anim->m_From) * x;
-                // Flag local transform as dirty for the node
-                scene->m_Nodes[anim->m_Node & 0xffff].m_Node.m_DirtyLocal = 1;
+            Animation* anim = &(*animations)[index];
+            // Skip animations cancelled, or restarted on the same property, by a callback this frame
+            if (anim->m_Cancelled || anim->m_FirstUpdate)
+                continue;
 
-                // Animation complete, see above
-                if (t >= 1.0f)
-                {
-                    if (looping) {
-                        anim->m_Elapsed = anim->m_Elapsed - anim->m_Duration;
-                        if (playback == PLAYBACK_LOOP_PINGPONG) {
-                            anim->m_Backwards ^= 1;
-                        }
-                    } else {
-                        CompleteAnimation(scene, anim, true);
-                    }
-                }
-            }
-            else
+            *anim->m_Value = values[i];
+            // Flag local transform as dirty for the node
+            scene->m_Nodes[anim->m_Node & 0xffff].m_Node.m_DirtyLocal = 1;
+            SetNodesChanged(scene);
+
+            if (completed[i])
             {
-                anim->m_Delay -= dt;
+                CompleteAnimation(scene, anim, true);
             }
         }
 
@@ -2443,6 +2518,8 @@ namespace dmGui
         node->m_ChildHead = INVALID_INDEX;
         node->m_ChildTail = INVALID_INDEX;
         node->m_SceneTraversalCacheVersion = INVALID_INDEX;
+        node->m_WorldTransformVersion = 0;
+        node->m_ParentWorldTransformVersion = 0;
         node->m_ClipperIndex = INVALID_INDEX;
         scene->m_NextVersionNumber = (version + 1) % ((1 << 16) - 1);
 
@@ -2533,6 +2610,7 @@ namespace dmGui
 
     static void AddToNodeList(HScene scene, InternalNode* n, InternalNode* parent_n, InternalNode* prev_n)
     {
+        SetNodesChanged(scene);
         uint16_t* head = &scene->m_RenderHead, * tail = &scene->m_RenderTail;
         uint16_t parent_index = INVALID_INDEX;
         if (parent_n != 0x0)
@@ -2577,6 +2655,7 @@ namespace dmGui
 
     static void RemoveFromNodeList(HScene scene, InternalNode* n)
     {
+        SetNodesChanged(scene);
         // Remove from list
         if (n->m_PrevIndex != INVALID_INDEX)
             scene->m_Nodes[n->m_PrevIndex].m_NextIndex = n->m_NextIndex;
@@ -2696,6 +2775,7 @@ namespace dmGui
         scene->m_RenderHead = INVALID_INDEX;
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NodePool.Clear();
+        SetNodesChanged(scene);
         scene->m_Animations.SetSize(0);
     }
 
@@ -2847,6 +2927,7 @@ namespace dmGui
                 n->m_State = n->m_ResetPointState;
             }
         }
+        SetNodesChanged(scene);
         scene->m_Animations.SetSize(0);
     }
 
@@ -2904,6 +2985,7 @@ namespace dmGui
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Properties[PROPERTY_POSITION] = Vector4(position);
         n->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(scene);
     }
 
     bool HasPropertyHash(HScene scene, HNode node, dmhash_t property)
@@ -2955,6 +3037,7 @@ namespace dmGui
 
         n->m_Node.m_Properties[property] = value;
         n->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(scene);
     }
 
     void SetNodeResetPoint(HScene scene, HNode node)
@@ -3077,6 +3160,7 @@ namespace dmGui
     Result SetNodeTexture(HScene scene, HNode node, dmhash_t texture_id)
     {
         InternalNode* n = GetNode(scene, node);
+        SetNodesChanged(scene);
         if (n->m_Node.m_TextureType == NODE_TEXTURE_TYPE_TEXTURE_SET)
             CancelNodeFlipbookAnim(scene, node);
         if (TextureInfo* texture_info = scene->m_Textures.Get(texture_id)) {
@@ -3243,6 +3327,7 @@ namespace dmGui
             InternalNode* n = GetNode(scene, node);
             n->m_Node.m_LayerHash = layer_id;
             n->m_Node.m_LayerIndex = *layer_index;
+            SetNodesChanged(scene);
             return RESULT_OK;
         }
         else
@@ -3486,6 +3571,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_XAnchor = (uint32_t) x_anchor;
+        SetNodesChanged(scene);
     }
 
     YAnchor GetNodeYAnchor(HScene scene, HNode node)
@@ -3498,6 +3584,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_YAnchor = (uint32_t) y_anchor;
+        SetNodesChanged(scene);
     }
 
 
@@ -3559,6 +3646,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Pivot = (uint32_t) pivot;
+        SetNodesChanged(scene);
     }
 
     bool GetNodeIsBone(HScene scene, HNode node)
@@ -3577,12 +3665,14 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_AdjustMode = (uint32_t) adjust_mode;
+        SetNodesChanged(scene);
     }
 
     void SetNodeSizeMode(HScene scene, HNode node, SizeMode size_mode)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_SizeMode = (uint32_t) size_mode;
+        SetNodesChanged(scene);
         if((n->m_Node.m_SizeMode != SIZE_MODE_MANUAL) && (n->m_Node.m_NodeType != NODE_TYPE_CUSTOM) && (n->m_Node.m_NodeType != NODE_TYPE_PARTICLEFX))
         {
             if (TextureInfo* texture_info = scene->m_Textures.Get(n->m_Node.m_TextureHash))
@@ -3939,6 +4029,7 @@ namespace dmGui
             AnimateTextureSetAnim(scene, node, offset, playback_rate, anim_complete_callback, callback_userdata1, callback_userdata2);
         }
         CalculateNodeSize(n);
+        SetNodesChanged(scene);
         return RESULT_OK;
     }
 
@@ -3968,17 +4059,25 @@ namespace dmGui
         flip_vertical = n->m_Node.m_TextureSetAnimDesc.m_FlipVertical;
     }
 
-    bool PickNode(HScene scene, HNode node, float x, float y)
+    // Maps from the predefined screen space used by the pick functions, to the physical screen space of the node transforms
+    static inline Vector4 GetPickScale(HScene scene)
     {
-        Vector4 scale((float) scene->m_Context->m_PhysicalWidth / (float) scene->m_Context->m_DefaultProjectWidth,
+        return Vector4((float) scene->m_Context->m_PhysicalWidth / (float) scene->m_Context->m_DefaultProjectWidth,
                 (float) scene->m_Context->m_PhysicalHeight / (float) scene->m_Context->m_DefaultProjectHeight, 1, 1);
-        Matrix4 transform;
-        InternalNode* n = GetNode(scene, node);
-        CalculateNodeTransform(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_BOUNDARY | CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform);
+    }
+
+    static Matrix4 CalculatePickTransform(const Matrix4& boundary_transform)
+    {
+        Matrix4 transform = boundary_transform;
         // DEF-3066 set Z scale to 1.0 to get a sound inverse node transform for picking
         transform.setElem(2, 2, 1.0f);
-        transform = inverse(transform);
-        Vector4 screen_pos(x * scale.getX(), y * scale.getY(), 0.0f, 1.0f);
+        return inverse(transform);
+    }
+
+    // Tests a point in physical screen space against the inverse of a node boundary transform
+    static bool PickInverseTransform(const Matrix4& transform, float x, float y)
+    {
+        Vector4 screen_pos(x, y, 0.0f, 1.0f);
         Vector4 node_pos = transform * screen_pos;
         const float EPSILON = 0.0001f;
         // check if we need to project the local position to the node plane
@@ -3998,6 +4097,288 @@ namespace dmGui
                 && node_pos.getY() <= 1.0f;
     }
 
+    bool PickNode(HScene scene, HNode node, float x, float y)
+    {
+        Vector4 scale = GetPickScale(scene);
+        Matrix4 transform;
+        InternalNode* n = GetNode(scene, node);
+        CalculateNodeTransform(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_BOUNDARY | CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform);
+        return PickInverseTransform(CalculatePickTransform(transform), x * scale.getX(), y * scale.getY());
+    }
+
+    // Slack (in physical pixels) added to the node bounds when assigning cells and rejecting points,
+    // since the exact test in PickInverseTransform() uses the inverse transform
+    static const float PICK_BOUNDS_EPSILON = 0.5f;
+
+    static inline uint32_t GetPickGridCell(float v, float size)
+    {
+        float cell = v * PICK_GRID_SIZE / size;
+        if (!(cell > 0.0f)) // Also catches NaN
+            return 0;
+        if (cell >= (float) (PICK_GRID_SIZE - 1))
+            return PICK_GRID_SIZE - 1;
+        return (uint32_t) cell;
+    }
+
+    static void RemovePickGridCells(PickGrid* grid, uint16_t index)
+    {
+        const PickGridNode& pick_node = grid->m_Nodes[index];
+        for (uint32_t y = pick_node.m_Cells[1]; y <= pick_node.m_Cells[3]; ++y)
+        {
+            for (uint32_t x = pick_node.m_Cells[0]; x <= pick_node.m_Cells[2]; ++x)
+            {
+                dmArray<uint16_t>& cell = grid->m_Cells[y * PICK_GRID_SIZE + x];
+                for (uint32_t i = 0; i < cell.Size(); ++i)
+                {
+                    if (cell[i] == index)
+                    {
+                        cell.EraseSwap(i);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    static void AddPickGridCells(PickGrid* grid, uint16_t index)
+    {
+        PickGridNode& pick_node = grid->m_Nodes[index];
+        pick_node.m_Cells[0] = (uint8_t) GetPickGridCell(pick_node.m_Bounds[0] - PICK_BOUNDS_EPSILON, grid->m_Width);
+        pick_node.m_Cells[1] = (uint8_t) GetPickGridCell(pick_node.m_Bounds[1] - PICK_BOUNDS_EPSILON, grid->m_Height);
+        pick_node.m_Cells[2] = (uint8_t) GetPickGridCell(pick_node.m_Bounds[2] + PICK_BOUNDS_EPSILON, grid->m_Width);
+        pick_node.m_Cells[3] = (uint8_t) GetPickGridCell(pick_node.m_Bounds[3] + PICK_BOUNDS_EPSILON, grid->m_Height);
+        for (uint32_t y = pick_node.m_Cells[1]; y <= pick_node.m_Cells[3]; ++y)
+        {
+            for (uint32_t x = pick_node.m_Cells[0]; x <= pick_node.m_Cells[2]; ++x)
+            {
+                dmArray<uint16_t>& cell = grid->m_Cells[y * PICK_GRID_SIZE + x];
+                if (cell.Full())
+                    cell.OffsetCapacity(16);
+                cell.Push(index);
+            }
+        }
+    }
+
+    // Visits the enabled nodes in render order, updating the world transforms and moving the nodes
+    // whose boundary changed to their new cells
+    static uint16_t UpdatePickGridNodes(HScene scene, PickGrid* grid, InternalNode* parent, uint16_t start_index, uint16_t order)
+    {
+        uint16_t index = start_index;
+        while (index != INVALID_INDEX)
+        {
+            InternalNode* n = &scene->m_Nodes[index];
+            const Node& node = n->m_Node;
+            if (node.m_Enabled)
+            {
+                UpdateWorldTransform(scene, n, parent);
+
+                PickGridNode& pick_node = grid->m_Nodes[index];
+                pick_node.m_Stamp = grid->m_Stamp;
+                pick_node.m_RenderKey = CalcRenderKey(GetLayerIndex(scene, n), order++);
+
+                const Vector4& size = node.m_Properties[PROPERTY_SIZE];
+                if (pick_node.m_Version != n->m_WorldTransformVersion || pick_node.m_Pivot != node.m_Pivot ||
+                    pick_node.m_Size[0] != size.getX() || pick_node.m_Size[1] != size.getY())
+                {
+                    if (pick_node.m_Version != 0)
+                    {
+                        RemovePickGridCells(grid, index);
+                    }
+                    else
+                    {
+                        if (grid->m_Inserted.Full())
+                            grid->m_Inserted.OffsetCapacity(64);
+                        grid->m_Inserted.Push(index);
+                    }
+
+                    Matrix4 transform = node.m_LocalTransform;
+                    CalculateNodeExtents(node, CalculateNodeTransformFlags(CALCULATE_NODE_BOUNDARY | CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform);
+                    if (parent)
+                    {
+                        transform = parent->m_Node.m_WorldTransform * transform;
+                    }
+
+                    // The node can be picked where its boundary projects onto the screen plane
+                    Vector4 corners[4] = { transform * Point3(0, 0, 0), transform * Point3(1, 0, 0), transform * Point3(0, 1, 0), transform * Point3(1, 1, 0) };
+                    pick_node.m_Bounds[0] = pick_node.m_Bounds[2] = corners[0].getX();
+                    pick_node.m_Bounds[1] = pick_node.m_Bounds[3] = corners[0].getY();
+                    for (uint32_t i = 1; i < 4; ++i)
+                    {
+                        pick_node.m_Bounds[0] = dmMath::Min(pick_node.m_Bounds[0], (float) corners[i].getX());
+                        pick_node.m_Bounds[1] = dmMath::Min(pick_node.m_Bounds[1], (float) corners[i].getY());
+                        pick_node.m_Bounds[2] = dmMath::Max(pick_node.m_Bounds[2], (float) corners[i].getX());
+                        pick_node.m_Bounds[3] = dmMath::Max(pick_node.m_Bounds[3], (float) corners[i].getY());
+                    }
+
+                    pick_node.m_InverseTransform = CalculatePickTransform(transform);
+                    pick_node.m_Size[0] = size.getX();
+                    pick_node.m_Size[1] = size.getY();
+                    pick_node.m_Pivot = node.m_Pivot;
+                    pick_node.m_Version = n->m_WorldTransformVersion;
+                    AddPickGridCells(grid, index);
+                }
+
+                order = UpdatePickGridNodes(scene, grid, n, n->m_ChildHead, order);
+            }
+            index = n->m_NextIndex;
+        }
+        return order;
+    }
+
+    static PickGrid* UpdatePickGrid(HScene scene)
+    {
+        DM_PROFILE("UpdatePickGrid");
+
+        PickGrid* grid = scene->m_PickGrid;
+        if (!grid)
+        {
+            grid = new PickGrid;
+            grid->m_Nodes.SetCapacity(scene->m_Nodes.Capacity());
+            grid->m_Nodes.SetSize(scene->m_Nodes.Capacity());
+            memset(grid->m_Nodes.Begin(), 0, grid->m_Nodes.Size() * sizeof(PickGridNode));
+            grid->m_Width = 0.0f;
+            grid->m_Height = 0.0f;
+            grid->m_Stamp = 0;
+            grid->m_NodesChanged = scene->m_NodesChanged - 1;
+            scene->m_PickGrid = grid;
+        }
+
+        // A new screen size moves all cells
+        float width = (float) scene->m_Context->m_PhysicalWidth;
+        float height = (float) scene->m_Context->m_PhysicalHeight;
+        if (width != grid->m_Width || height != grid->m_Height)
+        {
+            for (uint32_t i = 0; i < PICK_GRID_SIZE * PICK_GRID_SIZE; ++i)
+            {
+                grid->m_Cells[i].SetSize(0);
+            }
+            for (uint32_t i = 0; i < grid->m_Inserted.Size(); ++i)
+            {
+                grid->m_Nodes[grid->m_Inserted[i]].m_Version = 0;
+            }
+            grid->m_Inserted.SetSize(0);
+            grid->m_Width = dmMath::Max(width, 1.0f);
+            grid->m_Height = dmMath::Max(height, 1.0f);
+            grid->m_NodesChanged = scene->m_NodesChanged - 1;
+        }
+
+        // Nothing moved since the last query, the cells and render keys are up to date
+        if (grid->m_NodesChanged == scene->m_NodesChanged)
+        {
+            return grid;
+        }
+        grid->m_NodesChanged = scene->m_NodesChanged;
+
+        ++grid->m_Stamp;
+        UpdatePickGridNodes(scene, grid, 0, scene->m_RenderHead, 0);
+
+        // Remove the nodes that were deleted or disabled since the last update
+        for (uint32_t i = 0; i < grid->m_Inserted.Size();)
+        {
+            uint16_t index = grid->m_Inserted[i];
+            PickGridNode& pick_node = grid->m_Nodes[index];
+            if (pick_node.m_Stamp != grid->m_Stamp)
+            {
+                RemovePickGridCells(grid, index);
+                pick_node.m_Version = 0;
+                grid->m_Inserted.EraseSwap(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        return grid;
+    }
+
+    struct PickRenderOrderPred
+    {
+        PickRenderOrderPred(const PickGrid* grid) : m_Grid(grid) {}
+        bool operator ()(HNode a, HNode b) const
+        {
+            return m_Grid->m_Nodes[a & 0xffff].m_RenderKey < m_Grid->m_Nodes[b & 0xffff].m_RenderKey;
+        }
+        const PickGrid* m_Grid;
+    };
+
+    static inline void PushPickResult(dmArray<HNode>& nodes, HNode node)
+    {
+        if (nodes.Full())
+            nodes.OffsetCapacity(16);
+        nodes.Push(node);
+    }
+
+    void PickNodes(HScene scene, float x, float y, dmArray<HNode>& nodes)
+    {
+        nodes.SetSize(0);
+        PickGrid* grid = UpdatePickGrid(scene);
+
+        Vector4 scale = GetPickScale(scene);
+        x *= scale.getX();
+        y *= scale.getY();
+
+        const dmArray<uint16_t>& cell = grid->m_Cells[GetPickGridCell(y, grid->m_Height) * PICK_GRID_SIZE + GetPickGridCell(x, grid->m_Width)];
+        for (uint32_t i = 0; i < cell.Size(); ++i)
+        {
+            uint16_t index = cell[i];
+            const PickGridNode& pick_node = grid->m_Nodes[index];
+            if (x < pick_node.m_Bounds[0] - PICK_BOUNDS_EPSILON || x > pick_node.m_Bounds[2] + PICK_BOUNDS_EPSILON ||
+                y < pick_node.m_Bounds[1] - PICK_BOUNDS_EPSILON || y > pick_node.m_Bounds[3] + PICK_BOUNDS_EPSILON)
+                continue;
+
+            InternalNode* n = &scene->m_Nodes[index];
+            if (n->m_Node.m_IsBone || !PickInverseTransform(pick_node.m_InverseTransform, x, y))
+                continue;
+
+            PushPickResult(nodes, GetNodeHandle(n));
+        }
+
+        std::sort(nodes.Begin(), nodes.End(), PickRenderOrderPred(grid));
+    }
+
+    void QueryRect(HScene scene, float x0, float y0, float x1, float y1, dmArray<HNode>& nodes)
+    {
+        nodes.SetSize(0);
+        PickGrid* grid = UpdatePickGrid(scene);
+
+        Vector4 scale = GetPickScale(scene);
+        float min_x = dmMath::Min(x0, x1) * scale.getX();
+        float min_y = dmMath::Min(y0, y1) * scale.getY();
+        float max_x = dmMath::Max(x0, x1) * scale.getX();
+        float max_y = dmMath::Max(y0, y1) * scale.getY();
+
+        uint32_t cell_min_x = GetPickGridCell(min_x, grid->m_Width);
+        uint32_t cell_min_y = GetPickGridCell(min_y, grid->m_Height);
+        uint32_t cell_max_x = GetPickGridCell(max_x, grid->m_Width);
+        uint32_t cell_max_y = GetPickGridCell(max_y, grid->m_Height);
+        for (uint32_t cy = cell_min_y; cy <= cell_max_y; ++cy)
+        {
+            for (uint32_t cx = cell_min_x; cx <= cell_max_x; ++cx)
+            {
+                const dmArray<uint16_t>& cell = grid->m_Cells[cy * PICK_GRID_SIZE + cx];
+                for (uint32_t i = 0; i < cell.Size(); ++i)
+                {
+                    uint16_t index = cell[i];
+                    const PickGridNode& pick_node = grid->m_Nodes[index];
+                    // Only report the node in the first cell shared by the node and the rectangle
+                    if (cx != dmMath::Max(cell_min_x, (uint32_t) pick_node.m_Cells[0]) || cy != dmMath::Max(cell_min_y, (uint32_t) pick_node.m_Cells[1]))
+                        continue;
+                    if (max_x < pick_node.m_Bounds[0] || min_x > pick_node.m_Bounds[2] ||
+                        max_y < pick_node.m_Bounds[1] || min_y > pick_node.m_Bounds[3])
+                        continue;
+
+                    InternalNode* n = &scene->m_Nodes[index];
+                    if (n->m_Node.m_IsBone)
+                        continue;
+
+                    PushPickResult(nodes, GetNodeHandle(n));
+                }
+            }
+        }
+
+        std::sort(nodes.Begin(), nodes.End(), PickRenderOrderPred(grid));
+    }
+
     bool IsNodeEnabled(HScene scene, HNode node, bool recursive)
     {
         InternalNode* n = GetNode(scene, node);
@@ -4012,6 +4393,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(scene);
         uint16_t index = n->m_ChildHead;
         while (index != INVALID_INDEX)
         {
@@ -4029,6 +4411,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Enabled = enabled;
+        SetNodesChanged(scene);
         if(enabled)
         {
             SetDirtyLocalRecursive(scene, node);
@@ -4185,6 +4568,7 @@ namespace dmGui
         Vector3 local_position = ScreenToLocalPosition(scene, node, parent_node, screen_position);
         node->m_Node.m_Properties[dmGui::PROPERTY_POSITION] = Vector4(local_position, 1.0f);
         node->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(scene);
     }
 
     void SetScreenPosition(HScene scene, HNode node, const Point3& screen_position)
@@ -4308,48 +4692,29 @@ namespace dmGui
         return RESULT_OK;
     }
 
-    inline void CalculateParentNodeTransform(HScene scene, InternalNode* n, Matrix4& out_transform)
+    // Brings the cached world transforms of the node and its ancestors up to date
+    static void UpdateWorldTransformRecursive(HScene scene, InternalNode* n)
     {
-        Matrix4 parent_trans;
+        InternalNode* parent = 0;
         if (n->m_ParentIndex != INVALID_INDEX)
         {
-            InternalNode* parent = &scene->m_Nodes[n->m_ParentIndex];
-            CalculateParentNodeTransform(scene, parent, parent_trans);
-        }
-
-        const Node& node = n->m_Node;
-        if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
-        {
-            UpdateLocalTransform(scene, n);
-        }
-        out_transform = node.m_LocalTransform;
-
-        if (n->m_ParentIndex != INVALID_INDEX)
-        {
-            out_transform = parent_trans * out_transform;
+            parent = &scene->m_Nodes[n->m_ParentIndex];
+            UpdateWorldTransformRecursive(scene, parent);
         }
+        UpdateWorldTransform(scene, n, parent);
     }
 
     void CalculateNodeTransform(HScene scene, InternalNode* n, const CalculateNodeTransformFlags flags, Matrix4& out_transform)
     {
-        Matrix4 parent_trans;
-        if (n->m_ParentIndex != INVALID_INDEX)
-        {
-            InternalNode* parent = &scene->m_Nodes[n->m_ParentIndex];
-            CalculateParentNodeTransform(scene, parent, parent_trans);
-        }
+        UpdateWorldTransformRecursive(scene, n);
 
         const Node& node = n->m_Node;
-        if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
-        {
-            UpdateLocalTransform(scene, n);
-        }
         out_transform = node.m_LocalTransform;
         CalculateNodeExtents(node, flags, out_transform);
 
         if (n->m_ParentIndex != INVALID_INDEX)
         {
-            out_transform = parent_trans * out_transform;
+            out_transform = scene->m_Nodes[n->m_ParentIndex].m_Node.m_WorldTransform * out_transform;
         }
     }
 
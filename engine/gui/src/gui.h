@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include <dlib/message.h>
 #include <ddf/ddf.h>
+#include <dlib/array.h>
 #include <dlib/hash.h>
 #include <dlib/message.h>
 #include <dlib/easing.h>
@@ -1053,6 +1054,30 @@ namespace dmGui
      */
     bool PickNode(HScene scene, HNode node, float x, float y);
 
+    /** gets the nodes under a point
+     * Collects the enabled nodes that are picked by the supplied screen-space coordinates, as by PickNode().
+     * The nodes are looked up in a grid over the screen-space node bounds, which is updated for the nodes
+     * that have changed since the last query.
+     *
+     * @param scene the scene to pick nodes in
+     * @param x x-coordinate in predefined screen-space
+     * @param y y-coordinate in predefined screen-space
+     * @param nodes [out] the picked nodes, in render order
+     */
+    void PickNodes(HScene scene, float x, float y, dmArray<HNode>& nodes);
+
+    /** gets the nodes overlapping a rectangle
+     * Collects the enabled nodes whose screen-space bounds overlap the rectangle spanned by two corners.
+     *
+     * @param scene the scene to query
+     * @param x0 x-coordinate of the first corner in predefined screen-space
+     * @param y0 y-coordinate of the first corner in predefined screen-space
+     * @param x1 x-coordinate of the opposite corner in predefined screen-space
+     * @param y1 y-coordinate of the opposite corner in predefined screen-space
+     * @param nodes [out] the overlapping nodes, in render order
+     */
+    void QueryRect(HScene scene, float x0, float y0, float x1, float y1, dmArray<HNode>& nodes);
+
     /** retrieves if a node is enabled or not
      * Only enabled nodes are animated and rendered.
      *
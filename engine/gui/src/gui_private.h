@@ -60,7 +60,6 @@ namespace dmGui
         SceneTraversalCache() : m_NodeIndex(0), m_Version(0) {}
         struct Data
         {
-            dmVMath::Matrix4 m_Transform;
             float     	     m_Opacity;
         };
         dmArray<Data>   m_Data;
@@ -98,6 +97,11 @@ namespace dmGui
         dmArray<StencilScope*>          m_StencilScopes;
         dmArray<uint16_t>               m_StencilScopeIndices;
         dmArray<HNode>                  m_ScratchBoneNodes;
+        dmArray<HNode>                  m_QueryNodes;           // Results of gui.pick_nodes() and gui.query_rect()
+        dmArray<uint32_t>               m_AnimationIndices;     // UpdateAnimations() scratch data, per evaluated animation
+        dmArray<float*>                 m_AnimationTargets;
+        dmArray<float>                  m_AnimationValues;
+        dmArray<uint8_t>                m_AnimationCompleted;
         dmHID::HContext                 m_HidContext;
         void*                           m_DisplayProfiles;
         SceneTraversalCache             m_SceneTraversalCache;
@@ -108,6 +112,7 @@ namespace dmGui
         dmVMath::Vector4    m_Properties[PROPERTY_COUNT];
         dmVMath::Vector4    m_ResetPointProperties[PROPERTY_COUNT];
         dmVMath::Matrix4    m_LocalTransform;
+        dmVMath::Matrix4    m_WorldTransform; // Excluding size and pivot. Valid when up to date, see UpdateWorldTransform()
         dmVMath::Vector4    m_LocalAdjustScale;
         uint32_t            m_ResetPointState;
 
@@ -184,11 +189,44 @@ namespace dmGui
         uint16_t        m_ChildTail;
         uint16_t        m_SceneTraversalCacheIndex;
         uint16_t        m_SceneTraversalCacheVersion;
+        uint32_t        m_WorldTransformVersion;        // 0 if m_WorldTransform hasn't been calculated
+        uint32_t        m_ParentWorldTransformVersion;  // The parent's m_WorldTransformVersion when m_WorldTransform was calculated
         uint16_t        m_ClipperIndex;
         uint16_t        m_Deleted : 1; // Set to true for deferred deletion
         uint16_t        m_Padding : 15;
     };
 
+    const uint32_t PICK_GRID_SIZE = 16; // Cells per axis in the pick grid
+
+    struct PickGridNode
+    {
+        dmVMath::Matrix4    m_InverseTransform; // Maps screen space to the node boundary (0,1),(0,1)
+        float               m_Bounds[4];        // Screen space bounds: min x, min y, max x, max y
+        float               m_Size[2];          // The node size the bounds were calculated from
+        uint64_t            m_RenderKey;
+        uint32_t            m_Version;          // The world transform version the bounds were calculated from, 0 if not in the grid
+        uint32_t            m_Stamp;            // The grid refresh the node was last visited in
+        uint8_t             m_Cells[4];         // The cells covered by the bounds: min x, min y, max x, max y
+        uint8_t             m_Pivot;
+    };
+
+    /*
+     * Uniform grid over the screen space bounds of the enabled nodes, used by PickNodes() and QueryRect().
+     * It's allocated on first use, and before each query, the nodes whose world transform, size or pivot
+     * changed since the last query are moved to their new cells. The nodes are only visited when the scene
+     * counted a change to them since the last query (see SetNodesChanged()), so the render order is cached too.
+     */
+    struct PickGrid
+    {
+        dmArray<uint16_t>       m_Cells[PICK_GRID_SIZE * PICK_GRID_SIZE]; // Indices of the nodes overlapping each cell
+        dmArray<PickGridNode>   m_Nodes;    // Indexed by node index
+        dmArray<uint16_t>       m_Inserted; // Indices of the nodes in the grid
+        float                   m_Width;    // The screen size covered by the grid
+        float                   m_Height;
+        uint32_t                m_Stamp;
+        uint32_t                m_NodesChanged; // The scene's m_NodesChanged when the nodes were last visited
+    };
+
     struct NodeProxy
     {
         HScene m_Scene;
@@ -295,6 +333,9 @@ namespace dmGui
         uint16_t                m_RenderHead;
         uint16_t                m_RenderTail;
         uint16_t                m_NextVersionNumber;
+        uint32_t                m_WorldTransformVersion; // The last version given to a node world transform
+        uint32_t                m_NodesChanged; // Change counter, see SetNodesChanged()
+        PickGrid*               m_PickGrid; // Created on the first PickNodes() or QueryRect() call
         uint16_t                m_RenderOrder; // For the render-key
         uint16_t                m_NextLayerIndex;
         uint16_t                m_ResChanged : 1;
@@ -331,12 +372,51 @@ namespace dmGui
      */
     void CalculateNodeTransform(HScene scene, InternalNode* node, const CalculateNodeTransformFlags flags, dmVMath::Matrix4& out_transform);
 
+    /** Counts a change to the nodes of the scene that can move them in the pick grid or change their render order,
+     * e.g. a new local transform, size, pivot or layer, or nodes being added, deleted, reordered, enabled or disabled.
+     * @param scene scene of the nodes
+     */
+    inline void SetNodesChanged(HScene scene)
+    {
+        ++scene->m_NodesChanged;
+    }
+
     /** Updates the local transform of the node. Requires the parent node(s) to have been updated beforehand.
      * @param scene scene of the node
      * @param node node for which to calculate the transform
      */
     void UpdateLocalTransform(HScene scene, InternalNode* node);
 
+    /** Updates the cached world transform of the node, if the node or any of its ancestors have changed.
+     * Any change to a node gives its world transform a new version, which invalidates the world transforms of
+     * its children the next time they are updated, so unchanged subtrees are never recalculated.
+     * Requires the world transform of the parent node to have been updated beforehand.
+     * @param scene scene of the node
+     * @param node node for which to update the world transform
+     * @param parent parent of the node, or 0
+     */
+    inline void UpdateWorldTransform(HScene scene, InternalNode* n, InternalNode* parent)
+    {
+        Node& node = n->m_Node;
+        bool dirty = node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED);
+        if (dirty)
+        {
+            UpdateLocalTransform(scene, n);
+        }
+
+        uint32_t parent_version = parent ? parent->m_WorldTransformVersion : 0;
+        if (dirty || n->m_WorldTransformVersion == 0 || n->m_ParentWorldTransformVersion != parent_version)
+        {
+            node.m_WorldTransform = parent ? parent->m_Node.m_WorldTransform * node.m_LocalTransform : node.m_LocalTransform;
+            n->m_ParentWorldTransformVersion = parent_version;
+            if (++scene->m_WorldTransformVersion == 0)
+            {
+                scene->m_WorldTransformVersion = 1;
+            }
+            n->m_WorldTransformVersion = scene->m_WorldTransformVersion;
+        }
+    }
+
     /**
      */
     inline dmVMath::Vector4 CalcPivotDelta(uint32_t pivot, dmVMath::Vector4 size)
@@ -444,36 +524,29 @@ namespace dmGui
 
         dmVMath::Matrix4 parent_trans;
         float parent_opacity;
+        InternalNode* parent = 0;
         if (n->m_ParentIndex != INVALID_INDEX)
         {
-            InternalNode* parent = &scene->m_Nodes[n->m_ParentIndex];
+            parent = &scene->m_Nodes[n->m_ParentIndex];
             CalculateParentNodeTransformAndAlphaCached(scene, parent, parent_trans, parent_opacity, traversal_cache);
         }
 
-        if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
-        {
-            UpdateLocalTransform(scene, n);
-        }
-        else if(cached)
+        if (cached && !node.m_DirtyLocal && !(scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
         {
-            out_transform = cache_data.m_Transform;
+            out_transform = node.m_WorldTransform;
             out_opacity = cache_data.m_Opacity;
             return;
         }
-        out_transform = node.m_LocalTransform;
+
+        UpdateWorldTransform(scene, n, parent);
+        out_transform = node.m_WorldTransform;
         out_opacity = n->m_Node.m_Properties[dmGui::PROPERTY_COLOR].getW();
 
-        if (n->m_ParentIndex != INVALID_INDEX)
+        if (parent && node.m_InheritAlpha)
         {
-            out_transform = parent_trans * out_transform;
-
-            if (node.m_InheritAlpha)
-            {
-                out_opacity *= parent_opacity;
-            }
+            out_opacity *= parent_opacity;
         }
 
-        cache_data.m_Transform = out_transform;
         cache_data.m_Opacity = out_opacity;
     }
 
@@ -494,17 +567,17 @@ namespace dmGui
     {
         dmVMath::Matrix4 parent_trans;
         float parent_opacity;
+        InternalNode* parent = 0;
         if (n->m_ParentIndex != INVALID_INDEX)
         {
-            InternalNode* parent = &scene->m_Nodes[n->m_ParentIndex];
+            parent = &scene->m_Nodes[n->m_ParentIndex];
             CalculateParentNodeTransformAndAlphaCached(scene, parent, parent_trans, parent_opacity, scene->m_Context->m_SceneTraversalCache);
         }
 
+        // Also keeps the world transform of the node up to date for its children
+        UpdateWorldTransform(scene, n, parent);
+
         const Node& node = n->m_Node;
-        if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
-        {
-            UpdateLocalTransform(scene, n);
-        }
         out_transform = node.m_LocalTransform;
         CalculateNodeExtents(node, flags, out_transform);
 
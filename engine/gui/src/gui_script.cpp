@@ -3205,6 +3205,100 @@ namespace dmGui
         return 1;
     }
 
+    static void LuaPushNodeArray(lua_State* L, Scene* scene, const dmArray<HNode>& nodes)
+    {
+        lua_createtable(L, nodes.Size(), 0);
+        for (uint32_t i = 0; i < nodes.Size(); ++i)
+        {
+            LuaPushNode(L, scene, nodes[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+    }
+
+    /*# returns the nodes under a point
+     * Returns all enabled nodes that are picked by the supplied coordinates,
+     * in the same way as with [ref:gui.pick_node].
+     * The nodes are looked up in a spatial index over the scene, which is
+     * much faster than testing each node when there are many of them.
+     *
+     * @name gui.pick_nodes
+     * @param x [type:number] x-coordinate (see <a href="#on_input">on_input</a> )
+     * @param y [type:number] y-coordinate (see <a href="#on_input">on_input</a> )
+     * @return nodes [type:table] the picked nodes, in render order. The last node is drawn on top.
+     * @examples
+     *
+     * Find the top-most node under a touch:
+     *
+     * ```lua
+     * function on_input(self, action_id, action)
+     *     if action_id == hash("touch") and action.pressed then
+     *         local nodes = gui.pick_nodes(action.x, action.y)
+     *         local top = nodes[#nodes]
+     *         if top then
+     *             print("touched", gui.get_id(top))
+     *         end
+     *     end
+     * end
+     * ```
+     */
+    static int LuaPickNodes(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        lua_Number x = luaL_checknumber(L, 1);
+        lua_Number y = luaL_checknumber(L, 2);
+
+        Scene* scene = GuiScriptInstance_Check(L);
+
+        dmArray<HNode>& nodes = scene->m_Context->m_QueryNodes;
+        PickNodes(scene, (float) x, (float) y, nodes);
+        LuaPushNodeArray(L, scene, nodes);
+        return 1;
+    }
+
+    /*# returns the nodes overlapping a rectangle
+     * Returns all enabled nodes whose screen-space bounding box overlaps
+     * the rectangle spanned by two opposite corners.
+     *
+     * @name gui.query_rect
+     * @param x1 [type:number] x-coordinate of the first corner (see <a href="#on_input">on_input</a> )
+     * @param y1 [type:number] y-coordinate of the first corner
+     * @param x2 [type:number] x-coordinate of the opposite corner
+     * @param y2 [type:number] y-coordinate of the opposite corner
+     * @return nodes [type:table] the overlapping nodes, in render order
+     * @examples
+     *
+     * Select the nodes inside a drag rectangle:
+     *
+     * ```lua
+     * function on_input(self, action_id, action)
+     *     if action_id == hash("touch") then
+     *         if action.pressed then
+     *             self.drag_start = vmath.vector3(action.x, action.y, 0)
+     *         elseif action.released then
+     *             self.selection = gui.query_rect(self.drag_start.x, self.drag_start.y, action.x, action.y)
+     *         end
+     *     end
+     * end
+     * ```
+     */
+    static int LuaQueryRect(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        lua_Number x1 = luaL_checknumber(L, 1);
+        lua_Number y1 = luaL_checknumber(L, 2);
+        lua_Number x2 = luaL_checknumber(L, 3);
+        lua_Number y2 = luaL_checknumber(L, 4);
+
+        Scene* scene = GuiScriptInstance_Check(L);
+
+        dmArray<HNode>& nodes = scene->m_Context->m_QueryNodes;
+        QueryRect(scene, (float) x1, (float) y1, (float) x2, (float) y2, nodes);
+        LuaPushNodeArray(L, scene, nodes);
+        return 1;
+    }
+
     /*# returns if a node is enabled or not
      * Returns `true` if a node is enabled and `false` if it's not.
      * Disabled nodes are not rendered and animations acting on them are not evaluated.
@@ -3336,6 +3430,7 @@ namespace dmGui
         int adjust_mode = (int) luaL_checknumber(L, 2);
         n->m_Node.m_AdjustMode = (AdjustMode) adjust_mode;
         n->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(GetScene(L));
         return 0;
     }
 
@@ -3990,6 +4085,7 @@ namespace dmGui
                 v = *dmScript::CheckVector4(L, 2);\
             n->m_Node.m_Properties[property] = v;\
             n->m_Node.m_DirtyLocal = 1;\
+            SetNodesChanged(GetScene(L));\
             return 0;\
         }\
 
@@ -4063,6 +4159,7 @@ namespace dmGui
         n->m_Node.m_Properties[PROPERTY_ROTATION] = Vector4(r);
         n->m_Node.m_Properties[PROPERTY_EULER] = v;
         n->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(GetScene(L));
         return 0;
     }
 
@@ -4105,6 +4202,7 @@ namespace dmGui
         n->m_Node.m_Properties[PROPERTY_ROTATION] = Vector4(r);
         n->m_Node.m_Properties[PROPERTY_EULER] = v;
         n->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(GetScene(L));
         return 0;
     }
 
@@ -4151,6 +4249,7 @@ namespace dmGui
             v = *dmScript::CheckVector4(L, 2);
         n->m_Node.m_Properties[PROPERTY_SIZE] = v;
         n->m_Node.m_DirtyLocal = 1;
+        SetNodesChanged(GetScene(L));
         return 0;
     }
 
@@ -4742,6 +4841,8 @@ namespace dmGui
         {"get_slice9",      LuaGetSlice9},
         {"set_slice9",      LuaSetSlice9},
         {"pick_node",       LuaPickNode},
+        {"pick_nodes",      LuaPickNodes},
+        {"query_rect",      LuaQueryRect},
         {"is_enabled",      LuaIsEnabled},
         {"set_enabled",     LuaSetEnabled},
         {"get_visible",     LuaGetVisible},
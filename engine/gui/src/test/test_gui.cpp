@@ -1229,6 +1229,40 @@ TEST_F(dmGuiTest, AnimateComplete)
     dmGui::DeleteNode(m_Scene, node, true);
 }
 
+static void CancelOtherAnimationComplete(dmGui::HScene scene,
+                         dmGui::HNode node,
+                         bool finished,
+                         void* userdata1,
+                         void* userdata2)
+{
+    dmGui::CancelAnimationHash(scene, (dmGui::HNode)(uintptr_t) userdata1, dmGui::GetPropertyHash(dmGui::PROPERTY_POSITION));
+}
+
+TEST_F(dmGuiTest, AnimateCompleteCancelsLaterAnimation)
+{
+    dmGui::HNode node1 = dmGui::NewNode(m_Scene, Point3(0,0,0), Vector3(10,10,0), dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode node2 = dmGui::NewNode(m_Scene, Point3(0,0,0), Vector3(10,10,0), dmGui::NODE_TYPE_BOX, 0);
+    dmhash_t property = dmGui::GetPropertyHash(dmGui::PROPERTY_POSITION);
+    dmGui::AnimateNodeHash(m_Scene, node1, property, Vector4(1,0,0,0), dmEasing::Curve(dmEasing::TYPE_LINEAR), dmGui::PLAYBACK_ONCE_FORWARD, 1.0f, 0, &CancelOtherAnimationComplete, (void*)(uintptr_t) node2, 0);
+    dmGui::AnimateNodeHash(m_Scene, node2, property, Vector4(2,0,0,0), dmEasing::Curve(dmEasing::TYPE_LINEAR), dmGui::PLAYBACK_ONCE_FORWARD, 1.0f, 0, 0, 0, 0);
+
+    float dt = 1.0f / 60.0f;
+    for (int i = 0; i < 59; ++i)
+    {
+        dmGui::UpdateScene(m_Scene, dt);
+    }
+    float x2 = dmGui::GetNodePosition(m_Scene, node2).getX();
+    ASSERT_NEAR(x2, 2.0f * 59.0f / 60.0f, EPSILON);
+
+    // The callback of the first animation runs before the values of the later animations are applied
+    dmGui::UpdateScene(m_Scene, dt);
+    ASSERT_NEAR(dmGui::GetNodePosition(m_Scene, node1).getX(), 1.0f, EPSILON);
+    ASSERT_EQ(x2, dmGui::GetNodePosition(m_Scene, node2).getX());
+
+    dmGui::DeleteNode(m_Scene, node1, true);
+    dmGui::DeleteNode(m_Scene, node2, true);
+}
+
 void MyPingPongComplete2(dmGui::HScene scene,
                          dmGui::HNode node,
                          bool finished,
@@ -2734,6 +2768,132 @@ TEST_F(dmGuiTest, Picking)
     ASSERT_FALSE(dmGui::PickNode(m_Scene, n1, pos.getX() + 1.0f, pos.getY()));
 }
 
+TEST_F(dmGuiTest, PickNodes)
+{
+    uint32_t physical_width = 640;
+    uint32_t physical_height = 320;
+    float ref_scale = 0.5f;
+    dmGui::SetPhysicalResolution(m_Context, physical_width, physical_height);
+    dmGui::SetDefaultResolution(m_Context, (uint32_t) (physical_width * ref_scale), (uint32_t) (physical_height * ref_scale));
+    dmGui::SetSceneResolution(m_Scene, (uint32_t) (physical_width * ref_scale), (uint32_t) (physical_height * ref_scale));
+
+    Vector3 size(20, 20, 0);
+    dmGui::HNode n1 = dmGui::NewNode(m_Scene, Point3(50, 50, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n2 = dmGui::NewNode(m_Scene, Point3(55, 55, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n3 = dmGui::NewNode(m_Scene, Point3(200, 100, 0), size, dmGui::NODE_TYPE_BOX, 0);
+
+    dmArray<dmGui::HNode> nodes;
+    dmGui::PickNodes(m_Scene, 42, 42, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+
+    // Overlapping nodes are returned in render order
+    dmGui::PickNodes(m_Scene, 57, 57, nodes);
+    ASSERT_EQ(2u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    ASSERT_EQ(n2, nodes[1]);
+
+    dmGui::PickNodes(m_Scene, 150, 150, nodes);
+    ASSERT_EQ(0u, nodes.Size());
+
+    // Moved nodes are picked at their new position
+    dmGui::SetNodePosition(m_Scene, n1, Point3(205, 105, 0));
+    dmGui::PickNodes(m_Scene, 42, 42, nodes);
+    ASSERT_EQ(0u, nodes.Size());
+    dmGui::PickNodes(m_Scene, 200, 100, nodes);
+    ASSERT_EQ(2u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    ASSERT_EQ(n3, nodes[1]);
+
+    // Disabled nodes are not picked
+    dmGui::SetNodeEnabled(m_Scene, n3, false);
+    dmGui::PickNodes(m_Scene, 200, 100, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+
+    // Children follow their parent
+    dmGui::SetNodeEnabled(m_Scene, n3, true);
+    dmGui::SetNodeParent(m_Scene, n3, n2, false);
+    dmGui::SetNodePosition(m_Scene, n2, Point3(100, 50, 0));
+    dmGui::PickNodes(m_Scene, 300, 150, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n3, nodes[0]);
+
+    // The corners may be given in any order
+    dmGui::QueryRect(m_Scene, 320, 160, 0, 0, nodes);
+    ASSERT_EQ(3u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    ASSERT_EQ(n2, nodes[1]);
+    ASSERT_EQ(n3, nodes[2]);
+
+    dmGui::QueryRect(m_Scene, 80, 30, 120, 70, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n2, nodes[0]);
+
+    // Nodes outside of the screen are kept in the border cells
+    dmGui::SetNodePosition(m_Scene, n1, Point3(-500, -500, 0));
+    dmGui::PickNodes(m_Scene, -500, -500, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    dmGui::PickNodes(m_Scene, 1, 1, nodes);
+    ASSERT_EQ(0u, nodes.Size());
+}
+
+TEST_F(dmGuiTest, PickNodesCached)
+{
+    uint32_t physical_width = 640;
+    uint32_t physical_height = 320;
+    float ref_scale = 0.5f;
+    dmGui::SetPhysicalResolution(m_Context, physical_width, physical_height);
+    dmGui::SetDefaultResolution(m_Context, (uint32_t) (physical_width * ref_scale), (uint32_t) (physical_height * ref_scale));
+    dmGui::SetSceneResolution(m_Scene, (uint32_t) (physical_width * ref_scale), (uint32_t) (physical_height * ref_scale));
+
+    Vector3 size(20, 20, 0);
+    dmGui::HNode n1 = dmGui::NewNode(m_Scene, Point3(50, 50, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n2 = dmGui::NewNode(m_Scene, Point3(55, 55, 0), size, dmGui::NODE_TYPE_BOX, 0);
+
+    dmArray<dmGui::HNode> nodes;
+    dmGui::PickNodes(m_Scene, 57, 57, nodes);
+    ASSERT_EQ(2u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    ASSERT_EQ(n2, nodes[1]);
+
+    // The nodes aren't visited again while nothing changes
+    uint32_t stamp = m_Scene->m_PickGrid->m_Stamp;
+    dmGui::PickNodes(m_Scene, 57, 57, nodes);
+    dmGui::QueryRect(m_Scene, 0, 0, 320, 160, nodes);
+    ASSERT_EQ(2u, nodes.Size());
+    ASSERT_EQ(stamp, m_Scene->m_PickGrid->m_Stamp);
+
+    // The cached render order follows reordered nodes
+    dmGui::MoveNodeAbove(m_Scene, n1, n2);
+    dmGui::PickNodes(m_Scene, 57, 57, nodes);
+    ASSERT_EQ(2u, nodes.Size());
+    ASSERT_EQ(n2, nodes[0]);
+    ASSERT_EQ(n1, nodes[1]);
+    ASSERT_EQ(stamp + 1, m_Scene->m_PickGrid->m_Stamp);
+
+    // Size and pivot changes
+    dmGui::SetNodeProperty(m_Scene, n2, dmGui::PROPERTY_SIZE, Vector4(100, 100, 0, 0));
+    dmGui::PickNodes(m_Scene, 100, 100, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n2, nodes[0]);
+    dmGui::SetNodePivot(m_Scene, n2, dmGui::PIVOT_SW);
+    dmGui::PickNodes(m_Scene, 150, 150, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n2, nodes[0]);
+    dmGui::PickNodes(m_Scene, 10, 10, nodes);
+    ASSERT_EQ(0u, nodes.Size());
+
+    // Deleted nodes
+    dmGui::DeleteNode(m_Scene, n2, true);
+    dmGui::PickNodes(m_Scene, 150, 150, nodes);
+    ASSERT_EQ(0u, nodes.Size());
+    dmGui::PickNodes(m_Scene, 57, 57, nodes);
+    ASSERT_EQ(1u, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+}
+
 TEST_F(dmGuiTest, PickingDisabledAdjust)
 {
     uint32_t physical_width = 640;
@@ -3007,6 +3167,65 @@ static Vector4 _GET_NODE_SCENE_POSITION(dmGui::HScene scene, dmGui::HNode node)
     dmGui::SetNodeAdjustMode(m_Scene, n_left, adjust_mode);
 
 
+TEST_F(dmGuiTest, WorldTransformCache)
+{
+    // A resolution change recalculates all transforms, until the scene has been rendered
+    m_Scene->m_ResChanged = 0;
+
+    Vector3 size(10, 10, 0);
+    dmGui::HNode n1 = dmGui::NewNode(m_Scene, Point3(10, 0, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n2 = dmGui::NewNode(m_Scene, Point3(20, 0, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n3 = dmGui::NewNode(m_Scene, Point3(30, 0, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n4 = dmGui::NewNode(m_Scene, Point3(40, 0, 0), size, dmGui::NODE_TYPE_BOX, 0);
+
+    // n1 -> n2 -> n3, n1 -> n4
+    dmGui::SetNodeParent(m_Scene, n2, n1, false);
+    dmGui::SetNodeParent(m_Scene, n3, n2, false);
+    dmGui::SetNodeParent(m_Scene, n4, n1, false);
+
+    dmGui::InternalNode* nn1 = dmGui::GetNode(m_Scene, n1);
+    dmGui::InternalNode* nn2 = dmGui::GetNode(m_Scene, n2);
+    dmGui::InternalNode* nn3 = dmGui::GetNode(m_Scene, n3);
+    dmGui::InternalNode* nn4 = dmGui::GetNode(m_Scene, n4);
+
+    ASSERT_NEAR(60.0f, dmGui::GetNodeWorldTransform(m_Scene, n3).getTranslation().getX(), EPSILON);
+    ASSERT_NEAR(50.0f, dmGui::GetNodeWorldTransform(m_Scene, n4).getTranslation().getX(), EPSILON);
+
+    uint32_t version1 = nn1->m_WorldTransformVersion;
+    uint32_t version2 = nn2->m_WorldTransformVersion;
+    uint32_t version3 = nn3->m_WorldTransformVersion;
+    uint32_t version4 = nn4->m_WorldTransformVersion;
+    ASSERT_NE(0u, version1);
+    ASSERT_NE(0u, version2);
+    ASSERT_NE(0u, version3);
+    ASSERT_NE(0u, version4);
+
+    // Nothing changed, so nothing is recalculated
+    ASSERT_NEAR(60.0f, dmGui::GetNodeWorldTransform(m_Scene, n3).getTranslation().getX(), EPSILON);
+    ASSERT_EQ(version1, nn1->m_WorldTransformVersion);
+    ASSERT_EQ(version2, nn2->m_WorldTransformVersion);
+    ASSERT_EQ(version3, nn3->m_WorldTransformVersion);
+
+    // Changing a node invalidates its subtree only
+    dmGui::SetNodePosition(m_Scene, n2, Point3(25, 0, 0));
+    ASSERT_NEAR(65.0f, dmGui::GetNodeWorldTransform(m_Scene, n3).getTranslation().getX(), EPSILON);
+    ASSERT_NEAR(50.0f, dmGui::GetNodeWorldTransform(m_Scene, n4).getTranslation().getX(), EPSILON);
+    ASSERT_EQ(version1, nn1->m_WorldTransformVersion);
+    ASSERT_NE(version2, nn2->m_WorldTransformVersion);
+    ASSERT_NE(version3, nn3->m_WorldTransformVersion);
+    ASSERT_EQ(version4, nn4->m_WorldTransformVersion);
+
+    // Changes to the root propagate to all descendants
+    dmGui::SetNodeProperty(m_Scene, n1, dmGui::PROPERTY_SCALE, Vector4(2, 2, 1, 1));
+    ASSERT_NEAR(10.0f + 2.0f * 55.0f, dmGui::GetNodeWorldTransform(m_Scene, n3).getTranslation().getX(), EPSILON);
+    ASSERT_NEAR(10.0f + 2.0f * 40.0f, dmGui::GetNodeWorldTransform(m_Scene, n4).getTranslation().getX(), EPSILON);
+    ASSERT_NE(version4, nn4->m_WorldTransformVersion);
+
+    // Reparenting
+    dmGui::SetNodeParent(m_Scene, n3, dmGui::INVALID_HANDLE, false);
+    ASSERT_NEAR(30.0f, dmGui::GetNodeWorldTransform(m_Scene, n3).getTranslation().getX(), EPSILON);
+}
+
 TEST_F(dmGuiTest, ReparentKeepTrans)
 {
     // Test parenting with keep transform for GUI nodes.
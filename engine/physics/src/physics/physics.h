@@ -20,6 +20,7 @@
 #include <dmsdk/dlib/vmath.h>
 
 #include <dlib/hash.h>
+#include <dlib/job_thread.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
 
@@ -1178,6 +1179,38 @@ namespace dmPhysics
      */
     void RayCast2D(HWorld2D world, const RayCastRequest& request, dmArray<RayCastResponse>& results);
 
+    /**
+     * Perform a batch of synchronous ray casts, reporting the closest hit of each ray
+     *
+     * The queries only read the broadphase, so they are spread over the workers of the job thread,
+     * with the calling thread taking part. The call returns when all rays have been cast.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests. m_ReturnAllResults is ignored
+     * @param count Number of requests
+     * @param responses Array of count responses, receiving the result of the request with the same index.
+     *                  m_Hit is 0 for rays that hit nothing or have 0 length
+     * @param job_thread Job thread to run the queries on, or 0 to run them all on the calling thread
+     * @note Must not be called while the world is being stepped
+     */
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses, dmJobThread::HContext job_thread);
+
+    /**
+     * Perform a batch of synchronous ray casts, reporting the closest hit of each ray
+     *
+     * The queries only read the broadphase, so they are spread over the workers of the job thread,
+     * with the calling thread taking part. The call returns when all rays have been cast.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests. m_ReturnAllResults is ignored
+     * @param count Number of requests
+     * @param responses Array of count responses, receiving the result of the request with the same index.
+     *                  m_Hit is 0 for rays that hit nothing or have 0 length
+     * @param job_thread Job thread to run the queries on, or 0 to run them all on the calling thread
+     * @note Must not be called while the world is being stepped
+     */
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses, dmJobThread::HContext job_thread);
+
     /**
      * Set the gravity for a 2D physics world.
      *
@@ -1420,6 +1420,42 @@ namespace dmPhysics
         }
     }
 
+    static void RayCastBatchRange2D(void* context, const RayCastRequest* requests, RayCastResponse* responses, uint32_t begin, uint32_t end)
+    {
+        HWorld2D world = (HWorld2D)context;
+        float scale = world->m_Context->m_Scale;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const RayCastRequest& request = requests[i];
+            RayCastResponse& response = responses[i];
+            response.m_Hit = 0;
+
+            b2Vec2 from;
+            ToB2(request.m_From, from, scale);
+            b2Vec2 to;
+            ToB2(request.m_To, to, scale);
+            if ((to - from).LengthSquared() <= 0.0f)
+                continue;
+
+            ProcessRayCastResultCallback2D query;
+            query.m_Request = &request;
+            query.m_Context = world->m_Context;
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_CollisionMask = request.m_Mask;
+            query.m_Response.m_Hit = 0;
+            world->m_World.RayCast(&query, from, to);
+
+            if (query.m_Response.m_Hit)
+                response = query.m_Response;
+        }
+    }
+
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses, dmJobThread::HContext job_thread)
+    {
+        DM_PROFILE("RayCastBatch2D");
+        RunRayCastBatch(job_thread, RayCastBatchRange2D, world, requests, responses, count);
+    }
+
     void SetGravity2D(HWorld2D world, const Vector3& gravity)
     {
         b2Vec2 gravity_b;
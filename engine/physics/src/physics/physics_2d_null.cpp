@@ -265,6 +265,14 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses, dmJobThread::HContext job_thread)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i].m_Hit = 0;
+        }
+    }
+
     void SetGravity2D(HWorld2D world, const dmVMath::Vector3& gravity)
     {
     }
@@ -1255,6 +1255,41 @@ namespace dmPhysics
         }
     }
 
+    static void RayCastBatchRange3D(void* context, const RayCastRequest* requests, RayCastResponse* responses, uint32_t begin, uint32_t end)
+    {
+        HWorld3D world = (HWorld3D)context;
+        float scale = world->m_Context->m_Scale;
+        float inv_scale = world->m_Context->m_InvScale;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const RayCastRequest& request = requests[i];
+            RayCastResponse& response = responses[i];
+            response.m_Hit = 0;
+
+            if (lengthSqr(request.m_To - request.m_From) <= 0.0f)
+                continue;
+
+            btVector3 from;
+            ToBt(request.m_From, from, scale);
+            btVector3 to;
+            ToBt(request.m_To, to, scale);
+
+            RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+            world->m_DynamicsWorld->rayTest(from, to, result_callback);
+
+            if (result_callback.hasHit())
+            {
+                ResponseFromRayCastResult(response, inv_scale, result_callback.m_closestHitFraction, result_callback.m_hitPointWorld, result_callback.m_hitNormalWorld, result_callback.m_collisionObject);
+            }
+        }
+    }
+
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses, dmJobThread::HContext job_thread)
+    {
+        DM_PROFILE("RayCastBatch3D");
+        RunRayCastBatch(job_thread, RayCastBatchRange3D, world, requests, responses, count);
+    }
+
     void SetGravity3D(HWorld3D world, const Vector3& gravity)
     {
         HContext3D context = world->m_Context;
@@ -17,6 +17,11 @@
 
 #include <string.h>
 
+#include <dlib/atomic.h>
+#include <dlib/job_thread.h>
+#include <dlib/math.h>
+#include <dlib/time.h>
+
 namespace dmPhysics
 {
     const char* PHYSICS_SOCKET_NAME = "@physics";
@@ -119,4 +124,93 @@ namespace dmPhysics
         memset(this, 0, sizeof(*this));
     }
 
+    /// Number of rays each job claims at a time. Large enough to amortize the atomics,
+    /// small enough to balance the load when rays differ a lot in cost.
+    static const uint32_t RAY_CAST_BATCH_RANGE_SIZE = 64;
+
+    struct RayCastBatchJob
+    {
+        RayCastBatchRangeFn     m_Fn;
+        void*                   m_Context;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+        uint32_t                m_Count;
+        uint32_t                m_RangeCount;
+        int32_atomic_t          m_NextRange;
+        int32_atomic_t          m_RangesDone;
+        // One reference per pushed job plus one for the calling thread.
+        // The batch is deleted by whoever releases the last one.
+        int32_atomic_t          m_RefCount;
+    };
+
+    static void ReleaseRayCastBatchJob(RayCastBatchJob* job)
+    {
+        if (dmAtomicDecrement32(&job->m_RefCount) == 1)
+            delete job;
+    }
+
+    static void ProcessRayCastBatchRanges(RayCastBatchJob* job)
+    {
+        while (true)
+        {
+            uint32_t range = (uint32_t)dmAtomicIncrement32(&job->m_NextRange);
+            // A job that starts after all ranges are claimed must not touch the requests,
+            // as they may already have been returned to the caller
+            if (range >= job->m_RangeCount)
+                break;
+            uint32_t begin = range * RAY_CAST_BATCH_RANGE_SIZE;
+            uint32_t end = dmMath::Min(begin + RAY_CAST_BATCH_RANGE_SIZE, job->m_Count);
+            job->m_Fn(job->m_Context, job->m_Requests, job->m_Responses, begin, end);
+            dmAtomicIncrement32(&job->m_RangesDone);
+        }
+    }
+
+    static int RayCastBatchJobProcess(void* context, void* data)
+    {
+        RayCastBatchJob* job = (RayCastBatchJob*)data;
+        ProcessRayCastBatchRanges(job);
+        ReleaseRayCastBatchJob(job);
+        return 0;
+    }
+
+    void RunRayCastBatch(dmJobThread::HContext job_thread, RayCastBatchRangeFn fn, void* context, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count)
+    {
+        if (count == 0)
+            return;
+
+        uint32_t range_count = (count + RAY_CAST_BATCH_RANGE_SIZE - 1) / RAY_CAST_BATCH_RANGE_SIZE;
+        uint32_t worker_count = job_thread ? dmJobThread::GetWorkerCount(job_thread) : 0;
+        uint32_t job_count = dmMath::Min(worker_count, range_count - 1);
+        if (job_count == 0)
+        {
+            fn(context, requests, responses, 0, count);
+            return;
+        }
+
+        RayCastBatchJob* job = new RayCastBatchJob;
+        job->m_Fn = fn;
+        job->m_Context = context;
+        job->m_Requests = requests;
+        job->m_Responses = responses;
+        job->m_Count = count;
+        job->m_RangeCount = range_count;
+        dmAtomicStore32(&job->m_NextRange, 0);
+        dmAtomicStore32(&job->m_RangesDone, 0);
+        dmAtomicStore32(&job->m_RefCount, (int32_t)job_count + 1);
+
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            dmJobThread::PushJob(job_thread, RayCastBatchJobProcess, 0, 0, job);
+        }
+
+        // The calling thread takes part as well, and then waits for the ranges still in flight on the workers
+        ProcessRayCastBatchRanges(job);
+        while ((uint32_t)dmAtomicGet32(&job->m_RangesDone) != range_count)
+        {
+            dmTime::Sleep(0); // yield to the workers
+        }
+
+        ReleaseRayCastBatchJob(job);
+    }
+
 }
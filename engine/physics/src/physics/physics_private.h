@@ -125,6 +125,18 @@ namespace dmPhysics
      * if it is the last known occurrence of overlap.
      */
     void OverlapCachePrune(OverlapCache* cache, const OverlapCachePruneData& data);
+
+    /**
+     * Performs the closest hit ray casts for the requests in the range [begin, end).
+     */
+    typedef void (*RayCastBatchRangeFn)(void* context, const RayCastRequest* requests, RayCastResponse* responses, uint32_t begin, uint32_t end);
+
+    /**
+     * Splits a batch of ray casts into ranges which are processed by the job thread workers and the calling thread.
+     * Runs the whole batch on the calling thread when there are no workers.
+     * Returns when all ranges have been processed.
+     */
+    void RunRayCastBatch(dmJobThread::HContext job_thread, RayCastBatchRangeFn fn, void* context, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count);
 }
 
 #endif // PHYSICS_PRIVATE_H
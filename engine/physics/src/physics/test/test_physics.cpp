@@ -16,7 +16,9 @@
 #include <jc_test/jc_test.h>
 
 #include "test_physics.h"
+#include <dlib/job_thread.h>
 #include <dlib/math.h>
+#include <dlib/time.h>
 
 
 using namespace dmVMath;
@@ -128,6 +130,7 @@ Test3D::Test3D()
 , m_GetMassFunc(dmPhysics::GetMass3D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast3D)
 , m_RayCastFunc(dmPhysics::RayCast3D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch3D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks3D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape3D)
 , m_SetGravityFunc(dmPhysics::SetGravity3D)
@@ -186,6 +189,7 @@ Test2D::Test2D()
 , m_GetMassFunc(dmPhysics::GetMass2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
 , m_RayCastFunc(dmPhysics::RayCast2D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
 , m_SetGravityFunc(dmPhysics::SetGravity2D)
@@ -1302,6 +1306,116 @@ TYPED_TEST(PhysicsTest, FilteredRayCasting)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape_b);
 }
 
+TYPED_TEST(PhysicsTest, BatchRayCasting)
+{
+    // A grid of boxes in alternating groups, hit by rays crossing the grid in random directions
+    const int grid_size = 8;
+    const uint32_t ray_count = 10000;
+
+    VisualObject vos[grid_size * grid_size];
+    typename TypeParam::CollisionObjectType box_cos[grid_size * grid_size];
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.5f));
+    for (int i = 0; i < grid_size * grid_size; ++i)
+    {
+        vos[i].m_Position = Point3(2.0f * (i % grid_size) - grid_size, 2.0f * (i / grid_size) - grid_size, 0.0f);
+
+        dmPhysics::CollisionObjectData data;
+        data.m_Group = (i & 1) ? GROUP_B : GROUP_A;
+        data.m_Mask = GROUP_A | GROUP_B;
+        data.m_Mass = 0.0f;
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+        data.m_UserData = &vos[i];
+        box_cos[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    dmArray<dmPhysics::RayCastRequest> requests;
+    requests.SetCapacity(ray_count);
+    requests.SetSize(ray_count);
+    uint32_t seed = 0;
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        dmPhysics::RayCastRequest& request = requests[i];
+        request = dmPhysics::RayCastRequest();
+        float angle = dmMath::Rand01(&seed) * 2.0f * (float) M_PI;
+        request.m_From = Point3(dmMath::Rand11(&seed) * grid_size, dmMath::Rand11(&seed) * grid_size, 0.0f);
+        request.m_To = request.m_From + Vector3(cosf(angle), sinf(angle), 0.0f) * 4.0f * grid_size;
+        request.m_Mask = (i & 1) ? GROUP_A : (GROUP_A | GROUP_B);
+        request.m_UserId = i;
+    }
+    // A 0 length ray never hits
+    requests[1].m_To = requests[1].m_From;
+
+    dmArray<dmPhysics::RayCastResponse> expected;
+    expected.SetCapacity(ray_count);
+    expected.SetSize(ray_count);
+    dmArray<dmPhysics::RayCastResponse> hits;
+    hits.SetCapacity(1);
+
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        hits.SetSize(0);
+        (*TestFixture::m_Test.m_RayCastFunc)(TestFixture::m_World, requests[i], hits);
+        expected[i] = hits.Empty() ? dmPhysics::RayCastResponse() : hits[0];
+    }
+    uint64_t serial_time = dmTime::GetTime() - start;
+
+    dmJobThread::JobThreadCreationParams job_thread_create_param;
+    job_thread_create_param.m_ThreadNames[0] = "test_physics_jobs1";
+    job_thread_create_param.m_ThreadNames[1] = "test_physics_jobs2";
+    job_thread_create_param.m_ThreadNames[2] = "test_physics_jobs3";
+    job_thread_create_param.m_ThreadCount    = 3;
+    dmJobThread::HContext job_thread = dmJobThread::Create(job_thread_create_param);
+
+    dmArray<dmPhysics::RayCastResponse> responses;
+    responses.SetCapacity(ray_count);
+    responses.SetSize(ray_count);
+
+    // Without a job thread, all rays are cast on the calling thread
+    start = dmTime::GetTime();
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests.Begin(), ray_count, responses.Begin(), 0);
+    uint64_t batch_serial_time = dmTime::GetTime() - start;
+
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        ASSERT_EQ(expected[i].m_Hit, responses[i].m_Hit);
+    }
+
+    start = dmTime::GetTime();
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests.Begin(), ray_count, responses.Begin(), job_thread);
+    uint64_t batch_parallel_time = dmTime::GetTime() - start;
+
+    uint32_t hit_count = 0;
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        ASSERT_EQ(expected[i].m_Hit, responses[i].m_Hit);
+        if (!responses[i].m_Hit)
+            continue;
+        ++hit_count;
+        ASSERT_EQ(expected[i].m_Fraction, responses[i].m_Fraction);
+        ASSERT_EQ(expected[i].m_CollisionObjectUserData, responses[i].m_CollisionObjectUserData);
+        ASSERT_EQ(expected[i].m_CollisionObjectGroup, responses[i].m_CollisionObjectGroup);
+        ASSERT_EQ(expected[i].m_Position.getX(), responses[i].m_Position.getX());
+        ASSERT_EQ(expected[i].m_Position.getY(), responses[i].m_Position.getY());
+    }
+    ASSERT_FALSE(responses[1].m_Hit);
+    ASSERT_LT(0u, hit_count);
+    ASSERT_GT(ray_count, hit_count);
+
+    printf("%u rays (%u hits): RayCast %.2f ms, RayCastBatch %.2f ms, RayCastBatch with %u workers %.2f ms\n",
+            ray_count, hit_count, serial_time / 1000.0f, batch_serial_time / 1000.0f,
+            dmJobThread::GetWorkerCount(job_thread), batch_parallel_time / 1000.0f);
+
+    dmJobThread::Update(job_thread);
+    dmJobThread::Destroy(job_thread);
+
+    for (int i = 0; i < grid_size * grid_size; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_cos[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 TYPED_TEST(PhysicsTest, GravityChange)
 {
     float box_half_ext = 0.5f;
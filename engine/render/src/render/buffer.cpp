@@ -12,10 +12,20 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#include <string.h>
+
+#include <dlib/profile.h>
+
 #include "render_private.h"
 
+DM_PROPERTY_EXTERN(rmtp_Render);
+DM_PROPERTY_U32(rmtp_TransientBufferSize, 0, FrameReset, "bytes uploaded through the transient buffers", &rmtp_Render);
+
 namespace dmRender
 {
+    // Initial size of the client side storage of a transient buffer
+    static const uint32_t TRANSIENT_BUFFER_MIN_CAPACITY = 64 * 1024;
+
     static HRenderBuffer NewRenderBuffer(dmGraphics::HContext graphics_context, RenderBufferType type)
     {
         switch(type)
@@ -144,4 +154,154 @@ namespace dmRender
             return;
         buffer->m_BufferIndex = 0;
     }
+
+    void InitializeTransientBuffers(HRenderContext render_context)
+    {
+        for (uint32_t i = 0; i < MAX_RENDER_BUFFER_TYPE_COUNT; ++i)
+        {
+            TransientBuffer& transient_buffer = render_context->m_TransientBuffers[i];
+            transient_buffer.m_UploadedSize = 0;
+            for (uint32_t j = 0; j < MAX_TRANSIENT_BUFFER_FRAMES; ++j)
+            {
+                transient_buffer.m_Buffers[j]     = NewRenderBuffer(render_context->m_GraphicsContext, (RenderBufferType) i);
+                transient_buffer.m_BufferSizes[j] = 0;
+            }
+        }
+        memset(&render_context->m_TransientBufferStats, 0, sizeof(TransientBufferStats));
+        memset(&render_context->m_TransientBufferStatsPrevFrame, 0, sizeof(TransientBufferStats));
+        render_context->m_TransientBufferFrame = 0;
+    }
+
+    void FinalizeTransientBuffers(HRenderContext render_context)
+    {
+        for (uint32_t i = 0; i < MAX_RENDER_BUFFER_TYPE_COUNT; ++i)
+        {
+            TransientBuffer& transient_buffer = render_context->m_TransientBuffers[i];
+            for (uint32_t j = 0; j < MAX_TRANSIENT_BUFFER_FRAMES; ++j)
+            {
+                DeleteRenderBuffer(transient_buffer.m_Buffers[j], (RenderBufferType) i);
+            }
+        }
+    }
+
+    void NextTransientBufferFrame(HRenderContext render_context)
+    {
+        render_context->m_TransientBufferStatsPrevFrame = render_context->m_TransientBufferStats;
+        memset(&render_context->m_TransientBufferStats, 0, sizeof(TransientBufferStats));
+
+        for (uint32_t i = 0; i < MAX_RENDER_BUFFER_TYPE_COUNT; ++i)
+        {
+            TransientBuffer& transient_buffer = render_context->m_TransientBuffers[i];
+            transient_buffer.m_Data.SetSize(0);
+            transient_buffer.m_UploadedSize = 0;
+        }
+        render_context->m_TransientBufferFrame = (render_context->m_TransientBufferFrame + 1) % MAX_TRANSIENT_BUFFER_FRAMES;
+    }
+
+    static void AddTransientBufferCategoryBytes(TransientBufferStats& stats, dmhash_t category, uint32_t size)
+    {
+        for (uint32_t i = 0; i < stats.m_CategoryCount; ++i)
+        {
+            if (stats.m_Categories[i] == category)
+            {
+                stats.m_CategoryBytes[i] += size;
+                return;
+            }
+        }
+        if (stats.m_CategoryCount < TransientBufferStats::MAX_CATEGORY_COUNT)
+        {
+            stats.m_Categories[stats.m_CategoryCount]    = category;
+            stats.m_CategoryBytes[stats.m_CategoryCount] = size;
+            stats.m_CategoryCount++;
+        }
+    }
+
+    void* AllocTransientBuffer(HRenderContext render_context, RenderBufferType type, uint32_t size, uint32_t alignment, dmhash_t category, HRenderBuffer* out_buffer, uint32_t* out_offset)
+    {
+        assert(type < MAX_RENDER_BUFFER_TYPE_COUNT);
+        TransientBuffer& transient_buffer = render_context->m_TransientBuffers[type];
+
+        uint32_t offset = transient_buffer.m_Data.Size();
+        if (alignment > 1)
+        {
+            offset = ((offset + alignment - 1) / alignment) * alignment;
+        }
+
+        uint32_t end = offset + size;
+        if (end > transient_buffer.m_Data.Capacity())
+        {
+            uint32_t capacity = dmMath::Max(TRANSIENT_BUFFER_MIN_CAPACITY, transient_buffer.m_Data.Capacity() * 2);
+            transient_buffer.m_Data.SetCapacity(dmMath::Max(capacity, end));
+        }
+        transient_buffer.m_Data.SetSize(end);
+
+        AddTransientBufferCategoryBytes(render_context->m_TransientBufferStats, category, size);
+
+        *out_buffer = transient_buffer.m_Buffers[render_context->m_TransientBufferFrame];
+        *out_offset = offset;
+        return transient_buffer.m_Data.Begin() + offset;
+    }
+
+    static void FlushTransientBuffer(HRenderContext render_context, RenderBufferType type)
+    {
+        TransientBuffer& transient_buffer = render_context->m_TransientBuffers[type];
+
+        uint32_t size          = transient_buffer.m_Data.Size();
+        uint32_t uploaded_size = transient_buffer.m_UploadedSize;
+        if (size == uploaded_size)
+            return;
+
+        uint32_t frame       = render_context->m_TransientBufferFrame;
+        HRenderBuffer buffer = transient_buffer.m_Buffers[frame];
+
+        if (size > transient_buffer.m_BufferSizes[frame])
+        {
+            // Resizing discards the previous contents, so we upload everything allocated this frame.
+            // We allocate the full capacity to avoid resizing again later in the frame.
+            uint32_t capacity = transient_buffer.m_Data.Capacity();
+            switch(type)
+            {
+                case RENDER_BUFFER_TYPE_VERTEX_BUFFER:
+                    dmGraphics::SetVertexBufferData((dmGraphics::HVertexBuffer) buffer, capacity, transient_buffer.m_Data.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+                    break;
+                case RENDER_BUFFER_TYPE_INDEX_BUFFER:
+                    dmGraphics::SetIndexBufferData((dmGraphics::HIndexBuffer) buffer, capacity, transient_buffer.m_Data.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+                    break;
+                default:break;
+            }
+            transient_buffer.m_BufferSizes[frame] = capacity;
+        }
+        else
+        {
+            const uint8_t* data = transient_buffer.m_Data.Begin() + uploaded_size;
+            switch(type)
+            {
+                case RENDER_BUFFER_TYPE_VERTEX_BUFFER:
+                    dmGraphics::SetVertexBufferSubData((dmGraphics::HVertexBuffer) buffer, uploaded_size, size - uploaded_size, data);
+                    break;
+                case RENDER_BUFFER_TYPE_INDEX_BUFFER:
+                    dmGraphics::SetIndexBufferSubData((dmGraphics::HIndexBuffer) buffer, uploaded_size, size - uploaded_size, data);
+                    break;
+                default:break;
+            }
+        }
+
+        transient_buffer.m_UploadedSize = size;
+
+        TransientBufferStats& stats = render_context->m_TransientBufferStats;
+        stats.m_BytesUploaded += size - uploaded_size;
+        stats.m_UploadCount++;
+        DM_PROPERTY_ADD_U32(rmtp_TransientBufferSize, size - uploaded_size);
+    }
+
+    void FlushTransientBuffers(HRenderContext render_context)
+    {
+        FlushTransientBuffer(render_context, RENDER_BUFFER_TYPE_VERTEX_BUFFER);
+        FlushTransientBuffer(render_context, RENDER_BUFFER_TYPE_INDEX_BUFFER);
+    }
+
+    void GetTransientBufferStats(HRenderContext render_context, TransientBufferStats* stats)
+    {
+        *stats = render_context->m_TransientBufferStatsPrevFrame;
+    }
 }
@@ -368,14 +368,15 @@ static inline void ApplyConstant(ApplyConstantContext* context, const uint64_t*
     if (location)
     {
         dmVMath::Vector4* values = &context->m_ConstantBuffer->m_Values[constant->m_ValueIndex];
+        int32_t constant_index   = FindMaterialConstantIndex(context->m_Material, *name_hash);
 
         if (constant->m_Type == dmRenderDDF::MaterialDesc::CONSTANT_TYPE_USER_MATRIX4)
         {
-            dmGraphics::SetConstantM4(context->m_GraphicsContext, values, constant->m_NumValues / 4, *location);
+            SetMaterialConstant(context->m_GraphicsContext, context->m_Material, constant_index, *location, values, constant->m_NumValues & ~3, true);
         }
         else
         {
-            dmGraphics::SetConstantV4(context->m_GraphicsContext, values, constant->m_NumValues, *location);
+            SetMaterialConstant(context->m_GraphicsContext, context->m_Material, constant_index, *location, values, constant->m_NumValues, false);
         }
     }
 }
@@ -40,6 +40,7 @@
 DM_PROPERTY_EXTERN(rmtp_Render);
 DM_PROPERTY_U32(rmtp_FontCharacterCount, 0, FrameReset, "# glyphs", &rmtp_Render);
 DM_PROPERTY_U32(rmtp_FontVertexSize, 0, FrameReset, "size of vertices in bytes", &rmtp_Render);
+DM_PROPERTY_U32(rmtp_FontGlyphUploads, 0, FrameReset, "# glyphs added to the glyph caches", &rmtp_Render);
 
 namespace dmRender
 {
@@ -64,6 +65,19 @@ namespace dmRender
         SHADOW  = 0x4
     };
 
+    // Empty pixels between glyphs in the cache, so that filtering doesn't bleed into the neighbours
+    static const uint32_t CACHE_GLYPH_GUTTER = 1;
+    // Shelf heights are rounded up to this, so that evicted shelves can be reused by similar glyphs
+    static const uint32_t CACHE_SHELF_ALIGNMENT = 4;
+
+    // A row in the glyph cache, where glyphs are packed left to right
+    struct GlyphCacheShelf
+    {
+        uint16_t m_Y;
+        uint16_t m_Height;
+        uint16_t m_X;       // Where the next glyph goes
+    };
+
     FontMapParams::FontMapParams()
     : m_Glyphs()
     , m_ShadowX(0.0f)
@@ -103,26 +117,27 @@ namespace dmRender
         , m_CacheWidth(0)
         , m_CacheHeight(0)
         , m_GlyphData(0)
-        , m_Cache(0)
-        , m_CacheCursor(0)
-        , m_CacheColumns(0)
-        , m_CacheRows(0)
+        , m_CacheData(0)
+        , m_CacheChannels(0)
+        , m_CacheShelvesHeight(0)
+        , m_CacheDirtyMinY(0)
+        , m_CacheDirtyMaxY(0)
         , m_CellTempData(0)
         , m_CacheCellWidth(0)
         , m_CacheCellHeight(0)
-        , m_CacheCellMaxAscent(0)
         , m_CacheCellPadding(0)
         , m_LayerMask(FACE)
         , m_IsMonospaced(false)
         , m_Padding(0)
+        , m_LayoutVersion(0)
         {
 
         }
 
         ~FontMap()
         {
-            if (m_Cache) {
-                free(m_Cache);
+            if (m_CacheData) {
+                free(m_CacheData);
             }
             if (m_CellTempData) {
                 free(m_CellTempData);
@@ -150,41 +165,61 @@ namespace dmRender
         uint32_t                m_CacheHeight;
         void*                   m_GlyphData;
 
-        Glyph**                 m_Cache;
-        uint32_t                m_CacheCursor;
+        // The glyph cache is packed in shelves, and evicted a shelf at a time in least recently used order.
+        // Glyphs added to the cache are written to a CPU side copy of the texture, and the rows that changed
+        // are uploaded once per batch (see UpdateCacheTexture)
+        dmArray<GlyphCacheShelf> m_CacheShelves;
+        dmArray<Glyph*>         m_CacheGlyphs;          // The glyphs currently in the cache
+        dmArray<uint16_t>       m_CacheGlyphShelves;    // The shelf of each glyph in m_CacheGlyphs
+        dmArray<Glyph*>         m_PendingGlyphs;        // Glyphs added to the cache, but not yet written to m_CacheData
+        uint8_t*                m_CacheData;
+        uint32_t                m_CacheChannels;
+        uint32_t                m_CacheShelvesHeight;   // Where the next shelf goes
+        uint32_t                m_CacheDirtyMinY;
+        uint32_t                m_CacheDirtyMaxY;
         dmGraphics::TextureFormat m_CacheFormat;
         dmGraphics::TextureFilter m_MinFilter;
         dmGraphics::TextureFilter m_MagFilter;
 
-        uint32_t                m_CacheColumns;
-        uint32_t                m_CacheRows;
-
         uint8_t*                m_CellTempData; // a temporary unpack buffer for the compressed glyphs
 
         uint32_t                m_CacheCellWidth;
         uint32_t                m_CacheCellHeight;
-        uint32_t                m_CacheCellMaxAscent;
         uint8_t                 m_CacheCellPadding;
         uint8_t                 m_LayerMask;
         uint8_t                 m_IsMonospaced:1;
         uint8_t                 m_Padding:7;
+
+        // Changed whenever the glyphs are replaced, invalidating any cached text layouts
+        uint32_t                m_LayoutVersion;
     };
 
+    // Unique across all font maps, so that a new font map allocated at the address of a
+    // deleted one doesn't match the text layouts cached for the old one
+    static uint32_t g_FontMapLayoutVersion = 0;
+
     static float GetLineTextMetrics(HFontMap font_map, float tracking, const char* text, int n, bool measure_trailing_space);
 
-    static void InitFontmap(FontMapParams& params, dmGraphics::TextureParams& tex_params, uint8_t init_val)
+    // (Re)creates the empty glyph cache, and sets it as the texture data
+    static void InitFontmapCache(HFontMap font_map, FontMapParams& params, dmGraphics::TextureParams& tex_params)
     {
-        uint8_t bpp = params.m_GlyphChannels;
-        uint32_t data_size = tex_params.m_Width * tex_params.m_Height * bpp;
-        tex_params.m_Data = malloc(data_size);
+        uint32_t data_size = params.m_CacheWidth * params.m_CacheHeight * params.m_GlyphChannels;
+        if (font_map->m_CacheData) {
+            free(font_map->m_CacheData);
+        }
+        font_map->m_CacheData = (uint8_t*)malloc(data_size);
+        memset(font_map->m_CacheData, 0, data_size);
+        font_map->m_CacheChannels = params.m_GlyphChannels;
+        font_map->m_CacheShelves.SetSize(0);
+        font_map->m_CacheGlyphs.SetSize(0);
+        font_map->m_CacheGlyphShelves.SetSize(0);
+        font_map->m_PendingGlyphs.SetSize(0);
+        font_map->m_CacheShelvesHeight = 0;
+        font_map->m_CacheDirtyMinY = 0;
+        font_map->m_CacheDirtyMaxY = 0;
+
+        tex_params.m_Data = font_map->m_CacheData;
         tex_params.m_DataSize = data_size;
-        memset((void*)tex_params.m_Data, init_val, tex_params.m_DataSize);
-    }
-
-    static void CleanupFontmap(dmGraphics::TextureParams& tex_params)
-    {
-        free((void*)tex_params.m_Data);
-        tex_params.m_DataSize = 0;
     }
 
     // Font maps have no mips, so we need to make sure we use a supported min filter
@@ -233,16 +268,12 @@ namespace dmRender
 
         font_map->m_CacheCellWidth = params.m_CacheCellWidth;
         font_map->m_CacheCellHeight = params.m_CacheCellHeight;
-        font_map->m_CacheCellMaxAscent = params.m_CacheCellMaxAscent;
         font_map->m_CacheCellPadding = params.m_CacheCellPadding;
 
-        font_map->m_CacheColumns = params.m_CacheWidth / params.m_CacheCellWidth;
-        font_map->m_CacheRows = params.m_CacheHeight / params.m_CacheCellHeight;
-        uint32_t cell_count = font_map->m_CacheColumns * font_map->m_CacheRows;
-
         font_map->m_CellTempData = (uint8_t*)malloc(font_map->m_CacheCellWidth*font_map->m_CacheCellHeight*4);
         font_map->m_IsMonospaced = params.m_IsMonospaced;
         font_map->m_Padding = params.m_Padding;
+        font_map->m_LayoutVersion = ++g_FontMapLayoutVersion;
 
         switch (params.m_GlyphChannels)
         {
@@ -273,9 +304,6 @@ namespace dmRender
             font_map->m_MagFilter = dmGraphics::TEXTURE_FILTER_LINEAR;
         }
 
-        font_map->m_Cache = (Glyph**)malloc(sizeof(Glyph*) * cell_count);
-        memset(font_map->m_Cache, 0, sizeof(Glyph*) * cell_count);
-
         // create new texture to be used as a cache
         dmGraphics::TextureCreationParams tex_create_params;
         dmGraphics::TextureParams tex_params;
@@ -293,9 +321,8 @@ namespace dmRender
         tex_params.m_MagFilter = dmGraphics::TEXTURE_FILTER_LINEAR;
         font_map->m_Texture = dmGraphics::NewTexture(graphics_context, tex_create_params);
 
-        InitFontmap(params, tex_params, 0);
+        InitFontmapCache(font_map, params, tex_params);
         dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-        CleanupFontmap(tex_params);
 
         return font_map;
     }
@@ -316,8 +343,7 @@ namespace dmRender
         }
 
         // release previous glyph data bank
-        if (font_map->m_Cache) {
-            free(font_map->m_Cache);
+        if (font_map->m_CellTempData) {
             free(font_map->m_CellTempData);
         }
 
@@ -335,6 +361,7 @@ namespace dmRender
         font_map->m_LayerMask = params.m_LayerMask;
         font_map->m_IsMonospaced = params.m_IsMonospaced;
         font_map->m_Padding = params.m_Padding;
+        font_map->m_LayoutVersion = ++g_FontMapLayoutVersion;
 
         font_map->m_CacheWidth = params.m_CacheWidth;
         font_map->m_CacheHeight = params.m_CacheHeight;
@@ -342,13 +369,8 @@ namespace dmRender
 
         font_map->m_CacheCellWidth = params.m_CacheCellWidth;
         font_map->m_CacheCellHeight = params.m_CacheCellHeight;
-        font_map->m_CacheCellMaxAscent = params.m_CacheCellMaxAscent;
         font_map->m_CacheCellPadding = params.m_CacheCellPadding;
 
-        font_map->m_CacheColumns = params.m_CacheWidth / params.m_CacheCellWidth;
-        font_map->m_CacheRows = params.m_CacheHeight / params.m_CacheCellHeight;
-        uint32_t cell_count = font_map->m_CacheColumns * font_map->m_CacheRows;
-
         font_map->m_CellTempData = (uint8_t*)malloc(font_map->m_CacheCellWidth*font_map->m_CacheCellHeight*4);
 
         switch (params.m_GlyphChannels)
@@ -368,9 +390,6 @@ namespace dmRender
                 return;
         };
 
-        font_map->m_Cache = (Glyph**)malloc(sizeof(Glyph*) * cell_count);
-        memset(font_map->m_Cache, 0, sizeof(Glyph*) * cell_count);
-
         dmGraphics::TextureParams tex_params;
         tex_params.m_Format = font_map->m_CacheFormat;
         tex_params.m_Data = 0x0;
@@ -378,9 +397,8 @@ namespace dmRender
         tex_params.m_Width = params.m_CacheWidth;
         tex_params.m_Height = params.m_CacheHeight;
 
-        InitFontmap(params, tex_params, 0);
+        InitFontmapCache(font_map, params, tex_params);
         dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-        CleanupFontmap(tex_params);
     }
 
     void SetFontMapUserData(HFontMap font_map, void* user_data)
@@ -420,6 +438,7 @@ namespace dmRender
         text_context.m_ClientBuffer = 0x0;
         text_context.m_VertexIndex = 0;
         text_context.m_VerticesFlushed = 0;
+        text_context.m_RenderObjectsFlushed = 0;
         text_context.m_Frame = 0;
         text_context.m_PreviousFrame = ~0;
         text_context.m_TextEntriesFlushed = 0;
@@ -440,7 +459,6 @@ namespace dmRender
         dmGraphics::AddVertexStream(stream_declaration, "layer_mask", 3, dmGraphics::TYPE_FLOAT, false);
 
         text_context.m_VertexDecl = dmGraphics::NewVertexDeclaration(render_context->m_GraphicsContext, stream_declaration, sizeof(GlyphVertex));
-        text_context.m_VertexBuffer = dmGraphics::NewVertexBuffer(render_context->m_GraphicsContext, buffer_size, 0x0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
 
         dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
 
@@ -453,13 +471,15 @@ namespace dmRender
         // NOTE: 8 is "arbitrary" heuristic
         text_context.m_TextEntries.SetCapacity(max_characters / 8);
 
+        uint32_t max_text_layouts = dmMath::Max(1U, max_characters / 8);
+        text_context.m_TextLayouts.SetCapacity(dmMath::Max(1U, (2 * max_text_layouts) / 3), max_text_layouts);
+
         for (uint32_t i = 0; i < text_context.m_RenderObjects.Capacity(); ++i)
         {
             RenderObject ro;
             ro.m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_SRC_ALPHA;
             ro.m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
             ro.m_SetBlendFactors = 1;
-            ro.m_VertexBuffer = text_context.m_VertexBuffer;
             ro.m_VertexDeclaration = text_context.m_VertexDecl;
             ro.m_PrimitiveType = dmGraphics::PRIMITIVE_TRIANGLES;
             text_context.m_RenderObjects.Push(ro);
@@ -475,8 +495,9 @@ namespace dmRender
             dmRender::DeleteNamedConstantBuffer(text_context.m_ConstantBuffers[i]);
         }
         dmMemory::AlignedFree(text_context.m_ClientBuffer);
-        dmGraphics::DeleteVertexBuffer(text_context.m_VertexBuffer);
         dmGraphics::DeleteVertexDeclaration(text_context.m_VertexDecl);
+
+        PurgeTextLayouts(text_context, 0);
     }
 
     DrawTextParams::DrawTextParams()
@@ -513,6 +534,7 @@ namespace dmRender
     };
 
     static dmhash_t g_TextureSizeRecipHash = dmHashString64("texture_size_recip");
+    static dmhash_t g_TransientCategoryText = dmHashString64("text");
 
     static dmVMath::Point3 CalcCenterPoint(HFontMap font_map, const TextEntry& te, const TextMetrics& metrics) {
         float x_offset = OffsetX(te.m_Align, te.m_Width);
@@ -644,89 +666,241 @@ namespace dmRender
         return true;
     }
 
-    void AddGlyphToCache(HFontMap font_map, TextContext& text_context, Glyph* g, int16_t g_offset_y) {
-        uint32_t prev_cache_cursor = font_map->m_CacheCursor;
-        dmGraphics::TextureParams tex_params;
-        tex_params.m_SubUpdate = true;
-        tex_params.m_MipMap = 0;
-        tex_params.m_Format = font_map->m_CacheFormat;
-        tex_params.m_MinFilter = font_map->m_MinFilter;
-        tex_params.m_MagFilter = font_map->m_MagFilter;
+    static void MarkCacheDirty(HFontMap font_map, uint32_t y, uint32_t height)
+    {
+        if (font_map->m_CacheDirtyMinY == font_map->m_CacheDirtyMaxY)
+        {
+            font_map->m_CacheDirtyMinY = y;
+            font_map->m_CacheDirtyMaxY = y + height;
+        }
+        else
+        {
+            font_map->m_CacheDirtyMinY = dmMath::Min(font_map->m_CacheDirtyMinY, y);
+            font_map->m_CacheDirtyMaxY = dmMath::Max(font_map->m_CacheDirtyMaxY, y + height);
+        }
+    }
 
-        // Locate a cache cell candidate
-        do {
-            uint32_t cur = font_map->m_CacheCursor++;
-            Glyph* candidate = font_map->m_Cache[cur];
-            font_map->m_CacheCursor = font_map->m_CacheCursor % (font_map->m_CacheColumns * font_map->m_CacheRows);
-            if (candidate == 0x0 || text_context.m_Frame != candidate->m_Frame) {
+    // Evicts the least recently used shelf that isn't used in the current frame, and can fit the glyph
+    static int EvictCacheShelf(HFontMap font_map, uint32_t frame, uint32_t height)
+    {
+        uint32_t shelf_count = font_map->m_CacheShelves.Size();
+        dmArray<uint32_t> last_used;
+        last_used.SetCapacity(shelf_count);
+        last_used.SetSize(shelf_count);
+        memset(last_used.Begin(), 0, sizeof(uint32_t) * shelf_count);
+
+        // Shelves used this frame are skipped, so a glyph that is never used again keeps its shelf
+        // until everything else in the shelf is unused as well
+        for (uint32_t i = 0; i < font_map->m_CacheGlyphs.Size(); ++i)
+        {
+            uint32_t& shelf_frame = last_used[font_map->m_CacheGlyphShelves[i]];
+            uint32_t glyph_frame = font_map->m_CacheGlyphs[i]->m_Frame;
+            if (glyph_frame == frame || shelf_frame == frame)
+                shelf_frame = frame;
+            else
+                shelf_frame = dmMath::Max(shelf_frame, glyph_frame);
+        }
 
-                if (candidate) {
-                    candidate->m_InCache = false;
-                }
-                font_map->m_Cache[cur] = g;
+        int victim = -1;
+        for (uint32_t i = 0; i < shelf_count; ++i)
+        {
+            const GlyphCacheShelf& shelf = font_map->m_CacheShelves[i];
+            if (shelf.m_Height < height || last_used[i] == frame)
+                continue;
+            if (victim < 0 || last_used[i] < last_used[victim] ||
+                (last_used[i] == last_used[victim] && shelf.m_Height < font_map->m_CacheShelves[victim].m_Height))
+            {
+                victim = (int)i;
+            }
+        }
 
-                uint32_t col = cur % font_map->m_CacheColumns;
-                uint32_t row = cur / font_map->m_CacheColumns;
+        if (victim < 0)
+            return -1;
 
-                g->m_X = col * font_map->m_CacheCellWidth;
-                g->m_Y = row * font_map->m_CacheCellHeight;
-                g->m_Frame = text_context.m_Frame;
-                g->m_InCache = true;
-
-                // Upload glyph data to GPU
-                tex_params.m_Width = g->m_Width + font_map->m_CacheCellPadding*2;
-                tex_params.m_Height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
-
-                uint8_t* glyph_data = (uint8_t*)(uint8_t*)font_map->m_GlyphData + g->m_GlyphDataOffset;
-                uint32_t glyph_data_size = g->m_GlyphDataSize-1; // The first byte is a header
-                uint8_t is_compressed = *glyph_data++;
-
-                if (is_compressed) {
-
-                    // When if came to choosing between the different algorithms, here are some speed/compression tests
-                    // Decoding 100 glyphs
-                    // lz4:     0.1060 ms  compression: 72%
-                    // deflate: 0.2190 ms  compression: 66%
-                    // png:     0.6930 ms  compression: 67%
-                    // webp:    1.5170 ms  compression: 55%
-                    // further improvements (different test, Android, 92 glyphs)
-                    // webp          2.9440 ms  compression: 55%
-                    // deflate       0.7110 ms  compression: 66%
-                    // deflate+delta 0.7680 ms  compression: 62%
-
-                    FontGlyphInflaterContext deflate_context;
-                    deflate_context.m_Output = font_map->m_CellTempData;
-                    deflate_context.m_Cursor = 0;
-                    dmZlib::Result zlib_result = dmZlib::InflateBuffer(glyph_data, glyph_data_size, &deflate_context, FontGlyphInflater);
-                    if (zlib_result != dmZlib::RESULT_OK)
-                    {
-                        dmLogError("Failed to decompress glyph (%c)", g->m_Character);
-                        return;
-                    }
+        for (uint32_t i = font_map->m_CacheGlyphs.Size(); i > 0; --i)
+        {
+            if (font_map->m_CacheGlyphShelves[i-1] == victim)
+            {
+                font_map->m_CacheGlyphs[i-1]->m_InCache = false;
+                font_map->m_CacheGlyphs.EraseSwap(i-1);
+                font_map->m_CacheGlyphShelves.EraseSwap(i-1);
+            }
+        }
 
-                    uint32_t uncompressed_size = deflate_context.m_Cursor;
-                    delta_decode(font_map->m_CellTempData, uncompressed_size);
+        // Clear the old glyphs, so they don't show up in the gutters of the new ones
+        GlyphCacheShelf& shelf = font_map->m_CacheShelves[victim];
+        uint32_t stride = font_map->m_CacheWidth * font_map->m_CacheChannels;
+        memset(font_map->m_CacheData + shelf.m_Y * stride, 0, shelf.m_Height * stride);
+        MarkCacheDirty(font_map, shelf.m_Y, shelf.m_Height);
+        shelf.m_X = 0;
+        return victim;
+    }
 
-                    tex_params.m_Data = font_map->m_CellTempData;
-                } else {
-                    tex_params.m_Data = glyph_data;
-                }
+    static int FindCacheShelf(HFontMap font_map, uint32_t frame, uint32_t width, uint32_t height)
+    {
+        if (width > font_map->m_CacheWidth || height > font_map->m_CacheHeight)
+            return -1;
 
-                tex_params.m_X = g->m_X;
-                tex_params.m_Y = g->m_Y + g_offset_y;
+        // The lowest shelf with room for the glyph
+        int best = -1;
+        for (uint32_t i = 0; i < font_map->m_CacheShelves.Size(); ++i)
+        {
+            const GlyphCacheShelf& shelf = font_map->m_CacheShelves[i];
+            if (shelf.m_Height < height || shelf.m_X + width > font_map->m_CacheWidth)
+                continue;
+            if (best < 0 || shelf.m_Height < font_map->m_CacheShelves[best].m_Height)
+                best = (int)i;
+        }
 
-                dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-                break;
+        uint32_t shelf_height = DM_ALIGN(height, CACHE_SHELF_ALIGNMENT);
+        // Prefer opening a new shelf over wasting more than half of an existing one
+        if (best >= 0 && font_map->m_CacheShelves[best].m_Height <= shelf_height * 2)
+            return best;
+
+        if (font_map->m_CacheShelvesHeight + shelf_height <= font_map->m_CacheHeight)
+        {
+            GlyphCacheShelf shelf;
+            shelf.m_Y = (uint16_t)font_map->m_CacheShelvesHeight;
+            shelf.m_Height = (uint16_t)shelf_height;
+            shelf.m_X = 0;
+            if (font_map->m_CacheShelves.Full())
+                font_map->m_CacheShelves.OffsetCapacity(16);
+            font_map->m_CacheShelves.Push(shelf);
+            font_map->m_CacheShelvesHeight += shelf_height + CACHE_GLYPH_GUTTER;
+            return (int)font_map->m_CacheShelves.Size() - 1;
+        }
+
+        if (best >= 0)
+            return best;
+
+        return EvictCacheShelf(font_map, frame, height);
+    }
+
+    // Reserves space for the glyph in the cache. The glyph data is written to the texture in UpdateCacheTexture()
+    void AddGlyphToCache(HFontMap font_map, TextContext& text_context, Glyph* g)
+    {
+        uint32_t width = g->m_Width + font_map->m_CacheCellPadding*2;
+        uint32_t height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
+
+        int shelf_index = FindCacheShelf(font_map, text_context.m_Frame, width, height);
+        if (shelf_index < 0)
+        {
+            dmLogError("Out of available cache space! Consider increasing cache_width or cache_height for the font.");
+            return;
+        }
+
+        GlyphCacheShelf& shelf = font_map->m_CacheShelves[shelf_index];
+        g->m_X = shelf.m_X;
+        g->m_Y = shelf.m_Y;
+        g->m_Frame = text_context.m_Frame;
+        g->m_InCache = true;
+        shelf.m_X = (uint16_t)dmMath::Min(shelf.m_X + width + CACHE_GLYPH_GUTTER, font_map->m_CacheWidth);
+
+        if (font_map->m_CacheGlyphs.Full())
+        {
+            uint32_t grow = dmMath::Max(64U, font_map->m_CacheGlyphs.Capacity() / 2);
+            font_map->m_CacheGlyphs.OffsetCapacity(grow);
+            font_map->m_CacheGlyphShelves.OffsetCapacity(grow);
+        }
+        font_map->m_CacheGlyphs.Push(g);
+        font_map->m_CacheGlyphShelves.Push((uint16_t)shelf_index);
+
+        if (font_map->m_PendingGlyphs.Full())
+            font_map->m_PendingGlyphs.OffsetCapacity(dmMath::Max(64U, font_map->m_PendingGlyphs.Capacity() / 2));
+        font_map->m_PendingGlyphs.Push(g);
+    }
+
+    static void WriteGlyphToCache(HFontMap font_map, Glyph* g)
+    {
+        uint32_t width = g->m_Width + font_map->m_CacheCellPadding*2;
+        uint32_t height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
+
+        uint8_t* glyph_data = (uint8_t*)font_map->m_GlyphData + g->m_GlyphDataOffset;
+        uint32_t glyph_data_size = g->m_GlyphDataSize-1; // The first byte is a header
+        uint8_t is_compressed = *glyph_data++;
+
+        if (is_compressed) {
+
+            // When if came to choosing between the different algorithms, here are some speed/compression tests
+            // Decoding 100 glyphs
+            // lz4:     0.1060 ms  compression: 72%
+            // deflate: 0.2190 ms  compression: 66%
+            // png:     0.6930 ms  compression: 67%
+            // webp:    1.5170 ms  compression: 55%
+            // further improvements (different test, Android, 92 glyphs)
+            // webp          2.9440 ms  compression: 55%
+            // deflate       0.7110 ms  compression: 66%
+            // deflate+delta 0.7680 ms  compression: 62%
+
+            FontGlyphInflaterContext deflate_context;
+            deflate_context.m_Output = font_map->m_CellTempData;
+            deflate_context.m_Cursor = 0;
+            dmZlib::Result zlib_result = dmZlib::InflateBuffer(glyph_data, glyph_data_size, &deflate_context, FontGlyphInflater);
+            if (zlib_result != dmZlib::RESULT_OK)
+            {
+                dmLogError("Failed to decompress glyph (%c)", g->m_Character);
+                return;
             }
 
-        } while (prev_cache_cursor != font_map->m_CacheCursor);
+            uint32_t uncompressed_size = deflate_context.m_Cursor;
+            delta_decode(font_map->m_CellTempData, uncompressed_size);
+
+            glyph_data = font_map->m_CellTempData;
+        }
 
-        if (prev_cache_cursor == font_map->m_CacheCursor) {
-            dmLogError("Out of available cache cells! Consider increasing cache_width or cache_height for the font.");
+        uint32_t channels = font_map->m_CacheChannels;
+        uint32_t stride = font_map->m_CacheWidth * channels;
+        uint8_t* dst = font_map->m_CacheData + g->m_Y * stride + g->m_X * channels;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            memcpy(dst + y * stride, glyph_data + y * width * channels, width * channels);
         }
+        MarkCacheDirty(font_map, g->m_Y, height);
     }
 
-    static int CreateFontVertexDataInternal(TextContext& text_context, HFontMap font_map, const char* text, const TextEntry& te, float recip_w, float recip_h, GlyphVertex* vertices, uint32_t num_vertices)
+    // Writes the glyphs added since the last update to the cache, and uploads the changed rows as a single texture update
+    static void UpdateCacheTexture(HFontMap font_map)
+    {
+        if (font_map->m_PendingGlyphs.Empty() && font_map->m_CacheDirtyMinY == font_map->m_CacheDirtyMaxY)
+            return;
+
+        DM_PROFILE("UpdateGlyphCache");
+
+        uint32_t pending_count = font_map->m_PendingGlyphs.Size();
+        for (uint32_t i = 0; i < pending_count; ++i)
+        {
+            Glyph* g = font_map->m_PendingGlyphs[i];
+            if (g->m_InCache)
+            {
+                WriteGlyphToCache(font_map, g);
+            }
+        }
+        font_map->m_PendingGlyphs.SetSize(0);
+        DM_PROPERTY_ADD_U32(rmtp_FontGlyphUploads, pending_count);
+
+        uint32_t min_y = font_map->m_CacheDirtyMinY;
+        uint32_t max_y = dmMath::Min(font_map->m_CacheDirtyMaxY, font_map->m_CacheHeight);
+        font_map->m_CacheDirtyMinY = font_map->m_CacheDirtyMaxY = 0;
+        if (min_y >= max_y)
+            return;
+
+        // Whole rows, so that the data is contiguous in the cache
+        dmGraphics::TextureParams tex_params;
+        tex_params.m_SubUpdate = true;
+        tex_params.m_MipMap = 0;
+        tex_params.m_Format = font_map->m_CacheFormat;
+        tex_params.m_MinFilter = font_map->m_MinFilter;
+        tex_params.m_MagFilter = font_map->m_MagFilter;
+        tex_params.m_X = 0;
+        tex_params.m_Y = min_y;
+        tex_params.m_Width = font_map->m_CacheWidth;
+        tex_params.m_Height = max_y - min_y;
+        tex_params.m_Data = font_map->m_CacheData + min_y * font_map->m_CacheWidth * font_map->m_CacheChannels;
+        tex_params.m_DataSize = tex_params.m_Width * tex_params.m_Height * font_map->m_CacheChannels;
+        dmGraphics::SetTexture(font_map->m_Texture, tex_params);
+    }
+
+    static void CreateTextLayout(HFontMap font_map, const char* text, const TextEntry& te, TextLayout* layout)
     {
         float width = te.m_Width;
         if (!te.m_LineBreak) {
@@ -755,6 +929,129 @@ namespace dmRender
         }
         float y_offset = OffsetY(te.m_VAlign, te.m_Height, font_map->m_MaxAscent, font_map->m_MaxDescent, te.m_Leading, line_count);
 
+        layout->m_Glyphs.SetSize(0);
+        layout->m_Version = font_map->m_LayoutVersion;
+
+        for (int line = 0; line < line_count; ++line) {
+            TextLine& l = lines[line];
+            float x = x_offset - OffsetX(te.m_Align, l.m_Width);
+            float y = y_offset - line * leading;
+            const char* cursor = &text[l.m_Index];
+            int n = l.m_Count;
+            for (int j = 0; j < n; ++j)
+            {
+                uint32_t c = dmUtf8::NextChar(&cursor);
+
+                Glyph* g =  GetGlyph(font_map, c);
+                if (!g) {
+                    continue;
+                }
+
+                // Glyphs without width (e.g. spaces) only advance the cursor
+                if (g->m_Width > 0)
+                {
+                    if (layout->m_Glyphs.Full()) {
+                        layout->m_Glyphs.OffsetCapacity(dmMath::Max(16U, layout->m_Glyphs.Capacity() / 2));
+                    }
+                    TextLayoutGlyph lg;
+                    lg.m_Glyph = g;
+                    lg.m_X = x + g->m_LeftBearing;
+                    lg.m_Y = y;
+                    layout->m_Glyphs.Push(lg);
+                }
+                x += g->m_Advance + tracking;
+            }
+        }
+    }
+
+    const TextLayout* GetTextLayout(TextContext& text_context, const TextEntry& te, const char* text)
+    {
+        HFontMap font_map = te.m_FontMap;
+
+        // Everything the positions of the glyphs depend on, except the glyphs themselves (see m_LayoutVersion)
+        HashState64 key_state;
+        dmHashInit64(&key_state, false);
+        dmHashUpdateBuffer64(&key_state, &font_map, sizeof(font_map));
+        dmHashUpdateBuffer64(&key_state, &te.m_Width, sizeof(te.m_Width));
+        dmHashUpdateBuffer64(&key_state, &te.m_Height, sizeof(te.m_Height));
+        dmHashUpdateBuffer64(&key_state, &te.m_Leading, sizeof(te.m_Leading));
+        dmHashUpdateBuffer64(&key_state, &te.m_Tracking, sizeof(te.m_Tracking));
+        uint8_t flags[3] = { (uint8_t)te.m_LineBreak, (uint8_t)te.m_Align, (uint8_t)te.m_VAlign };
+        dmHashUpdateBuffer64(&key_state, flags, sizeof(flags));
+        dmHashUpdateBuffer64(&key_state, text, strlen(text));
+        dmhash_t key = dmHashFinal64(&key_state);
+
+        TextLayout* layout = 0;
+        TextLayout** layoutp = text_context.m_TextLayouts.Get(key);
+        if (layoutp)
+        {
+            layout = *layoutp;
+            if (layout->m_Version == font_map->m_LayoutVersion)
+            {
+                layout->m_Frame = text_context.m_Frame;
+                return layout;
+            }
+        }
+        else if (!text_context.m_TextLayouts.Full())
+        {
+            layout = new TextLayout;
+            text_context.m_TextLayouts.Put(key, layout);
+        }
+        else
+        {
+            // The cache is full until the unused layouts are purged, so lay out the text without caching it
+            layout = &text_context.m_TempTextLayout;
+        }
+
+        DM_PROFILE("CreateTextLayout");
+        CreateTextLayout(font_map, text, te, layout);
+        layout->m_Frame = text_context.m_Frame;
+        return layout;
+    }
+
+    struct PurgeTextLayoutsContext
+    {
+        dmArray<dmhash_t>* m_Keys;
+        uint32_t           m_Frame;
+        uint32_t           m_MaxAge;
+    };
+
+    static void CollectUnusedTextLayouts(PurgeTextLayoutsContext* context, const dmhash_t* key, TextLayout** layout)
+    {
+        if (context->m_Frame - (*layout)->m_Frame >= context->m_MaxAge)
+        {
+            context->m_Keys->Push(*key);
+        }
+    }
+
+    void PurgeTextLayouts(TextContext& text_context, uint32_t max_age)
+    {
+        if (text_context.m_TextLayouts.Empty())
+            return;
+
+        dmArray<dmhash_t> keys;
+        keys.SetCapacity(text_context.m_TextLayouts.Size());
+
+        PurgeTextLayoutsContext context;
+        context.m_Keys = &keys;
+        context.m_Frame = text_context.m_Frame;
+        context.m_MaxAge = max_age;
+        text_context.m_TextLayouts.Iterate(CollectUnusedTextLayouts, &context);
+
+        for (uint32_t i = 0; i < keys.Size(); ++i)
+        {
+            TextLayout** layout = text_context.m_TextLayouts.Get(keys[i]);
+            delete *layout;
+            text_context.m_TextLayouts.Erase(keys[i]);
+        }
+    }
+
+    static int CreateFontVertexDataInternal(TextContext& text_context, HFontMap font_map, const char* text, const TextEntry& te, float recip_w, float recip_h, GlyphVertex* vertices, uint32_t num_vertices)
+    {
+        const TextLayout* layout = GetTextLayout(text_context, te, text);
+        const TextLayoutGlyph* layout_glyphs = layout->m_Glyphs.Begin();
+        const uint32_t layout_glyph_count = layout->m_Glyphs.Size();
+
         const Vector4 face_color    = dmGraphics::UnpackRGBA(te.m_FaceColor);
         const Vector4 outline_color = dmGraphics::UnpackRGBA(te.m_OutlineColor);
         const Vector4 shadow_color  = dmGraphics::UnpackRGBA(te.m_ShadowColor);
@@ -790,246 +1087,205 @@ namespace dmRender
         // * For the layered approach, we need to place vertices in sorted order from
         //     back to front layer in the order of shadow -> outline -> face, where the offset of each
         //     layer depends on how many glyphs we actually can place in the buffer. To get a valid count, we
-        //     do a dry run first over the input string and place glyphs in the cache if they are renderable.
+        //     do a dry run first over the laid out glyphs and place them in the cache if they are renderable.
         if (HAS_LAYER(layer_mask,OUTLINE) || HAS_LAYER(layer_mask,SHADOW))
         {
             layer_count += HAS_LAYER(layer_mask,OUTLINE) + HAS_LAYER(layer_mask,SHADOW);
 
             // Calculate number of valid glyphs
-            for (int line = 0; line < line_count; ++line)
+            for (uint32_t i = 0; i < layout_glyph_count; ++i)
             {
-                TextLine& l = lines[line];
-                const char* cursor = &text[l.m_Index];
-                bool inner_break = false;
+                Glyph* g = layout_glyphs[i].m_Glyph;
 
-                for (int j = 0; j < l.m_Count; ++j)
+                if ((vertexindex + vertices_per_quad) * layer_count > num_vertices)
                 {
-                    uint32_t c = dmUtf8::NextChar(&cursor);
-                    Glyph* g   = GetGlyph(font_map, c);
-
-                    if (!g)
-                    {
-                        continue;
-                    }
-
-                    if ((vertexindex + vertices_per_quad) * layer_count > num_vertices)
-                    {
-                        inner_break = true;
-                        break;
-                    }
-
-                    if (g->m_Width > 0)
-                    {
-                        int16_t px_cell_offset_y = font_map->m_CacheCellMaxAscent - (int16_t)g->m_Ascent;
-
-                        // Prepare the cache here aswell since we only count glyphs we definitely
-                        // will render.
-                        if (!g->m_InCache)
-                        {
-                            AddGlyphToCache(font_map, text_context, g, px_cell_offset_y);
-                        }
-
-                        if (g->m_InCache)
-                        {
-                            valid_glyph_count++;
+                    break;
+                }
 
-                            vertexindex += vertices_per_quad;
-                        }
-                    }
+                // Prepare the cache here aswell since we only count glyphs we definitely
+                // will render.
+                if (!g->m_InCache)
+                {
+                    AddGlyphToCache(font_map, text_context, g);
                 }
 
-                if (inner_break)
+                if (g->m_InCache)
                 {
-                    break;
+                    valid_glyph_count++;
+
+                    vertexindex += vertices_per_quad;
                 }
             }
 
             vertexindex = 0;
         }
 
-        for (int line = 0; line < line_count; ++line) {
-            TextLine& l = lines[line];
-            float x = x_offset - OffsetX(te.m_Align, l.m_Width);
-            float y = y_offset - line * leading;
-            const char* cursor = &text[l.m_Index];
-            int n = l.m_Count;
-            for (int j = 0; j < n; ++j)
+        for (uint32_t i = 0; i < layout_glyph_count; ++i)
+        {
+            Glyph* g = layout_glyphs[i].m_Glyph;
+            float x  = layout_glyphs[i].m_X;
+            float y  = layout_glyphs[i].m_Y;
+
+            // Look ahead and see if we can produce vertices for the next glyph or not
+            if ((vertexindex + vertices_per_quad) * layer_count > num_vertices)
             {
-                uint32_t c = dmUtf8::NextChar(&cursor);
+                dmLogWarning("Character buffer exceeded (size: %d), increase the \"graphics.max_characters\" property in your game.project file.", num_vertices / 6);
+                return vertexindex * layer_count;
+            }
 
-                Glyph* g =  GetGlyph(font_map, c);
-                if (!g) {
-                    continue;
-                }
+            int16_t width   = (int16_t) g->m_Width;
+            int16_t descent = (int16_t) g->m_Descent;
+            int16_t ascent  = (int16_t) g->m_Ascent;
 
-                // Look ahead and see if we can produce vertices for the next glyph or not
-                if ((vertexindex + vertices_per_quad) * layer_count > num_vertices)
+            if (!g->m_InCache) {
+                AddGlyphToCache(font_map, text_context, g);
+            }
+
+            if (g->m_InCache) {
+                g->m_Frame = text_context.m_Frame;
+
+                uint32_t face_index = vertexindex + vertices_per_quad * valid_glyph_count * (layer_count-1);
+
+                // Set face vertices first, this will always hold since we can't have less than 1 layer
+                GlyphVertex& v1_layer_face = vertices[face_index];
+                GlyphVertex& v2_layer_face = vertices[face_index + 1];
+                GlyphVertex& v3_layer_face = vertices[face_index + 2];
+                GlyphVertex& v4_layer_face = vertices[face_index + 3];
+                GlyphVertex& v5_layer_face = vertices[face_index + 4];
+                GlyphVertex& v6_layer_face = vertices[face_index + 5];
+
+                (Vector4&) v1_layer_face.m_Position = te.m_Transform * Vector4(x, y - descent, 0, 1);
+                (Vector4&) v2_layer_face.m_Position = te.m_Transform * Vector4(x, y + ascent, 0, 1);
+                (Vector4&) v3_layer_face.m_Position = te.m_Transform * Vector4(x + width, y - descent, 0, 1);
+                (Vector4&) v6_layer_face.m_Position = te.m_Transform * Vector4(x + width, y + ascent, 0, 1);
+
+                v1_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding) * recip_w;
+                v1_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent) * recip_h;
+
+                v2_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding) * recip_w;
+                v2_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding) * recip_h;
+
+                v3_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding + g->m_Width) * recip_w;
+                v3_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent) * recip_h;
+
+                v6_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding + g->m_Width) * recip_w;
+                v6_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding) * recip_h;
+
+                #define SET_VERTEX_FONT_PROPERTIES(v) \
+                    v.m_FaceColor[0]    = face_color[0]; \
+                    v.m_FaceColor[1]    = face_color[1]; \
+                    v.m_FaceColor[2]    = face_color[2]; \
+                    v.m_FaceColor[3]    = face_color[3]; \
+                    v.m_OutlineColor[0] = outline_color[0]; \
+                    v.m_OutlineColor[1] = outline_color[1]; \
+                    v.m_OutlineColor[2] = outline_color[2]; \
+                    v.m_OutlineColor[3] = outline_color[3]; \
+                    v.m_ShadowColor[0]  = shadow_color[0]; \
+                    v.m_ShadowColor[1]  = shadow_color[1]; \
+                    v.m_ShadowColor[2]  = shadow_color[2]; \
+                    v.m_ShadowColor[3]  = shadow_color[3]; \
+                    v.m_FaceColor[0]    = face_color[0]; \
+                    v.m_FaceColor[1]    = face_color[1]; \
+                    v.m_FaceColor[2]    = face_color[2]; \
+                    v.m_FaceColor[3]    = face_color[3]; \
+                    v.m_SdfParams[0]    = sdf_edge_value; \
+                    v.m_SdfParams[1]    = sdf_outline; \
+                    v.m_SdfParams[2]    = sdf_smoothing; \
+                    v.m_SdfParams[3]    = sdf_shadow;
+
+                SET_VERTEX_FONT_PROPERTIES(v1_layer_face)
+                SET_VERTEX_FONT_PROPERTIES(v2_layer_face)
+                SET_VERTEX_FONT_PROPERTIES(v3_layer_face)
+                SET_VERTEX_FONT_PROPERTIES(v6_layer_face)
+
+                #undef SET_VERTEX_FONT_PROPERTIES
+
+                v4_layer_face = v3_layer_face;
+                v5_layer_face = v2_layer_face;
+
+                #define SET_VERTEX_LAYER_MASK(v,f,o,s) \
+                    v.m_LayerMasks[0] = f; \
+                    v.m_LayerMasks[1] = o; \
+                    v.m_LayerMasks[2] = s;
+
+                // Set outline vertices
+                if (HAS_LAYER(layer_mask,OUTLINE))
                 {
-                    dmLogWarning("Character buffer exceeded (size: %d), increase the \"graphics.max_characters\" property in your game.project file.", num_vertices / 6);
-                    return vertexindex * layer_count;
+                    uint32_t outline_index = vertexindex + vertices_per_quad * valid_glyph_count * (layer_count-2);
+
+                    GlyphVertex& v1_layer_outline = vertices[outline_index];
+                    GlyphVertex& v2_layer_outline = vertices[outline_index + 1];
+                    GlyphVertex& v3_layer_outline = vertices[outline_index + 2];
+                    GlyphVertex& v4_layer_outline = vertices[outline_index + 3];
+                    GlyphVertex& v5_layer_outline = vertices[outline_index + 4];
+                    GlyphVertex& v6_layer_outline = vertices[outline_index + 5];
+
+                    v1_layer_outline = v1_layer_face;
+                    v2_layer_outline = v2_layer_face;
+                    v3_layer_outline = v3_layer_face;
+                    v4_layer_outline = v4_layer_face;
+                    v5_layer_outline = v5_layer_face;
+                    v6_layer_outline = v6_layer_face;
+
+                    SET_VERTEX_LAYER_MASK(v1_layer_outline,0,1,0)
+                    SET_VERTEX_LAYER_MASK(v2_layer_outline,0,1,0)
+                    SET_VERTEX_LAYER_MASK(v3_layer_outline,0,1,0)
+                    SET_VERTEX_LAYER_MASK(v4_layer_outline,0,1,0)
+                    SET_VERTEX_LAYER_MASK(v5_layer_outline,0,1,0)
+                    SET_VERTEX_LAYER_MASK(v6_layer_outline,0,1,0)
                 }
 
-                if (g->m_Width > 0)
+                // Set shadow vertices
+                if (HAS_LAYER(layer_mask,SHADOW))
                 {
-                    int16_t width   = (int16_t) g->m_Width;
-                    int16_t descent = (int16_t) g->m_Descent;
-                    int16_t ascent  = (int16_t) g->m_Ascent;
-
-                    // Calculate y-offset in cache-cell space by moving glyphs down to baseline
-                    int16_t px_cell_offset_y = font_map->m_CacheCellMaxAscent - ascent;
-
-                    if (!g->m_InCache) {
-                        AddGlyphToCache(font_map, text_context, g, px_cell_offset_y);
-                    }
-
-                    if (g->m_InCache) {
-                        g->m_Frame = text_context.m_Frame;
-
-                        uint32_t face_index = vertexindex + vertices_per_quad * valid_glyph_count * (layer_count-1);
-
-                        // Set face vertices first, this will always hold since we can't have less than 1 layer
-                        GlyphVertex& v1_layer_face = vertices[face_index];
-                        GlyphVertex& v2_layer_face = vertices[face_index + 1];
-                        GlyphVertex& v3_layer_face = vertices[face_index + 2];
-                        GlyphVertex& v4_layer_face = vertices[face_index + 3];
-                        GlyphVertex& v5_layer_face = vertices[face_index + 4];
-                        GlyphVertex& v6_layer_face = vertices[face_index + 5];
-
-                        (Vector4&) v1_layer_face.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing, y - descent, 0, 1);
-                        (Vector4&) v2_layer_face.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing, y + ascent, 0, 1);
-                        (Vector4&) v3_layer_face.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing + width, y - descent, 0, 1);
-                        (Vector4&) v6_layer_face.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing + width, y + ascent, 0, 1);
-
-                        v1_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding) * recip_w;
-                        v1_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent + px_cell_offset_y) * recip_h;
-
-                        v2_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding) * recip_w;
-                        v2_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + px_cell_offset_y) * recip_h;
-
-                        v3_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding + g->m_Width) * recip_w;
-                        v3_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent + px_cell_offset_y) * recip_h;
-
-                        v6_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding + g->m_Width) * recip_w;
-                        v6_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + px_cell_offset_y) * recip_h;
-
-                        #define SET_VERTEX_FONT_PROPERTIES(v) \
-                            v.m_FaceColor[0]    = face_color[0]; \
-                            v.m_FaceColor[1]    = face_color[1]; \
-                            v.m_FaceColor[2]    = face_color[2]; \
-                            v.m_FaceColor[3]    = face_color[3]; \
-                            v.m_OutlineColor[0] = outline_color[0]; \
-                            v.m_OutlineColor[1] = outline_color[1]; \
-                            v.m_OutlineColor[2] = outline_color[2]; \
-                            v.m_OutlineColor[3] = outline_color[3]; \
-                            v.m_ShadowColor[0]  = shadow_color[0]; \
-                            v.m_ShadowColor[1]  = shadow_color[1]; \
-                            v.m_ShadowColor[2]  = shadow_color[2]; \
-                            v.m_ShadowColor[3]  = shadow_color[3]; \
-                            v.m_FaceColor[0]    = face_color[0]; \
-                            v.m_FaceColor[1]    = face_color[1]; \
-                            v.m_FaceColor[2]    = face_color[2]; \
-                            v.m_FaceColor[3]    = face_color[3]; \
-                            v.m_SdfParams[0]    = sdf_edge_value; \
-                            v.m_SdfParams[1]    = sdf_outline; \
-                            v.m_SdfParams[2]    = sdf_smoothing; \
-                            v.m_SdfParams[3]    = sdf_shadow;
-
-                        SET_VERTEX_FONT_PROPERTIES(v1_layer_face)
-                        SET_VERTEX_FONT_PROPERTIES(v2_layer_face)
-                        SET_VERTEX_FONT_PROPERTIES(v3_layer_face)
-                        SET_VERTEX_FONT_PROPERTIES(v6_layer_face)
-
-                        #undef SET_VERTEX_FONT_PROPERTIES
-
-                        v4_layer_face = v3_layer_face;
-                        v5_layer_face = v2_layer_face;
-
-                        #define SET_VERTEX_LAYER_MASK(v,f,o,s) \
-                            v.m_LayerMasks[0] = f; \
-                            v.m_LayerMasks[1] = o; \
-                            v.m_LayerMasks[2] = s;
-
-                        // Set outline vertices
-                        if (HAS_LAYER(layer_mask,OUTLINE))
-                        {
-                            uint32_t outline_index = vertexindex + vertices_per_quad * valid_glyph_count * (layer_count-2);
-
-                            GlyphVertex& v1_layer_outline = vertices[outline_index];
-                            GlyphVertex& v2_layer_outline = vertices[outline_index + 1];
-                            GlyphVertex& v3_layer_outline = vertices[outline_index + 2];
-                            GlyphVertex& v4_layer_outline = vertices[outline_index + 3];
-                            GlyphVertex& v5_layer_outline = vertices[outline_index + 4];
-                            GlyphVertex& v6_layer_outline = vertices[outline_index + 5];
-
-                            v1_layer_outline = v1_layer_face;
-                            v2_layer_outline = v2_layer_face;
-                            v3_layer_outline = v3_layer_face;
-                            v4_layer_outline = v4_layer_face;
-                            v5_layer_outline = v5_layer_face;
-                            v6_layer_outline = v6_layer_face;
-
-                            SET_VERTEX_LAYER_MASK(v1_layer_outline,0,1,0)
-                            SET_VERTEX_LAYER_MASK(v2_layer_outline,0,1,0)
-                            SET_VERTEX_LAYER_MASK(v3_layer_outline,0,1,0)
-                            SET_VERTEX_LAYER_MASK(v4_layer_outline,0,1,0)
-                            SET_VERTEX_LAYER_MASK(v5_layer_outline,0,1,0)
-                            SET_VERTEX_LAYER_MASK(v6_layer_outline,0,1,0)
-                        }
-
-                        // Set shadow vertices
-                        if (HAS_LAYER(layer_mask,SHADOW))
-                        {
-                            uint32_t shadow_index = vertexindex;
-                            float shadow_x        = font_map->m_ShadowX;
-                            float shadow_y        = font_map->m_ShadowY;
-
-                            GlyphVertex& v1_layer_shadow = vertices[shadow_index];
-                            GlyphVertex& v2_layer_shadow = vertices[shadow_index + 1];
-                            GlyphVertex& v3_layer_shadow = vertices[shadow_index + 2];
-                            GlyphVertex& v4_layer_shadow = vertices[shadow_index + 3];
-                            GlyphVertex& v5_layer_shadow = vertices[shadow_index + 4];
-                            GlyphVertex& v6_layer_shadow = vertices[shadow_index + 5];
-
-                            v1_layer_shadow = v1_layer_face;
-                            v2_layer_shadow = v2_layer_face;
-                            v3_layer_shadow = v3_layer_face;
-                            v6_layer_shadow = v6_layer_face;
-
-                            // Shadow offsets must be calculated since we need to offset in local space (before vertex transformation)
-                            (Vector4&) v1_layer_shadow.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing + shadow_x, y - descent + shadow_y, 0, 1);
-                            (Vector4&) v2_layer_shadow.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing + shadow_x, y + ascent + shadow_y, 0, 1);
-                            (Vector4&) v3_layer_shadow.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing + shadow_x + width, y - descent + shadow_y, 0, 1);
-                            (Vector4&) v6_layer_shadow.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing + shadow_x + width, y + ascent + shadow_y, 0, 1);
-
-                            v4_layer_shadow = v3_layer_shadow;
-                            v5_layer_shadow = v2_layer_shadow;
-
-                            SET_VERTEX_LAYER_MASK(v1_layer_shadow,0,0,1)
-                            SET_VERTEX_LAYER_MASK(v2_layer_shadow,0,0,1)
-                            SET_VERTEX_LAYER_MASK(v3_layer_shadow,0,0,1)
-                            SET_VERTEX_LAYER_MASK(v4_layer_shadow,0,0,1)
-                            SET_VERTEX_LAYER_MASK(v5_layer_shadow,0,0,1)
-                            SET_VERTEX_LAYER_MASK(v6_layer_shadow,0,0,1)
-                        }
-
-                        // If we only have one layer, we need to set the mask to (1,1,1)
-                        // so that we can use the same calculations for both single and multi.
-                        // The mask is set last for layer 1 since we copy the vertices to
-                        // all other layers to avoid re-calculating their data.
-                        uint8_t is_one_layer = layer_count > 1 ? 0 : 1;
-                        SET_VERTEX_LAYER_MASK(v1_layer_face,1,is_one_layer,is_one_layer)
-                        SET_VERTEX_LAYER_MASK(v2_layer_face,1,is_one_layer,is_one_layer)
-                        SET_VERTEX_LAYER_MASK(v3_layer_face,1,is_one_layer,is_one_layer)
-                        SET_VERTEX_LAYER_MASK(v4_layer_face,1,is_one_layer,is_one_layer)
-                        SET_VERTEX_LAYER_MASK(v5_layer_face,1,is_one_layer,is_one_layer)
-                        SET_VERTEX_LAYER_MASK(v6_layer_face,1,is_one_layer,is_one_layer)
-
-                        #undef SET_VERTEX_LAYER_MASK
-
-                        vertexindex += vertices_per_quad;
-                    }
+                    uint32_t shadow_index = vertexindex;
+                    float shadow_x        = font_map->m_ShadowX;
+                    float shadow_y        = font_map->m_ShadowY;
+
+                    GlyphVertex& v1_layer_shadow = vertices[shadow_index];
+                    GlyphVertex& v2_layer_shadow = vertices[shadow_index + 1];
+                    GlyphVertex& v3_layer_shadow = vertices[shadow_index + 2];
+                    GlyphVertex& v4_layer_shadow = vertices[shadow_index + 3];
+                    GlyphVertex& v5_layer_shadow = vertices[shadow_index + 4];
+                    GlyphVertex& v6_layer_shadow = vertices[shadow_index + 5];
+
+                    v1_layer_shadow = v1_layer_face;
+                    v2_layer_shadow = v2_layer_face;
+                    v3_layer_shadow = v3_layer_face;
+                    v6_layer_shadow = v6_layer_face;
+
+                    // Shadow offsets must be calculated since we need to offset in local space (before vertex transformation)
+                    (Vector4&) v1_layer_shadow.m_Position = te.m_Transform * Vector4(x + shadow_x, y - descent + shadow_y, 0, 1);
+                    (Vector4&) v2_layer_shadow.m_Position = te.m_Transform * Vector4(x + shadow_x, y + ascent + shadow_y, 0, 1);
+                    (Vector4&) v3_layer_shadow.m_Position = te.m_Transform * Vector4(x + shadow_x + width, y - descent + shadow_y, 0, 1);
+                    (Vector4&) v6_layer_shadow.m_Position = te.m_Transform * Vector4(x + shadow_x + width, y + ascent + shadow_y, 0, 1);
+
+                    v4_layer_shadow = v3_layer_shadow;
+                    v5_layer_shadow = v2_layer_shadow;
+
+                    SET_VERTEX_LAYER_MASK(v1_layer_shadow,0,0,1)
+                    SET_VERTEX_LAYER_MASK(v2_layer_shadow,0,0,1)
+                    SET_VERTEX_LAYER_MASK(v3_layer_shadow,0,0,1)
+                    SET_VERTEX_LAYER_MASK(v4_layer_shadow,0,0,1)
+                    SET_VERTEX_LAYER_MASK(v5_layer_shadow,0,0,1)
+                    SET_VERTEX_LAYER_MASK(v6_layer_shadow,0,0,1)
                 }
-                x += g->m_Advance + tracking;
+
+                // If we only have one layer, we need to set the mask to (1,1,1)
+                // so that we can use the same calculations for both single and multi.
+                // The mask is set last for layer 1 since we copy the vertices to
+                // all other layers to avoid re-calculating their data.
+                uint8_t is_one_layer = layer_count > 1 ? 0 : 1;
+                SET_VERTEX_LAYER_MASK(v1_layer_face,1,is_one_layer,is_one_layer)
+                SET_VERTEX_LAYER_MASK(v2_layer_face,1,is_one_layer,is_one_layer)
+                SET_VERTEX_LAYER_MASK(v3_layer_face,1,is_one_layer,is_one_layer)
+                SET_VERTEX_LAYER_MASK(v4_layer_face,1,is_one_layer,is_one_layer)
+                SET_VERTEX_LAYER_MASK(v5_layer_face,1,is_one_layer,is_one_layer)
+                SET_VERTEX_LAYER_MASK(v6_layer_face,1,is_one_layer,is_one_layer)
+
+                #undef SET_VERTEX_LAYER_MASK
+
+                vertexindex += vertices_per_quad;
             }
         }
 
@@ -1099,6 +1355,8 @@ namespace dmRender
             text_context.m_VertexIndex += num_indices;
         }
 
+        UpdateCacheTexture(font_map);
+
         ro->m_VertexCount = text_context.m_VertexIndex - ro->m_VertexStart;
 
         dmRender::AddToRender(render_context, ro);
@@ -1116,12 +1374,25 @@ namespace dmRender
             case dmRender::RENDER_LIST_OPERATION_END:
                 if (text_context.m_VerticesFlushed != text_context.m_VertexIndex)
                 {
-                    uint32_t buffer_size = sizeof(GlyphVertex) * text_context.m_VertexIndex;
-                    dmGraphics::SetVertexBufferData(text_context.m_VertexBuffer, 0, 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
-                    dmGraphics::SetVertexBufferData(text_context.m_VertexBuffer, buffer_size, text_context.m_ClientBuffer, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
-
                     uint32_t num_vertices = text_context.m_VertexIndex - text_context.m_VerticesFlushed;
+
+                    // Copy the vertices of this draw into the shared transient vertex buffer,
+                    // and point the render objects to their new location
+                    HRenderBuffer vertex_buffer;
+                    uint32_t vertex_buffer_offset;
+                    void* dst = AllocTransientBuffer(render_context, RENDER_BUFFER_TYPE_VERTEX_BUFFER, num_vertices * sizeof(GlyphVertex), sizeof(GlyphVertex), g_TransientCategoryText, &vertex_buffer, &vertex_buffer_offset);
+                    memcpy(dst, (GlyphVertex*) text_context.m_ClientBuffer + text_context.m_VerticesFlushed, num_vertices * sizeof(GlyphVertex));
+
+                    uint32_t vertex_start = vertex_buffer_offset / sizeof(GlyphVertex);
+                    for (uint32_t i = text_context.m_RenderObjectsFlushed; i < text_context.m_RenderObjectIndex; ++i)
+                    {
+                        RenderObject& ro = text_context.m_RenderObjects[i];
+                        ro.m_VertexBuffer = (dmGraphics::HVertexBuffer) vertex_buffer;
+                        ro.m_VertexStart  = ro.m_VertexStart - text_context.m_VerticesFlushed + vertex_start;
+                    }
+
                     text_context.m_VerticesFlushed = text_context.m_VertexIndex;
+                    text_context.m_RenderObjectsFlushed = text_context.m_RenderObjectIndex;
 
                     DM_PROPERTY_ADD_U32(rmtp_FontCharacterCount, num_vertices / 6);
                     DM_PROPERTY_ADD_U32(rmtp_FontVertexSize, num_vertices * sizeof(GlyphVertex));
@@ -1170,7 +1441,14 @@ namespace dmRender
                 text_context.m_RenderObjectIndex = 0;
                 text_context.m_VertexIndex = 0;
                 text_context.m_VerticesFlushed = 0;
+                text_context.m_RenderObjectsFlushed = 0;
                 text_context.m_TextEntriesFlushed = 0;
+
+                // Drop the layouts of texts that are no longer drawn
+                if (text_context.m_TextLayouts.Full() || (text_context.m_Frame % TEXT_LAYOUT_MAX_AGE) == 0)
+                {
+                    PurgeTextLayouts(text_context, TEXT_LAYOUT_MAX_AGE);
+                }
             }
 
             uint32_t count = text_context.m_TextEntries.Size() - text_context.m_TextEntriesFlushed;
@@ -1267,6 +1545,7 @@ namespace dmRender
         uint32_t size = sizeof(FontMap);
         size += font_map->m_Glyphs.Capacity()*(sizeof(Glyph)+sizeof(uint32_t));
         size += dmGraphics::GetTextureResourceSize(font_map->m_Texture);
+        size += font_map->m_CacheWidth * font_map->m_CacheHeight * font_map->m_CacheChannels; // m_CacheData
         return size;
     }
 
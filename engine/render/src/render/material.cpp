@@ -19,12 +19,17 @@
 #include <dlib/dstrings.h>
 #include <dlib/hashtable.h>
 #include <dlib/log.h>
+#include <dlib/profile.h>
 #include <dmsdk/dlib/math.h> // min
 #include <dmsdk/dlib/vmath.h>
 #include <dmsdk/graphics/graphics.h>
 #include "render.h"
 #include "render_private.h"
 
+DM_PROPERTY_EXTERN(rmtp_Render);
+DM_PROPERTY_U32(rmtp_UniformUploads, 0, FrameReset, "# uniform uploads", &rmtp_Render);
+DM_PROPERTY_U32(rmtp_UniformUploadsSkipped, 0, FrameReset, "# redundant uniform uploads skipped", &rmtp_Render);
+
 namespace dmRender
 {
     using namespace dmVMath;
@@ -144,6 +149,78 @@ namespace dmRender
         memset(m->m_MaterialAttributeValues.Begin(), 0, num_attribute_byte_size);
     }
 
+    static void CreateConstantShadows(HMaterial material)
+    {
+        uint32_t constants_count = material->m_Constants.Size();
+        uint32_t num_values_total = 0;
+
+        material->m_ConstantShadows.SetCapacity(constants_count);
+        material->m_ConstantShadows.SetSize(constants_count);
+        for (uint32_t i = 0; i < constants_count; ++i)
+        {
+            uint32_t num_values;
+            GetConstantValues(material->m_Constants[i].m_Constant, &num_values);
+
+            // Engine provided matrices (view, world etc) don't have any values of their own
+            if (num_values < 4)
+                num_values = 4;
+
+            MaterialConstantShadow& shadow = material->m_ConstantShadows[i];
+            shadow.m_ValueIndex = num_values_total;
+            shadow.m_MaxValues  = (uint16_t) num_values;
+            shadow.m_NumValues  = 0;
+            num_values_total   += num_values;
+        }
+
+        material->m_ConstantShadowValues.SetCapacity(num_values_total);
+        material->m_ConstantShadowValues.SetSize(num_values_total);
+    }
+
+    void InvalidateMaterialConstants(HMaterial material)
+    {
+        uint32_t n = material->m_ConstantShadows.Size();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            material->m_ConstantShadows[i].m_NumValues = 0;
+        }
+    }
+
+    void SetMaterialConstant(dmGraphics::HContext graphics_context, HMaterial material, int32_t constant_index, dmGraphics::HUniformLocation location, const Vector4* values, uint32_t num_values, bool is_matrix)
+    {
+        MaterialConstantShadow* shadow = 0;
+        if (constant_index >= 0 && constant_index < (int32_t) material->m_ConstantShadows.Size())
+        {
+            shadow = &material->m_ConstantShadows[constant_index];
+            if (num_values > shadow->m_MaxValues)
+            {
+                shadow->m_NumValues = 0;
+                shadow = 0;
+            }
+        }
+
+        if (shadow)
+        {
+            Vector4* shadow_values = &material->m_ConstantShadowValues[shadow->m_ValueIndex];
+            if (shadow->m_NumValues == num_values && memcmp(shadow_values, values, num_values * sizeof(Vector4)) == 0)
+            {
+                DM_PROPERTY_ADD_U32(rmtp_UniformUploadsSkipped, 1);
+                return;
+            }
+            memcpy(shadow_values, values, num_values * sizeof(Vector4));
+            shadow->m_NumValues = (uint16_t) num_values;
+        }
+
+        if (is_matrix)
+        {
+            dmGraphics::SetConstantM4(graphics_context, values, num_values / 4, location);
+        }
+        else
+        {
+            dmGraphics::SetConstantV4(graphics_context, values, num_values, location);
+        }
+        DM_PROPERTY_ADD_U32(rmtp_UniformUploads, 1);
+    }
+
     void CreateConstants(dmGraphics::HContext graphics_context, HMaterial material)
     {
         uint32_t total_constants_count = dmGraphics::GetUniformCount(material->m_Program);
@@ -168,6 +245,7 @@ namespace dmRender
         }
 
         SetMaterialConstantValues(graphics_context, material->m_Program, total_constants_count, material->m_NameHashToLocation, material->m_Constants, material->m_Samplers);
+        CreateConstantShadows(material);
     }
 
     HMaterial NewMaterial(dmRender::HRenderContext render_context, dmGraphics::HVertexProgram vertex_program, dmGraphics::HFragmentProgram fragment_program)
@@ -206,10 +284,18 @@ namespace dmRender
         delete material;
     }
 
+    // Vulkan NDC is [0..1] for z, so we must transform
+    // the projection before setting the constant.
+    static const Matrix4 g_SpirvNdcMatrix(Vector4(1.0f, 0.0f, 0.0f, 0.0f),
+                                          Vector4(0.0f, 1.0f, 0.0f, 0.0f),
+                                          Vector4(0.0f, 0.0f, 0.5f, 0.0f),
+                                          Vector4(0.0f, 0.0f, 0.5f, 1.0f));
+
     void ApplyMaterialConstants(dmRender::HRenderContext render_context, HMaterial material, const RenderObject* ro)
     {
         const dmArray<RenderConstant>& constants = material->m_Constants;
         dmGraphics::HContext graphics_context    = dmRender::GetGraphicsContext(render_context);
+        bool is_spirv = dmGraphics::GetProgramLanguage(material->m_Program) == dmGraphics::ShaderDesc::LANGUAGE_SPIRV;
 
         uint32_t n = constants.Size();
         for (uint32_t i = 0; i < n; ++i)
@@ -225,62 +311,54 @@ namespace dmRender
                 {
                     uint32_t num_values;
                     dmVMath::Vector4* values = GetConstantValues(constant, &num_values);
-                    dmGraphics::SetConstantV4(graphics_context, values, num_values, location);
+                    SetMaterialConstant(graphics_context, material, i, location, values, num_values, false);
                     break;
                 }
                 case dmRenderDDF::MaterialDesc::CONSTANT_TYPE_USER_MATRIX4:
                 {
                     uint32_t num_values;
                     dmVMath::Vector4* values = GetConstantValues(constant, &num_values);
-                    dmGraphics::SetConstantM4(graphics_context, values, num_values / 4, location);
+                    SetMaterialConstant(graphics_context, material, i, location, values, num_values & ~3, true);
                     break;
                 }
                 case dmRenderDDF::MaterialDesc::CONSTANT_TYPE_VIEWPROJ:
                 {
-                    if (dmGraphics::GetProgramLanguage(dmRender::GetMaterialProgram(material)) == dmGraphics::ShaderDesc::LANGUAGE_SPIRV)
+                    if (is_spirv)
                     {
-                        Matrix4 ndc_matrix = Matrix4::identity();
-                        ndc_matrix.setElem(2, 2, 0.5f );
-                        ndc_matrix.setElem(3, 2, 0.5f );
-                        const Matrix4 view_projection = ndc_matrix * render_context->m_ViewProj;
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&view_projection, 1, location);
+                        const Matrix4 view_projection = g_SpirvNdcMatrix * render_context->m_ViewProj;
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&view_projection, 4, true);
                     }
                     else
                     {
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&render_context->m_ViewProj, 1, location);
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&render_context->m_ViewProj, 4, true);
                     }
                     break;
                 }
                 case dmRenderDDF::MaterialDesc::CONSTANT_TYPE_WORLD:
                 {
-                    dmGraphics::SetConstantM4(graphics_context, (Vector4*)&ro->m_WorldTransform, 1, location);
+                    SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&ro->m_WorldTransform, 4, true);
                     break;
                 }
                 case dmRenderDDF::MaterialDesc::CONSTANT_TYPE_TEXTURE:
                 {
-                    dmGraphics::SetConstantM4(graphics_context, (Vector4*)&ro->m_TextureTransform, 1, location);
+                    SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&ro->m_TextureTransform, 4, true);
                     break;
                 }
                 case dmRenderDDF::MaterialDesc::CONSTANT_TYPE_VIEW:
                 {
-                    dmGraphics::SetConstantM4(graphics_context, (Vector4*)&render_context->m_View, 1, location);
+                    SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&render_context->m_View, 4, true);
                     break;
                 }
                 case dmRenderDDF::MaterialDesc::CONSTANT_TYPE_PROJECTION:
                 {
-                    // Vulkan NDC is [0..1] for z, so we must transform
-                    // the projection before setting the constant.
-                    if (dmGraphics::GetProgramLanguage(dmRender::GetMaterialProgram(material)) == dmGraphics::ShaderDesc::LANGUAGE_SPIRV)
+                    if (is_spirv)
                     {
-                        Matrix4 ndc_matrix = Matrix4::identity();
-                        ndc_matrix.setElem(2, 2, 0.5f );
-                        ndc_matrix.setElem(3, 2, 0.5f );
-                        const Matrix4 proj = ndc_matrix * render_context->m_Projection;
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&proj, 1, location);
+                        const Matrix4 proj = g_SpirvNdcMatrix * render_context->m_Projection;
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&proj, 4, true);
                     }
                     else
                     {
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&render_context->m_Projection, 1, location);
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&render_context->m_Projection, 4, true);
                     }
                     break;
                 }
@@ -293,7 +371,7 @@ namespace dmRender
                         // It is always affine however
                         normalT = affineInverse(normalT);
                         normalT = transpose(normalT);
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&normalT, 1, location);
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&normalT, 4, true);
                     }
                     break;
                 }
@@ -301,24 +379,21 @@ namespace dmRender
                 {
                     {
                         Matrix4 world_view = render_context->m_View * ro->m_WorldTransform;
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&world_view, 1, location);
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&world_view, 4, true);
                     }
                     break;
                 }
                 case dmRenderDDF::MaterialDesc::CONSTANT_TYPE_WORLDVIEWPROJ:
                 {
-                    if (dmGraphics::GetProgramLanguage(dmRender::GetMaterialProgram(material)) == dmGraphics::ShaderDesc::LANGUAGE_SPIRV)
+                    if (is_spirv)
                     {
-                        Matrix4 ndc_matrix = Matrix4::identity();
-                        ndc_matrix.setElem(2, 2, 0.5f );
-                        ndc_matrix.setElem(3, 2, 0.5f );
-                        const Matrix4 world_view_projection = ndc_matrix * render_context->m_ViewProj * ro->m_WorldTransform;
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&world_view_projection, 1, location);
+                        const Matrix4 world_view_projection = g_SpirvNdcMatrix * render_context->m_ViewProj * ro->m_WorldTransform;
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&world_view_projection, 4, true);
                     }
                     else
                     {
                         const Matrix4 world_view_projection = render_context->m_ViewProj * ro->m_WorldTransform;
-                        dmGraphics::SetConstantM4(graphics_context, (Vector4*)&world_view_projection, 1, location);
+                        SetMaterialConstant(graphics_context, material, i, location, (Vector4*)&world_view_projection, 4, true);
                     }
                     break;
                 }
@@ -412,7 +487,7 @@ namespace dmRender
         return -1;
     }
 
-    static inline int32_t FindMaterialConstantIndex(HMaterial material, dmhash_t name_hash)
+    int32_t FindMaterialConstantIndex(HMaterial material, dmhash_t name_hash)
     {
         dmArray<RenderConstant>& constants = material->m_Constants;
         int32_t n = (int32_t)constants.Size();
@@ -741,6 +816,7 @@ namespace dmRender
             taglist.m_Tags[i] = tags[i];
         }
         taglist.m_Count = tag_count;
+        MakeMaterialTagMask(context, tag_count, tags, &taglist.m_Mask);
 
         if (context->m_MaterialTagLists.Full())
         {
@@ -759,11 +835,51 @@ namespace dmRender
         if (!value) {
             dmLogError("Failed to get material tag list with hash 0x%08x", list_key)
             list->m_Count = 0;
+            memset(&list->m_Mask, 0, sizeof(list->m_Mask));
             return;
         }
         *list = *value;
     }
 
+    const MaterialTagList* FindMaterialTagList(HRenderContext context, uint32_t list_key)
+    {
+        return context->m_MaterialTagLists.Get(list_key);
+    }
+
+    void MakeMaterialTagMask(HRenderContext context, uint32_t tag_count, const dmhash_t* tags, MaterialTagMask* mask)
+    {
+        memset(mask, 0, sizeof(*mask));
+        mask->m_Valid = 1;
+
+        dmHashTable64<uint32_t>& bits = context->m_MaterialTagBits;
+        for (uint32_t i = 0; i < tag_count; ++i)
+        {
+            uint32_t* value = bits.Get(tags[i]);
+            uint32_t bit;
+            if (value)
+            {
+                bit = *value;
+            }
+            else
+            {
+                bit = bits.Size();
+                if (bit >= MAX_MATERIAL_TAG_BITS)
+                {
+                    // Out of bits, matching against this mask will use the tag arrays instead
+                    mask->m_Valid = 0;
+                    continue;
+                }
+                if (bits.Full())
+                {
+                    uint32_t capacity = dmMath::Min(bits.Capacity() + 16, MAX_MATERIAL_TAG_BITS);
+                    bits.SetCapacity(capacity / 2 + 1, capacity);
+                }
+                bits.Put(tags[i], bit);
+            }
+            mask->m_Bits[bit / 64] |= 1ULL << (bit % 64);
+        }
+    }
+
     void SetMaterialTags(HMaterial material, uint32_t tag_count, const dmhash_t* tags)
     {
         material->m_TagListKey = RegisterMaterialTagList(material->m_RenderContext, tag_count, tags);
@@ -21,6 +21,7 @@
 #include <dlib/hashtable.h>
 #include <dlib/profile.h>
 #include <dlib/math.h>
+#include <dlib/time.h>
 #include <dmsdk/dlib/vmath.h>
 #include <dmsdk/dlib/intersection.h>
 
@@ -32,6 +33,9 @@
 #include "font_renderer.h"
 
 DM_PROPERTY_GROUP(rmtp_Render, "Renderer");
+DM_PROPERTY_U32(rmtp_ProgramSwitches, 0, FrameReset, "# program switches", &rmtp_Render);
+DM_PROPERTY_U32(rmtp_TextureBinds, 0, FrameReset, "# texture binds", &rmtp_Render);
+DM_PROPERTY_U32(rmtp_StateChanges, 0, FrameReset, "# pipeline state changes", &rmtp_Render);
 
 namespace dmRender
 {
@@ -127,6 +131,10 @@ namespace dmRender
         }
 
         InitializeTextContext(context, params.m_MaxCharacters, params.m_MaxBatches);
+        InitializeTransientBuffers(context);
+
+        memset(&context->m_Stats, 0, sizeof(context->m_Stats));
+        memset(&context->m_StatsPrevFrame, 0, sizeof(context->m_StatsPrevFrame));
 
         context->m_OutOfResources = 0;
 
@@ -157,6 +165,7 @@ namespace dmRender
         dmScript::DeleteScriptWorld(render_context->m_ScriptWorld);
         FinalizeDebugRenderer(render_context);
         FinalizeTextContext(render_context);
+        FinalizeTransientBuffers(render_context);
         dmMessage::DeleteSocket(render_context->m_Socket);
         delete render_context;
 
@@ -322,6 +331,29 @@ namespace dmRender
         return RESULT_OK;
     }
 
+    void NextStatsFrame(HRenderContext render_context)
+    {
+        dmGraphics::Stats graphics_stats;
+        dmGraphics::GetStats(render_context->m_GraphicsContext, &graphics_stats);
+        dmGraphics::ResetStats(render_context->m_GraphicsContext);
+
+        Stats& stats                = render_context->m_Stats;
+        stats.m_DrawCalls            = graphics_stats.m_DrawCalls;
+        stats.m_Vertices             = graphics_stats.m_Vertices;
+        stats.m_BufferBytesUploaded  = graphics_stats.m_BufferBytesUploaded;
+        stats.m_TextureUploads       = graphics_stats.m_TextureUploads;
+        stats.m_TextureBytesUploaded = graphics_stats.m_TextureBytesUploaded;
+        stats.m_ProgramSwitches      = graphics_stats.m_ProgramSwitches;
+
+        render_context->m_StatsPrevFrame = stats;
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    void GetStats(HRenderContext render_context, Stats* stats)
+    {
+        *stats = render_context->m_StatsPrevFrame;
+    }
+
     Result ClearRenderObjects(HRenderContext context)
     {
         context->m_RenderObjects.SetSize(0);
@@ -334,32 +366,41 @@ namespace dmRender
         context->m_TextContext.m_TextBuffer.SetSize(0);
         context->m_TextContext.m_TextEntries.SetSize(0);
 
+        NextTransientBufferFrame(context);
+
         return RESULT_OK;
     }
 
     // This function will compare the values in ps_orig and ps_now and reset the render state that is different between them
     // It is expected that the first parameter is the "default" state, i.e the values from that pipeline will be used
-    static void ResetRenderStateIfChanged(dmGraphics::HContext graphics_context, dmGraphics::PipelineState ps_orig, dmGraphics::PipelineState ps_now)
+    static void ResetRenderStateIfChanged(HRenderContext render_context, dmGraphics::PipelineState ps_orig, dmGraphics::PipelineState ps_now)
     {
         #define HAS_CHANGED(name) (ps_now.name != ps_orig.name)
 
+        dmGraphics::HContext graphics_context = render_context->m_GraphicsContext;
+        uint32_t num_changes = 0;
+
         if (HAS_CHANGED(m_BlendSrcFactor) || HAS_CHANGED(m_BlendDstFactor))
         {
+            num_changes++;
             dmGraphics::SetBlendFunc(graphics_context, (dmGraphics::BlendFactor) ps_orig.m_BlendSrcFactor, (dmGraphics::BlendFactor) ps_orig.m_BlendDstFactor);
         }
 
         if (HAS_CHANGED(m_FaceWinding))
         {
+            num_changes++;
             dmGraphics::SetFaceWinding(graphics_context, (dmGraphics::FaceWinding) ps_orig.m_FaceWinding);
         }
 
         if (HAS_CHANGED(m_StencilWriteMask))
         {
+            num_changes++;
             dmGraphics::SetStencilMask(graphics_context, ps_orig.m_StencilWriteMask);
         }
 
         if (HAS_CHANGED(m_WriteColorMask))
         {
+            num_changes++;
             dmGraphics::SetColorMask(graphics_context,
                 ps_orig.m_WriteColorMask & (1<<3),
                 ps_orig.m_WriteColorMask & (1<<2),
@@ -369,18 +410,21 @@ namespace dmRender
 
         if (HAS_CHANGED(m_StencilFrontTestFunc) || HAS_CHANGED(m_StencilReference) || HAS_CHANGED(m_StencilCompareMask))
         {
+            num_changes++;
             dmGraphics::SetStencilFuncSeparate(graphics_context, dmGraphics::FACE_TYPE_FRONT,
                 (dmGraphics::CompareFunc) ps_orig.m_StencilFrontTestFunc, ps_orig.m_StencilReference, ps_orig.m_StencilCompareMask);
         }
 
         if (HAS_CHANGED(m_StencilBackTestFunc) || HAS_CHANGED(m_StencilReference) || HAS_CHANGED(m_StencilCompareMask))
         {
+            num_changes++;
             dmGraphics::SetStencilFuncSeparate(graphics_context, dmGraphics::FACE_TYPE_BACK,
                 (dmGraphics::CompareFunc) ps_orig.m_StencilBackTestFunc, ps_orig.m_StencilReference, ps_orig.m_StencilCompareMask);
         }
 
         if (HAS_CHANGED(m_StencilFrontOpFail) || HAS_CHANGED(m_StencilFrontOpDepthFail) || HAS_CHANGED(m_StencilFrontOpPass))
         {
+            num_changes++;
             dmGraphics::SetStencilOpSeparate(graphics_context, dmGraphics::FACE_TYPE_FRONT,
                 (dmGraphics::StencilOp) ps_orig.m_StencilFrontOpFail,
                 (dmGraphics::StencilOp) ps_orig.m_StencilFrontOpDepthFail,
@@ -389,6 +433,7 @@ namespace dmRender
 
         if (HAS_CHANGED(m_StencilBackOpFail) || HAS_CHANGED(m_StencilBackOpDepthFail) || HAS_CHANGED(m_StencilBackOpPass))
         {
+            num_changes++;
             dmGraphics::SetStencilOpSeparate(graphics_context, dmGraphics::FACE_TYPE_BACK,
                 (dmGraphics::StencilOp) ps_orig.m_StencilBackOpFail,
                 (dmGraphics::StencilOp) ps_orig.m_StencilBackOpDepthFail,
@@ -396,6 +441,9 @@ namespace dmRender
         }
 
         #undef HAS_CHANGED
+
+        render_context->m_Stats.m_StateChanges += num_changes;
+        DM_PROPERTY_ADD_U32(rmtp_StateChanges, num_changes);
     }
 
     static void ApplyRenderState(HRenderContext render_context, dmGraphics::HContext graphics_context, dmGraphics::PipelineState ps_default, const RenderObject* ro)
@@ -458,7 +506,81 @@ namespace dmRender
             }
         }
 
-        ResetRenderStateIfChanged(graphics_context, ps_now, ps_default);
+        ResetRenderStateIfChanged(render_context, ps_now, ps_default);
+    }
+
+    uint32_t GetRenderObjectStateKey(const RenderObject* ro)
+    {
+        uint32_t key = 0;
+        if (ro->m_SetBlendFactors)
+        {
+            key |= 1 << 31 | ((uint32_t) ro->m_SourceBlendFactor & 0xf) << 4 | ((uint32_t) ro->m_DestinationBlendFactor & 0xf);
+        }
+        if (ro->m_SetFaceWinding)
+        {
+            key |= 1 << 30 | ((uint32_t) ro->m_FaceWinding & 0x1) << 8;
+        }
+        return key;
+    }
+
+    struct RenderObjectStateSorter
+    {
+        bool operator()(const RenderObjectStateSortKey& a, const RenderObjectStateSortKey& b) const
+        {
+            if (a.m_Material != b.m_Material)
+                return a.m_Material < b.m_Material;
+            if (a.m_Textures != b.m_Textures)
+                return a.m_Textures < b.m_Textures;
+            return a.m_State < b.m_State;
+        }
+    };
+
+    static void SortRenderObjectRange(HRenderContext context, uint32_t start, uint32_t end)
+    {
+        if (end - start < 2)
+            return;
+
+        dmArray<RenderObjectStateSortKey>& keys = context->m_RenderObjectSortKeys;
+        if (keys.Capacity() < end - start)
+            keys.SetCapacity(end - start);
+        keys.SetSize(0);
+
+        RenderObject** render_objects = context->m_RenderObjects.Begin();
+        for (uint32_t i = start; i < end; ++i)
+        {
+            RenderObject* ro = render_objects[i];
+            RenderObjectStateSortKey key;
+            key.m_Material     = (uintptr_t) ro->m_Material;
+            key.m_Textures     = dmHashBuffer32(ro->m_Textures, sizeof(ro->m_Textures));
+            key.m_State        = GetRenderObjectStateKey(ro);
+            key.m_RenderObject = ro;
+            keys.Push(key);
+        }
+
+        std::stable_sort(keys.Begin(), keys.End(), RenderObjectStateSorter());
+
+        for (uint32_t i = start; i < end; ++i)
+        {
+            render_objects[i] = keys[i - start].m_RenderObject;
+        }
+    }
+
+    void SortRenderObjectsByState(HRenderContext context, uint32_t start, uint32_t end)
+    {
+        DM_PROFILE("SortRenderObjectsByState");
+
+        // Stencil state is order dependent (e.g. gui clipping), so objects using it act as barriers
+        RenderObject** render_objects = context->m_RenderObjects.Begin();
+        uint32_t range_start = start;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            if (render_objects[i]->m_SetStencilTest)
+            {
+                SortRenderObjectRange(context, range_start, i);
+                range_start = i + 1;
+            }
+        }
+        SortRenderObjectRange(context, range_start, end);
     }
 
     // For unit testing only
@@ -476,7 +598,7 @@ namespace dmRender
     }
 
     // Compute new sort values for everything that matches tag_mask
-    static void MakeSortBuffer(HRenderContext context, uint32_t tag_count, dmhash_t* tags)
+    static void MakeSortBuffer(HRenderContext context, uint32_t tag_count, const dmhash_t* tags, SortMode sort_mode)
     {
         DM_PROFILE("MakeSortBuffer");
 
@@ -495,20 +617,30 @@ namespace dmRender
         float minZW = FLT_MAX;
         float maxZW = -FLT_MAX;
 
+        MaterialTagMask tag_mask;
+        MakeMaterialTagMask(context, tag_count, tags, &tag_mask);
+
         RenderListRange* ranges = context->m_RenderListRanges.Begin();
         uint32_t num_ranges = context->m_RenderListRanges.Size();
         for( uint32_t r = 0; r < num_ranges; ++r)
         {
             RenderListRange& range = ranges[r];
 
-            MaterialTagList taglist;
-            dmRender::GetMaterialTagList(context, range.m_TagListKey, &taglist);
-
             range.m_Skip = 0;
-            if (tag_count > 0 && !dmRender::MatchMaterialTags(taglist.m_Count, taglist.m_Tags, tag_count, tags))
+            if (tag_count > 0)
             {
-                range.m_Skip = 1;
-                continue;
+                const MaterialTagList* taglist = FindMaterialTagList(context, range.m_TagListKey);
+                if (!taglist)
+                {
+                    dmLogError("Failed to get material tag list with hash 0x%08x", range.m_TagListKey);
+                    range.m_Skip = 1;
+                    continue;
+                }
+                if (!MatchMaterialTagList(taglist, tag_mask, tag_count, tags))
+                {
+                    range.m_Skip = 1;
+                    continue;
+                }
             }
 
             // Write z values...
@@ -528,6 +660,11 @@ namespace dmRender
                     continue; // Could perhaps break here, if we also sorted on the major order (cost more when I tested it /MAWE)
                 }
 
+                if (sort_mode == SORT_MODE_STATE)
+                {
+                    continue; // The depth isn't used, world objects are sorted on their batch key only
+                }
+
                 const Vector4 res = transform * entry->m_WorldPosition;
                 const float zw = res.getZ() / res.getW();
                 sort_values[idx].m_ZW = zw;
@@ -563,7 +700,11 @@ namespace dmRender
                 }
 
                 sort_values[idx].m_MajorOrder = entry->m_MajorOrder;
-                if (entry->m_MajorOrder == RENDER_ORDER_WORLD)
+                if (entry->m_MajorOrder == RENDER_ORDER_WORLD && sort_mode == SORT_MODE_STATE)
+                {
+                    sort_values[idx].m_Order = 0;
+                }
+                else if (entry->m_MajorOrder == RENDER_ORDER_WORLD)
                 {
                     const float z = sort_values[idx].m_ZW;
                     sort_values[idx].m_Order = (uint32_t) (0xfffff8 - 0xfffff0 * rc * (z - minZW));
@@ -800,6 +941,11 @@ namespace dmRender
     }
 
     Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer, const FrustumOptions* frustum_options)
+    {
+        return DrawRenderList(context, predicate, constant_buffer, frustum_options, SORT_MODE_DEPTH);
+    }
+
+    Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer, const FrustumOptions* frustum_options, SortMode sort_mode)
     {
         DM_PROFILE("DrawRenderList");
 
@@ -839,12 +985,16 @@ namespace dmRender
             }
         }
 
+        Stats& stats = context->m_Stats;
+        uint64_t time_start = dmTime::GetTime();
+
         // Cleared once per frame
         if (context->m_RenderListRanges.Empty())
         {
             SortRenderList(context);
         }
 
+        uint64_t time_cull_start = dmTime::GetTime();
         dmhash_t frustum_hash = frustum_matrix ? dmHashBuffer64((const void*) frustum_matrix, 16*sizeof(float)) : 0;
 
         if (context->m_FrustumHash != frustum_hash)
@@ -865,10 +1015,16 @@ namespace dmRender
             }
         }
 
-        MakeSortBuffer(context, predicate?predicate->m_TagCount:0, predicate?predicate->m_Tags:0);
+        uint64_t time_cull_end = dmTime::GetTime();
+        stats.m_CullTime += (uint32_t)(time_cull_end - time_cull_start);
+
+        MakeSortBuffer(context, predicate?predicate->m_TagCount:0, predicate?predicate->m_Tags:0, sort_mode);
 
         if (context->m_RenderListSortBuffer.Empty())
+        {
+            stats.m_SortTime += (uint32_t)((time_cull_start - time_start) + (dmTime::GetTime() - time_cull_end));
             return RESULT_OK;
+        }
 
         {
             DM_PROFILE("DrawRenderList_SORT");
@@ -877,6 +1033,9 @@ namespace dmRender
             std::stable_sort(context->m_RenderListSortBuffer.Begin(), context->m_RenderListSortBuffer.End(), sort);
         }
 
+        uint64_t time_dispatch_start = dmTime::GetTime();
+        stats.m_SortTime += (uint32_t)((time_cull_start - time_start) + (time_dispatch_start - time_cull_end));
+
         // Construct render objects
         context->m_RenderObjects.SetSize(0);
 
@@ -906,6 +1065,9 @@ namespace dmRender
         uint32_t *last = context->m_RenderListSortBuffer.Begin();
         uint32_t count = context->m_RenderListSortBuffer.Size();
 
+        // Start of the current run of render objects created from world ordered batches
+        uint32_t state_sort_start = context->m_RenderObjects.Size();
+
         {
             DM_PROFILE("Dispatch_Batch");
 
@@ -926,12 +1088,28 @@ namespace dmRender
                     params.m_UserData = d->m_UserData;
                     params.m_Begin = last;
                     params.m_End = idx;
+
+                    bool world_order = last_entry->m_MajorOrder == RENDER_ORDER_WORLD;
+                    if (sort_mode == SORT_MODE_STATE && !world_order)
+                    {
+                        SortRenderObjectsByState(context, state_sort_start, context->m_RenderObjects.Size());
+                    }
+
                     d->m_DispatchFn(params);
+
+                    if (!world_order)
+                    {
+                        state_sort_start = context->m_RenderObjects.Size();
+                    }
                 }
 
                 last = idx;
             }
 
+            if (sort_mode == SORT_MODE_STATE)
+            {
+                SortRenderObjectsByState(context, state_sort_start, context->m_RenderObjects.Size());
+            }
         }
 
         params.m_Operation = RENDER_LIST_OPERATION_END;
@@ -950,9 +1128,16 @@ namespace dmRender
             }
         }
 
-        return Draw(context, predicate, constant_buffer);
+        uint64_t time_draw_start = dmTime::GetTime();
+        stats.m_DispatchTime += (uint32_t)(time_draw_start - time_dispatch_start);
+
+        Result result = Draw(context, predicate, constant_buffer);
+        stats.m_DrawTime += (uint32_t)(dmTime::GetTime() - time_draw_start);
+        return result;
     }
 
+    static const uint32_t MAX_BOUND_TEXTURE_UNITS = 32;
+
     // NOTE: Currently only used externally in 1 test (fontview.cpp)
     // TODO: Replace that occurrance with DrawRenderList
     Result Draw(HRenderContext render_context, HPredicate predicate, HNamedConstantBuffer constant_buffer)
@@ -960,41 +1145,72 @@ namespace dmRender
         if (render_context == 0x0)
             return RESULT_INVALID_CONTEXT;
 
+        FlushTransientBuffers(render_context);
+
         dmGraphics::HContext context = dmRender::GetGraphicsContext(render_context);
         dmGraphics::HTexture render_context_textures[RenderObject::MAX_TEXTURE_COUNT] = {};
 
         HMaterial material         = render_context->m_Material;
         HMaterial context_material = render_context->m_Material;
 
+        // The textures currently bound per texture unit. Bindings are kept between render objects
+        // and only changed when a render object needs a different texture (or material) in a unit.
+        dmGraphics::HTexture bound_textures[MAX_BOUND_TEXTURE_UNITS] = {};
+        uint8_t bound_sub_handles[MAX_BOUND_TEXTURE_UNITS] = {};
+        HMaterial bound_material = 0;
+
         if(context_material)
         {
             dmGraphics::EnableProgram(context, GetMaterialProgram(context_material));
+            DM_PROPERTY_ADD_U32(rmtp_ProgramSwitches, 1);
             GetRenderContextTextures(render_context, context_material, render_context_textures);
         }
 
         dmGraphics::PipelineState ps_orig = dmGraphics::GetPipelineState(context);
 
+        // Render objects are mostly grouped by material, so the result of the last tag match is reused
+        MaterialTagMask predicate_mask;
+        uint32_t last_taglistkey = 0;
+        bool last_match = false;
+        bool has_last_match = false;
+        if (predicate)
+        {
+            MakeMaterialTagMask(render_context, predicate->m_TagCount, predicate->m_Tags, &predicate_mask);
+        }
+
         for (uint32_t i = 0; i < render_context->m_RenderObjects.Size(); ++i)
         {
             RenderObject* ro = render_context->m_RenderObjects[i];
             if (ro->m_VertexCount == 0)
                 continue;
 
-            MaterialTagList taglist;
-            uint32_t taglistkey = dmRender::GetMaterialTagListKey(ro->m_Material);
-            dmRender::GetMaterialTagList(render_context, taglistkey, &taglist);
-
-            if (predicate && !dmRender::MatchMaterialTags(taglist.m_Count, taglist.m_Tags, predicate->m_TagCount, predicate->m_Tags))
+            if (predicate)
             {
-                continue;
+                uint32_t taglistkey = dmRender::GetMaterialTagListKey(ro->m_Material);
+                if (!has_last_match || taglistkey != last_taglistkey)
+                {
+                    const MaterialTagList* taglist = FindMaterialTagList(render_context, taglistkey);
+                    if (!taglist)
+                    {
+                        dmLogError("Failed to get material tag list with hash 0x%08x", taglistkey);
+                    }
+                    last_match = taglist && MatchMaterialTagList(taglist, predicate_mask, predicate->m_TagCount, predicate->m_Tags);
+                    last_taglistkey = taglistkey;
+                    has_last_match = true;
+                }
+                if (!last_match)
+                    continue;
             }
 
+            render_context->m_Stats.m_RenderObjects++;
+
             if (!context_material)
             {
                 if(material != ro->m_Material)
                 {
                     material = ro->m_Material;
                     dmGraphics::EnableProgram(context, GetMaterialProgram(material));
+                    DM_PROPERTY_ADD_U32(rmtp_ProgramSwitches, 1);
                     // Reset the override texture binding array. The new material may have a different
                     // resource layout than the current material.
                     memset(render_context_textures, 0, sizeof(render_context_textures));
@@ -1012,7 +1228,7 @@ namespace dmRender
 
             ApplyRenderState(render_context, render_context->m_GraphicsContext, dmGraphics::GetPipelineState(context), ro);
 
-            uint8_t next_texture_unit = 0;
+            uint32_t next_texture_unit = 0;
             for (uint32_t i = 0; i < RenderObject::MAX_TEXTURE_COUNT; ++i)
             {
                 dmGraphics::HTexture texture = ro->m_Textures[i];
@@ -1026,16 +1242,37 @@ namespace dmRender
                     uint32_t num_texture_handles = dmGraphics::GetNumTextureHandles(texture);
                     for (int sub_handle = 0; sub_handle < num_texture_handles; ++sub_handle)
                     {
-                        // TODO paged-atlas: We can remove the HSampler concept now I think, unless we want to do validation in a debug runtime?
-                        HSampler sampler = GetMaterialSampler(material, next_texture_unit);
-
-                        dmGraphics::EnableTexture(context, next_texture_unit, sub_handle, texture);
-                        ApplyMaterialSampler(render_context, material, sampler, next_texture_unit, texture);
+                        // Units past the cache are bound for this render object only, and unbound after the draw
+                        bool cached = next_texture_unit < MAX_BOUND_TEXTURE_UNITS;
+                        if (!cached || bound_material != material || bound_textures[next_texture_unit] != texture || bound_sub_handles[next_texture_unit] != sub_handle)
+                        {
+                            // TODO paged-atlas: We can remove the HSampler concept now I think, unless we want to do validation in a debug runtime?
+                            HSampler sampler = GetMaterialSampler(material, next_texture_unit);
+
+                            dmGraphics::EnableTexture(context, next_texture_unit, sub_handle, texture);
+                            ApplyMaterialSampler(render_context, material, sampler, next_texture_unit, texture);
+                            DM_PROPERTY_ADD_U32(rmtp_TextureBinds, 1);
+                            render_context->m_Stats.m_TextureBinds++;
+
+                            if (cached)
+                            {
+                                bound_textures[next_texture_unit]    = texture;
+                                bound_sub_handles[next_texture_unit] = sub_handle;
+                            }
+                        }
 
                         next_texture_unit++;
                     }
                 }
             }
+            bound_material = material;
+
+            // Unbind units left over from the previous render object, so a material never samples a stale texture
+            for (uint32_t i = next_texture_unit; i < MAX_BOUND_TEXTURE_UNITS && bound_textures[i]; ++i)
+            {
+                dmGraphics::DisableTexture(context, i, bound_textures[i]);
+                bound_textures[i] = 0;
+            }
 
             dmGraphics::HProgram material_program = GetMaterialProgram(material);
 
@@ -1051,7 +1288,9 @@ namespace dmRender
                 }
             }
 
-            if (ro->m_IndexBuffer)
+            if (ro->m_IndexBuffer && ro->m_InstanceCount > 0)
+                dmGraphics::DrawElementsInstanced(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_InstanceCount, ro->m_IndexType, ro->m_IndexBuffer);
+            else if (ro->m_IndexBuffer)
                 dmGraphics::DrawElements(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_IndexType, ro->m_IndexBuffer);
             else
                 dmGraphics::Draw(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount);
@@ -1069,24 +1308,37 @@ namespace dmRender
                 }
             }
 
-            next_texture_unit = 0;
-            for (uint32_t i = 0; i < RenderObject::MAX_TEXTURE_COUNT; ++i)
+            if (next_texture_unit > MAX_BOUND_TEXTURE_UNITS)
             {
-                dmGraphics::HTexture texture = ro->m_Textures[i];
-                if (render_context_textures[i])
-                    texture = render_context_textures[i];
-                if (texture)
+                uint32_t texture_unit = 0;
+                for (uint32_t i = 0; i < RenderObject::MAX_TEXTURE_COUNT; ++i)
                 {
-                    for (int sub_handle = 0; sub_handle < dmGraphics::GetNumTextureHandles(texture); ++sub_handle)
+                    dmGraphics::HTexture texture = render_context_textures[i] ? render_context_textures[i] : ro->m_Textures[i];
+                    if (texture)
                     {
-                        dmGraphics::DisableTexture(context, next_texture_unit, texture);
-                        next_texture_unit++;
+                        uint32_t num_texture_handles = dmGraphics::GetNumTextureHandles(texture);
+                        for (uint32_t sub_handle = 0; sub_handle < num_texture_handles; ++sub_handle)
+                        {
+                            if (texture_unit >= MAX_BOUND_TEXTURE_UNITS)
+                            {
+                                dmGraphics::DisableTexture(context, texture_unit, texture);
+                            }
+                            texture_unit++;
+                        }
                     }
                 }
             }
         }
 
-        ResetRenderStateIfChanged(context, ps_orig, dmGraphics::GetPipelineState(context));
+        for (uint32_t i = 0; i < MAX_BOUND_TEXTURE_UNITS; ++i)
+        {
+            if (bound_textures[i])
+            {
+                dmGraphics::DisableTexture(context, i, bound_textures[i]);
+            }
+        }
+
+        ResetRenderStateIfChanged(render_context, ps_orig, dmGraphics::GetPipelineState(context));
 
         TrimTextureBindingTable(render_context);
 
@@ -74,6 +74,51 @@ namespace dmRender
     {
         RENDER_BUFFER_TYPE_VERTEX_BUFFER = 0,
         RENDER_BUFFER_TYPE_INDEX_BUFFER  = 1,
+        MAX_RENDER_BUFFER_TYPE_COUNT     = 2,
+    };
+
+    struct TransientBufferStats
+    {
+        static const uint32_t MAX_CATEGORY_COUNT = 16;
+
+        dmhash_t m_Categories[MAX_CATEGORY_COUNT];
+        uint32_t m_CategoryBytes[MAX_CATEGORY_COUNT];
+        uint32_t m_CategoryCount;
+        uint32_t m_BytesUploaded;
+        uint32_t m_UploadCount;
+    };
+
+    /**
+     * How the render objects of a draw call are ordered
+     * SORT_MODE_DEPTH: world ordered objects are sorted back to front (default)
+     * SORT_MODE_STATE: world ordered objects are sorted by material, textures and pipeline state to minimise
+     *                  state changes. Only suitable for objects that don't rely on draw order, e.g. opaque geometry.
+     */
+    enum SortMode
+    {
+        SORT_MODE_DEPTH = 0,
+        SORT_MODE_STATE = 1,
+    };
+
+    // Per frame render statistics, see GetStats()
+    struct Stats
+    {
+        uint32_t m_DrawCalls;
+        uint32_t m_Vertices;             // Vertices (or indices) submitted, including all instances
+        uint32_t m_BufferBytesUploaded;  // Bytes uploaded to vertex and index buffers
+        uint32_t m_TextureUploads;
+        uint32_t m_TextureBytesUploaded;
+        uint32_t m_ProgramSwitches;
+        uint32_t m_TextureBinds;
+        uint32_t m_StateChanges;
+        uint32_t m_RenderObjects;        // Render objects drawn
+        uint32_t m_TransientRenderTargets;     // Render targets in the render script transient pools
+        uint32_t m_TransientRenderTargetBytes; // Estimated memory used by the transient pools
+        // Time spent in DrawRenderList (us)
+        uint32_t m_SortTime;             // Sorting the render list, including the sort keys
+        uint32_t m_CullTime;             // Frustum culling
+        uint32_t m_DispatchTime;         // The render list dispatch callbacks, where vertex data is generated
+        uint32_t m_DrawTime;             // Drawing the render objects
     };
 
     enum TextAlign
@@ -173,6 +218,7 @@ namespace dmRender
     // Takes the contents of the render list, sorts by view and inserts all the objects in the
     // render list, unless they already are in place from a previous call.
     Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer, const FrustumOptions* frustum_options);
+    Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer, const FrustumOptions* frustum_options, SortMode sort_mode);
 
     Result Draw(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer);
     Result DrawDebug3d(HRenderContext context, const FrustumOptions* frustum_options);
@@ -243,6 +289,7 @@ namespace dmRender
     dmhash_t                        GetMaterialSamplerNameHash(HMaterial material, uint32_t unit);
     uint32_t                        GetMaterialSamplerUnit(HMaterial material, dmhash_t name_hash);
     void                            ApplyMaterialConstants(dmRender::HRenderContext render_context, HMaterial material, const RenderObject* ro);
+    void                            InvalidateMaterialConstants(HMaterial material);
     void                            ApplyMaterialSampler(dmRender::HRenderContext render_context, HMaterial material, HSampler sampler, uint8_t value_index, dmGraphics::HTexture texture);
 
     dmGraphics::HProgram            GetMaterialProgram(HMaterial material);
@@ -340,6 +387,42 @@ namespace dmRender
     void                            TrimBuffer(HRenderContext render_context, HBufferedRenderBuffer buffer);
     void                            RewindBuffer(HRenderContext render_context, HBufferedRenderBuffer buffer);
 
+    /** Transient render buffers
+     * The render context owns one transient vertex buffer and one transient index buffer that
+     * dynamic renderers can sub-allocate from, instead of owning and uploading buffers of their own.
+     * The allocations are linear and only live for the current frame. All data allocated since the
+     * last flush is uploaded with a single call before the render objects are drawn.
+     *
+     * Each frame uses its own set of graphics buffers (MAX_TRANSIENT_BUFFER_FRAMES), so that we never
+     * write to a buffer that might still be in use by the GPU from a previous frame.
+     *
+     * A typical usage scenario will look like this:
+     * HRenderBuffer buffer;
+     * uint32_t offset;
+     * MyVertex* vertices = (MyVertex*) AllocTransientBuffer(ctx, RENDER_BUFFER_TYPE_VERTEX_BUFFER, count * sizeof(MyVertex), sizeof(MyVertex), category, &buffer, &offset);
+     * ... write vertices ...
+     * ro.m_VertexBuffer = (dmGraphics::HVertexBuffer) buffer;
+     * ro.m_VertexStart  = offset / sizeof(MyVertex);
+     *
+     * Note: The returned pointer is only valid until the next allocation of the same buffer type.
+     * The offset is aligned to a multiple of the alignment, which doesn't have to be a power of two.
+     * The category is only used for the stats, e.g. the hash of the component type name.
+     */
+    void*                           AllocTransientBuffer(HRenderContext render_context, RenderBufferType type, uint32_t size, uint32_t alignment, dmhash_t category, HRenderBuffer* out_buffer, uint32_t* out_offset);
+    void                            FlushTransientBuffers(HRenderContext render_context);
+    // Gets the upload stats from the previous frame
+    void                            GetTransientBufferStats(HRenderContext render_context, TransientBufferStats* stats);
+
+    /** Render statistics
+     * The counters are collected by the renderer (texture binds, state changes and render objects) and by the
+     * graphics layer (draw calls, vertices, uploads and program switches) during a frame.
+     * NextStatsFrame() is called once per frame, after everything has been drawn, and makes the counters
+     * of the finished frame available through GetStats().
+     */
+    void                            NextStatsFrame(HRenderContext render_context);
+    // Gets the stats of the previous frame
+    void                            GetStats(HRenderContext render_context, Stats* stats);
+
     /** Render cameras
      * A render camera is a wrapper around common camera properties such as fov, near and far planes, viewport and aspect ratio.
      * Within the engine, the render cameras are "owned" by the renderer, but they can be manipulated elsewhere.
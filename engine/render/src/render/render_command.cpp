@@ -55,7 +55,9 @@ namespace dmRender
         m_Operands[3] = op3;
     }
 
-    void ParseCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count)
+    // When free_data is false the commands belong to a recorded command list and are executed again later,
+    // so any heap allocated operands must be left untouched.
+    static void ExecuteCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count, bool free_data)
     {
         dmGraphics::HContext context = dmRender::GetGraphicsContext(render_context);
 
@@ -119,14 +121,16 @@ namespace dmRender
                 {
                     dmVMath::Matrix4* matrix = (dmVMath::Matrix4*)c->m_Operands[0];
                     dmRender::SetViewMatrix(render_context, *matrix);
-                    delete matrix;
+                    if (free_data)
+                        delete matrix;
                     break;
                 }
                 case COMMAND_TYPE_SET_PROJECTION:
                 {
                     dmVMath::Matrix4* matrix = (dmVMath::Matrix4*)c->m_Operands[0];
                     dmRender::SetProjectionMatrix(render_context, *matrix);
-                    delete matrix;
+                    if (free_data)
+                        delete matrix;
                     break;
                 }
                 case COMMAND_TYPE_SET_BLEND_FUNC:
@@ -179,15 +183,18 @@ namespace dmRender
                     FrustumOptions* frustum_options = (FrustumOptions*)c->m_Operands[2];
                     dmRender::DrawRenderList(render_context, (dmRender::Predicate*)c->m_Operands[0],
                                                              (dmRender::HNamedConstantBuffer)c->m_Operands[1],
-                                                             frustum_options);
-                    delete frustum_options;
+                                                             frustum_options,
+                                                             (dmRender::SortMode)c->m_Operands[3]);
+                    if (free_data)
+                        delete frustum_options;
                     break;
                 }
                 case COMMAND_TYPE_DRAW_DEBUG3D:
                 {
                     FrustumOptions* frustum_options = (FrustumOptions*)c->m_Operands[0];
                     dmRender::DrawDebug3d(render_context, frustum_options);
-                    delete frustum_options;
+                    if (free_data)
+                        delete frustum_options;
                     break;
                 }
                 case COMMAND_TYPE_DRAW_DEBUG2D:
@@ -210,6 +217,11 @@ namespace dmRender
                     render_context->m_CurrentRenderCamera           = (HRenderCamera) c->m_Operands[0];
                     render_context->m_CurrentRenderCameraUseFrustum = c->m_Operands[1];
                 } break;
+                case COMMAND_TYPE_EXECUTE_COMMANDS:
+                {
+                    // operand order: Commands, Count
+                    ExecuteCommands(render_context, (Command*) c->m_Operands[0], (uint32_t) c->m_Operands[1], false);
+                } break;
                 default:
                 {
                     dmLogError("No such render command (%d).", c->m_Type);
@@ -218,4 +230,36 @@ namespace dmRender
         }
     }
 
+    void ParseCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count)
+    {
+        ExecuteCommands(render_context, commands, command_count, true);
+    }
+
+    void ReplayCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count)
+    {
+        ExecuteCommands(render_context, commands, command_count, false);
+    }
+
+    void FreeCommands(Command* commands, uint32_t command_count)
+    {
+        for (uint32_t i=0; i<command_count; i++)
+        {
+            Command* c = &commands[i];
+            switch (c->m_Type)
+            {
+                case COMMAND_TYPE_SET_VIEW:
+                case COMMAND_TYPE_SET_PROJECTION:
+                    delete (dmVMath::Matrix4*)c->m_Operands[0];
+                    break;
+                case COMMAND_TYPE_DRAW:
+                    delete (FrustumOptions*)c->m_Operands[2];
+                    break;
+                case COMMAND_TYPE_DRAW_DEBUG3D:
+                    delete (FrustumOptions*)c->m_Operands[0];
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
 }
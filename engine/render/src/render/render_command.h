@@ -47,6 +47,7 @@ namespace dmRender
         COMMAND_TYPE_ENABLE_MATERIAL,
         COMMAND_TYPE_DISABLE_MATERIAL,
         COMMAND_TYPE_SET_RENDER_CAMERA,
+        COMMAND_TYPE_EXECUTE_COMMANDS,
         COMMAND_TYPE_MAX
     };
 
@@ -63,6 +64,10 @@ namespace dmRender
     };
 
     void ParseCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count);
+    // Executes the commands without releasing their operands, used for recorded command lists
+    void ReplayCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count);
+    // Releases the heap allocated operands (matrices, frustum options) of the commands
+    void FreeCommands(Command* commands, uint32_t command_count);
 }
 
 #endif /* RENDER_COMMANDS_H_ */
@@ -74,6 +74,15 @@ namespace dmRender
         uint16_t m_ValueCount;
     };
 
+    // Shadow copy of the last values uploaded for a material constant.
+    // The values are stored in Material::m_ConstantShadowValues.
+    struct MaterialConstantShadow
+    {
+        uint32_t m_ValueIndex;
+        uint16_t m_MaxValues;   // number of values declared in the program
+        uint16_t m_NumValues;   // number of values last uploaded, 0 if unknown
+    };
+
     struct Material
     {
         Material()
@@ -92,6 +101,8 @@ namespace dmRender
         dmArray<MaterialAttribute>              m_MaterialAttributes;
         dmArray<uint8_t>                        m_MaterialAttributeValues;
         dmArray<RenderConstant>                 m_Constants;
+        dmArray<MaterialConstantShadow>         m_ConstantShadows; // one per constant in m_Constants
+        dmArray<dmVMath::Vector4>               m_ConstantShadowValues;
         dmArray<Sampler>                        m_Samplers;
         uint32_t                                m_TagListKey; // the key to use with GetMaterialTagList()
         uint64_t                                m_UserData1;  // used for hot reloading. stores shader name
@@ -169,23 +180,49 @@ namespace dmRender
         uint32_t            m_StencilTestParamsSet : 1;
     };
 
+    struct Glyph;
+
+    // A glyph positioned in the local space of a text, at the left bearing on the baseline
+    struct TextLayoutGlyph
+    {
+        Glyph*              m_Glyph;
+        float               m_X;
+        float               m_Y;
+    };
+
+    // The cached layout of a text, which only depends on the string, the font map and the layout parameters.
+    // The cache texture coordinates are read from the glyphs when the vertices are produced, so evicting
+    // glyphs from the cache texture doesn't invalidate the layout.
+    struct TextLayout
+    {
+        dmArray<TextLayoutGlyph> m_Glyphs;
+        uint32_t            m_Version;  // The layout version of the font map when the layout was created
+        uint32_t            m_Frame;    // The last frame the layout was used
+    };
+
+    const uint32_t TEXT_LAYOUT_MAX_AGE = 30; // Number of frames an unused layout is kept
+
     struct TextContext
     {
         dmArray<dmRender::RenderObject>         m_RenderObjects;
         dmArray<dmRender::HNamedConstantBuffer> m_ConstantBuffers;
-        dmGraphics::HVertexBuffer           m_VertexBuffer;
         void*                               m_ClientBuffer;
         dmGraphics::HVertexDeclaration      m_VertexDecl;
         uint32_t                            m_RenderObjectIndex;
         uint32_t                            m_VertexIndex;
         uint32_t                            m_MaxVertexCount;
         uint32_t                            m_VerticesFlushed;
+        uint32_t                            m_RenderObjectsFlushed;
         dmArray<char>                       m_TextBuffer;
         // Map from batch id (hash of font-map etc) to index into m_TextEntries
         dmArray<TextEntry>                  m_TextEntries;
         uint32_t                            m_TextEntriesFlushed;
         uint32_t                            m_Frame;
         uint32_t                            m_PreviousFrame;
+        // Map from hash of text and layout parameters to cached layout
+        dmHashTable64<TextLayout*>          m_TextLayouts;
+        // Used when the layout cache is full
+        TextLayout                          m_TempTextLayout;
     };
 
     struct RenderScriptContext
@@ -222,6 +259,14 @@ namespace dmRender
         };
     };
 
+    struct RenderObjectStateSortKey
+    {
+        uintptr_t     m_Material;
+        uint32_t      m_Textures; // hash of the texture handles
+        uint32_t      m_State;    // see GetRenderObjectStateKey()
+        RenderObject* m_RenderObject;
+    };
+
     struct RenderListRange
     {
         uint32_t m_TagListKey;
@@ -230,10 +275,21 @@ namespace dmRender
         uint32_t m_Skip:1;      // During the current draw call
     };
 
+    // Max number of distinct tags that can be interned into a bit (see MaterialTagMask)
+    static const uint32_t MAX_MATERIAL_TAG_BITS = 128;
+
+    // The tags of a tag list (or predicate) as bits, with each tag given a bit index on first use.
+    struct MaterialTagMask
+    {
+        uint64_t m_Bits[MAX_MATERIAL_TAG_BITS / 64];
+        uint8_t  m_Valid:1; // 0 if one or more tags couldn't be given a bit (all bits in use)
+    };
+
     struct MaterialTagList
     {
-        uint32_t m_Count;
-        dmhash_t m_Tags[MAX_MATERIAL_TAG_COUNT];
+        uint32_t        m_Count;
+        dmhash_t        m_Tags[MAX_MATERIAL_TAG_COUNT];
+        MaterialTagMask m_Mask;
     };
 
     struct TextureBinding
@@ -261,6 +317,18 @@ namespace dmRender
         uint8_t          m_Dirty : 1;
     };
 
+    // The engine can clear the render objects more than once per frame (e.g the profiler),
+    // so we keep more frames than there are frames in flight.
+    const static uint32_t MAX_TRANSIENT_BUFFER_FRAMES = 4;
+
+    struct TransientBuffer
+    {
+        dmArray<uint8_t> m_Data;            // Everything allocated this frame
+        HRenderBuffer    m_Buffers[MAX_TRANSIENT_BUFFER_FRAMES];
+        uint32_t         m_BufferSizes[MAX_TRANSIENT_BUFFER_FRAMES];
+        uint32_t         m_UploadedSize;    // Number of bytes of m_Data already uploaded this frame
+    };
+
     struct RenderContext
     {
         DebugRenderer               m_DebugRenderer;
@@ -276,10 +344,19 @@ namespace dmRender
         dmArray<uint32_t>           m_RenderListSortBuffer;
         dmArray<uint32_t>           m_RenderListSortIndices;
         dmArray<RenderListRange>    m_RenderListRanges;         // Maps tagmask to a range in the (sorted) render list
+        dmArray<RenderObjectStateSortKey> m_RenderObjectSortKeys; // Scratch buffer when sorting render objects by state
         dmArray<TextureBinding>     m_TextureBindTable;
+
+        TransientBuffer             m_TransientBuffers[MAX_RENDER_BUFFER_TYPE_COUNT];
+        TransientBufferStats        m_TransientBufferStats;
+        TransientBufferStats        m_TransientBufferStatsPrevFrame;
+        Stats                       m_Stats;
+        Stats                       m_StatsPrevFrame;
+        uint32_t                    m_TransientBufferFrame;
         dmhash_t                    m_FrustumHash;
 
         dmHashTable32<MaterialTagList>  m_MaterialTagLists;
+        dmHashTable64<uint32_t>         m_MaterialTagBits;          // tag hash -> bit index in a MaterialTagMask
 
         dmOpaqueHandleContainer<RenderCamera> m_RenderCameras;
         HRenderCamera                         m_CurrentRenderCamera; // When != 0, the renderer will use the matrices from this camera.
@@ -304,8 +381,17 @@ namespace dmRender
         uint16_t               m_BufferIndex;
     };
 
+    void InitializeTransientBuffers(HRenderContext render_context);
+    void FinalizeTransientBuffers(HRenderContext render_context);
+    // Starts using the next set of transient buffers and discards all allocations
+    void NextTransientBufferFrame(HRenderContext render_context);
+
     void RenderTypeTextBegin(HRenderContext rendercontext, void* user_context);
     void RenderTypeTextDraw(HRenderContext rendercontext, void* user_context, RenderObject* ro_, uint32_t count);
+    // Returns the layout of the text entry from the layout cache, (re)creating it if needed
+    const TextLayout* GetTextLayout(TextContext& text_context, const TextEntry& te, const char* text);
+    // Deletes the cached text layouts that haven't been used for max_age frames
+    void PurgeTextLayouts(TextContext& text_context, uint32_t max_age);
 
     void RenderTypeDebugBegin(HRenderContext rendercontext, void* user_context);
     void RenderTypeDebugDraw(HRenderContext rendercontext, void* user_context, RenderObject* ro, uint32_t count);
@@ -317,12 +403,35 @@ namespace dmRender
 
     void FillElementIds(char* buffer, uint32_t buffer_size, dmhash_t element_ids[4]);
 
+    int32_t FindMaterialConstantIndex(HMaterial material, dmhash_t name_hash);
+    // Uploads the constant unless the values are identical to what was last uploaded to the program.
+    // A negative constant_index bypasses the shadow state and always uploads.
+    void SetMaterialConstant(dmGraphics::HContext graphics_context, HMaterial material, int32_t constant_index, dmGraphics::HUniformLocation location, const dmVMath::Vector4* values, uint32_t num_values, bool is_matrix);
+
     // Return true if the predicate tags all exist in the material tag list
     bool                            MatchMaterialTags(uint32_t material_tag_count, const dmhash_t* material_tags, uint32_t tag_count, const dmhash_t* tags);
     // Returns a hashkey that the material can use to get the list
     uint32_t                        RegisterMaterialTagList(HRenderContext context, uint32_t tag_count, const dmhash_t* tags);
     // Gets the list associated with a hash of all the tags (see RegisterMaterialTagList)
     void                            GetMaterialTagList(HRenderContext context, uint32_t list_hash, MaterialTagList* list);
+    // Gets the list associated with a hash of all the tags, or 0 if it isn't registered
+    const MaterialTagList*          FindMaterialTagList(HRenderContext context, uint32_t list_hash);
+    // Creates a mask from the tags, giving each new tag the next free bit
+    void                            MakeMaterialTagMask(HRenderContext context, uint32_t tag_count, const dmhash_t* tags, MaterialTagMask* mask);
+
+    // Return true if the predicate tags all exist in the material tag list.
+    // Uses the masks when possible, and falls back to MatchMaterialTags() otherwise
+    static inline bool MatchMaterialTagList(const MaterialTagList* list, const MaterialTagMask& mask, uint32_t tag_count, const dmhash_t* tags)
+    {
+        if (list->m_Mask.m_Valid && mask.m_Valid)
+        {
+            uint64_t missing = 0;
+            for (uint32_t i = 0; i < MAX_MATERIAL_TAG_BITS / 64; ++i)
+                missing |= mask.m_Bits[i] & ~list->m_Mask.m_Bits[i];
+            return missing == 0 && tag_count > 0; // don't render anything with no matches at all
+        }
+        return MatchMaterialTags(list->m_Count, list->m_Tags, tag_count, tags);
+    }
 
     void    SetTextureBindingByHash(dmRender::HRenderContext render_context, dmhash_t sampler_hash, dmGraphics::HTexture texture);
     void    SetTextureBindingByUnit(dmRender::HRenderContext render_context, uint32_t unit, dmGraphics::HTexture texture);
@@ -361,6 +470,11 @@ namespace dmRender
 
     bool FindTagListRange(RenderListRange* ranges, uint32_t num_ranges, uint32_t tag_list_key, RenderListRange& range);
 
+    // Packs the blend and face winding state a render object sets on top of the current pipeline state
+    uint32_t GetRenderObjectStateKey(const RenderObject* ro);
+    // Reorders the render objects in [start, end) by material, textures and state. Objects with stencil state are never moved.
+    void SortRenderObjectsByState(HRenderContext context, uint32_t start, uint32_t end);
+
 
     // ******************************************************************************************************
 
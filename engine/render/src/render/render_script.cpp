@@ -19,6 +19,7 @@
 
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
+#include <dlib/math.h>
 #include <dlib/hash.h>
 #include <dlib/message.h>
 #include <dlib/profile.h>
@@ -604,6 +605,15 @@ namespace dmRender
 
     bool InsertCommand(RenderScriptInstance* i, const Command& command)
     {
+        RenderCommandList* list = i->m_RecordingCommandList;
+        if (list)
+        {
+            if (list->m_Commands.Full())
+                list->m_Commands.OffsetCapacity(dmMath::Max(16U, list->m_Commands.Capacity()));
+            list->m_Commands.Push(command);
+            return true;
+        }
+
         if (i->m_CommandBuffer.Full())
             return false;
         else
@@ -611,6 +621,19 @@ namespace dmRender
         return true;
     }
 
+    // Keeps the Lua object at the stack index alive for as long as the command list being recorded
+    static void RetainRecordedObject(lua_State* L, RenderScriptInstance* i, int index)
+    {
+        RenderCommandList* list = i->m_RecordingCommandList;
+        if (!list)
+            return;
+        lua_pushvalue(L, index);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, list->m_ObjectsReference);
+        lua_pushvalue(L, -2);
+        lua_rawseti(L, -2, lua_objlen(L, -1) + 1);
+        lua_pop(L, 2);
+    }
+
     /*#
      * @name render.STATE_DEPTH_TEST
      * @variable
@@ -863,133 +886,20 @@ namespace dmRender
      * @variable
      */
 
-    /*# creates a new render target
-     * Creates a new render target according to the supplied
-     * specification table.
-     *
-     * The table should contain keys specifying which buffers should be created
-     * with what parameters. Each buffer key should have a table value consisting
-     * of parameters. The following parameter keys are available:
-     *
-     * Key                     | Values
-     * ----------------------- | ----------------------------
-     * `format`                |  `render.FORMAT_LUMINANCE`<br/>`render.FORMAT_RGB`<br/>`render.FORMAT_RGBA`<br/>`render.FORMAT_DEPTH`<br/>`render.FORMAT_STENCIL`<br/>`render.FORMAT_RGBA32F`<br/>`render.FORMAT_RGBA16F`<br/>
-     * `width`                 | number
-     * `height`                | number
-     * `min_filter` (optional) | `render.FILTER_LINEAR`<br/>`render.FILTER_NEAREST`
-     * `mag_filter` (optional) | `render.FILTER_LINEAR`<br/>`render.FILTER_NEAREST`
-     * `u_wrap`     (optional) | `render.WRAP_CLAMP_TO_BORDER`<br/>`render.WRAP_CLAMP_TO_EDGE`<br/>`render.WRAP_MIRRORED_REPEAT`<br/>`render.WRAP_REPEAT`<br/>
-     * `v_wrap`     (optional) | `render.WRAP_CLAMP_TO_BORDER`<br/>`render.WRAP_CLAMP_TO_EDGE`<br/>`render.WRAP_MIRRORED_REPEAT`<br/>`render.WRAP_REPEAT`
-     * `flags`      (optional) | `render.TEXTURE_BIT` (only applicable to depth and stencil buffers)
-     *
-     * The render target can be created to support multiple color attachments. Each attachment can have different format settings and texture filters,
-     * but attachments must be added in sequence, meaning you cannot create a render target at slot 0 and 3.
-     * Instead it has to be created with all four buffer types ranging from [0..3] (as denoted by render.BUFFER_COLORX_BIT where 'X' is the attachment you want to create).
-     * It is not guaranteed that the device running the script can support creating render targets with multiple color attachments. To check if the device can support multiple attachments,
-     * you can check if the `render` table contains any of the `BUFFER_COLOR1_BIT`, `BUFFER_COLOR2_BIT` or `BUFFER_COLOR3_BIT` constants:
-     *
-     * ```lua
-     * function init(self)
-     *     if render.BUFFER_COLOR1_BIT == nil then
-     *         -- this devices does not support multiple color attachments
-     *     end
-     * end
-     * ```
-     *
-     * @name render.render_target
-     * @param name [type:string] render target name
-     * @param parameters [type:table] table of buffer parameters, see the description for available keys and values
-     * @return render_target [type:render_target] new render target
-     * @examples
-     *
-     * How to create a new render target and draw to it:
-     *
-     * ```lua
-     * function init(self)
-     *     -- render target buffer parameters
-     *     local color_params = { format = render.FORMAT_RGBA,
-     *                            width = render.get_window_width(),
-     *                            height = render.get_window_height(),
-     *                            min_filter = render.FILTER_LINEAR,
-     *                            mag_filter = render.FILTER_LINEAR,
-     *                            u_wrap = render.WRAP_CLAMP_TO_EDGE,
-     *                            v_wrap = render.WRAP_CLAMP_TO_EDGE }
-     *     local depth_params = { format = render.FORMAT_DEPTH,
-     *                            width = render.get_window_width(),
-     *                            height = render.get_window_height(),
-     *                            u_wrap = render.WRAP_CLAMP_TO_EDGE,
-     *                            v_wrap = render.WRAP_CLAMP_TO_EDGE }
-     *     self.my_render_target = render.render_target({[render.BUFFER_COLOR_BIT] = color_params, [render.BUFFER_DEPTH_BIT] = depth_params })
-     * end
-     *
-     * function update(self, dt)
-     *     -- enable target so all drawing is done to it
-     *     render.set_render_target(self.my_render_target)
-     *
-     *     -- draw a predicate to the render target
-     *     render.draw(self.my_pred)
-     * end
-     * ```
-     *
-     * How to create a render target with multiple outputs:
-     *
-     * ```lua
-     * function init(self)
-     *     -- render target buffer parameters
-     *     local color_params_rgba = { format = render.FORMAT_RGBA,
-     *                                 width = render.get_window_width(),
-     *                                 height = render.get_window_height(),
-     *                                 min_filter = render.FILTER_LINEAR,
-     *                                 mag_filter = render.FILTER_LINEAR,
-     *                                 u_wrap = render.WRAP_CLAMP_TO_EDGE,
-     *                                 v_wrap = render.WRAP_CLAMP_TO_EDGE }
-     *     local color_params_float = { format = render.FORMAT_RG32F,
-     *                            width = render.get_window_width(),
-     *                            height = render.get_window_height(),
-     *                            min_filter = render.FILTER_LINEAR,
-     *                            mag_filter = render.FILTER_LINEAR,
-     *                            u_wrap = render.WRAP_CLAMP_TO_EDGE,
-     *                            v_wrap = render.WRAP_CLAMP_TO_EDGE }
-     *
-     *
-     *     -- Create a render target with three color attachments
-     *     -- Note: No depth buffer is attached here
-     *     self.my_render_target = render.render_target({
-     *            [render.BUFFER_COLOR0_BIT] = color_params_rgba,
-     *            [render.BUFFER_COLOR1_BIT] = color_params_rgba,
-     *            [render.BUFFER_COLOR2_BIT] = color_params_float, })
-     * end
-     *
-     * function update(self, dt)
-     *     -- enable target so all drawing is done to it
-     *     render.enable_render_target(self.my_render_target)
-     *
-     *     -- draw a predicate to the render target
-     *     render.draw(self.my_pred)
-     * end
-     * ```
-     *
-     */
-    int RenderScript_RenderTarget(lua_State* L)
+    // Reads the render target buffer parameters table at table_index (see render.render_target)
+    static void CheckRenderTargetParams(lua_State* L, int table_index, RenderScriptInstance* i, uint32_t* out_buffer_type_flags, dmGraphics::RenderTargetCreationParams* out_params)
     {
         int top = lua_gettop(L);
         (void)top;
 
-        RenderScriptInstance* i = RenderScriptInstance_Check(L);
-
-        // Legacy support
-        int table_index = 2;
-        if (lua_istable(L, 1))
-        {
-            table_index = 1;
-        }
-
         const char* required_keys[] = { "format", "width", "height" };
         uint32_t buffer_type_flags = 0;
         uint32_t max_tex_size = dmGraphics::GetMaxTextureSize(i->m_RenderContext->m_GraphicsContext);
         luaL_checktype(L, table_index, LUA_TTABLE);
 
-        dmGraphics::RenderTargetCreationParams params = {};
+        // Cleared including padding, since the params are also used as a key for the transient render targets
+        dmGraphics::RenderTargetCreationParams& params = *out_params;
+        memset(&params, 0, sizeof(params));
 
         lua_pushnil(L);
         while (lua_next(L, table_index))
@@ -1021,7 +931,7 @@ namespace dmRender
             }
             else
             {
-                return luaL_error(L, "Invalid buffer type supplied to %s.render_target: (%d)", RENDER_SCRIPT_LIB_NAME, (uint32_t) buffer_type);
+                luaL_error(L, "Invalid buffer type supplied to %s.render_target: (%d)", RENDER_SCRIPT_LIB_NAME, (uint32_t) buffer_type);
             }
 
             luaL_checktype(L, -1, LUA_TTABLE);
@@ -1044,7 +954,7 @@ namespace dmRender
             {
                 if (!required_found[i])
                 {
-                    return luaL_error(L, "Required parameter key not found: '%s'", required_keys[i]);
+                    luaL_error(L, "Required parameter key not found: '%s'", required_keys[i]);
                 }
             }
             lua_pushnil(L);
@@ -1054,7 +964,7 @@ namespace dmRender
                 const char* key = luaL_checkstring(L, -2);
                 if (lua_isnil(L, -1) != 0)
                 {
-                    return luaL_error(L, "nil value supplied to %s.render_target: %s.", RENDER_SCRIPT_LIB_NAME, key);
+                    luaL_error(L, "nil value supplied to %s.render_target: %s.", RENDER_SCRIPT_LIB_NAME, key);
                 }
 
                 if (strncmp(key, RENDER_SCRIPT_FORMAT_NAME, strlen(RENDER_SCRIPT_FORMAT_NAME)) == 0)
@@ -1064,14 +974,14 @@ namespace dmRender
                     {
                         if(p->m_Format != dmGraphics::TEXTURE_FORMAT_DEPTH)
                         {
-                            return luaL_error(L, "The only valid format for depth buffers is FORMAT_DEPTH.");
+                            luaL_error(L, "The only valid format for depth buffers is FORMAT_DEPTH.");
                         }
                     }
                     if(buffer_type == dmGraphics::BUFFER_TYPE_STENCIL_BIT)
                     {
                         if(p->m_Format != dmGraphics::TEXTURE_FORMAT_STENCIL)
                         {
-                            return luaL_error(L, "The only valid format for stencil buffers is FORMAT_STENCIL.");
+                            luaL_error(L, "The only valid format for stencil buffers is FORMAT_STENCIL.");
                         }
                     }
                 }
@@ -1117,7 +1027,7 @@ namespace dmRender
                 {
                     lua_pop(L, 2);
                     assert(top == lua_gettop(L));
-                    return luaL_error(L, "Unknown key supplied to %s.rendertarget: %s. Available keys are: %s, %s, %s, %s, %s, %s, %s, %s.",
+                    luaL_error(L, "Unknown key supplied to %s.rendertarget: %s. Available keys are: %s, %s, %s, %s, %s, %s, %s, %s.",
                         RENDER_SCRIPT_LIB_NAME, key,
                         RENDER_SCRIPT_FORMAT_NAME,
                         RENDER_SCRIPT_WIDTH_NAME,
@@ -1136,11 +1046,139 @@ namespace dmRender
             {
                 lua_pop(L, 1);
                 assert(top == lua_gettop(L));
-                return luaL_error(L, "Render target (type %s) of width %d and height %d is greater than max supported texture size %d for this platform.",
+                luaL_error(L, "Render target (type %s) of width %d and height %d is greater than max supported texture size %d for this platform.",
                     dmGraphics::GetBufferTypeLiteral(buffer_type), cp->m_Width, cp->m_Height, max_tex_size);
             }
         }
 
+        *out_buffer_type_flags = buffer_type_flags;
+    }
+
+    /*# creates a new render target
+     * Creates a new render target according to the supplied
+     * specification table.
+     *
+     * The table should contain keys specifying which buffers should be created
+     * with what parameters. Each buffer key should have a table value consisting
+     * of parameters. The following parameter keys are available:
+     *
+     * Key                     | Values
+     * ----------------------- | ----------------------------
+     * `format`                |  `render.FORMAT_LUMINANCE`<br/>`render.FORMAT_RGB`<br/>`render.FORMAT_RGBA`<br/>`render.FORMAT_DEPTH`<br/>`render.FORMAT_STENCIL`<br/>`render.FORMAT_RGBA32F`<br/>`render.FORMAT_RGBA16F`<br/>
+     * `width`                 | number
+     * `height`                | number
+     * `min_filter` (optional) | `render.FILTER_LINEAR`<br/>`render.FILTER_NEAREST`
+     * `mag_filter` (optional) | `render.FILTER_LINEAR`<br/>`render.FILTER_NEAREST`
+     * `u_wrap`     (optional) | `render.WRAP_CLAMP_TO_BORDER`<br/>`render.WRAP_CLAMP_TO_EDGE`<br/>`render.WRAP_MIRRORED_REPEAT`<br/>`render.WRAP_REPEAT`<br/>
+     * `v_wrap`     (optional) | `render.WRAP_CLAMP_TO_BORDER`<br/>`render.WRAP_CLAMP_TO_EDGE`<br/>`render.WRAP_MIRRORED_REPEAT`<br/>`render.WRAP_REPEAT`
+     * `flags`      (optional) | `render.TEXTURE_BIT` (only applicable to depth and stencil buffers)
+     *
+     * The render target can be created to support multiple color attachments. Each attachment can have different format settings and texture filters,
+     * but attachments must be added in sequence, meaning you cannot create a render target at slot 0 and 3.
+     * Instead it has to be created with all four buffer types ranging from [0..3] (as denoted by render.BUFFER_COLORX_BIT where 'X' is the attachment you want to create).
+     * It is not guaranteed that the device running the script can support creating render targets with multiple color attachments. To check if the device can support multiple attachments,
+     * you can check if the `render` table contains any of the `BUFFER_COLOR1_BIT`, `BUFFER_COLOR2_BIT` or `BUFFER_COLOR3_BIT` constants:
+     *
+     * ```lua
+     * function init(self)
+     *     if render.BUFFER_COLOR1_BIT == nil then
+     *         -- this devices does not support multiple color attachments
+     *     end
+     * end
+     * ```
+     *
+     * @name render.render_target
+     * @param name [type:string] render target name
+     * @param parameters [type:table] table of buffer parameters, see the description for available keys and values
+     * @return render_target [type:render_target] new render target
+     * @examples
+     *
+     * How to create a new render target and draw to it:
+     *
+     * ```lua
+     * function init(self)
+     *     -- render target buffer parameters
+     *     local color_params = { format = render.FORMAT_RGBA,
+     *                            width = render.get_window_width(),
+     *                            height = render.get_window_height(),
+     *                            min_filter = render.FILTER_LINEAR,
+     *                            mag_filter = render.FILTER_LINEAR,
+     *                            u_wrap = render.WRAP_CLAMP_TO_EDGE,
+     *                            v_wrap = render.WRAP_CLAMP_TO_EDGE }
+     *     local depth_params = { format = render.FORMAT_DEPTH,
+     *                            width = render.get_window_width(),
+     *                            height = render.get_window_height(),
+     *                            u_wrap = render.WRAP_CLAMP_TO_EDGE,
+     *                            v_wrap = render.WRAP_CLAMP_TO_EDGE }
+     *     self.my_render_target = render.render_target({[render.BUFFER_COLOR_BIT] = color_params, [render.BUFFER_DEPTH_BIT] = depth_params })
+     * end
+     *
+     * function update(self, dt)
+     *     -- enable target so all drawing is done to it
+     *     render.set_render_target(self.my_render_target)
+     *
+     *     -- draw a predicate to the render target
+     *     render.draw(self.my_pred)
+     * end
+     * ```
+     *
+     * How to create a render target with multiple outputs:
+     *
+     * ```lua
+     * function init(self)
+     *     -- render target buffer parameters
+     *     local color_params_rgba = { format = render.FORMAT_RGBA,
+     *                                 width = render.get_window_width(),
+     *                                 height = render.get_window_height(),
+     *                                 min_filter = render.FILTER_LINEAR,
+     *                                 mag_filter = render.FILTER_LINEAR,
+     *                                 u_wrap = render.WRAP_CLAMP_TO_EDGE,
+     *                                 v_wrap = render.WRAP_CLAMP_TO_EDGE }
+     *     local color_params_float = { format = render.FORMAT_RG32F,
+     *                            width = render.get_window_width(),
+     *                            height = render.get_window_height(),
+     *                            min_filter = render.FILTER_LINEAR,
+     *                            mag_filter = render.FILTER_LINEAR,
+     *                            u_wrap = render.WRAP_CLAMP_TO_EDGE,
+     *                            v_wrap = render.WRAP_CLAMP_TO_EDGE }
+     *
+     *
+     *     -- Create a render target with three color attachments
+     *     -- Note: No depth buffer is attached here
+     *     self.my_render_target = render.render_target({
+     *            [render.BUFFER_COLOR0_BIT] = color_params_rgba,
+     *            [render.BUFFER_COLOR1_BIT] = color_params_rgba,
+     *            [render.BUFFER_COLOR2_BIT] = color_params_float, })
+     * end
+     *
+     * function update(self, dt)
+     *     -- enable target so all drawing is done to it
+     *     render.enable_render_target(self.my_render_target)
+     *
+     *     -- draw a predicate to the render target
+     *     render.draw(self.my_pred)
+     * end
+     * ```
+     *
+     */
+    int RenderScript_RenderTarget(lua_State* L)
+    {
+        int top = lua_gettop(L);
+        (void)top;
+
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+
+        // Legacy support
+        int table_index = 2;
+        if (lua_istable(L, 1))
+        {
+            table_index = 1;
+        }
+
+        uint32_t buffer_type_flags = 0;
+        dmGraphics::RenderTargetCreationParams params;
+        CheckRenderTargetParams(L, table_index, i, &buffer_type_flags, &params);
+
         dmGraphics::HRenderTarget render_target = dmGraphics::NewRenderTarget(i->m_RenderContext->m_GraphicsContext, buffer_type_flags, params);
         assert(dmGraphics::GetAssetType(render_target) == dmGraphics::ASSET_TYPE_RENDER_TARGET);
 
@@ -1212,7 +1250,7 @@ namespace dmRender
     /*# deletes a render target
      *
      * Deletes a render target created by a render script.
-     * You cannot delete a render target resource.
+     * You cannot delete a render target resource, or a transient render target acquired with [ref:render.acquire_render_target].
      *
      * @name render.delete_render_target
      * @param render_target [type:render_target] render target to delete
@@ -1233,10 +1271,193 @@ namespace dmRender
 
         RenderScriptInstance* i = RenderScriptInstance_Check(L);
         dmGraphics::HRenderTarget render_target = (dmGraphics::HRenderTarget) CheckAssetHandle(L, 1, i->m_RenderContext->m_GraphicsContext, dmGraphics::ASSET_TYPE_RENDER_TARGET);
+
+        // The transient pool owns its render targets, and deletes them when they've been unused for a few frames
+        dmArray<TransientRenderTarget>& pool = i->m_TransientRenderTargets;
+        for (uint32_t t = 0; t < pool.Size(); ++t)
+        {
+            if (pool[t].m_RenderTarget == render_target)
+            {
+                return luaL_error(L, "Transient render targets can't be deleted, use %s.release_render_target.", RENDER_SCRIPT_LIB_NAME);
+            }
+        }
+
         dmGraphics::DeleteRenderTarget(render_target);
         return 0;
     }
 
+    // Number of frames a transient render target can stay unused in the pool before it is deleted
+    static const uint32_t TRANSIENT_RENDER_TARGET_MAX_UNUSED_FRAMES = 3;
+
+    static uint32_t GetRenderTargetSize(uint32_t buffer_type_flags, const dmGraphics::RenderTargetCreationParams& params)
+    {
+        uint32_t size = 0;
+        for (uint32_t i = 0; i < dmGraphics::MAX_BUFFER_COLOR_ATTACHMENTS; ++i)
+        {
+            const dmGraphics::TextureParams& p = params.m_ColorBufferParams[i];
+            if (p.m_Width > 0 && p.m_Height > 0)
+                size += p.m_Width * p.m_Height * (dmGraphics::GetTextureFormatBitsPerPixel(p.m_Format) / 8);
+        }
+        if (buffer_type_flags & dmGraphics::BUFFER_TYPE_DEPTH_BIT)
+            size += params.m_DepthBufferParams.m_Width * params.m_DepthBufferParams.m_Height * 4;
+        if (buffer_type_flags & dmGraphics::BUFFER_TYPE_STENCIL_BIT)
+            size += params.m_StencilBufferParams.m_Width * params.m_StencilBufferParams.m_Height;
+        return size;
+    }
+
+    /*# acquires a render target from the transient pool
+     *
+     * Gets a render target matching the supplied specification table from the render script's
+     * transient pool, creating a new one only if there is no free render target with the same parameters.
+     * The table has the same format as for [ref:render.render_target].
+     *
+     * A transient render target is only valid during the frame it was acquired. All transient render targets
+     * are returned to the pool at the end of the frame, and render targets unused for a few frames are deleted.
+     * Passes that don't overlap can share the same memory by calling [ref:render.release_render_target] as soon as a
+     * render target is no longer needed, which makes it available to subsequent calls in the same frame.
+     *
+     * Transient render targets should not be used in command lists recorded with [ref:render.begin_commands], or be deleted
+     * with [ref:render.delete_render_target].
+     *
+     * @name render.acquire_render_target
+     * @param parameters [type:table] table of buffer parameters, see [ref:render.render_target]
+     * @return render_target [type:render_target] the transient render target
+     * @examples
+     *
+     * A blur pass using two transient render targets, where the second target reuses the memory of the first
+     *
+     * ```lua
+     * function update(self)
+     *     local w, h = render.get_window_width(), render.get_window_height()
+     *     local params = { [render.BUFFER_COLOR_BIT] = { format = render.FORMAT_RGBA, width = w, height = h } }
+     *
+     *     local scene = render.acquire_render_target(params)
+     *     render.set_render_target(scene)
+     *     render.draw(self.model_pred)
+     *
+     *     local blur = render.acquire_render_target(params)
+     *     render.set_render_target(blur)
+     *     render.enable_texture(0, scene, render.BUFFER_COLOR_BIT)
+     *     render.draw(self.blur_pred)
+     *     render.disable_texture(0)
+     *     render.release_render_target(scene)
+     *
+     *     local bloom = render.acquire_render_target(params) -- gets the render target 'scene' used
+     *     -- ...
+     * end
+     * ```
+     */
+    int RenderScript_AcquireRenderTarget(lua_State* L)
+    {
+        int top = lua_gettop(L);
+        (void)top;
+
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+
+        uint32_t buffer_type_flags = 0;
+        dmGraphics::RenderTargetCreationParams params;
+        CheckRenderTargetParams(L, 1, i, &buffer_type_flags, &params);
+
+        HashState32 hash_state;
+        dmHashInit32(&hash_state, false);
+        dmHashUpdateBuffer32(&hash_state, &buffer_type_flags, sizeof(buffer_type_flags));
+        dmHashUpdateBuffer32(&hash_state, &params, sizeof(params));
+        uint32_t params_hash = dmHashFinal32(&hash_state);
+
+        dmArray<TransientRenderTarget>& pool = i->m_TransientRenderTargets;
+        for (uint32_t t = 0; t < pool.Size(); ++t)
+        {
+            TransientRenderTarget& entry = pool[t];
+            if (!entry.m_InUse && entry.m_ParamsHash == params_hash)
+            {
+                entry.m_InUse         = 1;
+                entry.m_LastUsedFrame = i->m_TransientRenderTargetFrame;
+                lua_pushnumber(L, entry.m_RenderTarget);
+                assert(top + 1 == lua_gettop(L));
+                return 1;
+            }
+        }
+
+        dmGraphics::HRenderTarget render_target = dmGraphics::NewRenderTarget(i->m_RenderContext->m_GraphicsContext, buffer_type_flags, params);
+        if (render_target == 0)
+        {
+            return luaL_error(L, "Unable to create render target.");
+        }
+
+        TransientRenderTarget entry;
+        entry.m_RenderTarget  = render_target;
+        entry.m_ParamsHash    = params_hash;
+        entry.m_Size          = GetRenderTargetSize(buffer_type_flags, params);
+        entry.m_LastUsedFrame = i->m_TransientRenderTargetFrame;
+        entry.m_InUse         = 1;
+
+        if (pool.Full())
+            pool.OffsetCapacity(4);
+        pool.Push(entry);
+
+        lua_pushnumber(L, render_target);
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
+    /*# releases a transient render target
+     *
+     * Returns a render target acquired with [ref:render.acquire_render_target] to the transient pool,
+     * so that it can be reused by later passes in the same frame. The render target must not be used
+     * by any commands issued after it has been released.
+     *
+     * @name render.release_render_target
+     * @param render_target [type:render_target] the transient render target to release
+     */
+    int RenderScript_ReleaseRenderTarget(lua_State* L)
+    {
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        if (!lua_isnumber(L, 1))
+        {
+            return luaL_error(L, "Invalid render target (nil) supplied to %s.release_render_target.", RENDER_SCRIPT_LIB_NAME);
+        }
+        dmGraphics::HRenderTarget render_target = (dmGraphics::HRenderTarget) lua_tonumber(L, 1);
+
+        dmArray<TransientRenderTarget>& pool = i->m_TransientRenderTargets;
+        for (uint32_t t = 0; t < pool.Size(); ++t)
+        {
+            if (pool[t].m_RenderTarget == render_target)
+            {
+                if (!pool[t].m_InUse)
+                {
+                    return luaL_error(L, "The render target has already been released.");
+                }
+                pool[t].m_InUse = 0;
+                return 0;
+            }
+        }
+        return luaL_error(L, "The render target was not acquired with %s.acquire_render_target.", RENDER_SCRIPT_LIB_NAME);
+    }
+
+    // Called at the end of each frame, when all commands using the transient render targets have been executed
+    static void UpdateTransientRenderTargets(RenderScriptInstance* i)
+    {
+        dmArray<TransientRenderTarget>& pool = i->m_TransientRenderTargets;
+        Stats& stats = i->m_RenderContext->m_Stats;
+
+        uint32_t t = 0;
+        while (t < pool.Size())
+        {
+            TransientRenderTarget& entry = pool[t];
+            if (i->m_TransientRenderTargetFrame - entry.m_LastUsedFrame >= TRANSIENT_RENDER_TARGET_MAX_UNUSED_FRAMES)
+            {
+                dmGraphics::DeleteRenderTarget(entry.m_RenderTarget);
+                pool.EraseSwap(t);
+                continue;
+            }
+            entry.m_InUse = 0;
+            stats.m_TransientRenderTargets++;
+            stats.m_TransientRenderTargetBytes += entry.m_Size;
+            ++t;
+        }
+        i->m_TransientRenderTargetFrame++;
+    }
+
     /*#
      * @name render.RENDER_TARGET_DEFAULT
      * @variable
@@ -1872,6 +2093,13 @@ namespace dmRender
      * `constants`
      * : [type:constant_buffer] optional constants to use while rendering
      *
+     * `sort_mode`
+     * : [type:int] Determines how world ordered objects are sorted. Default is render.SORT_MODE_DEPTH.
+     *
+     * - render.SORT_MODE_DEPTH : Sorted back to front.
+     * - render.SORT_MODE_STATE : Sorted by material, textures and blend state, to minimise state changes and draw calls.
+     *   Use it for objects that don't depend on the draw order, e.g. opaque geometry with depth testing.
+     *
      * @examples
      *
      * ```lua
@@ -1908,6 +2136,13 @@ namespace dmRender
      * render.draw(self.my_pred, {frustum = frustum, frustum_planes = render.FRUSTUM_PLANES_ALL})
      * ```
 
+     * Draw opaque geometry sorted on state instead of depth:
+     *
+     * ```lua
+     * render.enable_state(render.STATE_DEPTH_TEST)
+     * render.draw(self.opaque_pred, {sort_mode = render.SORT_MODE_STATE})
+     * ```
+
      */
     int RenderScript_Draw(lua_State* L)
     {
@@ -1917,6 +2152,7 @@ namespace dmRender
         {
             HPredicate* tmp = RenderScriptPredicate_Check(L, 1);
             predicate = *tmp;
+            RetainRecordedObject(L, i, 1);
         }
         else
         {
@@ -1926,6 +2162,7 @@ namespace dmRender
         dmVMath::Matrix4* frustum_matrix = 0;
         dmRender::FrustumPlanes frustum_num_planes = dmRender::FRUSTUM_PLANES_SIDES;
         HNamedConstantBuffer constant_buffer = 0;
+        dmRender::SortMode sort_mode = dmRender::SORT_MODE_DEPTH;
 
         if (lua_istable(L, 2))
         {
@@ -1941,7 +2178,15 @@ namespace dmRender
             lua_pop(L, 1);
 
             lua_getfield(L, -1, "constants");
-            constant_buffer = lua_isnil(L, -1) ? 0 : *RenderScriptConstantBuffer_Check(L, -1);
+            if (!lua_isnil(L, -1))
+            {
+                constant_buffer = *RenderScriptConstantBuffer_Check(L, -1);
+                RetainRecordedObject(L, i, lua_gettop(L));
+            }
+            lua_pop(L, 1);
+
+            lua_getfield(L, -1, "sort_mode");
+            sort_mode = lua_isnil(L, -1) ? sort_mode : (dmRender::SortMode)luaL_checkinteger(L, -1);
             lua_pop(L, 1);
 
             lua_pop(L, 1);
@@ -1951,6 +2196,7 @@ namespace dmRender
             dmLogOnceWarning("This interface for render.draw() is deprecated. Please see documentation at https://defold.com/ref/stable/render/#render.draw:predicate-[constants]")
             HNamedConstantBuffer* tmp = RenderScriptConstantBuffer_Check(L, 2);
             constant_buffer = *tmp;
+            RetainRecordedObject(L, i, 2);
         }
 
         // we need to pass ownership to the command queue
@@ -1962,7 +2208,7 @@ namespace dmRender
             frustum_options->m_NumPlanes = frustum_num_planes;
         }
 
-        if (InsertCommand(i, Command(COMMAND_TYPE_DRAW, (uint64_t)predicate, (uint64_t) constant_buffer, (uint64_t) frustum_options)))
+        if (InsertCommand(i, Command(COMMAND_TYPE_DRAW, (uint64_t)predicate, (uint64_t) constant_buffer, (uint64_t) frustum_options, (uint64_t) sort_mode)))
             return 0;
         else
             return luaL_error(L, "Command buffer is full (%d).", i->m_CommandBuffer.Capacity());
@@ -2123,6 +2369,16 @@ namespace dmRender
      * @variable
      */
 
+    /*#
+     * @name render.SORT_MODE_DEPTH
+     * @variable
+     */
+
+    /*#
+     * @name render.SORT_MODE_STATE
+     * @variable
+     */
+
     /*#
      * @name render.BLEND_ZERO
      * @variable
@@ -2871,6 +3127,106 @@ namespace dmRender
         return 1;
     }
 
+    /*# gets the render statistics of the previous frame
+     *
+     * Returns the number of draw calls, uploads and state changes of the previous frame.
+     * Use it to keep track of performance budgets while developing, e.g. by showing the
+     * values on screen or logging them when a budget is exceeded.
+     *
+     * @name render.get_stats
+     * @return stats [type:table] table with the counters of the previous frame:
+     *
+     * `draw_calls`
+     * : [type:number] number of draw calls
+     *
+     * `vertices`
+     * : [type:number] number of vertices (or indices) submitted, including all instances
+     *
+     * `buffer_bytes_uploaded`
+     * : [type:number] number of bytes uploaded to vertex and index buffers
+     *
+     * `texture_uploads`
+     * : [type:number] number of texture uploads
+     *
+     * `texture_bytes_uploaded`
+     * : [type:number] number of bytes uploaded to textures
+     *
+     * `program_switches`
+     * : [type:number] number of shader program switches
+     *
+     * `texture_binds`
+     * : [type:number] number of texture binds
+     *
+     * `state_changes`
+     * : [type:number] number of pipeline state changes (blend, stencil, face winding etc)
+     *
+     * `render_objects`
+     * : [type:number] number of render objects drawn
+     *
+     * `transient_render_targets`
+     * : [type:number] number of render targets in the transient pool, see [ref:render.acquire_render_target]
+     *
+     * `transient_render_target_bytes`
+     * : [type:number] estimated memory used by the render targets in the transient pool
+     *
+     * `sort_time`
+     * : [type:number] time spent sorting the render list (microseconds)
+     *
+     * `cull_time`
+     * : [type:number] time spent frustum culling the render list (microseconds)
+     *
+     * `dispatch_time`
+     * : [type:number] time spent in the component render callbacks, generating vertex data (microseconds)
+     *
+     * `draw_time`
+     * : [type:number] time spent drawing the render objects (microseconds)
+     *
+     * @examples
+     *
+     * Warn when the draw call budget is exceeded
+     *
+     * ```lua
+     * local stats = render.get_stats()
+     * if stats.draw_calls > 100 then
+     *     print("Draw call budget exceeded:", stats.draw_calls)
+     * end
+     * ```
+     */
+    static int RenderScript_GetStats(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+
+        Stats stats;
+        GetStats(i->m_RenderContext, &stats);
+
+        lua_newtable(L);
+
+#define SET_STATS_FIELD(name, value)\
+        lua_pushinteger(L, (lua_Integer) value); \
+        lua_setfield(L, -2, name);
+
+        SET_STATS_FIELD("draw_calls",             stats.m_DrawCalls);
+        SET_STATS_FIELD("vertices",               stats.m_Vertices);
+        SET_STATS_FIELD("buffer_bytes_uploaded",  stats.m_BufferBytesUploaded);
+        SET_STATS_FIELD("texture_uploads",        stats.m_TextureUploads);
+        SET_STATS_FIELD("texture_bytes_uploaded", stats.m_TextureBytesUploaded);
+        SET_STATS_FIELD("program_switches",       stats.m_ProgramSwitches);
+        SET_STATS_FIELD("texture_binds",          stats.m_TextureBinds);
+        SET_STATS_FIELD("state_changes",          stats.m_StateChanges);
+        SET_STATS_FIELD("render_objects",         stats.m_RenderObjects);
+        SET_STATS_FIELD("transient_render_targets",      stats.m_TransientRenderTargets);
+        SET_STATS_FIELD("transient_render_target_bytes", stats.m_TransientRenderTargetBytes);
+        SET_STATS_FIELD("sort_time",              stats.m_SortTime);
+        SET_STATS_FIELD("cull_time",              stats.m_CullTime);
+        SET_STATS_FIELD("dispatch_time",          stats.m_DispatchTime);
+        SET_STATS_FIELD("draw_time",              stats.m_DrawTime);
+
+#undef SET_STATS_FIELD
+
+        return 1;
+    }
+
     /*# creates a new render predicate
      *
      * This function returns a new render predicate for objects with materials matching
@@ -3072,12 +3428,257 @@ namespace dmRender
         return DM_LUA_ERROR("Command buffer is full (%d).", i->m_CommandBuffer.Capacity());
     }
 
+    static void DeleteCommandList(lua_State* L, RenderCommandList* list)
+    {
+        FreeCommands(list->m_Commands.Begin(), list->m_Commands.Size());
+        dmScript::Unref(L, LUA_REGISTRYINDEX, list->m_ObjectsReference);
+        delete list;
+    }
+
+    static void DeletePendingCommandLists(lua_State* L, RenderScriptInstance* i)
+    {
+        for (uint32_t j = 0; j < i->m_CommandListsToDelete.Size(); ++j)
+        {
+            DeleteCommandList(L, i->m_CommandListsToDelete[j]);
+        }
+        i->m_CommandListsToDelete.SetSize(0);
+    }
+
+    // Returns the slot of the command list handle at the index, or -1 if it isn't a valid handle.
+    // Doesn't raise any errors, since the callers hold a stack check.
+    static int GetCommandListSlot(lua_State* L, RenderScriptInstance* i, int index)
+    {
+        if (lua_type(L, index) != LUA_TNUMBER)
+            return -1;
+        int handle = (int) lua_tointeger(L, index);
+        if (handle < 1 || handle > (int) i->m_CommandLists.Size() || i->m_CommandLists[handle - 1] == 0)
+            return -1;
+        return handle - 1;
+    }
+
+    // A recorded list keeps the handles it was recorded with, which are stale if the
+    // render target, texture or camera has been deleted since
+    static bool HasValidHandles(RenderScriptInstance* i, RenderCommandList* list)
+    {
+        dmGraphics::HContext graphics_context = i->m_RenderContext->m_GraphicsContext;
+        for (uint32_t j = 0; j < list->m_Commands.Size(); ++j)
+        {
+            const Command& c = list->m_Commands[j];
+            switch (c.m_Type)
+            {
+                case COMMAND_TYPE_SET_RENDER_TARGET:
+                    if (c.m_Operands[0] != 0 && !dmGraphics::IsAssetHandleValid(graphics_context, (dmGraphics::HAssetHandle) c.m_Operands[0]))
+                        return false;
+                    break;
+                case COMMAND_TYPE_ENABLE_TEXTURE:
+                    if (!dmGraphics::IsAssetHandleValid(graphics_context, (dmGraphics::HAssetHandle) c.m_Operands[2]))
+                        return false;
+                    break;
+                case COMMAND_TYPE_SET_RENDER_CAMERA:
+                    if (c.m_Operands[0] != 0 && i->m_RenderContext->m_RenderCameras.Get((HRenderCamera) c.m_Operands[0]) == 0)
+                        return false;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
+    /*# starts recording a command list
+     * Starts recording render commands into a command list instead of the command buffer of the
+     * current frame. All render commands issued until [ref:render.end_commands] is called are
+     * recorded, and the list can then be replayed any number of times with [ref:render.execute].
+     *
+     * Recording a list once and replaying it saves the cost of issuing the same commands from Lua
+     * every frame. Note that all arguments are captured when the commands are recorded, including
+     * matrices passed to [ref:render.set_view] and [ref:render.set_projection] and the frustum passed
+     * to [ref:render.draw]. State that changes from frame to frame should be set outside of the list,
+     * before calling [ref:render.execute], or come from a camera set with [ref:render.set_camera].
+     *
+     * @name render.begin_commands
+     * @examples
+     *
+     * Record the passes of the render script once and replay them every frame
+     *
+     * ```lua
+     * function init(self)
+     *     self.predicate = render.predicate({"tile"})
+     *
+     *     render.begin_commands()
+     *     render.set_depth_mask(false)
+     *     render.enable_state(render.STATE_BLEND)
+     *     render.set_blend_func(render.BLEND_SRC_ALPHA, render.BLEND_ONE_MINUS_SRC_ALPHA)
+     *     render.draw(self.predicate)
+     *     self.commands = render.end_commands()
+     * end
+     *
+     * function update(self)
+     *     render.set_view(self.view)
+     *     render.set_projection(self.projection)
+     *     render.execute(self.commands)
+     * end
+     * ```
+     */
+    static int RenderScript_BeginCommands(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        if (i->m_RecordingCommandList)
+        {
+            return DM_LUA_ERROR("A command list is already being recorded, call %s.end_commands() first.", RENDER_SCRIPT_LIB_NAME);
+        }
+
+        RenderCommandList* list = new RenderCommandList;
+        list->m_Commands.SetCapacity(16);
+        lua_newtable(L);
+        list->m_ObjectsReference = dmScript::Ref(L, LUA_REGISTRYINDEX);
+        i->m_RecordingCommandList = list;
+        return 0;
+    }
+
+    /*# stops recording a command list
+     * Stops recording the command list started with [ref:render.begin_commands] and returns a handle to it.
+     * The command list stays valid until it is deleted with [ref:render.delete_commands], or the render script is deleted.
+     *
+     * @name render.end_commands
+     * @return list [type:number] handle to the recorded command list
+     * @examples
+     *
+     * ```lua
+     * render.begin_commands()
+     * render.draw(self.predicate)
+     * self.commands = render.end_commands()
+     * ```
+     */
+    static int RenderScript_EndCommands(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        RenderCommandList* list = i->m_RecordingCommandList;
+        if (!list)
+        {
+            return DM_LUA_ERROR("No command list is being recorded, call %s.begin_commands() first.", RENDER_SCRIPT_LIB_NAME);
+        }
+        i->m_RecordingCommandList = 0;
+
+        // Reuse the slot of a deleted list if there is one
+        uint32_t slot = i->m_CommandLists.Size();
+        for (uint32_t j = 0; j < i->m_CommandLists.Size(); ++j)
+        {
+            if (i->m_CommandLists[j] == 0)
+            {
+                slot = j;
+                break;
+            }
+        }
+
+        if (slot == i->m_CommandLists.Size())
+        {
+            if (i->m_CommandLists.Full())
+                i->m_CommandLists.OffsetCapacity(8);
+            i->m_CommandLists.Push(list);
+        }
+        else
+        {
+            i->m_CommandLists[slot] = list;
+        }
+
+        lua_pushinteger(L, (lua_Integer) slot + 1);
+        return 1;
+    }
+
+    /*# executes a recorded command list
+     * Executes the commands of a command list recorded with [ref:render.begin_commands] and [ref:render.end_commands],
+     * at this position in the current frame. The commands are executed as they were recorded, which means any state
+     * set by the list (viewport, blend state, render target etc.) is still active after the list has been executed.
+     * A list that uses a render target, texture or camera that has since been deleted can't be executed, and
+     * has to be recorded again.
+     *
+     * @name render.execute
+     * @param list [type:number] handle to the recorded command list
+     * @examples
+     *
+     * ```lua
+     * function update(self)
+     *     render.set_view(self.view)
+     *     render.set_projection(self.projection)
+     *     render.execute(self.commands)
+     * end
+     * ```
+     */
+    static int RenderScript_Execute(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        int slot = GetCommandListSlot(L, i, 1);
+        if (slot < 0)
+        {
+            return DM_LUA_ERROR("Invalid command list handle (%d).", (int) lua_tointeger(L, 1));
+        }
+        if (i->m_RecordingCommandList)
+        {
+            return DM_LUA_ERROR("Command lists cannot be executed while recording a command list.");
+        }
+
+        RenderCommandList* list = i->m_CommandLists[slot];
+        if (!HasValidHandles(i, list))
+        {
+            return DM_LUA_ERROR("Command list %d uses a render target, texture or camera that has been deleted.", slot + 1);
+        }
+
+        if (list->m_Commands.Empty())
+            return 0;
+
+        if (InsertCommand(i, Command(COMMAND_TYPE_EXECUTE_COMMANDS, (uint64_t) list->m_Commands.Begin(), list->m_Commands.Size())))
+            return 0;
+        return DM_LUA_ERROR("Command buffer is full (%d).", i->m_CommandBuffer.Capacity());
+    }
+
+    /*# deletes a recorded command list
+     * Deletes a command list recorded with [ref:render.begin_commands] and [ref:render.end_commands].
+     * The handle is invalid after this call. It is safe to delete a list that has been executed in the current frame.
+     *
+     * @name render.delete_commands
+     * @param list [type:number] handle to the recorded command list
+     * @examples
+     *
+     * ```lua
+     * function on_message(self, message_id, message)
+     *     if message_id == hash("window_resized") then
+     *         render.delete_commands(self.commands)
+     *         self.commands = record_commands(self)
+     *     end
+     * end
+     * ```
+     */
+    static int RenderScript_DeleteCommands(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        int slot = GetCommandListSlot(L, i, 1);
+        if (slot < 0)
+        {
+            return DM_LUA_ERROR("Invalid command list handle (%d).", (int) lua_tointeger(L, 1));
+        }
+
+        // The list might be referenced from the command buffer of the current frame,
+        // so it is deleted after the commands have been executed
+        if (i->m_CommandListsToDelete.Full())
+            i->m_CommandListsToDelete.OffsetCapacity(8);
+        i->m_CommandListsToDelete.Push(i->m_CommandLists[slot]);
+        i->m_CommandLists[slot] = 0;
+        return 0;
+    }
+
     static const luaL_reg Render_methods[] =
     {
         {"enable_state",                    RenderScript_EnableState},
         {"disable_state",                   RenderScript_DisableState},
         {"render_target",                   RenderScript_RenderTarget},
         {"delete_render_target",            RenderScript_DeleteRenderTarget},
+        {"acquire_render_target",           RenderScript_AcquireRenderTarget},
+        {"release_render_target",           RenderScript_ReleaseRenderTarget},
         {"set_render_target",               RenderScript_SetRenderTarget},
         {"enable_render_target",            RenderScript_EnableRenderTarget},
         {"disable_render_target",           RenderScript_DisableRenderTarget},
@@ -3106,11 +3707,16 @@ namespace dmRender
         {"get_height",                      RenderScript_GetHeight},
         {"get_window_width",                RenderScript_GetWindowWidth},
         {"get_window_height",               RenderScript_GetWindowHeight},
+        {"get_stats",                       RenderScript_GetStats},
         {"predicate",                       RenderScript_Predicate},
         {"constant_buffer",                 RenderScript_ConstantBuffer},
         {"enable_material",                 RenderScript_EnableMaterial},
         {"disable_material",                RenderScript_DisableMaterial},
         {"set_camera",                      RenderScript_SetCamera},
+        {"begin_commands",                  RenderScript_BeginCommands},
+        {"end_commands",                    RenderScript_EndCommands},
+        {"execute",                         RenderScript_Execute},
+        {"delete_commands",                 RenderScript_DeleteCommands},
         {0, 0}
     };
 
@@ -3287,6 +3893,15 @@ namespace dmRender
 
 #undef REGISTER_FRUSTUM_PLANES_CONSTANT
 
+#define REGISTER_SORT_MODE_CONSTANT(name)\
+        lua_pushnumber(L, (lua_Number) dmRender::SORT_MODE_##name); \
+        lua_setfield(L, -2, "SORT_MODE_"#name);
+
+        REGISTER_SORT_MODE_CONSTANT(DEPTH);
+        REGISTER_SORT_MODE_CONSTANT(STATE);
+
+#undef REGISTER_SORT_MODE_CONSTANT
+
         // Flags (only flag here currently, so no need for an enum)
         lua_pushnumber(L, RENDER_SCRIPT_FLAG_TEXTURE_BIT);
         lua_setfield(L, -2, "TEXTURE_BIT");
@@ -3478,6 +4093,20 @@ bail:
         dmScript::Unref(L, LUA_REGISTRYINDEX, render_script_instance->m_RenderScriptDataReference);
         dmScript::Unref(L, LUA_REGISTRYINDEX, render_script_instance->m_ContextTableReference);
 
+        for (uint32_t i = 0; i < render_script_instance->m_CommandLists.Size(); ++i)
+        {
+            if (render_script_instance->m_CommandLists[i])
+                DeleteCommandList(L, render_script_instance->m_CommandLists[i]);
+        }
+        if (render_script_instance->m_RecordingCommandList)
+            DeleteCommandList(L, render_script_instance->m_RecordingCommandList);
+        DeletePendingCommandLists(L, render_script_instance);
+
+        for (uint32_t i = 0; i < render_script_instance->m_TransientRenderTargets.Size(); ++i)
+        {
+            dmGraphics::DeleteRenderTarget(render_script_instance->m_TransientRenderTargets[i].m_RenderTarget);
+        }
+
         assert(top == lua_gettop(L));
 
         for (uint32_t i = 0; i < render_script_instance->m_PredicateCount; ++i) {
@@ -3674,8 +4303,19 @@ bail:
 
         RenderScriptResult result = RunScript(instance, RENDER_SCRIPT_FUNCTION_UPDATE, (void*)&dt);
 
+        lua_State* L = instance->m_RenderContext->m_RenderScriptContext.m_LuaState;
+        if (instance->m_RecordingCommandList)
+        {
+            dmLogError("A command list was still being recorded at the end of update, it has been discarded. Call %s.end_commands() to finish recording.", RENDER_SCRIPT_LIB_NAME);
+            DeleteCommandList(L, instance->m_RecordingCommandList);
+            instance->m_RecordingCommandList = 0;
+        }
+
         if (instance->m_CommandBuffer.Size() > 0)
             ParseCommands(instance->m_RenderContext, &instance->m_CommandBuffer.Front(), instance->m_CommandBuffer.Size());
+
+        DeletePendingCommandLists(L, instance);
+        UpdateTransientRenderTargets(instance);
         return result;
     }
 
@@ -53,16 +53,39 @@ namespace dmRender
         RenderResourceType m_Type;
     };
 
+    // A command list recorded with render.begin_commands()/render.end_commands(), replayed with render.execute()
+    struct RenderCommandList
+    {
+        dmArray<Command>              m_Commands;
+        // Lua table keeping the predicates and constant buffers used by the recorded commands alive
+        int                           m_ObjectsReference;
+    };
+
+    // A render target owned by the transient pool, see render.acquire_render_target()
+    struct TransientRenderTarget
+    {
+        dmGraphics::HRenderTarget     m_RenderTarget;
+        uint32_t                      m_ParamsHash;    // Hash of the buffer type flags and creation params
+        uint32_t                      m_Size;          // Estimated size in bytes
+        uint32_t                      m_LastUsedFrame;
+        uint8_t                       m_InUse:1;
+    };
+
     static const uint32_t MAX_PREDICATE_COUNT = 64;
     struct RenderScriptInstance
     {
         dmArray<Command>              m_CommandBuffer;
+        dmArray<RenderCommandList*>   m_CommandLists; // handle is index + 1, deleted lists leave a null slot
+        dmArray<RenderCommandList*>   m_CommandListsToDelete;
+        RenderCommandList*            m_RecordingCommandList;
+        dmArray<TransientRenderTarget> m_TransientRenderTargets;
         dmHashTable64<RenderResource> m_RenderResources;
         Predicate*                    m_Predicates[MAX_PREDICATE_COUNT];
         RenderContext*                m_RenderContext;
         HRenderScript                 m_RenderScript;
         dmScript::ScriptWorld*        m_ScriptWorld;
         uint32_t                      m_PredicateCount;
+        uint32_t                      m_TransientRenderTargetFrame;
         int                           m_InstanceReference;
         int                           m_RenderScriptDataReference;
         int                           m_ContextTableReference;
@@ -134,6 +134,51 @@ TEST_F(dmRenderMaterialTest, TestMaterialConstants)
     dmRender::DeleteMaterial(m_RenderContext, material);
 }
 
+TEST_F(dmRenderMaterialTest, TestMaterialConstantsRedundantUpload)
+{
+    dmGraphics::ShaderDesc::Shader vp_shader = MakeDDFShader("uniform vec4 tint;\n", 19);
+    dmGraphics::HVertexProgram vp = dmGraphics::NewVertexProgram(m_GraphicsContext, &vp_shader);
+
+    dmGraphics::ShaderDesc::Shader fp_shader = MakeDDFShader("foo", 3);
+    dmGraphics::HFragmentProgram fp = dmGraphics::NewFragmentProgram(m_GraphicsContext, &fp_shader);
+    dmRender::HMaterial material = dmRender::NewMaterial(m_RenderContext, vp, fp);
+
+    dmRender::HNamedConstantBuffer constants = dmRender::NewNamedConstantBuffer();
+    Vector4 test_v(1.0f, 0.0f, 0.0f, 0.0f);
+    dmRender::SetNamedConstant(constants, dmHashString64("tint"), &test_v, 1);
+
+    dmGraphics::HProgram program = dmRender::GetMaterialProgram(material);
+    dmGraphics::EnableProgram(m_GraphicsContext, program);
+    dmGraphics::HUniformLocation tint_loc = dmGraphics::GetUniformLocation(program, "tint");
+    const Vector4& v = dmGraphics::GetConstantV4Ptr(m_GraphicsContext, tint_loc);
+
+    dmRender::ApplyNamedConstantBuffer(m_RenderContext, material, constants);
+    ASSERT_EQ(1.0f, v.getX());
+
+    // Write the register behind the back of the material, applying the same values again must not upload anything
+    Vector4 other_v(5.0f, 0.0f, 0.0f, 0.0f);
+    dmGraphics::SetConstantV4(m_GraphicsContext, &other_v, 1, tint_loc);
+    dmRender::ApplyNamedConstantBuffer(m_RenderContext, material, constants);
+    ASSERT_EQ(5.0f, v.getX());
+
+    // Invalidating the shadow state forces the next upload
+    dmRender::InvalidateMaterialConstants(material);
+    dmRender::ApplyNamedConstantBuffer(m_RenderContext, material, constants);
+    ASSERT_EQ(1.0f, v.getX());
+
+    // Changed values are always uploaded
+    test_v = Vector4(2.0f, 0.0f, 0.0f, 0.0f);
+    dmRender::SetNamedConstant(constants, dmHashString64("tint"), &test_v, 1);
+    dmRender::ApplyNamedConstantBuffer(m_RenderContext, material, constants);
+    ASSERT_EQ(2.0f, v.getX());
+
+    dmRender::DeleteNamedConstantBuffer(constants);
+    dmGraphics::DisableProgram(m_GraphicsContext);
+    dmGraphics::DeleteVertexProgram(vp);
+    dmGraphics::DeleteFragmentProgram(fp);
+    dmRender::DeleteMaterial(m_RenderContext, material);
+}
+
 TEST_F(dmRenderMaterialTest, TestMaterialVertexAttributes)
 {
 
@@ -303,6 +348,51 @@ TEST_F(dmRenderMaterialTest, MatchMaterialTags)
     ASSERT_FALSE(dmRender::MatchMaterialTags(DM_ARRAY_SIZE(material_tags), material_tags, DM_ARRAY_SIZE(tags_e), tags_e));
 }
 
+TEST_F(dmRenderMaterialTest, MatchMaterialTagMasks)
+{
+    dmhash_t material_tags[] = { 1, 2, 3, 4, 5 };
+    uint32_t list_key = dmRender::RegisterMaterialTagList(m_RenderContext, DM_ARRAY_SIZE(material_tags), material_tags);
+    const dmRender::MaterialTagList* list = dmRender::FindMaterialTagList(m_RenderContext, list_key);
+    ASSERT_NE((const dmRender::MaterialTagList*)0, list);
+    ASSERT_TRUE(list->m_Mask.m_Valid);
+
+    dmRender::MaterialTagMask mask;
+
+    dmhash_t tags_a[] = { 2, 3 };
+    dmRender::MakeMaterialTagMask(m_RenderContext, DM_ARRAY_SIZE(tags_a), tags_a, &mask);
+    ASSERT_TRUE(mask.m_Valid);
+    ASSERT_TRUE(dmRender::MatchMaterialTagList(list, mask, DM_ARRAY_SIZE(tags_a), tags_a));
+
+    dmhash_t tags_b[] = { 3, 4, 6 };
+    dmRender::MakeMaterialTagMask(m_RenderContext, DM_ARRAY_SIZE(tags_b), tags_b, &mask);
+    ASSERT_FALSE(dmRender::MatchMaterialTagList(list, mask, DM_ARRAY_SIZE(tags_b), tags_b));
+
+    dmRender::MakeMaterialTagMask(m_RenderContext, 0, 0, &mask);
+    ASSERT_FALSE(dmRender::MatchMaterialTagList(list, mask, 0, 0));
+
+    // Use up all the bits, after which new tags fall back to matching the tag arrays
+    for (uint32_t i = 0; i < dmRender::MAX_MATERIAL_TAG_BITS; ++i)
+    {
+        dmhash_t tag = 1000 + i;
+        dmRender::MakeMaterialTagMask(m_RenderContext, 1, &tag, &mask);
+    }
+
+    dmhash_t overflow_tags[] = { 2, 5, 7000 };
+    uint32_t overflow_key = dmRender::RegisterMaterialTagList(m_RenderContext, DM_ARRAY_SIZE(overflow_tags), overflow_tags);
+    const dmRender::MaterialTagList* overflow_list = dmRender::FindMaterialTagList(m_RenderContext, overflow_key);
+    ASSERT_FALSE(overflow_list->m_Mask.m_Valid);
+
+    dmhash_t tags_c[] = { 2, 7000 };
+    dmRender::MakeMaterialTagMask(m_RenderContext, DM_ARRAY_SIZE(tags_c), tags_c, &mask);
+    ASSERT_FALSE(mask.m_Valid);
+    ASSERT_TRUE(dmRender::MatchMaterialTagList(overflow_list, mask, DM_ARRAY_SIZE(tags_c), tags_c));
+    ASSERT_FALSE(dmRender::MatchMaterialTagList(list, mask, DM_ARRAY_SIZE(tags_c), tags_c));
+
+    dmRender::MakeMaterialTagMask(m_RenderContext, DM_ARRAY_SIZE(tags_a), tags_a, &mask);
+    ASSERT_TRUE(mask.m_Valid);
+    ASSERT_FALSE(dmRender::MatchMaterialTagList(overflow_list, mask, DM_ARRAY_SIZE(tags_a), tags_a));
+}
+
 extern "C" void dmExportedSymbols();
 
 int main(int argc, char **argv)
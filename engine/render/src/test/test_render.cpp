@@ -174,6 +174,98 @@ TEST_F(dmRenderTest, TestRenderObjects)
     ASSERT_EQ(dmRender::RESULT_OK, AddToRender(m_Context, &ro));
 }
 
+TEST_F(dmRenderTest, TestSortRenderObjectsByState)
+{
+    dmRender::HMaterial material_a = (dmRender::HMaterial) 0x10;
+    dmRender::HMaterial material_b = (dmRender::HMaterial) 0x20;
+
+    dmRender::RenderObject ros[6];
+    ros[0].m_Material = material_b;
+    ros[1].m_Material = material_a;
+    ros[1].m_SetBlendFactors = 1;
+    ros[1].m_SourceBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
+    ros[1].m_DestinationBlendFactor = dmGraphics::BLEND_FACTOR_ONE;
+    ros[2].m_Material = material_b;
+    ros[3].m_Material = material_a;
+    // Stencil state is order dependent and splits the objects into separately sorted ranges
+    ros[4].m_Material = material_b;
+    ros[4].m_SetStencilTest = 1;
+    ros[5].m_Material = material_a;
+
+    ASSERT_EQ(0u, dmRender::GetRenderObjectStateKey(&ros[0]));
+    ASSERT_NE(0u, dmRender::GetRenderObjectStateKey(&ros[1]));
+
+    m_Context->m_RenderObjects.SetCapacity(6);
+    m_Context->m_RenderObjects.SetSize(0);
+    for (int i = 0; i < 6; ++i)
+        m_Context->m_RenderObjects.Push(&ros[i]);
+
+    dmRender::SortRenderObjectsByState(m_Context, 0, 6);
+
+    dmRender::RenderObject** sorted = m_Context->m_RenderObjects.Begin();
+    ASSERT_EQ(&ros[3], sorted[0]); // material a, default state
+    ASSERT_EQ(&ros[1], sorted[1]); // material a, blend state
+    ASSERT_EQ(&ros[0], sorted[2]); // material b (stable)
+    ASSERT_EQ(&ros[2], sorted[3]);
+    ASSERT_EQ(&ros[4], sorted[4]); // barrier stays in place
+    ASSERT_EQ(&ros[5], sorted[5]);
+
+    m_Context->m_RenderObjects.SetSize(0);
+}
+
+TEST_F(dmRenderTest, TestTransientBuffers)
+{
+    const dmhash_t category_a = dmHashString64("a");
+    const dmhash_t category_b = dmHashString64("b");
+
+    dmRender::HRenderBuffer buffer_a;
+    uint32_t offset_a;
+    uint8_t* data_a = (uint8_t*) dmRender::AllocTransientBuffer(m_Context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, 10, 1, category_a, &buffer_a, &offset_a);
+    ASSERT_NE((uint8_t*) 0, data_a);
+    ASSERT_EQ(0u, offset_a);
+    memset(data_a, 1, 10);
+
+    // Offsets are aligned to any stride
+    dmRender::HRenderBuffer buffer_b;
+    uint32_t offset_b;
+    uint8_t* data_b = (uint8_t*) dmRender::AllocTransientBuffer(m_Context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, 24, 12, category_b, &buffer_b, &offset_b);
+    ASSERT_EQ(buffer_a, buffer_b);
+    ASSERT_EQ(12u, offset_b);
+    memset(data_b, 2, 24);
+
+    // Drawing uploads everything allocated so far
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::Draw(m_Context, 0, 0));
+    dmGraphics::VertexBuffer* vx_buffer = (dmGraphics::VertexBuffer*) buffer_a;
+    ASSERT_LE(36u, vx_buffer->m_Size);
+    ASSERT_EQ(1, vx_buffer->m_Buffer[9]);
+    ASSERT_EQ(2, vx_buffer->m_Buffer[12]);
+    ASSERT_EQ(2, vx_buffer->m_Buffer[35]);
+
+    // Allocations made after a draw are uploaded with the next draw
+    data_a = (uint8_t*) dmRender::AllocTransientBuffer(m_Context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, 4, 1, category_a, &buffer_a, &offset_a);
+    ASSERT_EQ(36u, offset_a);
+    memset(data_a, 3, 4);
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::Draw(m_Context, 0, 0));
+    ASSERT_EQ(3, vx_buffer->m_Buffer[39]);
+
+    // The stats are reported for the previous frame
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::ClearRenderObjects(m_Context));
+    dmRender::TransientBufferStats stats;
+    dmRender::GetTransientBufferStats(m_Context, &stats);
+    ASSERT_EQ(40u, stats.m_BytesUploaded);
+    ASSERT_EQ(2u, stats.m_UploadCount);
+    ASSERT_EQ(2u, stats.m_CategoryCount);
+    ASSERT_EQ(category_a, stats.m_Categories[0]);
+    ASSERT_EQ(14u, stats.m_CategoryBytes[0]);
+    ASSERT_EQ(category_b, stats.m_Categories[1]);
+    ASSERT_EQ(24u, stats.m_CategoryBytes[1]);
+
+    // The next frame starts over in a different buffer
+    data_a = (uint8_t*) dmRender::AllocTransientBuffer(m_Context, dmRender::RENDER_BUFFER_TYPE_VERTEX_BUFFER, 4, 1, category_a, &buffer_b, &offset_a);
+    ASSERT_EQ(0u, offset_a);
+    ASSERT_NE(buffer_a, buffer_b);
+}
+
 TEST_F(dmRenderTest, TestRenderCamera)
 {
     dmRender::HRenderCamera camera = dmRender::NewRenderCamera(m_Context);
@@ -712,6 +804,156 @@ TEST_F(dmRenderTest, TestEnableTextureByHash)
     dmGraphics::DeleteVertexDeclaration(vx_decl);
 }
 
+TEST_F(dmRenderTest, TestStats)
+{
+    const char* shader_src = "uniform lowp sampler2D texture_sampler_1;\n"
+                             "uniform lowp sampler2D texture_sampler_2;\n";
+
+    dmGraphics::ShaderDesc::Shader vs_shader = MakeDDFShader("foo", 3);
+    dmGraphics::ShaderDesc::Shader fs_shader = MakeDDFShader(shader_src, strlen(shader_src));
+
+    dmGraphics::HVertexProgram vp   = dmGraphics::NewVertexProgram(m_GraphicsContext, &vs_shader);
+    dmGraphics::HFragmentProgram fp = dmGraphics::NewFragmentProgram(m_GraphicsContext, &fs_shader);
+    dmRender::HMaterial material    = dmRender::NewMaterial(m_Context, vp, fp);
+
+    dmGraphics::HVertexDeclaration vx_decl = dmGraphics::NewVertexDeclaration(m_GraphicsContext, 0, 0);
+    dmGraphics::HVertexBuffer vx_buffer = dmGraphics::NewVertexBuffer(m_GraphicsContext, 0, 0, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+
+    // Start from a clean frame
+    dmRender::NextStatsFrame(m_Context);
+
+    dmGraphics::HTexture textures[dmRender::RenderObject::MAX_TEXTURE_COUNT] = {};
+    textures[0] = MakeDummyTexture(m_GraphicsContext);
+    textures[1] = MakeDummyTexture(m_GraphicsContext);
+
+    TestEnableTextureByHashDispatchCtx user_ctx;
+    user_ctx.m_Context           = m_Context;
+    user_ctx.m_Material          = material;
+    user_ctx.m_VertexDeclaration = vx_decl;
+    user_ctx.m_VertexBuffer      = vx_buffer;
+    user_ctx.m_Textures          = textures;
+
+    dmRender::RenderListBegin(m_Context);
+
+    uint8_t dispatch = dmRender::RenderListMakeDispatch(m_Context, TestEnableTextureByHashDispatch, 0, &user_ctx);
+    dmRender::RenderListEntry* out = dmRender::RenderListAlloc(m_Context, 1);
+    out[0].m_WorldPosition = Point3(0,0,0);
+    out[0].m_MajorOrder    = 0;
+    out[0].m_MinorOrder    = 0;
+    out[0].m_TagListKey    = 0;
+    out[0].m_Order         = 1;
+    out[0].m_BatchKey      = 0;
+    out[0].m_Dispatch      = dispatch;
+    out[0].m_UserData      = 0;
+
+    dmRender::RenderListSubmit(m_Context, out, out + 1);
+    dmRender::RenderListEnd(m_Context);
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+
+    // The stats are reported for the previous frame
+    dmRender::Stats stats;
+    dmRender::GetStats(m_Context, &stats);
+    ASSERT_EQ(0u, stats.m_DrawCalls);
+
+    dmRender::NextStatsFrame(m_Context);
+    dmRender::GetStats(m_Context, &stats);
+    ASSERT_EQ(1u, stats.m_DrawCalls);
+    ASSERT_EQ(1u, stats.m_Vertices);
+    ASSERT_EQ(1u, stats.m_RenderObjects);
+    ASSERT_EQ(1u, stats.m_ProgramSwitches);
+    ASSERT_EQ(2u, stats.m_TextureBinds);
+    ASSERT_EQ(2u, stats.m_TextureUploads);
+    ASSERT_EQ(8u, stats.m_TextureBytesUploaded);
+
+    dmRender::NextStatsFrame(m_Context);
+    dmRender::GetStats(m_Context, &stats);
+    ASSERT_EQ(0u, stats.m_DrawCalls);
+    ASSERT_EQ(0u, stats.m_TextureUploads);
+
+    dmGraphics::DeleteTexture(textures[0]);
+    dmGraphics::DeleteTexture(textures[1]);
+
+    dmGraphics::DeleteVertexProgram(vp);
+    dmGraphics::DeleteFragmentProgram(fp);
+    dmRender::DeleteMaterial(m_Context, material);
+
+    dmGraphics::DeleteVertexBuffer(vx_buffer);
+    dmGraphics::DeleteVertexDeclaration(vx_decl);
+}
+
+TEST_F(dmRenderTest, TestInstancedDraw)
+{
+    dmGraphics::ShaderDesc::Shader shader = MakeDDFShader("foo", 3);
+    dmGraphics::HVertexProgram vp   = dmGraphics::NewVertexProgram(m_GraphicsContext, &shader);
+    dmGraphics::HFragmentProgram fp = dmGraphics::NewFragmentProgram(m_GraphicsContext, &shader);
+    dmRender::HMaterial material    = dmRender::NewMaterial(m_Context, vp, fp);
+
+    const float vertices[] = { 0, 0, 0, 1, 0, 0, 0, 1, 0 };
+    const uint16_t indices[] = { 0, 1, 2 };
+    const float instance_data[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    dmGraphics::HVertexStreamDeclaration stream_declaration = dmGraphics::NewVertexStreamDeclaration(m_GraphicsContext);
+    dmGraphics::AddVertexStream(stream_declaration, "position", 3, dmGraphics::TYPE_FLOAT, false);
+    dmGraphics::HVertexDeclaration vx_decl = dmGraphics::NewVertexDeclaration(m_GraphicsContext, stream_declaration);
+
+    dmGraphics::HVertexStreamDeclaration instance_stream_declaration = dmGraphics::NewVertexStreamDeclaration(m_GraphicsContext);
+    dmGraphics::AddVertexStream(instance_stream_declaration, "offset", 2, dmGraphics::TYPE_FLOAT, false);
+    dmGraphics::HVertexDeclaration instance_decl = dmGraphics::NewVertexDeclaration(m_GraphicsContext, instance_stream_declaration);
+    dmGraphics::SetVertexDeclarationStepFunction(m_GraphicsContext, instance_decl, dmGraphics::VERTEX_STEP_FUNCTION_INSTANCE);
+
+    dmGraphics::HVertexBuffer vx_buffer       = dmGraphics::NewVertexBuffer(m_GraphicsContext, sizeof(vertices), vertices, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+    dmGraphics::HVertexBuffer instance_buffer = dmGraphics::NewVertexBuffer(m_GraphicsContext, sizeof(instance_data), instance_data, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+    dmGraphics::HIndexBuffer ix_buffer        = dmGraphics::NewIndexBuffer(m_GraphicsContext, sizeof(indices), indices, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+
+    dmRender::RenderObject ros[3];
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(ros); ++i)
+    {
+        ros[i].m_Material              = material;
+        ros[i].m_PrimitiveType         = dmGraphics::PRIMITIVE_TRIANGLES;
+        ros[i].m_VertexDeclarations[0] = vx_decl;
+        ros[i].m_VertexBuffers[0]      = vx_buffer;
+        ros[i].m_VertexCount           = 3;
+    }
+    // Four instances in one draw call
+    ros[0].m_VertexDeclarations[1] = instance_decl;
+    ros[0].m_VertexBuffers[1]      = instance_buffer;
+    ros[0].m_IndexBuffer           = ix_buffer;
+    ros[0].m_IndexType             = dmGraphics::TYPE_UNSIGNED_SHORT;
+    ros[0].m_InstanceCount         = 4;
+    // Without an instance count, a regular indexed draw
+    ros[1].m_IndexBuffer           = ix_buffer;
+    ros[1].m_IndexType             = dmGraphics::TYPE_UNSIGNED_SHORT;
+    // Without an index buffer, the instance count is ignored
+    ros[2].m_InstanceCount         = 4;
+
+    dmGraphics::ResetDrawCount();
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::AddToRender(m_Context, &ros[0]));
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::Draw(m_Context, 0, 0));
+    ASSERT_EQ(1u, dmGraphics::GetDrawCount());
+    ASSERT_EQ(4u, dmGraphics::GetDrawInstanceCount());
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::ClearRenderObjects(m_Context));
+
+    dmGraphics::ResetDrawCount();
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::AddToRender(m_Context, &ros[1]));
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::AddToRender(m_Context, &ros[2]));
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::Draw(m_Context, 0, 0));
+    ASSERT_EQ(2u, dmGraphics::GetDrawCount());
+    ASSERT_EQ(2u, dmGraphics::GetDrawInstanceCount());
+    ASSERT_EQ(dmRender::RESULT_OK, dmRender::ClearRenderObjects(m_Context));
+
+    dmGraphics::DeleteVertexProgram(vp);
+    dmGraphics::DeleteFragmentProgram(fp);
+    dmRender::DeleteMaterial(m_Context, material);
+
+    dmGraphics::DeleteIndexBuffer(ix_buffer);
+    dmGraphics::DeleteVertexBuffer(instance_buffer);
+    dmGraphics::DeleteVertexBuffer(vx_buffer);
+    dmGraphics::DeleteVertexDeclaration(instance_decl);
+    dmGraphics::DeleteVertexDeclaration(vx_decl);
+    dmGraphics::DeleteVertexStreamDeclaration(instance_stream_declaration);
+    dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
+}
+
 TEST_F(dmRenderTest, TestEnableDisableContextTextures)
 {
     dmGraphics::ShaderDesc::Shader vs_shader = MakeDDFShader("foo", 3);
@@ -1437,6 +1679,162 @@ TEST_F(dmRenderTest, GetTextMetricsMeasureTrailingSpace)
     ASSERT_GT(metricsSingleLineSpace.m_Width, 0);
 }
 
+TEST_F(dmRenderTest, TextLayoutCache)
+{
+    const int charwidth = 2;
+    dmRender::TextContext& text_context = m_Context->m_TextContext;
+
+    dmRender::TextEntry te;
+    te.m_FontMap   = m_SystemFontMap;
+    te.m_Width     = 8*charwidth;
+    te.m_Height    = 0;
+    te.m_Leading   = 1.0f;
+    te.m_Tracking  = 0.0f;
+    te.m_LineBreak = false;
+    te.m_Align     = dmRender::TEXT_ALIGN_LEFT;
+    te.m_VAlign    = dmRender::TEXT_VALIGN_TOP;
+
+    const dmRender::TextLayout* layout = dmRender::GetTextLayout(text_context, te, "Hello World");
+    ASSERT_EQ(11u, layout->m_Glyphs.Size());
+    ASSERT_EQ('H', layout->m_Glyphs[0].m_Glyph->m_Character);
+    ASSERT_EQ(1.0f, layout->m_Glyphs[0].m_X);
+    ASSERT_EQ(1.0f + charwidth, layout->m_Glyphs[1].m_X);
+    ASSERT_EQ(layout->m_Glyphs[0].m_Y, layout->m_Glyphs[10].m_Y);
+    ASSERT_EQ(1u, text_context.m_TextLayouts.Size());
+
+    // Same text and layout parameters
+    ASSERT_EQ(layout, dmRender::GetTextLayout(text_context, te, "Hello World"));
+    ASSERT_EQ(1u, text_context.m_TextLayouts.Size());
+
+    // Line breaking is a different layout
+    te.m_LineBreak = true;
+    const dmRender::TextLayout* layout_break = dmRender::GetTextLayout(text_context, te, "Hello World");
+    ASSERT_NE(layout, layout_break);
+    ASSERT_EQ(2u, text_context.m_TextLayouts.Size());
+    ASSERT_GT(layout_break->m_Glyphs[0].m_Y, layout_break->m_Glyphs[layout_break->m_Glyphs.Size()-1].m_Y);
+    te.m_LineBreak = false;
+
+    // Only the layouts that haven't been used lately are purged
+    text_context.m_Frame += dmRender::TEXT_LAYOUT_MAX_AGE;
+    ASSERT_EQ(layout, dmRender::GetTextLayout(text_context, te, "Hello World"));
+    dmRender::PurgeTextLayouts(text_context, dmRender::TEXT_LAYOUT_MAX_AGE);
+    ASSERT_EQ(1u, text_context.m_TextLayouts.Size());
+
+    // Replacing the glyphs of the font map invalidates the layout
+    dmRender::FontMapParams font_map_params;
+    font_map_params.m_CacheWidth = 128;
+    font_map_params.m_CacheHeight = 128;
+    font_map_params.m_CacheCellWidth = 8;
+    font_map_params.m_CacheCellHeight = 8;
+    font_map_params.m_MaxAscent = 2;
+    font_map_params.m_MaxDescent = 1;
+    font_map_params.m_Glyphs.SetCapacity(128);
+    font_map_params.m_Glyphs.SetSize(128);
+    memset((void*)&font_map_params.m_Glyphs[0], 0, sizeof(dmRender::Glyph)*128);
+    for (uint32_t i = 0; i < 128; ++i)
+    {
+        font_map_params.m_Glyphs[i].m_Character = i;
+        font_map_params.m_Glyphs[i].m_Width = 1;
+        font_map_params.m_Glyphs[i].m_LeftBearing = 1;
+        font_map_params.m_Glyphs[i].m_Advance = 3;
+        font_map_params.m_Glyphs[i].m_Ascent = 2;
+        font_map_params.m_Glyphs[i].m_Descent = 1;
+    }
+    dmRender::SetFontMap(m_SystemFontMap, font_map_params);
+
+    layout = dmRender::GetTextLayout(text_context, te, "Hello World");
+    ASSERT_EQ(11u, layout->m_Glyphs.Size());
+    ASSERT_EQ(1.0f + 3.0f, layout->m_Glyphs[1].m_X);
+
+    dmRender::PurgeTextLayouts(text_context, 0);
+    ASSERT_EQ(0u, text_context.m_TextLayouts.Size());
+}
+
+TEST_F(dmRenderTest, TextGlyphCache)
+{
+    // A cache with room for three shelves of glyphs, so that drawing different texts evicts the least recently used ones
+    const uint32_t glyph_count = 26;
+    const uint32_t max_glyph_width = 4;
+    uint8_t glyph_data[glyph_count * (1 + max_glyph_width * 3)];
+    memset(glyph_data, 0, sizeof(glyph_data)); // A zero header means uncompressed
+
+    dmRender::FontMapParams font_map_params;
+    font_map_params.m_CacheWidth = 16;
+    font_map_params.m_CacheHeight = 16;
+    font_map_params.m_CacheCellWidth = 8;
+    font_map_params.m_CacheCellHeight = 8;
+    font_map_params.m_MaxAscent = 2;
+    font_map_params.m_MaxDescent = 1;
+    font_map_params.m_GlyphData = glyph_data;
+    font_map_params.m_Glyphs.SetCapacity(glyph_count);
+    font_map_params.m_Glyphs.SetSize(glyph_count);
+    memset((void*)&font_map_params.m_Glyphs[0], 0, sizeof(dmRender::Glyph)*glyph_count);
+    uint32_t glyph_data_offset = 0;
+    for (uint32_t i = 0; i < glyph_count; ++i)
+    {
+        dmRender::Glyph& g = font_map_params.m_Glyphs[i];
+        g.m_Character = 'A' + i;
+        g.m_Width = 1 + (i % max_glyph_width);
+        g.m_Advance = g.m_Width + 1;
+        g.m_Ascent = 2;
+        g.m_Descent = 1;
+        g.m_GlyphDataOffset = glyph_data_offset;
+        g.m_GlyphDataSize = 1 + g.m_Width * (g.m_Ascent + g.m_Descent);
+        glyph_data_offset += g.m_GlyphDataSize;
+    }
+    dmRender::HFontMap font_map = dmRender::NewFontMap(m_GraphicsContext, font_map_params);
+
+    dmGraphics::ShaderDesc::Shader shader = MakeDDFShader("foo", 3);
+    dmGraphics::HVertexProgram vp = dmGraphics::NewVertexProgram(m_GraphicsContext, &shader);
+    dmGraphics::HFragmentProgram fp = dmGraphics::NewFragmentProgram(m_GraphicsContext, &shader);
+    dmRender::HMaterial material = dmRender::NewMaterial(m_Context, vp, fp);
+
+    const char* texts[] = { "ABCD", "EFGHIJ", "KLMNOP", "QRSTUV", "WXYZ", "ABCD", "ABCDEFGHIJKL" };
+    for (uint32_t t = 0; t < DM_ARRAY_SIZE(texts); ++t)
+    {
+        dmRender::ClearRenderObjects(m_Context);
+        dmRender::RenderListBegin(m_Context);
+
+        dmRender::DrawTextParams params;
+        params.m_Text = texts[t];
+        dmRender::DrawText(m_Context, font_map, material, 0, params);
+        dmRender::FlushTexts(m_Context, 0, 0, true);
+
+        dmRender::RenderListEnd(m_Context);
+        dmRender::DrawRenderList(m_Context, 0, 0, 0);
+
+        const dmRender::TextContext& text_context = m_Context->m_TextContext;
+        const dmRender::GlyphVertex* vertices = (const dmRender::GlyphVertex*)text_context.m_ClientBuffer;
+        uint32_t quad_count = text_context.m_VertexIndex / 6;
+        ASSERT_EQ(strlen(texts[t]), quad_count);
+
+        // All glyphs drawn in the same frame must have their own place in the cache
+        for (uint32_t i = 0; i < quad_count; ++i)
+        {
+            const dmRender::GlyphVertex& a_min = vertices[i*6 + 1];
+            const dmRender::GlyphVertex& a_max = vertices[i*6 + 2];
+            ASSERT_LE(0.0f, a_min.m_UV[0]);
+            ASSERT_LE(0.0f, a_min.m_UV[1]);
+            ASSERT_GE(1.0f, a_max.m_UV[0]);
+            ASSERT_GE(1.0f, a_max.m_UV[1]);
+
+            for (uint32_t j = 0; j < i; ++j)
+            {
+                const dmRender::GlyphVertex& b_min = vertices[j*6 + 1];
+                const dmRender::GlyphVertex& b_max = vertices[j*6 + 2];
+                bool separate = a_max.m_UV[0] <= b_min.m_UV[0] || b_max.m_UV[0] <= a_min.m_UV[0] ||
+                                a_max.m_UV[1] <= b_min.m_UV[1] || b_max.m_UV[1] <= a_min.m_UV[1];
+                ASSERT_TRUE(separate);
+            }
+        }
+    }
+
+    dmRender::DeleteMaterial(m_Context, material);
+    dmGraphics::DeleteVertexProgram(vp);
+    dmGraphics::DeleteFragmentProgram(fp);
+    dmRender::DeleteFontMap(font_map);
+}
+
 TEST_F(dmRenderTest, TextAlignment)
 {
     dmRender::TextMetrics metrics;
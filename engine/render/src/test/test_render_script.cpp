@@ -830,6 +830,157 @@ TEST_F(dmRenderScriptTest, TestLuaDraw_NoPredicate)
     dmRender::DeleteRenderScript(m_Context, render_script);
 }
 
+TEST_F(dmRenderScriptTest, TestLuaCommandLists)
+{
+    const char* script =
+    "function init(self)\n"
+    "    local constants = render.constant_buffer()\n"
+    "    constants.tint = vmath.vector4(1, 0, 0, 1)\n"
+    "    render.begin_commands()\n"
+    "    render.set_viewport(1, 2, 3, 4)\n"
+    "    render.set_view(vmath.matrix4())\n"
+    "    render.draw(render.predicate({\"one\"}), {constants = constants, frustum = vmath.matrix4()})\n"
+    "    self.commands = render.end_commands()\n"
+    "    assert(not pcall(render.end_commands))\n"
+    "    self.frame = 0\n"
+    "end\n"
+    "function update(self)\n"
+    "    collectgarbage()\n"
+    "    self.frame = self.frame + 1\n"
+    "    render.execute(self.commands)\n"
+    "    render.execute(self.commands)\n"
+    "    if self.frame == 2 then\n"
+    "        render.delete_commands(self.commands)\n"
+    "        assert(not pcall(render.execute, self.commands))\n"
+    "    end\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::InitRenderScriptInstance(render_script_instance));
+    // Recorded commands are not added to the command buffer of the frame
+    ASSERT_EQ(0u, render_script_instance->m_CommandBuffer.Size());
+    ASSERT_EQ(1u, render_script_instance->m_CommandLists.Size());
+
+    dmArray<dmRender::Command>& recorded = render_script_instance->m_CommandLists[0]->m_Commands;
+    ASSERT_EQ(3u, recorded.Size());
+    ASSERT_EQ(dmRender::COMMAND_TYPE_SET_VIEWPORT, recorded[0].m_Type);
+    ASSERT_EQ(dmRender::COMMAND_TYPE_SET_VIEW, recorded[1].m_Type);
+    ASSERT_EQ(dmRender::COMMAND_TYPE_DRAW, recorded[2].m_Type);
+
+    // The list is replayed (twice) every frame, the predicate and constants are kept alive by the list
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+
+        dmArray<dmRender::Command>& commands = render_script_instance->m_CommandBuffer;
+        ASSERT_EQ(2u, commands.Size());
+        ASSERT_EQ(dmRender::COMMAND_TYPE_EXECUTE_COMMANDS, commands[0].m_Type);
+        ASSERT_EQ(3u, commands[0].m_Operands[1]);
+        ASSERT_EQ(dmRender::COMMAND_TYPE_EXECUTE_COMMANDS, commands[1].m_Type);
+    }
+
+    ASSERT_EQ((void*)0, (void*)render_script_instance->m_CommandLists[0]);
+    ASSERT_EQ(0u, render_script_instance->m_CommandListsToDelete.Size());
+
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
+TEST_F(dmRenderScriptTest, TestLuaCommandListDeletedRenderTarget)
+{
+    const char* script =
+    "function init(self)\n"
+    "    local params_color = {format = render.FORMAT_RGBA, width = 16, height = 8}\n"
+    "    self.rt = render.render_target({[render.BUFFER_COLOR_BIT] = params_color})\n"
+    "    render.begin_commands()\n"
+    "    render.set_render_target(self.rt)\n"
+    "    render.set_render_target(render.RENDER_TARGET_DEFAULT)\n"
+    "    self.commands = render.end_commands()\n"
+    "    assert(not pcall(render.execute, 0))\n"
+    "    assert(not pcall(render.execute, \"commands\"))\n"
+    "    assert(not pcall(render.delete_commands, self.commands + 1))\n"
+    "end\n"
+    "function update(self)\n"
+    "    if not self.executed then\n"
+    "        render.execute(self.commands)\n"
+    "        self.executed = true\n"
+    "    else\n"
+    "        render.delete_render_target(self.rt)\n"
+    "        local ok, err = pcall(render.execute, self.commands)\n"
+    "        assert(not ok)\n"
+    "        assert(string.find(err, \"deleted\"))\n"
+    "        render.delete_commands(self.commands)\n"
+    "    end\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::InitRenderScriptInstance(render_script_instance));
+
+    dmArray<dmRender::Command>& commands = render_script_instance->m_CommandBuffer;
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+    ASSERT_EQ(1u, commands.Size());
+    ASSERT_EQ(dmRender::COMMAND_TYPE_EXECUTE_COMMANDS, commands[0].m_Type);
+
+    // The list can't be executed once the render target it uses has been deleted
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+    ASSERT_EQ(0u, commands.Size());
+    ASSERT_EQ((void*)0, (void*)render_script_instance->m_CommandLists[0]);
+
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
+TEST_F(dmRenderScriptTest, TestLuaTransientRenderTargets)
+{
+    const char* script =
+    "function init(self)\n"
+    "    self.frame = 0\n"
+    "    self.params = {[render.BUFFER_COLOR_BIT] = {format = render.FORMAT_RGBA, width = 16, height = 8}}\n"
+    "end\n"
+    "function update(self)\n"
+    "    self.frame = self.frame + 1\n"
+    "    if self.frame == 1 then\n"
+    "        local a = render.acquire_render_target(self.params)\n"
+    "        local b = render.acquire_render_target(self.params)\n"
+    "        assert(a ~= b)\n"
+    "        render.release_render_target(a)\n"
+    "        assert(not pcall(render.release_render_target, a))\n"
+    "        assert(render.acquire_render_target(self.params) == a)\n"
+    "        assert(not pcall(render.delete_render_target, b))\n"
+    "        self.targets = {a, b}\n"
+    "    elseif self.frame == 2 then\n"
+    "        local c = render.acquire_render_target(self.params)\n"
+    "        assert(c == self.targets[1] or c == self.targets[2])\n"
+    "    end\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::InitRenderScriptInstance(render_script_instance));
+
+    dmRender::NextStatsFrame(m_Context);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+    ASSERT_EQ(2u, render_script_instance->m_TransientRenderTargets.Size());
+
+    dmRender::NextStatsFrame(m_Context);
+    dmRender::Stats stats;
+    dmRender::GetStats(m_Context, &stats);
+    ASSERT_EQ(2u, stats.m_TransientRenderTargets);
+    ASSERT_EQ(2u * 16 * 8 * 4, stats.m_TransientRenderTargetBytes);
+
+    // Targets not acquired for a few frames are deleted
+    const uint32_t expected_sizes[] = { 2, 2, 1, 0 };
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(expected_sizes); ++i)
+    {
+        ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+        ASSERT_EQ(expected_sizes[i], render_script_instance->m_TransientRenderTargets.Size());
+    }
+
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
 TEST_F(dmRenderScriptTest, TestLuaWindowSize)
 {
     const char* script =
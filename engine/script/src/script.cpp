@@ -19,6 +19,7 @@
 #include <dlib/math.h>
 #include <dlib/pprint.h>
 #include <dlib/profile.h>
+#include <dlib/time.h>
 
 #include "script_private.h"
 #include "script_hash.h"
@@ -83,6 +84,8 @@ namespace dmScript
         context->m_LuaState = lua_open();
         context->m_ContextTableRef = LUA_NOREF;
         context->m_EnableExtensions = enable_extensions;
+        context->m_ManualGC = false;
+        context->m_GCHeapLimit = 0;
         return context;
     }
 
@@ -1474,6 +1477,64 @@ namespace dmScript
         return (uint32_t)lua_gc(L, LUA_GCCOUNT, 0);
     }
 
+    // The heap may grow to this many times its size after a completed cycle before
+    // the automatic collector is restarted, if the per frame steps can't keep up
+    static const uint32_t GC_HEAP_LIMIT_FACTOR = 2;
+    // Lower bound of the heap limit (kb), to avoid restarting the automatic collector for small heaps
+    static const uint32_t GC_HEAP_LIMIT_MIN = 4 * 1024;
+
+    static void UpdateGCHeapLimit(HContext context)
+    {
+        uint32_t heap = GetLuaGCCount(context->m_LuaState);
+        context->m_GCHeapLimit = dmMath::Max(heap * GC_HEAP_LIMIT_FACTOR, GC_HEAP_LIMIT_MIN);
+    }
+
+    void SetManualGC(HContext context, bool enable)
+    {
+        lua_State* L = context->m_LuaState;
+        context->m_ManualGC = enable;
+        if (enable)
+        {
+            UpdateGCHeapLimit(context);
+            lua_gc(L, LUA_GCSTOP, 0);
+        }
+        else
+        {
+            lua_gc(L, LUA_GCRESTART, 0);
+        }
+    }
+
+    bool StepGC(HContext context, uint64_t time_budget)
+    {
+        DM_PROFILE("StepGC");
+        lua_State* L = context->m_LuaState;
+
+        // Always take at least one step, so that the collector makes progress even with a tiny budget
+        uint64_t start_time = dmTime::GetTime();
+        bool cycle_done = false;
+        do
+        {
+            cycle_done = lua_gc(L, LUA_GCSTEP, 0) != 0;
+        } while (!cycle_done && (dmTime::GetTime() - start_time) < time_budget);
+
+        if (!context->m_ManualGC)
+            return cycle_done;
+
+        if (cycle_done)
+        {
+            UpdateGCHeapLimit(context);
+        }
+
+        // A step resets the collector threshold, so we stop it again to keep allocations from triggering steps.
+        // If the budget is too small to keep up with the allocations, we let the automatic collector run until the
+        // current cycle is done instead of letting the heap grow unbounded
+        if (GetLuaGCCount(L) < context->m_GCHeapLimit)
+        {
+            lua_gc(L, LUA_GCSTOP, 0);
+        }
+        return cycle_done;
+    }
+
     LuaStackCheck::LuaStackCheck(lua_State* L, int diff, const char* filename, int linenumber) : m_L(L), m_Filename(filename), m_Linenumber(linenumber), m_Top(lua_gettop(L)), m_Diff(diff)
     {
         if (!(m_Diff >= -m_Top)) {
@@ -626,6 +626,22 @@ namespace dmScript
     */
     uint32_t GetLuaGCCount(lua_State* L);
 
+    /** Puts the garbage collector of the context under manual control. The allocation driven
+    * collector is stopped, and garbage is instead collected by calling StepGC, typically once per frame.
+    * @param context script context
+    * @param enable true to enable manual gc, false to restore the automatic collector
+    */
+    void SetManualGC(HContext context, bool enable);
+
+    /** Runs incremental garbage collection steps until the time budget is spent or a collection cycle finishes.
+    * At least one step is taken. In manual gc mode, the automatic collector is restarted if the heap grows
+    * too large because the steps can't keep up with the allocations.
+    * @param context script context
+    * @param time_budget time budget in microseconds
+    * @return true if a collection cycle finished
+    */
+    bool StepGC(HContext context, uint64_t time_budget);
+
 // DEPRECATED
 // I really don't like this callback setup (mistake on my part). It's clunky.
 // Perhaps better to have a lambda function? (now that all compilers support C++11) /MAWE
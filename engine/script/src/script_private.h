@@ -77,7 +77,9 @@ namespace dmScript
         dmArray<HScriptExtension>   m_ScriptExtensions;
         lua_State*                  m_LuaState;
         int                         m_ContextTableRef;
+        uint32_t                    m_GCHeapLimit;      // Heap size (kb) at which the automatic collector is restarted while in manual gc mode
         bool                        m_EnableExtensions;
+        bool                        m_ManualGC;
     };
 
     HContext GetScriptContext(lua_State* L);
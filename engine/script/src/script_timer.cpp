@@ -16,8 +16,11 @@
 #include "script_timer_private.h"
 
 #include <string.h>
-#include <dlib/index_pool.h>
+#include <algorithm> // std::sort
+#include <math.h>
+#include <dlib/array.h>
 #include <dlib/hashtable.h>
+#include <dlib/math.h>
 #include <dlib/profile.h>
 
 #include "script.h"
@@ -42,123 +45,315 @@ namespace dmScript
      */
 
     /*
-        The timers are stored in a flat array with no holes which we scan sequenctially on each update.
+        The timers are stored in a pool indexed by the lookup index of the timer handle, and are
+        scheduled in a hierarchical timing wheel so that the cost of UpdateTimers scales with the
+        number of timers that fire rather than the number of timers that exist.
 
-        When a timer is removed the last timer in the list may change location (EraseSwap).
+        The timer world keeps an absolute time which is advanced by UpdateTimers, and each timer
+        stores the absolute time when it fires. The time is quantized into ticks (TIMER_TICKS_PER_SECOND)
+        for the wheel. The wheel has TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots each, where each
+        slot at level n covers TIMER_WHEEL_SLOTS^n ticks. When the wheel passes the start of a slot on a
+        higher level, the timers in that slot are cascaded down to the lower levels. Timers that are further
+        away than the wheel covers are kept in the last slot of the top level and re-inserted on each cascade.
 
-        This is to keep the array sweep fast and handle cases where multiple short lived timers are
-        created followed by one long-lived timer. If we did not re-shuffle and keep holes we would keep
-        scanning the array to the end where the only live timer exists skipping all the holes.
-        How much of an issue this is guesswork at this point.
+        Timers whose tick has been reached are moved to the due list, where they stay until the world time
+        passes their fire time. Since ticks are shorter than a frame the due list is small.
 
-        The timer identity is an index into an indirection layer combined with a generation counter,
-        this makes it possible to reuse the index for the indirection layer without risk of using
-        stale indexes - the caller to CancelTimer is allowed to call with an handle of a timer that already
-        has expired.
+        All timers that fire in an update are collected before any callback is called, so that timers added
+        from a callback are never triggered in the same update. They fire in the order of their fire time.
+
+        The timer identity is an index into the timer pool combined with a per index generation counter,
+        this makes it possible to reuse the index without risk of using stale handles - the caller to
+        CancelTimer is allowed to call with an handle of a timer that already has expired.
 
         Each script instance needs to call KillTimers for its owner to clean up potential timers
-        that has not yet been cancelled or completed (one-shot).
+        that has not yet been cancelled or completed (one-shot). The timers are linked per owner to
+        make this independent of the total number of timers.
     */
 
     static const char TIMER_WORLD_VALUE_KEY[] = "__dm_timer_world__";
     static const uint32_t TIMER_WORLD_VALUE_KEY_HASH = dmHashBuffer32(TIMER_WORLD_VALUE_KEY, sizeof(TIMER_WORLD_VALUE_KEY) - 1);
 
+    #define TIMER_INDEX_BITS            20u
+    #define TIMER_INDEX_MASK            ((1u << TIMER_INDEX_BITS) - 1u)
+    #define TIMER_GENERATION_MASK       ((1u << (32u - TIMER_INDEX_BITS)) - 1u)
+    #define INVALID_TIMER_INDEX         0xffffffffu
+    #define INITIAL_TIMER_CAPACITY      8u
+    #define MAX_TIMER_CAPACITY          TIMER_INDEX_MASK // The last index is reserved, since INVALID_TIMER_HANDLE uses it
+    #define TIMER_CAPACITY_GROWTH       16u
+
+    #define TIMER_TICKS_PER_SECOND      128.0
+    #define TIMER_WHEEL_SLOT_BITS       6u
+    #define TIMER_WHEEL_SLOTS           (1u << TIMER_WHEEL_SLOT_BITS)
+    #define TIMER_WHEEL_SLOT_MASK       (TIMER_WHEEL_SLOTS - 1u)
+    #define TIMER_WHEEL_LEVELS          4u
+    #define TIMER_WHEEL_MAX_DELTA       ((1ull << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1u)
+
+    // Identifies which list a timer is linked into, list ids below TIMER_LIST_DUE are wheel slots
+    #define TIMER_LIST_DUE              (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+    #define TIMER_LIST_NONE             (TIMER_LIST_DUE + 1)
+    #define TIMER_LIST_COUNT            TIMER_LIST_NONE
+
     struct Timer
     {
         TimerCallback   m_Callback;
         uintptr_t       m_Owner;
         uintptr_t       m_UserData;
 
+        // The world time when the timer fires
+        double          m_FireTime;
+
         // Store complete timer handle with generation here to identify stale timer handles
         HTimer          m_Handle;
 
-        // How much time remaining until the timer fires
-        float           m_Remaining;
-
         // The timer delay, we need to keep this for repeating timers
         float           m_Delay;
 
+        // Links in the wheel slot or due list (m_List), the free list reuses m_Next
+        uint32_t        m_Next;
+        uint32_t        m_Prev;
+        // Links in the list of timers with the same owner
+        uint32_t        m_OwnerNext;
+        uint32_t        m_OwnerPrev;
+
+        uint16_t        m_List;
         // Flag if the timer should repeat
-        uint32_t        m_Repeat : 1;
+        uint16_t        m_Repeat : 1;
         // Flag if the timer is alive
-        uint32_t        m_IsAlive : 1;
+        uint16_t        m_IsAlive : 1;
     };
 
-    #define INVALID_TIMER_LOOKUP_INDEX  0xffffu
-    #define INITIAL_TIMER_CAPACITY      8u
-    #define MAX_TIMER_CAPACITY          65000u  // Needs to be less that 65535 since 65535 is reserved for invalid index
-    #define TIMER_CAPACITY_GROWTH       16u
+    struct FiringTimer
+    {
+        double  m_FireTime;
+        HTimer  m_Handle;
+    };
 
     struct TimerWorld
     {
         dmArray<Timer>                      m_Timers;
-        dmArray<uint16_t>                   m_IndexLookup;
-        dmIndexPool<uint16_t>               m_IndexPool;
-        uint16_t                            m_Version;   // Incremented to avoid collisions each time we push timer indexes back to the m_IndexPool
+        dmArray<FiringTimer>                m_Firing;
+        dmHashTable64<uint32_t>             m_OwnerTimers;      // Owner -> first timer of the owner
+        uint32_t                            m_Lists[TIMER_LIST_COUNT];
+        double                              m_Time;
+        uint64_t                            m_Tick;             // The last tick the wheel has been advanced to
+        uint32_t                            m_FreeList;
+        uint32_t                            m_AliveCount;
+        uint32_t                            m_LevelCounts[TIMER_WHEEL_LEVELS]; // Number of timers in the slots of each wheel level
         uint16_t                            m_InUpdate : 1;
     };
 
-    static uint16_t GetLookupIndex(HTimer handle)
+    static uint32_t GetLookupIndex(HTimer handle)
     {
-        return (uint16_t)(handle & 0xffffu);
+        return handle & TIMER_INDEX_MASK;
     }
 
-    static HTimer MakeHandle(uint16_t generation, uint16_t lookup_index)
+    static HTimer MakeHandle(uint32_t generation, uint32_t lookup_index)
     {
-        return (((uint32_t)generation) << 16) | (lookup_index);
+        return ((generation & TIMER_GENERATION_MASK) << TIMER_INDEX_BITS) | lookup_index;
     }
 
-    static Timer* AllocateTimer(HTimerWorld timer_world, uintptr_t owner)
+    static uint64_t GetTick(double time)
     {
-        assert(timer_world != 0x0);
-        uint32_t timer_count = timer_world->m_Timers.Size();
-        if (timer_count == MAX_TIMER_CAPACITY)
+        return time > 0.0 ? (uint64_t)(time * TIMER_TICKS_PER_SECOND) : 0u;
+    }
+
+    static Timer* GetTimer(HTimerWorld timer_world, HTimer handle)
+    {
+        uint32_t lookup_index = GetLookupIndex(handle);
+        if (lookup_index >= timer_world->m_Timers.Size())
         {
-            dmLogError("Timer could not be stored since the timer buffer is full (%d).", MAX_TIMER_CAPACITY);
             return 0x0;
         }
+        Timer* timer = &timer_world->m_Timers[lookup_index];
+        if (timer->m_Handle != handle || timer->m_IsAlive == 0)
+        {
+            return 0x0;
+        }
+        return timer;
+    }
 
-        if (timer_world->m_IndexPool.Remaining() == 0)
+    static void LinkTimer(HTimerWorld timer_world, uint32_t timer_index, uint16_t list)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        uint32_t head = timer_world->m_Lists[list];
+        timer.m_List = list;
+        timer.m_Prev = INVALID_TIMER_INDEX;
+        timer.m_Next = head;
+        if (head != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[head].m_Prev = timer_index;
+        }
+        timer_world->m_Lists[list] = timer_index;
+        if (list < TIMER_LIST_DUE)
         {
-            uint32_t old_capacity = timer_world->m_IndexPool.Capacity();
-            uint32_t capacity = dmMath::Min(old_capacity + TIMER_CAPACITY_GROWTH, MAX_TIMER_CAPACITY);
-            timer_world->m_IndexPool.SetCapacity(capacity);
-            timer_world->m_IndexLookup.SetCapacity(capacity);
-            timer_world->m_IndexLookup.SetSize(capacity);
-            memset(&timer_world->m_IndexLookup[old_capacity], 0u, (capacity - old_capacity) * sizeof(uint16_t));
+            ++timer_world->m_LevelCounts[list / TIMER_WHEEL_SLOTS];
         }
+    }
 
-        HTimer handle = MakeHandle(timer_world->m_Version, timer_world->m_IndexPool.Pop());
+    static void UnlinkTimer(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        if (timer.m_List == TIMER_LIST_NONE)
+        {
+            return;
+        }
+        if (timer.m_Prev != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[timer.m_Prev].m_Next = timer.m_Next;
+        }
+        else
+        {
+            timer_world->m_Lists[timer.m_List] = timer.m_Next;
+        }
+        if (timer.m_Next != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[timer.m_Next].m_Prev = timer.m_Prev;
+        }
+        if (timer.m_List < TIMER_LIST_DUE)
+        {
+            --timer_world->m_LevelCounts[timer.m_List / TIMER_WHEEL_SLOTS];
+        }
+        timer.m_List = TIMER_LIST_NONE;
+    }
 
-        if (timer_world->m_Timers.Full())
+    // Links the timer into the wheel slot, or the due list, matching its fire time
+    static void ScheduleTimer(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        uint64_t tick = GetTick(timer.m_FireTime);
+        if (tick <= timer_world->m_Tick)
         {
-            uint32_t capacity = timer_world->m_Timers.Capacity();
-            capacity = dmMath::Min(capacity + TIMER_CAPACITY_GROWTH, MAX_TIMER_CAPACITY);
-            timer_world->m_Timers.SetCapacity(capacity);
+            LinkTimer(timer_world, timer_index, TIMER_LIST_DUE);
+            return;
         }
 
-        timer_world->m_Timers.SetSize(timer_count + 1);
-        Timer& timer = timer_world->m_Timers[timer_count];
-        timer.m_Handle = handle;
-        timer.m_Owner = owner;
+        uint64_t delta = tick - timer_world->m_Tick;
+        if (delta > TIMER_WHEEL_MAX_DELTA)
+        {
+            // Beyond the range of the wheel, it is re-scheduled when the slot is cascaded
+            tick = timer_world->m_Tick + TIMER_WHEEL_MAX_DELTA;
+            delta = TIMER_WHEEL_MAX_DELTA;
+        }
 
-        uint16_t lookup_index = GetLookupIndex(handle);
+        uint32_t level = 0;
+        while ((delta >> (TIMER_WHEEL_SLOT_BITS * (level + 1))) != 0)
+        {
+            ++level;
+        }
+        uint32_t slot = (uint32_t)(tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+        LinkTimer(timer_world, timer_index, (uint16_t)(level * TIMER_WHEEL_SLOTS + slot));
+    }
 
-        timer_world->m_IndexLookup[lookup_index] = timer_count;
-        return &timer;
+    static void RescheduleList(HTimerWorld timer_world, uint16_t list)
+    {
+        uint32_t timer_index = timer_world->m_Lists[list];
+        while (timer_index != INVALID_TIMER_INDEX)
+        {
+            uint32_t next = timer_world->m_Timers[timer_index].m_Next;
+            UnlinkTimer(timer_world, timer_index);
+            ScheduleTimer(timer_world, timer_index);
+            timer_index = next;
+        }
     }
 
-    static void EraseTimer(HTimerWorld timer_world, uint32_t timer_index)
+    // Advances the wheel one tick, cascading the higher levels and moving the timers of the reached slot to the due list
+    static void AdvanceTick(HTimerWorld timer_world)
     {
-        assert(timer_world != 0x0);
+        uint64_t tick = ++timer_world->m_Tick;
 
-        Timer& movedTimer = timer_world->m_Timers.EraseSwap(timer_index);
+        uint32_t cascade_levels = 0;
+        while (cascade_levels + 1 < TIMER_WHEEL_LEVELS && ((tick >> (TIMER_WHEEL_SLOT_BITS * (cascade_levels + 1))) << (TIMER_WHEEL_SLOT_BITS * (cascade_levels + 1))) == tick)
+        {
+            ++cascade_levels;
+        }
+        for (uint32_t level = cascade_levels; level > 0; --level)
+        {
+            uint32_t slot = (uint32_t)(tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+            RescheduleList(timer_world, (uint16_t)(level * TIMER_WHEEL_SLOTS + slot));
+        }
+        RescheduleList(timer_world, (uint16_t)(tick & TIMER_WHEEL_SLOT_MASK));
+    }
+
+    static void LinkOwner(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        uint32_t* head = timer_world->m_OwnerTimers.Get(timer.m_Owner);
+        timer.m_OwnerPrev = INVALID_TIMER_INDEX;
+        if (head)
+        {
+            timer.m_OwnerNext = *head;
+            timer_world->m_Timers[*head].m_OwnerPrev = timer_index;
+            *head = timer_index;
+            return;
+        }
 
-        if (timer_index < timer_world->m_Timers.Size())
+        if (timer_world->m_OwnerTimers.Full())
         {
-            uint16_t moved_lookup_index = GetLookupIndex(movedTimer.m_Handle);
-            timer_world->m_IndexLookup[moved_lookup_index] = timer_index;
+            uint32_t capacity = timer_world->m_OwnerTimers.Capacity() + 64;
+            timer_world->m_OwnerTimers.SetCapacity(dmMath::Max(capacity / 2, 16u), capacity);
         }
+        timer.m_OwnerNext = INVALID_TIMER_INDEX;
+        timer_world->m_OwnerTimers.Put(timer.m_Owner, timer_index);
+    }
+
+    static void UnlinkOwner(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        if (timer.m_OwnerPrev != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[timer.m_OwnerPrev].m_OwnerNext = timer.m_OwnerNext;
+        }
+        else if (timer.m_OwnerNext != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_OwnerTimers.Put(timer.m_Owner, timer.m_OwnerNext);
+        }
+        else
+        {
+            timer_world->m_OwnerTimers.Erase(timer.m_Owner);
+        }
+        if (timer.m_OwnerNext != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[timer.m_OwnerNext].m_OwnerPrev = timer.m_OwnerPrev;
+        }
+    }
+
+    static Timer* AllocateTimer(HTimerWorld timer_world, uintptr_t owner)
+    {
+        assert(timer_world != 0x0);
+        if (timer_world->m_FreeList == INVALID_TIMER_INDEX)
+        {
+            uint32_t timer_count = timer_world->m_Timers.Size();
+            if (timer_count == MAX_TIMER_CAPACITY)
+            {
+                dmLogError("Timer could not be stored since the timer buffer is full (%d).", MAX_TIMER_CAPACITY);
+                return 0x0;
+            }
+
+            if (timer_world->m_Timers.Full())
+            {
+                // Grow geometrically, to keep adding many timers cheap
+                uint32_t capacity = timer_world->m_Timers.Capacity();
+                capacity = dmMath::Min(capacity + dmMath::Max(capacity / 2, TIMER_CAPACITY_GROWTH), MAX_TIMER_CAPACITY);
+                timer_world->m_Timers.SetCapacity(capacity);
+            }
+
+            timer_world->m_Timers.SetSize(timer_count + 1);
+            Timer& timer = timer_world->m_Timers[timer_count];
+            timer.m_Handle = MakeHandle(0, timer_count);
+            timer.m_Next = timer_world->m_FreeList;
+            timer_world->m_FreeList = timer_count;
+        }
+
+        uint32_t timer_index = timer_world->m_FreeList;
+        Timer& timer = timer_world->m_Timers[timer_index];
+        timer_world->m_FreeList = timer.m_Next;
+
+        timer.m_Owner = owner;
+        timer.m_List = TIMER_LIST_NONE;
+        LinkOwner(timer_world, timer_index);
+        ++timer_world->m_AliveCount;
+        return &timer;
     }
 
     static void FreeTimer(HTimerWorld timer_world, Timer& timer)
@@ -166,22 +361,31 @@ namespace dmScript
         assert(timer_world != 0x0);
         assert(timer.m_IsAlive == 0);
 
-        uint16_t lookup_index = GetLookupIndex(timer.m_Handle);
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        timer_world->m_IndexPool.Push(lookup_index);
+        uint32_t timer_index = GetLookupIndex(timer.m_Handle);
+        UnlinkTimer(timer_world, timer_index);
+        UnlinkOwner(timer_world, timer_index);
+        --timer_world->m_AliveCount;
 
-        EraseTimer(timer_world, timer_index);
+        // Bump the generation so that stale handles to this index are detected
+        timer.m_Handle = MakeHandle((timer.m_Handle >> TIMER_INDEX_BITS) + 1, timer_index);
+        timer.m_Next = timer_world->m_FreeList;
+        timer_world->m_FreeList = timer_index;
     }
 
     HTimerWorld NewTimerWorld()
     {
         TimerWorld* timer_world = new TimerWorld();
         timer_world->m_Timers.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_IndexLookup.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_IndexLookup.SetSize(INITIAL_TIMER_CAPACITY);
-        memset(&timer_world->m_IndexLookup[0], 0u, INITIAL_TIMER_CAPACITY * sizeof(uint16_t));
-        timer_world->m_IndexPool.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_Version = 0;
+        timer_world->m_OwnerTimers.SetCapacity(16, 32);
+        for (uint32_t i = 0; i < TIMER_LIST_COUNT; ++i)
+        {
+            timer_world->m_Lists[i] = INVALID_TIMER_INDEX;
+        }
+        timer_world->m_Time = 0.0;
+        timer_world->m_Tick = 0;
+        timer_world->m_FreeList = INVALID_TIMER_INDEX;
+        timer_world->m_AliveCount = 0;
+        memset(timer_world->m_LevelCounts, 0, sizeof(timer_world->m_LevelCounts));
         timer_world->m_InUpdate = 0;
         return timer_world;
     }
@@ -192,42 +396,100 @@ namespace dmScript
         delete timer_world;
     }
 
+    static bool FiringTimerLess(const FiringTimer& a, const FiringTimer& b)
+    {
+        if (a.m_FireTime != b.m_FireTime)
+        {
+            return a.m_FireTime < b.m_FireTime;
+        }
+        return GetLookupIndex(a.m_Handle) < GetLookupIndex(b.m_Handle);
+    }
+
     void UpdateTimers(HTimerWorld timer_world, float dt)
     {
         assert(timer_world != 0x0);
         DM_PROFILE("Update");
 
-        timer_world->m_InUpdate = 1;
+        DM_PROPERTY_ADD_U32(rmtp_TimerCount, timer_world->m_AliveCount);
 
-        // We only scan timers for trigger if the timer *existed at entry to UpdateTimers*, any timers added
-        // in a trigger callback will always be added at the end of m_Timers and not triggered in this scope.
-        uint32_t size = timer_world->m_Timers.Size();
-        DM_PROPERTY_ADD_U32(rmtp_TimerCount, size);
+        timer_world->m_Time += dt;
+        double time = timer_world->m_Time;
 
-        for (uint32_t i = 0; i < size; ++i)
+        uint64_t target_tick = GetTick(time);
+        while (timer_world->m_Tick < target_tick)
         {
-            Timer* timer = &timer_world->m_Timers[i];
-            if (timer->m_IsAlive == 0)
+            // Skip ahead to the tick before the next slot that may hold timers, i.e. past the empty lower levels
+            uint32_t empty_levels = 0;
+            while (empty_levels < TIMER_WHEEL_LEVELS && timer_world->m_LevelCounts[empty_levels] == 0)
             {
-                continue;
+                ++empty_levels;
+            }
+            if (empty_levels == TIMER_WHEEL_LEVELS)
+            {
+                timer_world->m_Tick = target_tick;
+                break;
+            }
+            if (empty_levels > 0)
+            {
+                uint32_t shift = TIMER_WHEEL_SLOT_BITS * empty_levels;
+                uint64_t next_tick = ((timer_world->m_Tick >> shift) + 1) << shift;
+                timer_world->m_Tick = dmMath::Min(next_tick, target_tick) - 1;
+            }
+            AdvanceTick(timer_world);
+        }
+
+        // Collect the timers that fire before calling any callback, any timers added in a
+        // trigger callback will not be triggered in this scope.
+        dmArray<FiringTimer>& firing = timer_world->m_Firing;
+        firing.SetSize(0);
+        uint32_t timer_index = timer_world->m_Lists[TIMER_LIST_DUE];
+        while (timer_index != INVALID_TIMER_INDEX)
+        {
+            Timer& timer = timer_world->m_Timers[timer_index];
+            uint32_t next = timer.m_Next;
+            if (timer.m_FireTime <= time)
+            {
+                UnlinkTimer(timer_world, timer_index);
+                if (firing.Full())
+                {
+                    firing.OffsetCapacity(dmMath::Max(firing.Capacity() / 2, 16u));
+                }
+                FiringTimer firing_timer = { timer.m_FireTime, timer.m_Handle };
+                firing.Push(firing_timer);
             }
+            timer_index = next;
+        }
+
+        if (firing.Empty())
+        {
+            return;
+        }
+
+        std::sort(firing.Begin(), firing.End(), FiringTimerLess);
 
-            timer->m_Remaining -= dt;
-            if (timer->m_Remaining > 0.0f)
+        timer_world->m_InUpdate = 1;
+
+        uint32_t size = firing.Size();
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            HTimer handle = firing[i].m_Handle;
+            Timer* timer = GetTimer(timer_world, handle);
+            if (timer == 0x0)
             {
+                // Cancelled or killed by a previous callback
                 continue;
             }
 
-            float elapsed_time = timer->m_Delay - timer->m_Remaining;
+            double remaining = timer->m_FireTime - time;
+            float elapsed_time = timer->m_Delay - (float)remaining;
 
             TimerEventType eventType = timer->m_Repeat == 0 ? TIMER_EVENT_TRIGGER_WILL_DIE : TIMER_EVENT_TRIGGER_WILL_REPEAT;
 
-            timer->m_Callback(timer_world, eventType, timer->m_Handle, elapsed_time, timer->m_Owner, timer->m_UserData);
-
-            // The array might have been reallocated here! So grab the pointer again...
-            timer = &timer_world->m_Timers[i];
+            timer->m_Callback(timer_world, eventType, handle, elapsed_time, timer->m_Owner, timer->m_UserData);
 
-            if (timer->m_IsAlive == 0)
+            // The array might have been reallocated here, or the timer cancelled! So grab the pointer again...
+            timer = GetTimer(timer_world, handle);
+            if (timer == 0x0)
             {
                 continue;
             }
@@ -235,45 +497,27 @@ namespace dmScript
             if (timer->m_Repeat == 0)
             {
                 timer->m_IsAlive = 0;
+                FreeTimer(timer_world, *timer);
                 continue;
             }
 
             if (timer->m_Delay == 0.0f)
             {
-                timer->m_Remaining = 0.0f;
-                continue;
-            }
-
-            float wrapped_count = ((-timer->m_Remaining) / timer->m_Delay) + 1.f;
-            float offset_to_next_trigger  = floor(wrapped_count) * timer->m_Delay;
-            timer->m_Remaining += offset_to_next_trigger;
-            if (timer->m_Remaining < 0) // If the delay is very small, the floating point precision might produce issues
-                timer->m_Remaining = timer->m_Delay; // reset the timer
-        }
-
-        timer_world->m_InUpdate = 0;
-
-        size = timer_world->m_Timers.Size();
-        uint32_t original_size = size;
-        uint32_t i = 0;
-        while (i < size)
-        {
-            Timer& timer = timer_world->m_Timers[i];
-            if (timer.m_IsAlive == 0)
-            {
-                FreeTimer(timer_world, timer);
-                --size;
+                remaining = 0.0;
             }
             else
             {
-                ++i;
+                double wrapped_count = ((-remaining) / timer->m_Delay) + 1.0;
+                double offset_to_next_trigger = floor(wrapped_count) * timer->m_Delay;
+                remaining += offset_to_next_trigger;
+                if (remaining < 0.0) // If the delay is very small, the floating point precision might produce issues
+                    remaining = timer->m_Delay; // reset the timer
             }
+            timer->m_FireTime = time + remaining;
+            ScheduleTimer(timer_world, GetLookupIndex(handle));
         }
 
-        if (size != original_size)
-        {
-            ++timer_world->m_Version;
-        }
+        timer_world->m_InUpdate = 0;
     }
 
     HTimer AddTimer(HTimerWorld timer_world,
@@ -293,49 +537,31 @@ namespace dmScript
         }
 
         timer->m_Delay = delay;
-        timer->m_Remaining = delay;
+        timer->m_FireTime = timer_world->m_Time + delay;
         timer->m_UserData = userdata;
         timer->m_Callback = timer_callback;
         timer->m_Repeat = repeat;
         timer->m_IsAlive = 1;
 
+        ScheduleTimer(timer_world, GetLookupIndex(timer->m_Handle));
+
         return timer->m_Handle;
     }
 
     bool CancelTimer(HTimerWorld timer_world, HTimer handle)
     {
         assert(timer_world != 0x0);
-        uint16_t lookup_index = GetLookupIndex(handle);
-        if (lookup_index >= timer_world->m_IndexLookup.Size())
-        {
-            return false;
-        }
-
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        if (timer_index >= timer_world->m_Timers.Size())
-        {
-            return false;
-        }
-
-        Timer& timer = timer_world->m_Timers[timer_index];
-        if (timer.m_Handle != handle)
-        {
-            return false;
-        }
-
-        if (timer.m_IsAlive == 0)
+        Timer* timer = GetTimer(timer_world, handle);
+        if (timer == 0x0)
         {
             return false;
         }
 
-        timer.m_IsAlive = 0;
-        timer.m_Callback(timer_world, TIMER_EVENT_CANCELLED, timer.m_Handle, 0.f, timer.m_Owner, timer.m_UserData);
+        timer->m_IsAlive = 0;
+        timer->m_Callback(timer_world, TIMER_EVENT_CANCELLED, timer->m_Handle, 0.f, timer->m_Owner, timer->m_UserData);
 
-        if (timer_world->m_InUpdate == 0)
-        {
-            FreeTimer(timer_world, timer);
-            ++timer_world->m_Version;
-        }
+        // The array might have been reallocated in the callback
+        FreeTimer(timer_world, timer_world->m_Timers[GetLookupIndex(handle)]);
         return true;
     }
 
@@ -343,60 +569,29 @@ namespace dmScript
     {
         assert(timer_world != 0x0);
 
-        uint32_t size = timer_world->m_Timers.Size();
-        uint32_t cancelled_count = 0;
-        uint32_t timer_index = 0;
-        while (timer_index < size)
+        uint32_t* head = timer_world->m_OwnerTimers.Get(owner);
+        if (head == 0x0)
         {
-            Timer& timer = timer_world->m_Timers[timer_index];
-            if (timer.m_Owner != owner)
-            {
-                ++timer_index;
-                continue;
-            }
-
-            if (timer.m_IsAlive == 1)
-            {
-                timer.m_IsAlive = 0;
-                ++cancelled_count;
-            }
-
-            if (timer_world->m_InUpdate == 0)
-            {
-                FreeTimer(timer_world, timer);
-                --size;
-            }
-            else
-            {
-                ++timer_index;
-            }
+            return 0;
         }
 
-        if (cancelled_count > 0)
+        uint32_t cancelled_count = 0;
+        uint32_t timer_index = *head;
+        while (timer_index != INVALID_TIMER_INDEX)
         {
-            ++timer_world->m_Version;
+            Timer& timer = timer_world->m_Timers[timer_index];
+            timer_index = timer.m_OwnerNext;
+            timer.m_IsAlive = 0;
+            FreeTimer(timer_world, timer);
+            ++cancelled_count;
         }
-
         return cancelled_count;
     }
 
     uint32_t GetAliveTimers(HTimerWorld timer_world)
     {
         assert(timer_world != 0x0);
-
-        uint32_t alive_timers = 0u;
-        uint32_t size = timer_world->m_Timers.Size();
-        uint32_t i = 0;
-        while (i < size)
-        {
-            Timer& timer = timer_world->m_Timers[i];
-            if(timer.m_IsAlive == 1)
-            {
-                ++alive_timers;
-            }
-            ++i;
-        }
-        return alive_timers;
+        return timer_world->m_AliveCount;
     }
 
     static void SetTimerWorld(HScriptWorld script_world, HTimerWorld timer_world)
@@ -495,7 +690,7 @@ namespace dmScript
     static void LuaTimerCallbackArgsCB(lua_State* L, void* user_context)
     {
         LuaTimerCallbackArgs* args = (LuaTimerCallbackArgs*)user_context;
-        lua_pushinteger(L, args->timer_handle);
+        lua_pushnumber(L, args->timer_handle);
         lua_pushnumber(L, args->time_elapsed);
     }
 
@@ -536,6 +731,12 @@ namespace dmScript
         return world;
     }
 
+    // Timer handles use all 32 bits, so they are passed to Lua as numbers rather than (possibly 32 bit signed) integers
+    static dmScript::HTimer CheckTimerHandle(lua_State* L, int index)
+    {
+        return (dmScript::HTimer)(uint32_t)luaL_checknumber(L, index);
+    }
+
     /*# create a timer
      * Adds a timer and returns a unique handle.
      *
@@ -613,7 +814,7 @@ namespace dmScript
 
         dmScript::HTimer handle = dmScript::AddTimer(timer_world, seconds, repeat, LuaTimerCallback, (uintptr_t)owner, (uintptr_t)user_data);
 
-        lua_pushinteger(L, handle);
+        lua_pushnumber(L, handle);
         assert(top + 1 == lua_gettop(L));
         return 1;
     }
@@ -641,7 +842,7 @@ namespace dmScript
     static int TimerCancel(lua_State* L)
     {
         int top = lua_gettop(L);
-        const int handle = luaL_checkint(L, 1);
+        const dmScript::HTimer handle = CheckTimerHandle(L, 1);
 
         dmScript::HTimerWorld timer_world = GetTimerWorld(L);
         if (timer_world == 0x0)
@@ -650,7 +851,7 @@ namespace dmScript
             return 1;
         }
 
-        bool cancelled = dmScript::CancelTimer(timer_world, (dmScript::HTimer)handle);
+        bool cancelled = dmScript::CancelTimer(timer_world, handle);
         lua_pushboolean(L, cancelled ? 1 : 0);
         assert(top + 1 == lua_gettop(L));
         return 1;
@@ -678,7 +879,7 @@ namespace dmScript
     {
         DM_LUA_STACK_CHECK(L, 1);
 
-        const int timer_handle = luaL_checkint(L, 1);
+        const dmScript::HTimer timer_handle = CheckTimerHandle(L, 1);
 
         dmScript::HTimerWorld timer_world = GetTimerWorld(L);
         if (timer_world == 0x0)
@@ -688,30 +889,21 @@ namespace dmScript
             return 1;
         }
 
-        uint16_t lookup_index = GetLookupIndex(timer_handle);
-        if (lookup_index >= timer_world->m_IndexLookup.Size())
-        {
-            lua_pushboolean(L, 0);
-            return 1;
-        }
-
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        if (timer_index >= timer_world->m_Timers.Size())
+        Timer* timer = GetTimer(timer_world, timer_handle);
+        if (timer == 0x0)
         {
             lua_pushboolean(L, 0);
             return 1;
         }
 
-        Timer& timer = timer_world->m_Timers[timer_index];
-
-        LuaCallbackInfo* callback = (LuaCallbackInfo*)timer.m_UserData;
+        LuaCallbackInfo* callback = (LuaCallbackInfo*)timer->m_UserData;
         if (!IsCallbackValid(callback))
         {
             lua_pushboolean(L, 0);
             return 1;
         }
 
-        LuaTimerCallbackArgs args = { timer.m_Handle, timer.m_Delay - timer.m_Remaining };
+        LuaTimerCallbackArgs args = { timer->m_Handle, timer->m_Delay - (float)(timer->m_FireTime - timer_world->m_Time) };
         InvokeCallback(callback, LuaTimerCallbackArgsCB, &args);
 
         lua_pushboolean(L, 1);
@@ -753,7 +945,7 @@ namespace dmScript
     {
         DM_LUA_STACK_CHECK(L, 1);
 
-        const int timer_handle = luaL_checkint(L, 1);
+        const dmScript::HTimer timer_handle = CheckTimerHandle(L, 1);
 
         dmScript::HTimerWorld timer_world = GetTimerWorld(L);
         if (timer_world == 0x0)
@@ -763,34 +955,19 @@ namespace dmScript
             return 1;
         }
 
-        uint16_t lookup_index = GetLookupIndex(timer_handle);
-        if (lookup_index >= timer_world->m_IndexLookup.Size())
-        {
-            lua_pushnil(L);
-            return 1;
-        }
-
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        if (timer_index >= timer_world->m_Timers.Size())
-        {
-            lua_pushnil(L);
-            return 1;
-        }
-
-        Timer& timer = timer_world->m_Timers[timer_index];
-
-        if (timer.m_Handle != timer_handle)
+        Timer* timer = GetTimer(timer_world, timer_handle);
+        if (timer == 0x0)
         {
             lua_pushnil(L);
             return 1;
         }
 
         lua_newtable(L);
-        lua_pushnumber(L,timer.m_Remaining);
+        lua_pushnumber(L,(float)(timer->m_FireTime - timer_world->m_Time));
         lua_setfield(L, -2, "time_remaining");
-        lua_pushnumber(L,timer.m_Delay);
+        lua_pushnumber(L,timer->m_Delay);
         lua_setfield(L, -2, "delay");
-        lua_pushboolean(L,timer.m_Repeat==1);
+        lua_pushboolean(L,timer->m_Repeat==1);
         lua_setfield(L, -2, "repeating");
         return 1;
     }
@@ -2299,6 +2299,212 @@ namespace dmScript
         return 1;
     }
 
+    static const char* IN_PLACE_TYPES = SCRIPT_TYPE_NAME_VECTOR3 ", " SCRIPT_TYPE_NAME_VECTOR4 ", " SCRIPT_TYPE_NAME_QUAT " or " SCRIPT_TYPE_NAME_MATRIX4;
+
+    /*# sets the components of an existing vector, quaternion or matrix
+     *
+     * Sets the components of `out` in place, either from numbers or by copying another
+     * value of the same type. Unlike the constructors, no new value is allocated, which
+     * avoids generating garbage when called every frame.
+     *
+     * @name vmath.set
+     * @param out [type:vector3|vector4|quaternion|matrix4] the value to set
+     * @param ... [type:number|vector3|vector4|quaternion|matrix4] the `x`, `y`, `z` (and `w`) components,
+     * or a value of the same type as `out` to copy
+     * @return out [type:vector3|vector4|quaternion|matrix4] the value that was set
+     * @examples
+     *
+     * ```lua
+     * function init(self)
+     *     self.velocity = vmath.vector3()
+     * end
+     *
+     * function on_input(self, action_id, action)
+     *     vmath.set(self.velocity, action.x, action.y, 0)
+     * end
+     * ```
+     */
+    static int Set(lua_State* L)
+    {
+        switch (GetType(L, 1))
+        {
+        case SCRIPT_TYPE_VECTOR3:
+            {
+                Vector3* out = (Vector3*)lua_touserdata(L, 1);
+                if (lua_gettop(L) == 2)
+                    *out = *CheckVector3(L, 2);
+                else
+                    *out = Vector3((float) luaL_checknumber(L, 2), (float) luaL_checknumber(L, 3), (float) luaL_checknumber(L, 4));
+            }
+            break;
+        case SCRIPT_TYPE_VECTOR4:
+            {
+                Vector4* out = (Vector4*)lua_touserdata(L, 1);
+                if (lua_gettop(L) == 2)
+                    *out = *CheckVector4(L, 2);
+                else
+                    *out = Vector4((float) luaL_checknumber(L, 2), (float) luaL_checknumber(L, 3), (float) luaL_checknumber(L, 4), (float) luaL_checknumber(L, 5));
+            }
+            break;
+        case SCRIPT_TYPE_QUAT:
+            {
+                Quat* out = (Quat*)lua_touserdata(L, 1);
+                if (lua_gettop(L) == 2)
+                    *out = *CheckQuat(L, 2);
+                else
+                    *out = Quat((float) luaL_checknumber(L, 2), (float) luaL_checknumber(L, 3), (float) luaL_checknumber(L, 4), (float) luaL_checknumber(L, 5));
+            }
+            break;
+        case SCRIPT_TYPE_MATRIX4:
+            {
+                Matrix4* out = (Matrix4*)lua_touserdata(L, 1);
+                *out = *CheckMatrix4(L, 2);
+            }
+            break;
+        default:
+            return luaL_error(L, "%s.%s expects a %s as first argument.", SCRIPT_LIB_NAME, "set", IN_PLACE_TYPES);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# adds two vectors in place
+     *
+     * Adds `v1` and `v2` and stores the result in `out`, which can be one of the arguments.
+     * Works like `out = v1 + v2`, but without allocating a new vector.
+     *
+     * @name vmath.add
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] first vector
+     * @param v2 [type:vector3|vector4] second vector
+     * @return out [type:vector3|vector4] the result
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     vmath.mul(self.step, self.velocity, dt)
+     *     vmath.add(self.position, self.position, self.step)
+     *     go.set_position(self.position)
+     * end
+     * ```
+     */
+    static int Add(lua_State* L)
+    {
+        switch (GetType(L, 1))
+        {
+        case SCRIPT_TYPE_VECTOR3:
+            *(Vector3*)lua_touserdata(L, 1) = *CheckVector3(L, 2) + *CheckVector3(L, 3);
+            break;
+        case SCRIPT_TYPE_VECTOR4:
+            *(Vector4*)lua_touserdata(L, 1) = *CheckVector4(L, 2) + *CheckVector4(L, 3);
+            break;
+        default:
+            return luaL_error(L, "%s.%s accepts (%s|%s) as arguments.", SCRIPT_LIB_NAME, "add", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# subtracts two vectors in place
+     *
+     * Subtracts `v2` from `v1` and stores the result in `out`, which can be one of the arguments.
+     * Works like `out = v1 - v2`, but without allocating a new vector.
+     *
+     * @name vmath.sub
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] first vector
+     * @param v2 [type:vector3|vector4] second vector
+     * @return out [type:vector3|vector4] the result
+     * @examples
+     *
+     * ```lua
+     * vmath.sub(self.direction, target_position, self.position)
+     * ```
+     */
+    static int Sub(lua_State* L)
+    {
+        switch (GetType(L, 1))
+        {
+        case SCRIPT_TYPE_VECTOR3:
+            *(Vector3*)lua_touserdata(L, 1) = *CheckVector3(L, 2) - *CheckVector3(L, 3);
+            break;
+        case SCRIPT_TYPE_VECTOR4:
+            *(Vector4*)lua_touserdata(L, 1) = *CheckVector4(L, 2) - *CheckVector4(L, 3);
+            break;
+        default:
+            return luaL_error(L, "%s.%s accepts (%s|%s) as arguments.", SCRIPT_LIB_NAME, "sub", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# multiplies in place
+     *
+     * Multiplies `a` and `b` and stores the result in `out`, which can be one of the arguments.
+     * Works like `out = a * b`, but without allocating a new value. The supported combinations are:
+     *
+     * - `vector3` or `vector4` multiplied with a number
+     * - `quat` multiplied with a `quat`
+     * - `matrix4` multiplied with a `matrix4` or a number
+     * - `matrix4` multiplied with a `vector4`, storing the result in a `vector4`
+     *
+     * @name vmath.mul
+     * @param out [type:vector3|vector4|quaternion|matrix4] value to store the result in
+     * @param a [type:vector3|vector4|quaternion|matrix4|number] first operand
+     * @param b [type:vector3|vector4|quaternion|matrix4|number] second operand
+     * @return out [type:vector3|vector4|quaternion|matrix4] the result
+     * @examples
+     *
+     * ```lua
+     * vmath.mul(self.velocity, self.velocity, 0.9) -- damping
+     * vmath.mul(self.rotation, self.rotation, self.spin)
+     * ```
+     */
+    static int Mul(lua_State* L)
+    {
+        switch (GetType(L, 1))
+        {
+        case SCRIPT_TYPE_VECTOR3:
+            {
+                Vector3* out = (Vector3*)lua_touserdata(L, 1);
+                if (lua_isnumber(L, 2))
+                    *out = *CheckVector3(L, 3) * (float) lua_tonumber(L, 2);
+                else
+                    *out = *CheckVector3(L, 2) * (float) luaL_checknumber(L, 3);
+            }
+            break;
+        case SCRIPT_TYPE_VECTOR4:
+            {
+                Vector4* out = (Vector4*)lua_touserdata(L, 1);
+                if (lua_isnumber(L, 2))
+                    *out = *CheckVector4(L, 3) * (float) lua_tonumber(L, 2);
+                else if (GetType(L, 2) == SCRIPT_TYPE_MATRIX4)
+                    *out = *CheckMatrix4(L, 2) * *CheckVector4(L, 3);
+                else
+                    *out = *CheckVector4(L, 2) * (float) luaL_checknumber(L, 3);
+            }
+            break;
+        case SCRIPT_TYPE_QUAT:
+            *(Quat*)lua_touserdata(L, 1) = *CheckQuat(L, 2) * *CheckQuat(L, 3);
+            break;
+        case SCRIPT_TYPE_MATRIX4:
+            {
+                Matrix4* out = (Matrix4*)lua_touserdata(L, 1);
+                if (lua_isnumber(L, 2))
+                    *out = *CheckMatrix4(L, 3) * (float) lua_tonumber(L, 2);
+                else if (lua_isnumber(L, 3))
+                    *out = *CheckMatrix4(L, 2) * (float) lua_tonumber(L, 3);
+                else
+                    *out = *CheckMatrix4(L, 2) * *CheckMatrix4(L, 3);
+            }
+            break;
+        default:
+            return luaL_error(L, "%s.%s expects a %s as first argument.", SCRIPT_LIB_NAME, "mul", IN_PLACE_TYPES);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
     static const luaL_reg methods[] =
     {
         {SCRIPT_TYPE_NAME_VECTOR, Vector_new},
@@ -2335,6 +2541,10 @@ namespace dmScript
         {"inv", Inverse},
         {"ortho_inv", OrthoInverse},
         {"mul_per_elem", MulPerElem},
+        {"set", Set},
+        {"add", Add},
+        {"sub", Sub},
+        {"mul", Mul},
         {0, 0}
     };
 
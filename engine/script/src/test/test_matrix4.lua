@@ -169,3 +169,12 @@ m.c1 = vmath.vector4(-10.01,-10.01,-10.01,-10.01)
 m.c2 = vmath.vector4(-10.01,-10.01,-10.01,-10.01)
 m.c3 = vmath.vector4(-10.01,-10.01,-10.01,-10.01)
 assert(tostring(m) == ("" .. m))
+
+-- in place
+m = vmath.matrix4()
+vmath.set(m, vmath.matrix4_translation(vmath.vector3(1, 2, 3)))
+assert(m.c3.x == 1 and m.c3.y == 2 and m.c3.z == 3, "set")
+vmath.mul(m, m, vmath.matrix4_translation(vmath.vector3(1, 1, 1)))
+assert(m.c3.x == 2 and m.c3.y == 3 and m.c3.z == 4, "mul")
+vmath.mul(m, m, 2)
+assert(m.m00 == 2 and m.c3.x == 4, "mul number")
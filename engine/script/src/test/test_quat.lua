@@ -114,3 +114,13 @@ assert(("foo " .. tostring(q)) == "foo vmath.quat(1, 2, 3, 4)")
 assert(("foo " .. q) == "foo vmath.quat(1, 2, 3, 4)")
 q = vmath.quat(-10.01, -10.01, -10.01, -10.01)
 assert(tostring(q) == ("" .. q))
+
+-- in place
+q = vmath.quat()
+vmath.set(q, 1, 2, 3, 4)
+assert(q.x == 1 and q.y == 2 and q.z == 3 and q.w == 4, "set")
+vmath.set(q, vmath.quat())
+assert(q.x == 0 and q.y == 0 and q.z == 0 and q.w == 1, "set copy")
+local rz = vmath.quat_rotation_z(math.pi * 0.5)
+vmath.mul(q, q, rz)
+assert(q == rz, "mul")
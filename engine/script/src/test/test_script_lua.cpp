@@ -1065,6 +1065,30 @@ TEST_F(ScriptTestLua, LuaBooleanFunctions)
     lua_pop(L, 1);
 }
 
+TEST_F(ScriptTestLua, ManualGC)
+{
+    DM_LUA_STACK_CHECK(L, 0);
+
+    dmScript::SetManualGC(m_Context, true);
+
+    uint32_t base_count = dmScript::GetLuaGCCount(L);
+    ASSERT_TRUE(RunString(L, "for i = 1, 10000 do local t = { i } end"));
+
+    // The garbage stays around until the collector is stepped
+    uint32_t garbage_count = dmScript::GetLuaGCCount(L);
+    ASSERT_LT(base_count, garbage_count);
+
+    bool cycle_done = false;
+    for (uint32_t i = 0; i < 100000 && !cycle_done; ++i)
+    {
+        cycle_done = dmScript::StepGC(m_Context, 1);
+    }
+    ASSERT_TRUE(cycle_done);
+    ASSERT_GT(garbage_count, dmScript::GetLuaGCCount(L));
+
+    dmScript::SetManualGC(m_Context, false);
+}
+
 #undef USE_PANIC_FN
 
 extern "C" void dmExportedSymbols();
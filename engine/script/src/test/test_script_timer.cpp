@@ -17,6 +17,8 @@
 #include "test_script.h"
 
 #include <testmain/testmain.h>
+#include <dlib/math.h>
+#include <dlib/time.h>
 
 struct TimerTestCallback
 {
@@ -706,6 +708,119 @@ TEST_F(ScriptTimerTest, TestKillTimers)
     dmScript::DeleteTimerWorld(timer_world);
 }
 
+TEST_F(ScriptTimerTest, TestTimerOrder)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    static float fire_times[3];
+    static uint32_t fire_count = 0;
+
+    struct Callback {
+        static void cb(dmScript::HTimerWorld timer_world, dmScript::TimerEventType event_type, dmScript::HTimer timer_handle, float time_elapsed, uintptr_t owner, uintptr_t userdata)
+        {
+            fire_times[fire_count++] = (float)userdata;
+        }
+    };
+
+    // Timers that fire in the same update are triggered in the order they expire
+    dmScript::AddTimer(timer_world, 0.3f, false, Callback::cb, 0x10, 3);
+    dmScript::AddTimer(timer_world, 0.1f, false, Callback::cb, 0x10, 1);
+    dmScript::AddTimer(timer_world, 0.2f, false, Callback::cb, 0x10, 2);
+
+    dmScript::UpdateTimers(timer_world, 1.f);
+    ASSERT_EQ(3u, fire_count);
+    ASSERT_EQ(1.f, fire_times[0]);
+    ASSERT_EQ(2.f, fire_times[1]);
+    ASSERT_EQ(3.f, fire_times[2]);
+
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
+TEST_F(ScriptTimerTest, TestLongTimer)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    // Longer than the range covered by the timing wheel
+    const float delay = 60.f * 60.f * 24.f * 4.f;
+    dmScript::HTimer handle = dmScript::AddTimer(timer_world, delay, false, TestCallback, 0x10, 0x0);
+    ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, handle);
+
+    const uint32_t steps = 1000;
+    for (uint32_t i = 0; i < steps - 1; ++i)
+    {
+        dmScript::UpdateTimers(timer_world, delay / steps);
+    }
+    ASSERT_EQ(0u, TimerTestCallback::callback_count);
+    dmScript::UpdateTimers(timer_world, delay / steps);
+    ASSERT_EQ(1u, TimerTestCallback::callback_count);
+
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
+TEST_F(ScriptTimerTest, TestTimerBenchmark)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    const uint32_t timer_count = 100000u;
+    const uint32_t owner_count = 1000u;
+    const float dt = 1.f / 60.f;
+    const uint32_t frame_count = 600u;
+
+    uint64_t start = dmTime::GetTime();
+    uint32_t expected_callback_count = 0;
+    for (uint32_t i = 0; i < timer_count; ++i)
+    {
+        // Delays spread between 0.1 and 100 seconds, every 10th timer repeats
+        float delay = 0.1f + (i % 1000) * 0.1f;
+        bool repeat = (i % 10) == 0;
+        dmScript::HTimer handle = dmScript::AddTimer(timer_world, delay, repeat, TestCallback, 1 + (i % owner_count), 0x0);
+        ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, handle);
+    }
+    uint64_t add_time = dmTime::GetTime() - start;
+    ASSERT_EQ(timer_count, GetAliveTimers(timer_world));
+
+    start = dmTime::GetTime();
+    uint64_t max_update_time = 0;
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        uint64_t update_start = dmTime::GetTime();
+        dmScript::UpdateTimers(timer_world, dt);
+        max_update_time = dmMath::Max(max_update_time, dmTime::GetTime() - update_start);
+    }
+    uint64_t update_time = dmTime::GetTime() - start;
+
+    // Timers with delays up to 10 seconds fired at least once
+    for (uint32_t i = 0; i < timer_count; ++i)
+    {
+        float delay = 0.1f + (i % 1000) * 0.1f;
+        if (delay < frame_count * dt - dt)
+        {
+            ++expected_callback_count;
+        }
+    }
+    ASSERT_LE(expected_callback_count, TimerTestCallback::callback_count);
+
+    start = dmTime::GetTime();
+    uint32_t killed = 0;
+    for (uint32_t i = 0; i < owner_count; ++i)
+    {
+        killed += dmScript::KillTimers(timer_world, 1 + i);
+    }
+    uint64_t kill_time = dmTime::GetTime() - start;
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+    ASSERT_LT(0u, killed);
+
+    printf("%u timers: add %.3f ms, %u updates %.3f ms (avg %.3f ms, max %.3f ms), %u callbacks, kill %.3f ms\n",
+            timer_count, add_time / 1000.0, frame_count, update_time / 1000.0, update_time / (1000.0 * frame_count), max_update_time / 1000.0,
+            TimerTestCallback::callback_count, kill_time / 1000.0);
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
 static dmScript::HTimer cb_callback_handle = dmScript::INVALID_TIMER_HANDLE;
 static uint32_t cb_callback_counter = 0u;
 static float cb_elapsed_time = 0.0f;
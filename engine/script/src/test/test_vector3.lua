@@ -130,3 +130,19 @@ assert(("foo " .. tostring(v)) == "foo vmath.vector3(1, 2, 3)")
 assert(("foo " .. v) == "foo vmath.vector3(1, 2, 3)")
 v = vmath.vector3(-10.01, -10.01, -10.01)
 assert(tostring(v) == ("" .. v))
+
+-- in place
+v = vmath.vector3()
+local r = vmath.set(v, 1, 2, 3)
+assert(r == v and v.x == 1 and v.y == 2 and v.z == 3, "set")
+vmath.set(v, vmath.vector3(4, 5, 6))
+assert(v.x == 4 and v.y == 5 and v.z == 6, "set copy")
+vmath.add(v, v, vmath.vector3(1, 1, 1))
+assert(v.x == 5 and v.y == 6 and v.z == 7, "add")
+vmath.sub(v, v, vmath.vector3(5, 5, 5))
+assert(v.x == 0 and v.y == 1 and v.z == 2, "sub")
+vmath.mul(v, v, 2)
+assert(v.x == 0 and v.y == 2 and v.z == 4, "mul")
+vmath.mul(v, 0.5, v)
+assert(v.x == 0 and v.y == 1 and v.z == 2, "mul number first")
+assert(not pcall(vmath.add, v, v, vmath.vector4()), "add with mismatching types")
@@ -140,3 +140,16 @@ assert(("foo " .. tostring(v)) == "foo vmath.vector4(1, 2, 3, 4)")
 assert(("foo " .. v) == "foo vmath.vector4(1, 2, 3, 4)")
 v = vmath.vector4(-10.01, -10.01, -10.01, -10.01)
 assert(tostring(v) == ("" .. v))
+
+-- in place
+v = vmath.vector4()
+vmath.set(v, 1, 2, 3, 4)
+assert(v.x == 1 and v.y == 2 and v.z == 3 and v.w == 4, "set")
+vmath.add(v, v, vmath.vector4(1, 1, 1, 1))
+assert(v.x == 2 and v.y == 3 and v.z == 4 and v.w == 5, "add")
+vmath.sub(v, v, vmath.vector4(2, 2, 2, 2))
+assert(v.x == 0 and v.y == 1 and v.z == 2 and v.w == 3, "sub")
+vmath.mul(v, v, 2)
+assert(v.x == 0 and v.y == 2 and v.z == 4 and v.w == 6, "mul")
+vmath.mul(v, vmath.matrix4_translation(vmath.vector3(1, 2, 3)), vmath.vector4(0, 0, 0, 1))
+assert(v.x == 1 and v.y == 2 and v.z == 3 and v.w == 1, "mul matrix")